@@ -1,14 +1,207 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <time.h>
+#include <pthread.h>
 #include "logs.h"
 #include "../../utils/logs/logs-common.h"
+#include "../../utils/parson/parson.h"
 
+/*
+ * Logs do cliente: o jogo só copia a entrada para uma fila em memória e continua; uma thread
+ * escreve as entradas em lotes, uma linha JSON por entrada, no fim do ficheiro do cliente.
+ * O ficheiro nunca é relido nem reescrito, e o jogo nunca espera pelo disco: com a fila cheia
+ * a entrada é descartada e o número de entradas perdidas fica registado no ficheiro.
+ */
 
-void err_dump_client(char *filePath, int idJogo, int idJogador, char *msg, char *event) {
-	
-	// produce log message
-    writeLogJSON(filePath, idJogo, idJogador, msg);
+typedef struct {
+    time_t timestamp;
+    int fileID; // client ID when the entry was made: the file it goes to
+    int gameID;
+    int playerID;
+    char text[CLIENT_LOG_TEXT_SIZE];
+} ClientLogEntry;
+
+// bounded queue of entries (protected by logMutex)
+static pthread_mutex_t logMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t logReady = PTHREAD_COND_INITIALIZER;
+static ClientLogEntry logQueue[CLIENT_LOG_QUEUE_SIZE];
+static int logIn = 0;
+static int logCount = 0;
+static int logDropped = 0;
+static bool logStopping = false;
+
+static bool logStarted = false;
+static pthread_t logThread;
+static char logDirectory[256];
+
+// append one entry as a JSON line
+static void writeEntry(FILE *file, const ClientLogEntry *entry) {
+
+    struct tm tm;
+    localtime_r(&entry->timestamp, &tm);
+    char timestamp[72];
+    sprintf(timestamp, "%02d-%02d-%04d %02d:%02d:%02d",
+            tm.tm_mday, tm.tm_mon + 1, tm.tm_year + 1900,
+            tm.tm_hour, tm.tm_min, tm.tm_sec);
+
+    JSON_Value *logValue = json_value_init_object();
+    JSON_Object *logObject = json_value_get_object(logValue);
+    json_object_set_string(logObject, "timestamp", timestamp);
+    json_object_set_number(logObject, "gameID", entry->gameID);
+    json_object_set_number(logObject, "playerID", entry->playerID);
+    json_object_set_string(logObject, "message", entry->text);
+
+    char *line = json_serialize_to_string(logValue);
+    if (line != NULL) {
+        fputs(line, file);
+        fputc('\n', file);
+        json_free_serialized_string(line);
+    }
+
+    json_value_free(logValue);
+}
+
+static void *writeClientLogs(void *arg) {
+
+    ClientLogEntry *batch = (ClientLogEntry *)malloc(sizeof(ClientLogEntry) * CLIENT_LOG_QUEUE_SIZE);
+    if (batch == NULL) {
+        fprintf(stderr, "Memory allocation failed for the client logs\n");
+        return NULL;
+    }
+
+    FILE *file = NULL;
+    int fileID = -1;
+
+    for (;;) {
+
+        // take everything queued in one go, so the game only waits for a copy
+        pthread_mutex_lock(&logMutex);
+        while (logCount == 0 && logDropped == 0 && !logStopping) {
+            pthread_cond_wait(&logReady, &logMutex);
+        }
+
+        int numEntries = logCount;
+        int first = (logIn - logCount + CLIENT_LOG_QUEUE_SIZE) % CLIENT_LOG_QUEUE_SIZE;
+        for (int i = 0; i < numEntries; i++) {
+            batch[i] = logQueue[(first + i) % CLIENT_LOG_QUEUE_SIZE];
+        }
+        logCount = 0;
+
+        int dropped = logDropped;
+        logDropped = 0;
+        bool isStopping = logStopping;
+
+        pthread_mutex_unlock(&logMutex);
+
+        for (int i = 0; i < numEntries; i++) {
+
+            // the client ID arrives after the first entries: they go to client-0
+            if (file == NULL || batch[i].fileID != fileID) {
+                if (file != NULL) {
+                    fclose(file);
+                }
+                char path[512];
+                snprintf(path, sizeof(path), CLIENT_LOG_FILE_FORMAT, logDirectory, batch[i].fileID);
+                file = fopen(path, "a");
+                fileID = batch[i].fileID;
+            }
+
+            if (file != NULL) {
+                writeEntry(file, &batch[i]);
+            }
+        }
+
+        if (dropped > 0 && file != NULL) {
+            ClientLogEntry note;
+            memset(&note, 0, sizeof(note));
+            note.timestamp = time(NULL);
+            note.playerID = fileID;
+            snprintf(note.text, sizeof(note.text), "%d log entries dropped (queue full)", dropped);
+            writeEntry(file, &note);
+        }
+
+        // one write to disk per batch
+        if (file != NULL) {
+            fflush(file);
+        }
+
+        if (isStopping && numEntries == 0) {
+            break;
+        }
+    }
+
+    if (file != NULL) {
+        fclose(file);
+    }
+    free(batch);
+
+    return NULL;
+}
+
+void startClientLog(clientConfig *config) {
+
+    if (logStarted) {
+        return;
+    }
+
+    strncpy(logDirectory, config->sourceLogPath, sizeof(logDirectory) - 1);
+
+    if (pthread_create(&logThread, NULL, writeClientLogs, NULL) != 0) {
+        // without the writer the entries are simply not written
+        fprintf(stderr, "Couldn't start the client log writer\n");
+        return;
+    }
+
+    logStarted = true;
+
+    // exit() anywhere in the client (err_dump_client included) writes the pending entries first
+    atexit(stopClientLog);
+}
+
+void produceClientLog(clientConfig *config, int gameID, int playerID, const char *logMessage) {
+
+    pthread_mutex_lock(&logMutex);
+
+    if (logCount == CLIENT_LOG_QUEUE_SIZE) {
+        // never wait for the disk: the writer records how many were lost
+        logDropped++;
+    } else {
+        ClientLogEntry *entry = &logQueue[logIn];
+        entry->timestamp = time(NULL);
+        entry->fileID = config->clientID;
+        entry->gameID = gameID;
+        entry->playerID = playerID;
+        strncpy(entry->text, logMessage, sizeof(entry->text) - 1);
+        entry->text[sizeof(entry->text) - 1] = '\0';
+
+        logIn = (logIn + 1) % CLIENT_LOG_QUEUE_SIZE;
+        logCount++;
+    }
+
+    pthread_cond_signal(&logReady);
+    pthread_mutex_unlock(&logMutex);
+}
+
+void stopClientLog(void) {
+
+    if (!logStarted) {
+        return;
+    }
+    logStarted = false;
+
+    pthread_mutex_lock(&logMutex);
+    logStopping = true;
+    pthread_cond_signal(&logReady);
+    pthread_mutex_unlock(&logMutex);
+
+    pthread_join(logThread, NULL);
+}
+
+void err_dump_client(clientConfig *config, int idJogo, int idJogador, char *msg, char *event) {
+
+	// produce log message (written by stopClientLog, at exit)
+    produceClientLog(config, idJogo, idJogador, msg);
 
 	// imprime a mensagem de erro e termina o programa
 	perror(msg);
@@ -3,8 +3,21 @@
 
 #include "../config/config.h"
 
+#define CLIENT_LOG_FILE_FORMAT "%sclient-%d-logs.jsonl" // LOG_PATH and the client ID, one JSON object per line
+#define CLIENT_LOG_QUEUE_SIZE 256                       // entries waiting for the writer thread
+#define CLIENT_LOG_TEXT_SIZE 256
+
+// Inicia a thread que escreve os logs do cliente; os logs pendentes são escritos quando o programa termina.
+void startClientLog(clientConfig *config);
+
+// Põe uma entrada na fila de logs sem esperar pelo disco (se a fila estiver cheia, a entrada é descartada e contada).
+void produceClientLog(clientConfig *config, int gameID, int playerID, const char *logMessage);
+
+// Escreve os logs pendentes e termina a thread de escrita.
+void stopClientLog(void);
+
 // Função externa para registar um erro no log e terminar o programa.
-void err_dump_client(char *filePath, int idJogo, int idJogador, char *msg, char *event);
+void err_dump_client(clientConfig *config, int idJogo, int idJogador, char *msg, char *event);
 
 
-#endif // LOGS_H
\ No newline at end of file
+#endif // LOGS_H
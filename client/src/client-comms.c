@@ -4,6 +4,8 @@
 #include "../logs/logs.h"
 #include "client-comms.h"
 
+#define RESUME_ATTEMPTS 10 // one per second: covers a server restart, well inside its grace period
+
 /**
  * Estabelece uma ligação TCP ao servidor especificado na configuração do cliente.
  *
@@ -35,7 +37,7 @@ void connectToServer(struct sockaddr_in *serv_addr, int *socketfd, clientConfig
     /* Converter serverIP para binario*/
     if (inet_pton(AF_INET, config->serverIP, &serv_addr->sin_addr) <= 0) {
         // erro ao converter serverIP para binario
-        err_dump_client(config->logPath, 0, config->clientID, "can't get server address", EVENT_CONNECTION_CLIENT_NOT_ESTABLISHED);
+        err_dump_client(config, 0, config->clientID, "can't get server address", EVENT_CONNECTION_CLIENT_NOT_ESTABLISHED);
     }
 
     /* Dados para o socket stream: porta do servidor */ 
@@ -44,18 +46,93 @@ void connectToServer(struct sockaddr_in *serv_addr, int *socketfd, clientConfig
 	/* Cria socket tcp (stream) */
     if ((*socketfd = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
         // erro ao abrir socket
-        err_dump_client(config->logPath, 0, config->clientID, "can't open datagram socket", EVENT_CONNECTION_CLIENT_NOT_ESTABLISHED);
+        err_dump_client(config, 0, config->clientID, "can't open datagram socket", EVENT_CONNECTION_CLIENT_NOT_ESTABLISHED);
     }
     
 	/* Estabelece ligação com o servidor */
     if (connect(*socketfd, (struct sockaddr *)serv_addr, sizeof(*serv_addr)) < 0) {
         // erro ao conectar ao servidor
-        err_dump_client(config->logPath, 0, config->clientID, "can't connect to server", EVENT_CONNECTION_CLIENT_NOT_ESTABLISHED);
+        err_dump_client(config, 0, config->clientID, "can't connect to server", EVENT_CONNECTION_CLIENT_NOT_ESTABLISHED);
     }
     
     /* Print conexao estabelecida */
     printf("Conexao estabelecida com o servidor %s:%d\n", config->serverIP, config->serverPort);
-    writeLogJSON(config->logPath, 0, config->clientID, EVENT_CONNECTION_CLIENT_ESTABLISHED);
+    produceClientLog(config, 0, config->clientID, EVENT_CONNECTION_CLIENT_ESTABLISHED);
+}
+
+
+/**
+ * Volta a ligar-se ao servidor e retoma a sessão depois de a ligação cair a meio de um jogo.
+ *
+ * @param socketfd Um pointer para o descritor de socket; em caso de sucesso passa a ser o da nova ligação.
+ * @param config A estrutura `clientConfig` com o endereço do servidor e o token da sessão.
+ * @return `true` se o servidor respondeu "RESUMED", `false` se não houver token ou a sessão tiver expirado.
+ *
+ * @details A função faz o seguinte:
+ * - Fecha o socket perdido e tenta abrir uma nova ligação até `RESUME_ATTEMPTS` vezes, com um segundo entre tentativas.
+ * - Envia "resume <token>" em vez do estado premium, e lê a resposta até ao fim da linha.
+ * - O servidor volta depois a enviar o tabuleiro e a linha atual, que quem chamou deve ler normalmente.
+ * - Ao contrário de `connectToServer`, uma falha não termina o programa: só é registada no log.
+ */
+
+bool resumeSession(int *socketfd, clientConfig *config) {
+
+    if (config->sessionToken[0] == '\0') {
+        return false;
+    }
+
+    close(*socketfd);
+    *socketfd = -1;
+
+    struct sockaddr_in serv_addr;
+    memset(&serv_addr, 0, sizeof(serv_addr));
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_port = htons(config->serverPort);
+    if (inet_pton(AF_INET, config->serverIP, &serv_addr.sin_addr) <= 0) {
+        return false;
+    }
+
+    printf("Ligacao perdida, a tentar retomar a sessao...\n");
+
+    for (int attempt = 0; attempt < RESUME_ATTEMPTS; attempt++) {
+
+        if (attempt > 0) {
+            sleep(1);
+        }
+
+        int newSocket = socket(AF_INET, SOCK_STREAM, 0);
+        if (newSocket < 0) {
+            continue;
+        }
+
+        if (connect(newSocket, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
+            close(newSocket);
+            continue;
+        }
+
+        char buffer[BUFFER_SIZE];
+        snprintf(buffer, sizeof(buffer), "resume %s", config->sessionToken);
+
+        if (send(newSocket, buffer, strlen(buffer), 0) < 0) {
+            close(newSocket);
+            continue;
+        }
+
+        // "RESUMED <id>" or "EXPIRED": either way the answer is final
+        memset(buffer, 0, sizeof(buffer));
+        if (readline(newSocket, buffer, sizeof(buffer)) > 0 && strncmp(buffer, "RESUMED", 7) == 0) {
+            *socketfd = newSocket;
+            printf("Sessao retomada\n");
+            produceClientLog(config, 0, config->clientID, "Session resumed after a lost connection");
+            return true;
+        }
+
+        close(newSocket);
+        break;
+    }
+
+    produceClientLog(config, 0, config->clientID, "Session could not be resumed");
+    return false;
 }
 
 
@@ -76,10 +153,10 @@ void closeConnection(int *socketfd, clientConfig *config) {
 
     // send close connection message to the server
     if (send(*socketfd, "closeConnection", strlen("closeConnection"), 0) < 0) {
-        err_dump_client(config->logPath, 0, config->clientID, "can't send close connection message to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
+        err_dump_client(config, 0, config->clientID, "can't send close connection message to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
     } else {
         printf("Closing connection...\n");
-        writeLogJSON(config->logPath, 0, config->clientID, EVENT_CONNECTION_CLIENT_CLOSED);
+        produceClientLog(config, 0, config->clientID, EVENT_CONNECTION_CLIENT_CLOSED);
     }
 
     // close the socket
@@ -8,6 +8,9 @@
 // Estabelece uma ligação TCP com o servidor.
 void connectToServer(struct sockaddr_in *serv_addr, int *socketfd, clientConfig *config);
 
+// Volta a ligar-se ao servidor e retoma a sessão depois de a ligação cair.
+bool resumeSession(int *socketfd, clientConfig *config);
+
 // Envia uma mensagem para fechar a conexão com o servidor.
 void closeConnection(int *socketfd, clientConfig *config);
 
@@ -4,29 +4,33 @@
 #include <time.h>
 #include "../../utils/parson/parson.h"
 #include "../../utils/logs/logs-common.h"
+#include "../../utils/board/board.h"
 #include "../logs/logs.h"
 #include "client-game.h"
 
 /**
- * Verifica se a linha contém exatamente 9 dígitos numéricos (de '0' a '9').
+ * Verifica se a linha contém exatamente uma célula válida por coluna do tabuleiro.
  *
  * @param buffer Uma string que contém a linha a ser verificada.
- * @return -1 se a linha não tiver exatamente 9 caracteres ou se contiver caracteres não numéricos.
- *         0 se a linha for válida (contém exatamente 9 dígitos numéricos).
+ * @param size O número de colunas do tabuleiro.
+ * @return -1 se a linha não tiver exatamente `size` caracteres ou se contiver valores inválidos.
+ *         0 se a linha for válida.
  *
  * @details A função faz o seguinte:
- * - Verifica se o comprimento da string `buffer` é exatamente 9.
- * - Percorre cada carácter na string para verificar se é um dígito numérico.
- * - Se qualquer carácter não for um dígito ou se o comprimento for diferente de 9,
+ * - Verifica se o comprimento da string `buffer` é exatamente `size`.
+ * - Percorre cada carácter na string para verificar se é uma célula ('0'-'9' e 'A'-'P' para 10 a 25)
+ * que cabe no tabuleiro.
+ * - Se qualquer carácter não for válido ou se o comprimento for diferente de `size`,
  * retorna -1; caso contrário, retorna 0.
  */
 
-int verifyLine(char *buffer) {
-    if (strlen(buffer) != 9) {
+int verifyLine(char *buffer, int size) {
+    if (strlen(buffer) != size) {
         return -1;
     }
-    for (int i = 0; i < 9; i++) {
-        if (buffer[i] < '0' || buffer[i] > '9') {
+    for (int i = 0; i < size; i++) {
+        int value = decodeCell(buffer[i]);
+        if (value < 0 || value > size) {
             return -1;
         }
     }
@@ -37,7 +41,7 @@ int verifyLine(char *buffer) {
  * Resolve uma linha do tabuleiro de jogo, preenchendo células vazias com números válidos.
  *
  * @param buffer Uma string JSON que contém o estado atual do tabuleiro.
- * @param line Uma string de 10 caracteres onde a linha resolvida será armazenada (9 dígitos + terminador nulo).
+ * @param line Uma string onde a linha resolvida será armazenada (uma célula por coluna + terminador nulo).
  * @param row O número da linha (0-indexado) que será resolvida.
  * @param difficulty O nível de dificuldade usado para validar os números inseridos.
  *
@@ -45,7 +49,7 @@ int verifyLine(char *buffer) {
  * - Inicializa o gerador de números aleatórios.
  * - Faz o parse da string JSON para obter o tabuleiro de jogo.
  * - Itera por cada célula da linha especificada:
- *   - Se a célula estiver vazia (valor 0), tenta números de 1 a 9 até encontrar um válido.
+ *   - Se a célula estiver vazia (valor 0), tenta números de 1 ao tamanho do tabuleiro até encontrar um válido.
  *   - Se a célula já tiver um valor, copia-o para a string `line`.
  * - Usa a função `isValid` para verificar se um número é válido para a posição dada, tendo em conta a dificuldade.
  * - Termina a string `line` com o caractere nulo (`'\0'`) e liberta a memória alocada para o objeto JSON.
@@ -67,21 +71,22 @@ void resolveLine(char *buffer, char *line, int row, int difficulty, Estatisticas
 
     // Get the line array from the board array
     JSON_Array *linha_array = json_array_get_array(board_array, row);
+    int size = json_array_get_count(board_array);
 
     // Iterate through each cell in the line
-    for (int i = 0; i < 9; i++) {
+    for (int i = 0; i < size; i++) {
         int cell_value = (int)json_array_get_number(linha_array, i);
 
         // If the cell is empty (value is 0)
         if (cell_value == 0) {
             // Try different numbers until a valid one is found
-            for (int num = 1; num <= 9; num++) {
+            for (int num = 1; num <= size; num++) {
                 estatisticas->tentativas++; // Aumenta o número de tentativas a cada tentativa de número
 
                 // Check if the number is valid for this cell
                 if (isValid(board_array, row, i, num, difficulty)) {
                     // Set the cell value to the number
-                    line[i] = num + '0'; // Convert to character for string representation
+                    line[i] = encodeCell(num); // Convert to character for string representation
 
                     // Se o número for o correto, aumenta o número de acertos
                     if (num == (int)json_array_get_number(linha_array, i)) {
@@ -92,13 +97,13 @@ void resolveLine(char *buffer, char *line, int row, int difficulty, Estatisticas
             }
         } else {
             // The cell is already filled, copy the value to the line
-            line[i] = cell_value + '0';
+            line[i] = encodeCell(cell_value);
             estatisticas->acertos++; // Aumenta o número de acertos
         }
     }
 
     // Terminate the string
-    line[9] = '\0';
+    line[size] = '\0';
 
     // Free the JSON objects
     json_value_free(root_value);
@@ -129,18 +134,21 @@ void resolveLine(char *buffer, char *line, int row, int difficulty, Estatisticas
  * @details A função verifica a validade do número nas seguintes condições:
  * - **Linha**: O número não pode já existir na mesma linha (exceto na coluna atual).
  * - **Coluna**: Se a dificuldade for 2 ou superior, o número não pode já existir na mesma coluna (exceto na linha atual).
- * - **Subgrade 3x3**: Se a dificuldade for 3, o número não pode já existir na mesma subgrade 3x3 (exceto na célula atual).
+ * - **Caixa**: Se a dificuldade for 3, o número não pode já existir na mesma caixa (3x3 num tabuleiro 9x9, exceto na célula atual).
  * 
  * @note A função ajusta a complexidade da verificação com base no nível de dificuldade fornecido:
  * - Dificuldade 1: Apenas verifica a linha.
  * - Dificuldade 2: Verifica a linha e a coluna.
- * - Dificuldade 3: Verifica a linha, a coluna, e a subgrade 3x3.
+ * - Dificuldade 3: Verifica a linha, a coluna, e a caixa.
  */
 
 bool isValid(JSON_Array *board_array, int row, int col, int num, int difficulty) {
 
+    int size = json_array_get_count(board_array);
+    int boxSize = boardBoxSize(size);
+
     // Check row
-    for (int i = 0; i < 9; i++) {
+    for (int i = 0; i < size; i++) {
         if (i != col && json_array_get_number(json_array_get_array(board_array, row), i) == num) {
             return false;
         }
@@ -148,19 +156,19 @@ bool isValid(JSON_Array *board_array, int row, int col, int num, int difficulty)
 
     // Check column
     if (difficulty >=2) {
-        for (int i = 0; i < 9; i++) {
+        for (int i = 0; i < size; i++) {
             if (i != row && json_array_get_number(json_array_get_array(board_array, i), col) == num) {
                 return false;
             }
         }
     }
     
-    // Check 3x3 subgrid
-    if (difficulty == 3) {
-        int startRow = (row / 3) * 3;
-        int startCol = (col / 3) * 3;
-        for (int i = 0; i < 3; i++) {
-            for (int j = 0; j < 3; j++) {
+    // Check the box
+    if (difficulty == 3 && boxSize > 0) {
+        int startRow = (row / boxSize) * boxSize;
+        int startCol = (col / boxSize) * boxSize;
+        for (int i = 0; i < boxSize; i++) {
+            for (int j = 0; j < boxSize; j++) {
                 if (i + startRow != row && j + startCol != col &&
                     json_array_get_number(json_array_get_array(board_array, i + startRow), j + startCol) == num) {
                     return false;
@@ -186,14 +194,24 @@ void playGame(int *socketfd, clientConfig *config) {
     char *board;
     board = showBoard(socketfd, config);
 
+    // no game was started: back to the menu
+    if (board == NULL) {
+        return;
+    }
+
     // get the current line
     char *boardSplit = strtok(board, "\n");
     char *token = strtok(NULL, "\n");
     int currentLine = atoi(token);
 
-    char tempString[BUFFER_SIZE]; // Allocate a temporary buffer
+    char tempString[BOARD_BUFFER_SIZE]; // Allocate a temporary buffer
     strcpy(tempString, boardSplit); // Copy the original board data
 
+    // get the board size
+    JSON_Value *board_value = json_parse_string(tempString);
+    int size = json_array_get_count(json_object_get_array(json_value_get_object(board_value), "board"));
+    json_value_free(board_value);
+
     printf("Linha atual: %d\n", currentLine);
 
     EstatisticasLinha *estatisticas;
@@ -204,28 +222,31 @@ void playGame(int *socketfd, clientConfig *config) {
     estatisticas->tempoResolucao = 0.0;
 
     free(board);
-    writeLogJSON(config->logPath, 0, config->clientID, "Started playing the game");
+    produceClientLog(config, 0, config->clientID, "Started playing the game");
 
     // Enviar linhas inseridas pelo utilizador e receber o board atualizado
-    while (currentLine <= 9) {
+    while (currentLine <= size) {
 
         int validLine = 0;  // Variável para controlar se a linha está correta
 
-        // line to send to server
-        char line[10];
+        // line to send to server (one character per cell)
+        char line[BOARD_MAX_SIZE + 1];
 
-        // inicializa o buffer com '0' e terminador nulo
-        memset(line, '0', sizeof(line));
+        // inicializa o buffer com terminadores nulos
+        memset(line, 0, sizeof(line));
 
         while (!validLine) {
 
             if (config->isManual) {
 
-                printf("Insira valores para a linha %d do board (exactamente 9 digitos):\n", currentLine);
-                scanf("%s", line);
+                printf("Insira valores para a linha %d do board (exactamente %d celulas, 0-9 e A-P para 10-25):\n", currentLine, size);
+                if (scanf("%25s", line) != 1 || verifyLine(line, size) < 0) {
+                    printf("Linha invalida.\n");
+                    continue;
+                }
                 char logMessage[256];
                 snprintf(logMessage, sizeof(logMessage), "Manual input for board line %d", currentLine);
-                writeLogJSON(config->logPath, 0, config->clientID, logMessage);
+                produceClientLog(config, 0, config->clientID, logMessage);
 
             } else {
 
@@ -233,21 +254,21 @@ void playGame(int *socketfd, clientConfig *config) {
                 resolveLine(tempString, line, currentLine - 1, config->difficulty, estatisticas);
                 char logMessage[256];
                 snprintf(logMessage, sizeof(logMessage), "Auto-solving the board line %d", currentLine);
-                writeLogJSON(config->logPath, 0, config->clientID, logMessage);
+                produceClientLog(config, 0, config->clientID, logMessage);
 
             }
 
             // Enviar a linha ao servidor
-            if (send(*socketfd, line, sizeof(line), 0) < 0) {
-                err_dump_client(config->logPath, 0, config->clientID, "can't send lines to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
-                continue;
+            if (send(*socketfd, line, strlen(line) + 1, 0) < 0) {
+                // the connection is gone: showBoard resumes the session and the line is sent again
+                produceClientLog(config, 0, config->clientID, EVENT_MESSAGE_CLIENT_NOT_SENT);
             } else {
                 printf("Linha enviada: %s\n", line);
                 // Incrementa o contador de escritas
                 config->writesCount++;
                 char logMessage[256];
                 snprintf(logMessage, sizeof(logMessage), "Sent line %d to server", currentLine);
-                writeLogJSON(config->logPath, 0, config->clientID, logMessage);
+                produceClientLog(config, 0, config->clientID, logMessage);
             }
 
             char *board;
@@ -265,12 +286,12 @@ void playGame(int *socketfd, clientConfig *config) {
                 currentLine = serverLine;
                 char logMessage[256];
                 snprintf(logMessage, sizeof(logMessage), "Received line %d from server", currentLine);
-                writeLogJSON(config->logPath, 0, config->clientID, logMessage);
+                produceClientLog(config, 0, config->clientID, logMessage);
             } else {
                 printf("Linha %d incorreta. Tente novamente.\n", currentLine);
                 char logMessage[256];
                 snprintf(logMessage, sizeof(logMessage), "Received incorrect line %d from server", currentLine);
-                writeLogJSON(config->logPath, 1, config->clientID, logMessage);
+                produceClientLog(config, 1, config->clientID, logMessage);
             }
 
             // print read and write counts
@@ -282,7 +303,7 @@ void playGame(int *socketfd, clientConfig *config) {
     }
 
     finishGame(socketfd, config, estatisticas);
-    writeLogJSON(config->logPath, 0, config->clientID, "Game finished");
+    produceClientLog(config, 0, config->clientID, "Game finished");
 }
 
 /**
@@ -294,7 +315,7 @@ void playGame(int *socketfd, clientConfig *config) {
  *
  * @details A função faz o seguinte:
  * - Faz o parse da string JSON para obter o objeto `board` e o `gameID`.
- * - Imprime o tabuleiro no formato de uma grelha 9x9 com separadores visuais.
+ * - Imprime o tabuleiro no formato de uma grelha NxN com separadores entre as caixas.
  * - Regista o evento de visualização do tabuleiro no ficheiro de log.
  * - Liberta a memória alocada para o objeto JSON após a operação.
  */
@@ -303,28 +324,49 @@ char *showBoard(int *socketfd, clientConfig *config) {
 
     // buffer for the board
     // Allocate memory for buffer on the heap
-    char *buffer = (char *)malloc(BUFFER_SIZE);
+    char *buffer = (char *)malloc(BOARD_BUFFER_SIZE);
     if (buffer == NULL) {
         perror("Failed to allocate memory");
         return NULL;
     }
-    memset(buffer, 0, BUFFER_SIZE);
+    memset(buffer, 0, BOARD_BUFFER_SIZE);
 
     printf("Received board from server...\n");
 
-    // receive the board from the server
-    if (recv(*socketfd, buffer, BUFFER_SIZE, 0) < 0) {
-        // error receiving board from server
-        err_dump_client(config->logPath, 0, config->clientID, "can't receive board from server", EVENT_MESSAGE_CLIENT_NOT_RECEIVED);
-        free(buffer);
+    // receive the board from the server: "<json>\n<line>\n", in as many segments as it takes
+    int received = 0;
 
-    } else {
+    while (received < BOARD_BUFFER_SIZE - 1) {
+
+        int n = recv(*socketfd, buffer + received, BOARD_BUFFER_SIZE - 1 - received, 0);
 
-        if (strcmp(buffer, "No rooms available") == 0) {
-            printf("No rooms available\n");
+        if (n <= 0 && resumeSession(socketfd, config)) {
+            // the server sends the whole board again on the new connection
+            received = 0;
+            memset(buffer, 0, BOARD_BUFFER_SIZE);
+            continue;
+        }
+
+        if (n <= 0) {
+            // error receiving board from server
+            err_dump_client(config, 0, config->clientID, "can't receive board from server", EVENT_MESSAGE_CLIENT_NOT_RECEIVED);
             free(buffer);
             return NULL;
         }
+
+        received += n;
+        buffer[received] = '\0';
+
+        if (strcmp(buffer, "No rooms available") == 0 || strcmp(buffer, "Game not found") == 0) {
+            printf("%s\n", buffer);
+            free(buffer);
+            return NULL;
+        }
+
+        char *lineStart = strchr(buffer, '\n');
+        if (lineStart != NULL && buffer[received - 1] == '\n' && buffer + received - 1 > lineStart) {
+            break;
+        }
     }
 
     //printf("Board received: %s\n", buffer);
@@ -348,29 +390,31 @@ char *showBoard(int *socketfd, clientConfig *config) {
 
     // get the board array from the JSON object
     JSON_Array *board_array = json_object_get_array(root_object, "board");
+    int size = json_array_get_count(board_array);
+    int boxSize = boardBoxSize(size) > 0 ? boardBoxSize(size) : size;
 
-    for (int i = 0; i < json_array_get_count(board_array); i++) {
+    for (int i = 0; i < size; i++) {
 
         // get the line array from the board array
         JSON_Array *linha_array = json_array_get_array(board_array, i);
 
-        printf("| line %d -> | ", i + 1);
+        printf("| line %2d -> | ", i + 1);
 
-        // print the line array
-        for (int j = 0; j < 9; j++) {
-            printf("%d ", (int)json_array_get_number(linha_array, j));
-            if ((j + 1) % 3 == 0) {
+        // print the line array (10 to 25 as A to P)
+        for (int j = 0; j < size; j++) {
+            printf("%c ", encodeCell((int)json_array_get_number(linha_array, j)));
+            if ((j + 1) % boxSize == 0) {
                 printf("| ");
             }
         }
         printf("\n");
-        if ((i + 1) % 3 == 0) {
+        if ((i + 1) % boxSize == 0) {
             printf("-------------------------------------\n");
         }
     }
 
     // Concatenate board and server line
-    char tempString[BUFFER_SIZE]; // Allocate a temporary buffer
+    char tempString[BOARD_BUFFER_SIZE]; // Allocate a temporary buffer
     strcpy(tempString, board); // Copy the original board data
     strcat(tempString, "\n"); // Concatenate newline
     char serverLineStr[10];
@@ -383,7 +427,7 @@ char *showBoard(int *socketfd, clientConfig *config) {
     // Free the JSON object
     json_value_free(root_value);
 
-    writeLogJSON(config->logPath, gameID, config->clientID, EVENT_BOARD_SHOW);
+    produceClientLog(config, gameID, config->clientID, EVENT_BOARD_SHOW);
 
     // increase the reads count
     config->readsCount++;
@@ -404,7 +448,7 @@ void finishGame(int *socketfd, clientConfig *config, EstatisticasLinha *estatist
     if (send(*socketfd, accuracyString, strlen(accuracyString), 0) < 0) {
 
         // error sending accuracy to server
-        err_dump_client(config->logPath, 0, config->clientID, "can't send accuracy to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
+        err_dump_client(config, 0, config->clientID, "can't send accuracy to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
     } else {
 
         // show the accuracy sent
@@ -412,7 +456,7 @@ void finishGame(int *socketfd, clientConfig *config, EstatisticasLinha *estatist
          // Log accuracy sent
         char logMessage[256];
         snprintf(logMessage, sizeof(logMessage), "%s: sent accuracy: %s", EVENT_MESSAGE_CLIENT_SENT, accuracyString);
-        writeLogJSON(config->logPath, 0, config->clientID, logMessage); // Log de envio de precisão
+        produceClientLog(config, 0, config->clientID, logMessage); // Log de envio de precisão
     }
 
     printf("Tentativas: %d\n", estatisticas->tentativas);
@@ -425,7 +469,7 @@ void finishGame(int *socketfd, clientConfig *config, EstatisticasLinha *estatist
     if (recv(*socketfd, buffer, sizeof(buffer), 0) < 0) {
 
         // error receiving final board from server
-        err_dump_client(config->logPath, 0, config->clientID, "can't receive final board from server", EVENT_MESSAGE_CLIENT_NOT_RECEIVED);
+        err_dump_client(config, 0, config->clientID, "can't receive final board from server", EVENT_MESSAGE_CLIENT_NOT_RECEIVED);
 
     } else {
 
@@ -434,4 +478,365 @@ void finishGame(int *socketfd, clientConfig *config, EstatisticasLinha *estatist
     }
 
     free(estatisticas);
-}
\ No newline at end of file
+}
+// one of the games played at once on the connection
+typedef struct {
+    int roomID;
+    int gameID;
+    int size;
+    int currentLine;
+    bool isOpen;
+    char cells[BOARD_MAX_SIZE * BOARD_MAX_SIZE + 1];
+    EstatisticasLinha estatisticas;
+} MuxGame;
+
+// the board in the JSON format resolveLine reads
+static void muxBoardJSON(MuxGame *game, char *json, int length) {
+
+    int used = snprintf(json, length, "{\"id\":%d,\"size\":%d,\"board\":[", game->gameID, game->size);
+
+    for (int i = 0; i < game->size; i++) {
+        used += snprintf(json + used, length - used, i == 0 ? "[" : ",[");
+        for (int j = 0; j < game->size; j++) {
+            used += snprintf(json + used, length - used, j == 0 ? "%d" : ",%d", decodeCell(game->cells[i * game->size + j]));
+        }
+        used += snprintf(json + used, length - used, "]");
+    }
+
+    snprintf(json + used, length - used, "]}");
+}
+
+static MuxGame *findMuxGame(MuxGame *games, int numGames, int roomID) {
+
+    for (int i = 0; i < numGames; i++) {
+        if (games[i].roomID == roomID) {
+            return &games[i];
+        }
+    }
+
+    return NULL;
+}
+
+// read one reply line, without the newline (false if the connection was closed)
+static bool readMuxReply(LineReader *reader, clientConfig *config, char *reply, int length) {
+
+    if (readBufferedLine(reader, reply, length) <= 0) {
+        err_dump_client(config, 0, config->clientID, "can't receive reply from server", EVENT_MESSAGE_CLIENT_NOT_RECEIVED);
+        return false;
+    }
+
+    reply[strcspn(reply, "\n")] = '\0';
+    return true;
+}
+
+static bool sendMuxRequests(int *socketfd, clientConfig *config, char *requests, int length) {
+
+    if (writen(*socketfd, requests, length) < 0) {
+        err_dump_client(config, 0, config->clientID, "can't send requests to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
+        return false;
+    }
+
+    config->writesCount++;
+    return true;
+}
+
+// open the games and play them round after round (false if the connection was lost)
+static bool playMuxGames(int *socketfd, clientConfig *config, LineReader *reader, MuxGame *games, int numGames, char *reply, char *requests) {
+
+    // ask for every game at once
+    int used = 0;
+    for (int i = 0; i < numGames; i++) {
+        used += snprintf(requests + used, BOARD_BUFFER_SIZE - used, "NEW\n");
+    }
+    if (!sendMuxRequests(socketfd, config, requests, used)) {
+        return false;
+    }
+
+    int numOpen = 0;
+    for (int i = 0; i < numGames; i++) {
+
+        if (!readMuxReply(reader, config, reply, BOARD_BUFFER_SIZE)) {
+            return false;
+        }
+
+        MuxGame *game = &games[numOpen];
+        if (sscanf(reply, "GAME %d %d %d %d %625s", &game->roomID, &game->gameID, &game->size, &game->currentLine, game->cells) == 5) {
+            game->isOpen = true;
+            numOpen++;
+            printf("Jogo %d na sala %d (%dx%d)\n", game->gameID, game->roomID, game->size, game->size);
+        } else {
+            printf("%s\n", reply);
+        }
+    }
+
+    produceClientLog(config, 0, config->clientID, "Started playing several games at once");
+
+    char json[BOARD_BUFFER_SIZE];
+
+    while (numOpen > 0) {
+
+        // one request per open game: its next line, or the accuracy once it is solved
+        int numRequests = 0;
+        used = 0;
+
+        for (int i = 0; i < numGames; i++) {
+
+            MuxGame *game = &games[i];
+            if (!game->isOpen) {
+                continue;
+            }
+
+            if (game->currentLine > game->size) {
+                used += snprintf(requests + used, BOARD_BUFFER_SIZE - used, "FINISH %d %.2f\n",
+                                 game->roomID, game->estatisticas.percentagemAcerto);
+            } else {
+                char line[BOARD_MAX_SIZE + 1];
+                muxBoardJSON(game, json, sizeof(json));
+                resolveLine(json, line, game->currentLine - 1, config->difficulty, &game->estatisticas);
+                used += snprintf(requests + used, BOARD_BUFFER_SIZE - used, "LINE %d %s\n", game->roomID, line);
+            }
+
+            numRequests++;
+        }
+
+        if (!sendMuxRequests(socketfd, config, requests, used)) {
+            return false;
+        }
+
+        // the replies come in the order of the requests
+        for (int i = 0; i < numRequests; i++) {
+
+            if (!readMuxReply(reader, config, reply, BOARD_BUFFER_SIZE)) {
+                return false;
+            }
+            config->readsCount++;
+
+            int roomID = 0;
+            sscanf(reply, "%*s %d", &roomID);
+            MuxGame *game = findMuxGame(games, numGames, roomID);
+
+            if (game == NULL || !game->isOpen) {
+                printf("%s\n", reply);
+                continue;
+            }
+
+            if (strncmp(reply, "BOARD ", 6) == 0) {
+
+                int serverLine = game->currentLine;
+                sscanf(reply, "BOARD %*d %d %625s", &serverLine, game->cells);
+                if (serverLine > game->currentLine) {
+                    printf("Sala %d: linha %d certa\n", game->roomID, game->currentLine);
+                }
+                game->currentLine = serverLine;
+
+            } else if (strncmp(reply, "DONE ", 5) == 0) {
+
+                double elapsedTime = 0;
+                sscanf(reply, "DONE %*d %lf", &elapsedTime);
+                printf("O jogo %d na sala %d terminou! Tempo total: %.2f segundos, accuracy %.2f%%\n",
+                       game->gameID, game->roomID, elapsedTime, game->estatisticas.percentagemAcerto);
+                game->isOpen = false;
+                numOpen--;
+
+                char logMessage[256];
+                snprintf(logMessage, sizeof(logMessage), "Game %d finished in room %d", game->gameID, game->roomID);
+                produceClientLog(config, game->gameID, config->clientID, logMessage);
+
+            } else {
+
+                // the server gave up on this game
+                printf("%s\n", reply);
+                game->isOpen = false;
+                numOpen--;
+            }
+        }
+    }
+
+    printf("Number of Reads: %d\n", config->readsCount);
+    printf("Number of Writes: %d\n", config->writesCount);
+
+    return true;
+}
+
+/**
+ * Joga vários jogos single player aleatórios ao mesmo tempo, todos na mesma ligação.
+ *
+ * @param socketfd Um pointer para o descritor de socket usado para a comunicação com o servidor.
+ * @param config A estrutura `clientConfig` que contém as configurações do cliente.
+ * @param numGames O número de jogos pedido (limitado ao máximo indicado pelo servidor).
+ *
+ * @details A função faz o seguinte:
+ * - Envia "MUX" e espera por "MUX OK <máximo>", passando a trocar linhas de texto com o servidor.
+ * - Pede todos os jogos de uma vez ("NEW" por jogo) e lê as respostas "GAME".
+ * - Em cada ronda resolve a linha atual de cada jogo por acabar e envia as linhas de todos os
+ *   jogos juntas ("LINE <sala> <linha>"), lendo depois uma resposta "BOARD" por jogo.
+ * - Quando um jogo fica resolvido envia "FINISH <sala> <accuracy>" e mostra o tempo recebido.
+ * - Termina com "END" e espera por "BYE", voltando o servidor ao menu.
+ *
+ * @note As linhas são sempre resolvidas automaticamente, mesmo com o modo manual ativo.
+ */
+
+void playMultiplexedGames(int *socketfd, clientConfig *config, int numGames) {
+
+    char *reply = (char *)malloc(BOARD_BUFFER_SIZE);
+    char *requests = (char *)malloc(BOARD_BUFFER_SIZE);
+    LineReader *reader = (LineReader *)malloc(sizeof(LineReader));
+    MuxGame *games = NULL;
+
+    if (reply == NULL || requests == NULL || reader == NULL) {
+        perror("Failed to allocate memory");
+        free(reply);
+        free(requests);
+        free(reader);
+        return;
+    }
+
+    config->readsCount = 0;
+    config->writesCount = 0;
+    initLineReader(reader, *socketfd);
+
+    int maxGames = 0;
+    bool isConnected = true;
+
+    strcpy(requests, "MUX");
+    if (send(*socketfd, requests, strlen(requests), 0) < 0) {
+        err_dump_client(config, 0, config->clientID, "can't send request to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
+        isConnected = false;
+    } else if (!readMuxReply(reader, config, reply, BOARD_BUFFER_SIZE) || sscanf(reply, "MUX OK %d", &maxGames) != 1) {
+        printf("O servidor nao aceitou jogos simultaneos\n");
+        isConnected = false;
+    }
+
+    if (isConnected) {
+
+        if (numGames > maxGames) {
+            numGames = maxGames;
+        }
+
+        games = (MuxGame *)calloc(numGames, sizeof(MuxGame));
+        if (games == NULL) {
+            perror("Failed to allocate memory");
+            isConnected = false;
+        } else {
+            isConnected = playMuxGames(socketfd, config, reader, games, numGames, reply, requests);
+        }
+    }
+
+    // back to the menu (the server also ends the session when a game request fails)
+    if (isConnected) {
+        strcpy(requests, "END\n");
+        if (sendMuxRequests(socketfd, config, requests, strlen(requests))) {
+            do {
+                if (!readMuxReply(reader, config, reply, BOARD_BUFFER_SIZE)) {
+                    break;
+                }
+            } while (strcmp(reply, "BYE") != 0);
+        }
+    }
+
+    free(games);
+    free(reply);
+    free(requests);
+    free(reader);
+}
+
+// print a "BOARD <room> <game> <size> <currentLine> <cells>" update
+static void showSpectatedBoard(const char *reply) {
+
+    int roomID = 0, gameID = 0, size = 0, currentLine = 0;
+    char cells[BOARD_MAX_SIZE * BOARD_MAX_SIZE + 1];
+
+    if (sscanf(reply, "BOARD %d %d %d %d %625s", &roomID, &gameID, &size, &currentLine, cells) != 5 ||
+        size < 1 || size > BOARD_MAX_SIZE || strlen(cells) != (size_t)(size * size)) {
+        printf("%s\n", reply);
+        return;
+    }
+
+    int boxSize = boardBoxSize(size) > 0 ? boardBoxSize(size) : size;
+
+    printf("-------------------------------------\n");
+    printf("ROOM %d  BOARD ID: %d  LINE: %d/%d (SPECTATING)\n", roomID, gameID, currentLine > size ? size : currentLine, size);
+    printf("-------------------------------------\n");
+
+    for (int i = 0; i < size; i++) {
+        printf("| line %2d -> | ", i + 1);
+        for (int j = 0; j < size; j++) {
+            printf("%c ", cells[i * size + j]);
+            if ((j + 1) % boxSize == 0) {
+                printf("| ");
+            }
+        }
+        printf("\n");
+        if ((i + 1) % boxSize == 0) {
+            printf("-------------------------------------\n");
+        }
+    }
+}
+
+/**
+ * Acompanha uma sala como espectador, sem ocupar um lugar de jogador.
+ *
+ * @param socketfd Um pointer para o descritor de socket usado para a comunicação com o servidor.
+ * @param config A estrutura `clientConfig` que contém as configurações do cliente.
+ * @param roomID O identificador da sala a acompanhar.
+ *
+ * @details A função faz o seguinte:
+ * - Envia "spectateRoom <sala>" e espera por "SPECTATING <sala>" (ou "ERROR" se a sala não existir).
+ * - Mostra cada tabuleiro "BOARD" recebido. Se o cliente for lento, o servidor salta os estados
+ *   intermédios, pelo que podem aparecer várias linhas resolvidas de uma vez.
+ * - Quando recebe "OVER" envia "stopSpectating" e lê até "STOPPED", voltando ao menu.
+ */
+
+void watchRoom(int *socketfd, clientConfig *config, int roomID) {
+
+    char *reply = (char *)malloc(BOARD_BUFFER_SIZE);
+    LineReader *reader = (LineReader *)malloc(sizeof(LineReader));
+    if (reply == NULL || reader == NULL) {
+        perror("Failed to allocate memory");
+        free(reply);
+        free(reader);
+        return;
+    }
+
+    initLineReader(reader, *socketfd);
+
+    snprintf(reply, BOARD_BUFFER_SIZE, "spectateRoom %d", roomID);
+    if (send(*socketfd, reply, strlen(reply), 0) < 0) {
+        err_dump_client(config, 0, config->clientID, "can't send spectate request to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
+        free(reply);
+        free(reader);
+        return;
+    }
+
+    bool isWatching = readMuxReply(reader, config, reply, BOARD_BUFFER_SIZE);
+    if (isWatching && strncmp(reply, "SPECTATING", strlen("SPECTATING")) != 0) {
+        printf("%s\n", reply);
+        isWatching = false;
+    }
+
+    if (isWatching) {
+        char logMessage[256];
+        snprintf(logMessage, sizeof(logMessage), "Watching room %d", roomID);
+        produceClientLog(config, 0, config->clientID, logMessage);
+    }
+
+    bool isStopping = false;
+
+    while (isWatching && readMuxReply(reader, config, reply, BOARD_BUFFER_SIZE)) {
+
+        if (strncmp(reply, "BOARD ", 6) == 0) {
+            showSpectatedBoard(reply);
+        } else if (strncmp(reply, "OVER", 4) == 0 && !isStopping) {
+            printf("O jogo na sala %d terminou\n", roomID);
+            isStopping = true;
+            if (send(*socketfd, "stopSpectating", strlen("stopSpectating"), 0) < 0) {
+                err_dump_client(config, 0, config->clientID, "can't send stop request to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
+            }
+        } else if (strcmp(reply, "STOPPED") == 0) {
+            isWatching = false;
+        }
+    }
+
+    free(reply);
+    free(reader);
+}
@@ -2,8 +2,12 @@
 #define CLIENT_GAME_H
 
 #include <stdbool.h>
+#include "../../utils/parson/parson.h"
 #include "client-menus.h"
 
+// Tamanho do buffer de um tabuleiro recebido do servidor (um 25x25 em JSON não cabe em BUFFER_SIZE).
+#define BOARD_BUFFER_SIZE 4096
+
 // Estrutura para armazenar estatísticas da resolução de uma linha
 typedef struct {
     double tempoResolucao;
@@ -13,7 +17,7 @@ typedef struct {
 } EstatisticasLinha;
 
 // Função para verificar a linha no buffer
-int verifyLine(char *buffer);
+int verifyLine(char *buffer, int size);
 
 // Função para resolver uma linha
 void resolveLine(char *buffer, char *line, int row, int difficulty, EstatisticasLinha *estatisticas);
@@ -27,6 +31,12 @@ void playGame(int *socketfd, clientConfig *config);
 // Exibe o tabuleiro de jogo recebido do servidor.
 char *showBoard(int *socketfd, clientConfig *config);
 
+// Joga vários jogos single player aleatórios ao mesmo tempo na mesma ligação.
+void playMultiplexedGames(int *socketfd, clientConfig *config, int numGames);
+
+// Acompanha uma sala como espectador até o jogo terminar.
+void watchRoom(int *socketfd, clientConfig *config, int roomID);
+
 // Acaba o jogo
 void finishGame(int *socketfd, clientConfig *config, EstatisticasLinha *estatisticas);
 
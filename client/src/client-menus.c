@@ -3,6 +3,7 @@
 #include "../../utils/logs/logs-common.h"
 #include "../logs/logs.h"
 #include "client-menus.h"
+#include "client-game.h"
 
 /*
  * Exibe o menu principal do cliente e processa as opções selecionadas pelo utilizador.
@@ -64,9 +65,10 @@ void showMenu(int *socketfd, clientConfig *config) {
  * - Processa a opção escolhida:
  *   - Opção 1: Chama a função `showSinglePlayerMenu` para mostrar o menu de jogo single player.
  *   - Opção 2: Chama a função `showMultiPlayerMenu` para mostrar o menu de jogo multiplayer.
- *   - Opção 3: Retorna ao menu principal chamando `showMenu`.
- *   - Opção 4: Fecha a conexão com o servidor e termina o programa.
- * - Repete o loop até que o utilizador escolha uma opção válida (1 a 4).
+ *   - Opção 3: Joga vários jogos single player ao mesmo tempo com `playMultiplexedGames`.
+ *   - Opção 4: Retorna ao menu principal chamando `showMenu`.
+ *   - Opção 5: Fecha a conexão com o servidor e termina o programa.
+ * - Repete o loop até que o utilizador escolha uma opção válida (1 a 5).
  */
 
 void showPlayMenu(int *socketfd, clientConfig *config) {
@@ -92,17 +94,30 @@ void showPlayMenu(int *socketfd, clientConfig *config) {
             case 2:
                 showMultiPlayerMenu(socketfd, config);
                 break;
-            case 3:
+            case 3: {
+                // several random single player games on this connection
+                int numGames = 0;
+                printf(INTERFACE_SELECT_NUM_GAMES);
+                if (scanf("%d", &numGames) != 1 || numGames < 1) {
+                    printf("Invalid number of games\n");
+                    option = 0;
+                    break;
+                }
+                playMultiplexedGames(socketfd, config, numGames);
                 showMenu(socketfd, config);
                 break;
+            }
             case 4:
+                showMenu(socketfd, config);
+                break;
+            case 5:
                 closeConnection(socketfd, config);
                 break;
             default:
                 printf("Invalid option\n");
                 break;
         }
-    } while (option < 1 || option > 4);
+    } while (option < 1 || option > 5);
 }
 
 
@@ -118,9 +133,10 @@ void showPlayMenu(int *socketfd, clientConfig *config) {
  * - Processa a opção escolhida:
  *   - Opção 1: Chama a função `playRandomSinglePlayerGame` para jogar um jogo aleatório.
  *   - Opção 2: Chama a função `showGames` para mostrar os jogos disponíveis.
- *   - Opção 3: Retorna ao menu de jogo chamando `showPlayMenu`.
- *   - Opção 4: Fecha a conexão com o servidor e termina o programa.
- * - Repete o loop até que o utilizador escolha uma opção válida (1 a 4).
+ *   - Opção 3: Pede uma dificuldade (1 a 5) e joga um jogo aleatório dessa dificuldade.
+ *   - Opção 4: Retorna ao menu de jogo chamando `showPlayMenu`.
+ *   - Opção 5: Fecha a conexão com o servidor e termina o programa.
+ * - Repete o loop até que o utilizador escolha uma opção válida (1 a 5).
  */
 
 void showSinglePLayerMenu(int *socketfd, clientConfig *config) {
@@ -142,23 +158,35 @@ void showSinglePLayerMenu(int *socketfd, clientConfig *config) {
         switch (option) {
             case 1:
                 // choose a random game
-                playSinglePlayerGame(socketfd, config);
+                playSinglePlayerGame(socketfd, config, 0);
                 break;
             case 2:
                 // choose a specific single player game
                 showGames(socketfd, config, true);
                 break;
-            case 3:
-                showPlayMenu(socketfd, config);
+            case 3: {
+                // choose a random game of a given difficulty
+                int difficulty = 0;
+                printf(INTERFACE_SELECT_DIFFICULTY);
+                if (scanf("%d", &difficulty) != 1 || difficulty < 1 || difficulty > 5) {
+                    printf("Invalid difficulty\n");
+                    option = 0;
+                    break;
+                }
+                playSinglePlayerGame(socketfd, config, difficulty);
                 break;
+            }
             case 4:
+                showPlayMenu(socketfd, config);
+                break;
+            case 5:
                 closeConnection(socketfd, config);
                 break;
             default:
                 printf("Invalid option\n");
                 break;
         }
-    } while (option < 1 || option > 4);
+    } while (option < 1 || option > 5);
 }
 
 
@@ -180,23 +208,39 @@ void showStatisticsMenu(int *socketfd, clientConfig *client) {
     const char *request = "GET_STATS";
     if (send(*socketfd, request, strlen(request), 0) < 0) {
         // erro ao enviar pedido de estatísticas
-        err_dump_client(client->logPath, 0, client->clientID, "can't send statistics request to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
+        err_dump_client(client, 0, client->clientID, "can't send statistics request to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
     } else {
         printf("Pedido de estatísticas enviado ao servidor\n");
         char logMessage[256];
         sprintf(logMessage, "%s: Pedido de estatísticas enviado ao servidor", EVENT_MESSAGE_CLIENT_SENT);
-        writeLogJSON(client->logPath, 0, client->clientID, logMessage);
+        produceClientLog(client, 0, client->clientID, logMessage);
     }
 
     // Recebe e exibe as estatísticas do servidor
-    char buffer[1024];
-    memset(buffer, 0, sizeof(buffer));
+    int offset, count, total;
+    printf("Estatísticas do servidor:\n");
+    receiveListing(socketfd, client, &offset, &count, &total);
+
+    // ask for a game to show detailed statistics and its leaderboard
+    int gameID;
+    printf(INTERFACE_STATISTICS_MENU);
+    if (scanf("%d", &gameID) != 1) {
+        printf("Invalid input. Please enter a number.\n");
+        fflush(stdin); // Clear the input buffer
+        return;
+    }
 
-    if (recv(*socketfd, buffer, sizeof(buffer), 0) < 0) {
-        // erro ao receber estatísticas
-        err_dump_client(client->logPath, 0, client->clientID, "can't receive statistics from server", EVENT_MESSAGE_CLIENT_NOT_RECEIVED);
-    } else {
-        printf("Estatísticas do servidor:\n%s\n", buffer);
+    if (gameID > 0) {
+        char gameRequest[32];
+        snprintf(gameRequest, sizeof(gameRequest), "GET_STATS %d", gameID);
+        requestListing(socketfd, client, gameRequest, &offset, &count, &total);
+
+        printf("Leaderboard:\n");
+        snprintf(gameRequest, sizeof(gameRequest), "GET_LEADERBOARD %d", gameID);
+        requestListing(socketfd, client, gameRequest, &offset, &count, &total);
+    } else if (gameID == -1) {
+        printf("My best results:\n");
+        requestListing(socketfd, client, "GET_PLAYER_BESTS", &offset, &count, &total);
     }
 }
 
@@ -224,9 +268,10 @@ void showStatisticsMenu(int *socketfd, clientConfig *client) {
  * - Processa a opção escolhida:
  *   - Opção 1: Chama a função `createNewMultiplayerGame` para criar um novo jogo multiplayer.
  *   - Opção 2: Chama a função `showMultiplayerRooms` para mostrar as salas de jogo disponíveis.
- *   - Opção 3: Retorna ao menu de jogo chamando `showPlayMenu`.
- *   - Opção 4: Fecha a conexão com o servidor e termina o programa.
- * - Repete o loop até que o utilizador escolha uma opção válida (1 a 4).
+ *   - Opção 3: Pede o ID de uma sala e acompanha-a como espectador com `watchRoom`.
+ *   - Opção 4: Retorna ao menu de jogo chamando `showPlayMenu`.
+ *   - Opção 5: Fecha a conexão com o servidor e termina o programa.
+ * - Repete o loop até que o utilizador escolha uma opção válida (1 a 5).
  */
 
 void showMultiPlayerMenu(int *socketfd, clientConfig *config) {
@@ -254,17 +299,30 @@ void showMultiPlayerMenu(int *socketfd, clientConfig *config) {
                 // join a room
                 showMultiplayerRooms(socketfd, config);
                 break;
-            case 3:
-                showPlayMenu(socketfd, config);
+            case 3: {
+                // watch a room without taking a seat
+                int roomID = 0;
+                printf(INTERFACE_SELECT_ROOM_TO_WATCH);
+                if (scanf("%d", &roomID) != 1 || roomID < 1) {
+                    printf("Invalid room ID\n");
+                    option = 0;
+                    break;
+                }
+                watchRoom(socketfd, config, roomID);
+                showMenu(socketfd, config);
                 break;
+            }
             case 4:
+                showPlayMenu(socketfd, config);
+                break;
+            case 5:
                 closeConnection(socketfd, config);
                 break;
             default:
                 printf("Invalid option\n");
                 break;
         }
-    } while (option < 1 || option > 4);
+    } while (option < 1 || option > 5);
 }
 
 void createNewMultiplayerGame(int *socketfd, clientConfig *config) {
@@ -344,39 +402,39 @@ void showPossibleSynchronizations(int *socketfd, clientConfig *config) {
             case 1:
                 // create a new random multiplayer game with readers-writers synchronization
                 playMultiPlayerGame(socketfd, config, "readersWriters");
-                writeLogJSON(config->logPath, 0, config->clientID, "Started multiplayer game with readers-writers synchronization");
+                produceClientLog(config, 0, config->clientID, "Started multiplayer game with readers-writers synchronization");
 
                 break;
             case 2:
                 // create a new random multiplayer game with barber shop synchronization with priority queues
                 playMultiPlayerGame(socketfd, config, "barberShopStaticPriority");
-                writeLogJSON(config->logPath, 0, config->clientID, "Started multiplayer game with barberShopStaticPriority synchronization");
+                produceClientLog(config, 0, config->clientID, "Started multiplayer game with barberShopStaticPriority synchronization");
                 break;
             case 3:
                 // create a new random multiplayer game with barber shop synchronization with dynamic priority queues
                 playMultiPlayerGame(socketfd, config, "barberShopDynamicPriority");
-                writeLogJSON(config->logPath, 0, config->clientID, "Started multiplayer game with barberShopDynamicPriority synchronization");
+                produceClientLog(config, 0, config->clientID, "Started multiplayer game with barberShopDynamicPriority synchronization");
                 break;
             case 4:
                 // create a new random multiplayer game with barber shop synchronization with a FIFO queue
                 playMultiPlayerGame(socketfd, config, "barberShopFIFO");
-                writeLogJSON(config->logPath, 0, config->clientID, "Started multiplayer game with barberShopFIFO synchronization");
+                produceClientLog(config, 0, config->clientID, "Started multiplayer game with barberShopFIFO synchronization");
                 
                 break;
             case 5:
 
                 // send 0 to the server
                 if (send(*socketfd, "0", strlen("0"), 0) < 0) {
-                    err_dump_client(config->logPath, 0, config->clientID, "can't send return to menu to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
+                    err_dump_client(config, 0, config->clientID, "can't send return to menu to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
                 } else {
                     char logMessage[256];
                     snprintf(logMessage, sizeof(logMessage), "%s: sent 0 to return to multiplayer menu", EVENT_MESSAGE_CLIENT_SENT);
-                    writeLogJSON(config->logPath, 0, config->clientID, logMessage);
+                    produceClientLog(config, 0, config->clientID, logMessage);
                 }
 
                 // back to the multiplayer menu
                 createNewMultiplayerGame(socketfd, config);
-                writeLogJSON(config->logPath, 0, config->clientID, "Returned to multiplayer menu");
+                produceClientLog(config, 0, config->clientID, "Returned to multiplayer menu");
                 break;
             case 6:
                 // close the connection
@@ -390,6 +448,99 @@ void showPossibleSynchronizations(int *socketfd, clientConfig *config) {
 
 }
 
+/**
+ * Recebe uma página de uma listagem (jogos ou salas) enviada pelo servidor e exibe-a.
+ *
+ * @param socketfd Um pointer para o descritor de socket usado para a comunicação com o servidor.
+ * @param config A estrutura `clientConfig` que contém as configurações do cliente.
+ * @param offset Recebe a posição da primeira entrada da página.
+ * @param count Recebe o número de entradas na página.
+ * @param total Recebe o número total de entradas que passam os filtros.
+ *
+ * @details A listagem pode chegar em vários blocos. As linhas incompletas são guardadas
+ * até ao bloco seguinte, e a página termina com a linha "END <offset> <count> <total>".
+ */
+
+void receiveListing(int *socketfd, clientConfig *config, int *offset, int *count, int *total) {
+
+    char buffer[BUFFER_SIZE];
+    char line[BUFFER_SIZE];
+    int lineLength = 0;
+
+    for (;;) {
+
+        int received = recv(*socketfd, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            err_dump_client(config, 0, config->clientID, "can't receive listing from server", EVENT_MESSAGE_CLIENT_NOT_RECEIVED);
+        }
+
+        for (int i = 0; i < received; i++) {
+
+            // keep partial lines until the next chunk
+            if (buffer[i] != '\n') {
+                if (lineLength < (int)sizeof(line) - 1) {
+                    line[lineLength++] = buffer[i];
+                }
+                continue;
+            }
+
+            line[lineLength] = '\0';
+            lineLength = 0;
+
+            if (strncmp(line, "END ", strlen("END ")) == 0) {
+                sscanf(line, "END %d %d %d", offset, count, total);
+                return;
+            }
+
+            printf("%s\n", line);
+        }
+    }
+}
+
+/**
+ * Pede ao servidor outra página de uma listagem e exibe-a.
+ *
+ * @param socketfd Um pointer para o descritor de socket usado para a comunicação com o servidor.
+ * @param config A estrutura `clientConfig` que contém as configurações do cliente.
+ * @param request O pedido "LIST <offset> <limit> <filtros>" a enviar.
+ * @param offset Recebe a posição da primeira entrada da página.
+ * @param count Recebe o número de entradas na página.
+ * @param total Recebe o número total de entradas que passam os filtros.
+ */
+
+void requestListing(int *socketfd, clientConfig *config, char *request, int *offset, int *count, int *total) {
+
+    if (send(*socketfd, request, strlen(request), 0) < 0) {
+        err_dump_client(config, 0, config->clientID, "can't send listing request to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
+    }
+
+    receiveListing(socketfd, config, offset, count, total);
+}
+
+/**
+ * Calcula o offset da página seguinte (-1) ou anterior (-2) de uma listagem.
+ *
+ * @return O novo offset, ou -1 se não houver página nessa direção.
+ */
+
+int nextListingOffset(int option, int offset, int count, int total) {
+
+    if (option == -1) {
+        if (offset + count >= total) {
+            printf("Already at the last page\n");
+            return -1;
+        }
+        return offset + LISTING_PAGE_SIZE;
+    }
+
+    if (offset == 0) {
+        printf("Already at the first page\n");
+        return -1;
+    }
+
+    return offset - LISTING_PAGE_SIZE < 0 ? 0 : offset - LISTING_PAGE_SIZE;
+}
+
 /**
  * Solicita ao servidor a lista de salas multiplayer existentes e permite ao utilizador 
  * escolher uma sala ou voltar atrás.
@@ -401,7 +552,9 @@ void showPossibleSynchronizations(int *socketfd, clientConfig *config) {
  * @details A função faz o seguinte:
  * - Envia um pedido ao servidor para obter a lista de salas multiplayer disponíveis.
  * - Se o pedido falhar, regista o erro no log e termina.
- * - Se o pedido for bem-sucedido, recebe a lista de salas do servidor e exibe-a.
+ * - Se o pedido for bem-sucedido, recebe a primeira página de salas do servidor e exibe-a.
+ * - Permite ao utilizador mudar de página (-1/-2) ou filtrar por sincronização e lugares livres (-3),
+ *   pedindo a nova página ao servidor com "LIST <offset> <limit> <sincronização> <lugares>".
  * - Permite ao utilizador escolher uma sala pelo ID ou voltar ao menu anterior:
  *   - Se o utilizador escolher 0, envia o pedido de retorno ao servidor e exibe o menu multiplayer.
  *   - Se for escolhido um ID de sala, envia o ID ao servidor e aguarda o tabuleiro da sala.
@@ -411,70 +564,98 @@ void showPossibleSynchronizations(int *socketfd, clientConfig *config) {
 void showMultiplayerRooms(int *socketfd, clientConfig *config) {
     // ask server for existing rooms
     if (send(*socketfd, "existingRooms", strlen("existingRooms"), 0) < 0) {
-        err_dump_client(config->logPath, 0, config->clientID, "can't send existing rooms request to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
+        err_dump_client(config, 0, config->clientID, "can't send existing rooms request to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
         
     } else {
         printf("Requesting existing multiplayer rooms...\n");
-        writeLogJSON(config->logPath, 0, config->clientID, "Sent existing rooms request to server");
+        produceClientLog(config, 0, config->clientID, "Sent existing rooms request to server");
 
-        // receive the rooms from the server
-        char buffer[BUFFER_SIZE];
-        memset(buffer, 0, sizeof(buffer));
+        int offset = 0, count = 0, total = 0;
+        int synchronizationType = -1, minOpenSlots = 0;
 
-        if (recv(*socketfd, buffer, sizeof(buffer), 0) < 0) {
+        // receive the first page of rooms from the server
+        printf("Existing rooms:\n");
+        receiveListing(socketfd, config, &offset, &count, &total);
+        produceClientLog(config, 0, config->clientID, "Received existing rooms from server");
 
-            // error receiving rooms from server
-            err_dump_client(config->logPath, 0, config->clientID, "can't receive rooms from server", EVENT_MESSAGE_CLIENT_NOT_RECEIVED);
-        
-        } else {
+        int roomID;
 
-            // show the rooms
-            printf("Existing rooms:\n%s\n", buffer);
-            printf("0 - Back\n");
-            writeLogJSON(config->logPath, 0, config->clientID, "Received existing rooms from server");
+        for (;;) {
 
-            // ask for the game ID
-            int roomID;
-            printf("Choose an option: ");
+            // show the paging options
+            printf("Showing %d-%d of %d rooms\n", count > 0 ? offset + 1 : 0, offset + count, total);
+            printf(INTERFACE_LISTING_ROOMS);
 
-            // Get the game ID from the user
+            // Get the room ID from the user
             if (scanf("%d", &roomID) != 1) {
                 printf("Invalid input. Please enter a number.\n");
                 fflush(stdin); // Clear the input buffer
                 return;
             }
 
-            if (roomID == 0) {
+            if (roomID >= 0) {
+                break;
+            }
+
+            int newOffset = offset;
 
-                // send 0 to the server
-                if (send(*socketfd, "0", strlen("0"), 0) < 0) {
-                    err_dump_client(config->logPath, 0, config->clientID, "can't send return to menu to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
-                } else {
-                    char logMessage[256];
-                    snprintf(logMessage, sizeof(logMessage), "%s: sent 0 to return to multiplayer menu", EVENT_MESSAGE_CLIENT_SENT);
-                    writeLogJSON(config->logPath, 0, config->clientID, logMessage);
+            if (roomID == -3) {
+                // ask for the filters
+                printf("Synchronization (-1 any, 0 Readers-Writers, 1 static priority, 2 dynamic priority, 3 FIFO): ");
+                if (scanf("%d", &synchronizationType) != 1) {
+                    synchronizationType = -1;
+                }
+                printf("Minimum open slots: ");
+                if (scanf("%d", &minOpenSlots) != 1) {
+                    minOpenSlots = 0;
+                }
+                newOffset = 0;
+            } else if (roomID == -1 || roomID == -2) {
+                newOffset = nextListingOffset(roomID, offset, count, total);
+                if (newOffset < 0) {
+                    continue;
                 }
+            } else {
+                printf("Invalid option\n");
+                continue;
+            }
 
-                // show the multiplayer menu
-                showMultiPlayerMenu(socketfd, config);
+            // ask the server for the page
+            char request[64];
+            snprintf(request, sizeof(request), "LIST %d %d %d %d", newOffset, LISTING_PAGE_SIZE, synchronizationType, minOpenSlots);
+            requestListing(socketfd, config, request, &offset, &count, &total);
+        }
 
+        if (roomID == 0) {
 
+            // send 0 to the server
+            if (send(*socketfd, "0", strlen("0"), 0) < 0) {
+                err_dump_client(config, 0, config->clientID, "can't send return to menu to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
             } else {
+                char logMessage[256];
+                snprintf(logMessage, sizeof(logMessage), "%s: sent 0 to return to multiplayer menu", EVENT_MESSAGE_CLIENT_SENT);
+                produceClientLog(config, 0, config->clientID, logMessage);
+            }
 
-                // send the room ID to the server
-                char roomIDString[10];
-                sprintf(roomIDString, "%d", roomID);
+            // show the multiplayer menu
+            showMultiPlayerMenu(socketfd, config);
 
-                if (send(*socketfd, roomIDString, strlen(roomIDString), 0) < 0) {
-                    err_dump_client(config->logPath, 0, config->clientID, "can't send room ID to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
-                } else {
-                    printf("Requesting room with ID %s...\n", roomIDString);
-                }
-                    
-                //printf("NOW RECEIVING TIMER\n");
-                // receive timer from server
-                receiveTimer(socketfd, config);
+
+        } else {
+
+            // send the room ID to the server
+            char roomIDString[10];
+            sprintf(roomIDString, "%d", roomID);
+
+            if (send(*socketfd, roomIDString, strlen(roomIDString), 0) < 0) {
+                err_dump_client(config, 0, config->clientID, "can't send room ID to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
+            } else {
+                printf("Requesting room with ID %s...\n", roomIDString);
             }
+                
+            //printf("NOW RECEIVING TIMER\n");
+            // receive timer from server
+            receiveTimer(socketfd, config);
         }
     }
 }
@@ -493,7 +674,9 @@ void showMultiplayerRooms(int *socketfd, clientConfig *config) {
  * - Envia um pedido ao servidor para obter a lista de jogos disponíveis, 
  * com base no tipo de jogo (single player ou multiplayer).
  * - Se o pedido falhar, regista o erro no log e termina.
- * - Se o pedido for bem-sucedido, recebe e exibe a lista de jogos.
+ * - Se o pedido for bem-sucedido, recebe e exibe a primeira página de jogos.
+ * - Permite ao utilizador mudar de página (-1/-2) ou filtrar por dificuldade (-3),
+ *   pedindo a nova página ao servidor com "LIST <offset> <limit> <dificuldade>".
  * - Permite ao utilizador escolher um jogo pelo ID ou voltar ao menu anterior:
  *   - Se o utilizador escolher 0, envia a escolha ao servidor e exibe o menu apropriado (single player ou multiplayer).
  *   - Se for escolhido um ID de jogo, envia o ID ao servidor, recebe o tabuleiro e chama `showBoard` para o exibir.
@@ -511,29 +694,26 @@ void showGames(int *socketfd, clientConfig *config, bool isSinglePlayer) {
 
     // ask server for existing games
     if (send(*socketfd, message, strlen(message), 0) < 0) {
-        err_dump_client(config->logPath, 0, config->clientID, "can't send existing games request to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
+        err_dump_client(config, 0, config->clientID, "can't send existing games request to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
     } else {
-        writeLogJSON(config->logPath, 0, config->clientID, "Requested existing games from server");
+        produceClientLog(config, 0, config->clientID, "Requested existing games from server");
         printf("Requesting existing games...\n");
 
-        // receive the games from the server
-        char buffer[BUFFER_SIZE];
-        memset(buffer, 0, sizeof(buffer));
+        int offset = 0, count = 0, total = 0;
+        int difficulty = 0;
 
-        if (recv(*socketfd, buffer, sizeof(buffer), 0) < 0) {
+        // receive the first page of games from the server
+        printf("Existing games:\n");
+        receiveListing(socketfd, config, &offset, &count, &total);
+        produceClientLog(config, 0, config->clientID, "Received and displayed existing games");
 
-            // error receiving games from server
-            err_dump_client(config->logPath, 0, config->clientID, "can't receive games from server", EVENT_MESSAGE_CLIENT_NOT_RECEIVED);
+        int gameID;
 
-        } else {
+        for (;;) {
 
-            // show the games
-            printf("Existing games:\n%s", buffer);
-            printf("0 - Back\n");
-            writeLogJSON(config->logPath, 0, config->clientID, "Received and displayed existing games");
-            // ask for the game ID
-            int gameID;
-            printf("Choose an option: ");
+            // show the paging options
+            printf("Showing %d-%d of %d games\n", count > 0 ? offset + 1 : 0, offset + count, total);
+            printf(INTERFACE_LISTING_GAMES);
 
             // Get the game ID from the user
             if (scanf("%d", &gameID) != 1) {
@@ -542,42 +722,70 @@ void showGames(int *socketfd, clientConfig *config, bool isSinglePlayer) {
                 return;
             }
 
-            if (gameID == 0) {
+            if (gameID >= 0) {
+                break;
+            }
+
+            int newOffset = offset;
 
-                // send 0 to the server
-                if (send(*socketfd, "0", strlen("0"), 0) < 0) {
-                    err_dump_client(config->logPath, 0, config->clientID, "can't send return to menu to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
-                } else {
-                    char logMessage[256];
-                    snprintf(logMessage, sizeof(logMessage), "%s: sent 0 to return to menu", EVENT_MESSAGE_CLIENT_SENT);
-                    writeLogJSON(config->logPath, 0, config->clientID, logMessage);
+            if (gameID == -3) {
+                // ask for the difficulty filter
+                printf("Difficulty (0 any): ");
+                if (scanf("%d", &difficulty) != 1) {
+                    difficulty = 0;
                 }
-
-                // show the single player menu
-                if (isSinglePlayer) {
-                    showSinglePLayerMenu(socketfd, config);
-                } else {
-                    showMultiPlayerMenu(socketfd, config);
+                newOffset = 0;
+            } else if (gameID == -1 || gameID == -2) {
+                newOffset = nextListingOffset(gameID, offset, count, total);
+                if (newOffset < 0) {
+                    continue;
                 }
+            } else {
+                printf("Invalid option\n");
+                continue;
+            }
+
+            // ask the server for the page
+            char request[64];
+            snprintf(request, sizeof(request), "LIST %d %d %d", newOffset, LISTING_PAGE_SIZE, difficulty);
+            requestListing(socketfd, config, request, &offset, &count, &total);
+        }
+
+        if (gameID == 0) {
 
+            // send 0 to the server
+            if (send(*socketfd, "0", strlen("0"), 0) < 0) {
+                err_dump_client(config, 0, config->clientID, "can't send return to menu to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
             } else {
-                // send the game ID to the server
-                char gameIDString[10];
-                sprintf(gameIDString, "%d", gameID);
+                char logMessage[256];
+                snprintf(logMessage, sizeof(logMessage), "%s: sent 0 to return to menu", EVENT_MESSAGE_CLIENT_SENT);
+                produceClientLog(config, 0, config->clientID, logMessage);
+            }
 
-                if (send(*socketfd, gameIDString, strlen(gameIDString), 0) < 0) {
-                    err_dump_client(config->logPath, 0, config->clientID, "can't send game ID to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
-                } else {
-                    printf("Requesting game with ID %s...\n", gameIDString);
-                }
+            // show the single player menu
+            if (isSinglePlayer) {
+                showSinglePLayerMenu(socketfd, config);
+            } else {
+                showMultiPlayerMenu(socketfd, config);
+            }
 
-                if (!isSinglePlayer) {
-                    // now need to choose synchronization
-                    showPossibleSynchronizations(socketfd, config);
-                    writeLogJSON(config->logPath, 0, config->clientID, "Selected synchronization type for multiplayer game");
-                }
-            }  
-        }
+        } else {
+            // send the game ID to the server
+            char gameIDString[10];
+            sprintf(gameIDString, "%d", gameID);
+
+            if (send(*socketfd, gameIDString, strlen(gameIDString), 0) < 0) {
+                err_dump_client(config, 0, config->clientID, "can't send game ID to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
+            } else {
+                printf("Requesting game with ID %s...\n", gameIDString);
+            }
+
+            if (!isSinglePlayer) {
+                // now need to choose synchronization
+                showPossibleSynchronizations(socketfd, config);
+                produceClientLog(config, 0, config->clientID, "Selected synchronization type for multiplayer game");
+            }
+        }  
     }
 }
 
@@ -597,19 +805,19 @@ void receiveTimer(int *socketfd, clientConfig *config) {
         if (recv(*socketfd, buffer, sizeof(buffer), 0) < 0) {
 
             // error receiving timer from server
-            err_dump_client(config->logPath, 0, config->clientID, "can't receive timer from server", EVENT_MESSAGE_CLIENT_NOT_RECEIVED);
+            err_dump_client(config, 0, config->clientID, "can't receive timer from server", EVENT_MESSAGE_CLIENT_NOT_RECEIVED);
 
         } else {
 
             //printf("Buffer: %s\n", buffer);
 
-            // check if buffer is "Room is full"
-            if (strcmp(buffer, "Room is full") == 0) {
+            // check if buffer is "Room is full" (or the game chosen no longer exists)
+            if (strcmp(buffer, "Room is full") == 0 || strcmp(buffer, "Game not found") == 0) {
                 
                 isRoomFull = true;
                 char logMessage[256];
-                snprintf(logMessage, sizeof(logMessage), "%s: room is full", EVENT_MESSAGE_CLIENT_RECEIVED);
-                writeLogJSON(config->logPath, 0, config->clientID, logMessage);
+                snprintf(logMessage, sizeof(logMessage), "%s: %.64s", EVENT_MESSAGE_CLIENT_RECEIVED, buffer);
+                produceClientLog(config, 0, config->clientID, logMessage);
                 break;
             }
 
@@ -617,24 +825,32 @@ void receiveTimer(int *socketfd, clientConfig *config) {
 
             char logMessage[256];
             snprintf(logMessage, sizeof(logMessage), "%s: time left: %d", EVENT_MESSAGE_CLIENT_RECEIVED, timeLeft);
-            writeLogJSON(config->logPath, 0, config->clientID, logMessage);
+            produceClientLog(config, 0, config->clientID, logMessage);
         }
     }
 
     if (isRoomFull) {
         //debug
-        writeLogJSON(config->logPath, 0, config->clientID, "Room is full. Returning to multiplayer menu.");
-        printf("Room is full\n");
+        produceClientLog(config, 0, config->clientID, "No seat in the room. Returning to multiplayer menu.");
+        printf("%s\n", buffer);
         // show the multiplayer menu
         showMultiPlayerMenu(socketfd, config);
     }
 }
 
-void playSinglePlayerGame(int *socketfd, clientConfig *config) {
+void playSinglePlayerGame(int *socketfd, clientConfig *config, int difficulty) {
+
+    char buffer[BUFFER_SIZE];
+
+    // ask server for a random game, of a given difficulty if there's one
+    if (difficulty > 0) {
+        snprintf(buffer, sizeof(buffer), "newSinglePlayerGame %d", difficulty);
+    } else {
+        strcpy(buffer, "newSinglePlayerGame");
+    }
 
-    // ask server for a random game
-    if (send(*socketfd, "newSinglePlayerGame", strlen("newSinglePlayerGame"), 0) < 0) {
-        err_dump_client(config->logPath, 0, config->clientID, "can't send game request to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
+    if (send(*socketfd, buffer, strlen(buffer), 0) < 0) {
+        err_dump_client(config, 0, config->clientID, "can't send game request to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
     } else {
         printf("Requesting a new game...\n");
     }
@@ -652,37 +868,37 @@ void playMultiPlayerGame(int *socketfd, clientConfig *config, char *synchronizat
         // buffer for readersWriters
         strcpy(buffer, "newMultiPlayerGameReadersWriters");
      // Log evento de solicitação
-        writeLogJSON(config->logPath, 0, config->clientID, "Requesting multiplayer game with readers-writers synchronization");
+        produceClientLog(config, 0, config->clientID, "Requesting multiplayer game with readers-writers synchronization");
     } else if (strcmp(synchronization, "barberShopStaticPriority") == 0) {
         
         // buffer for barberShopPriority
         strcpy(buffer, "newMultiPlayerGameBarberShopStaticPriority");
          // Log evento de solicitação
-        writeLogJSON(config->logPath, 0, config->clientID, "Requesting multiplayer game with barber shop static priority synchronization");
+        produceClientLog(config, 0, config->clientID, "Requesting multiplayer game with barber shop static priority synchronization");
     
     } else if (strcmp(synchronization, "barberShopDynamicPriority") == 0) {
         
         // buffer for barberShopDynamicPriority
         strcpy(buffer, "newMultiPlayerGameBarberShopDynamicPriority");
          // Log evento de solicitação
-        writeLogJSON(config->logPath, 0, config->clientID, "Requesting multiplayer game with barber shop dynamic priority synchronization");
+        produceClientLog(config, 0, config->clientID, "Requesting multiplayer game with barber shop dynamic priority synchronization");
 
     } else if (strcmp(synchronization, "barberShopFIFO") == 0) {
         
         // buffer for barberShopFIFO
         strcpy(buffer, "newMultiPlayerGameBarberShopFIFO");
-        writeLogJSON(config->logPath, 0, config->clientID, "Requesting multiplayer game with barber shop FIFO synchronization");
+        produceClientLog(config, 0, config->clientID, "Requesting multiplayer game with barber shop FIFO synchronization");
 
     } else {
         printf("Invalid synchronization option\n");
-        writeLogJSON(config->logPath, 1, config->clientID, "Invalid synchronization option requested");
+        produceClientLog(config, 1, config->clientID, "Invalid synchronization option requested");
         
         return;
     }
 
     // ask server for a 
     if (send(*socketfd, buffer, BUFFER_SIZE, 0) < 0) {
-        err_dump_client(config->logPath, 0, config->clientID, "can't send multiplayer game request to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
+        err_dump_client(config, 0, config->clientID, "can't send multiplayer game request to server", EVENT_MESSAGE_CLIENT_NOT_SENT);
     } else {
         printf("Requesting a new multiplayer game...\n");
 
@@ -5,11 +5,20 @@
 #include "../config/config.h"
 #include "client-comms.h"
 
+// Número de entradas pedidas por página nas listagens de jogos e salas.
+#define LISTING_PAGE_SIZE 20
+
 #define INTERFACE_MENU "1. Play\n2. Statistics\n3. Exit\nChoose an option: "
-#define INTERFACE_PLAY_MENU "1. Singleplayer\n2. Multiplayer\n3. Back\n4. Exit\nChoose an option: "
-#define INTERFACE_SELECT_SINGLEPLAYER_GAME "1. New Random SinglepLayer Game\n2. New Specific Singleplayer Game\n3. Back\n4. Exit\nChoose an option: "
+#define INTERFACE_PLAY_MENU "1. Singleplayer\n2. Multiplayer\n3. Several Singleplayer Games at Once\n4. Back\n5. Exit\nChoose an option: "
+#define INTERFACE_SELECT_SINGLEPLAYER_GAME "1. New Random SinglepLayer Game\n2. New Specific Singleplayer Game\n3. New Random Singleplayer Game by Difficulty\n4. Back\n5. Exit\nChoose an option: "
+#define INTERFACE_SELECT_NUM_GAMES "Number of games to play at once (1 - 16): "
+#define INTERFACE_SELECT_DIFFICULTY "Difficulty (1 - Easiest ... 5 - Hardest): "
 #define INTERFACE_SELECT_MULTIPLAYER_GAME "1. New Random Multiplayer Game\n2. New Specific Multiplayer Game\n3. Back\n4. Exit\nChoose an option: "
-#define INTERFACE_SELECT_MULTIPLAYER_MENU "1. Create a New Multiplayer Game\n2. Join a Multiplayer Game\n3. Back\n4. Exit\nChoose an option: "
+#define INTERFACE_SELECT_MULTIPLAYER_MENU "1. Create a New Multiplayer Game\n2. Join a Multiplayer Game\n3. Watch a Room\n4. Back\n5. Exit\nChoose an option: "
+#define INTERFACE_SELECT_ROOM_TO_WATCH "Room ID to watch (until its game ends): "
+#define INTERFACE_LISTING_GAMES "-1 - Next page\n-2 - Previous page\n-3 - Filter by difficulty\n0 - Back\nChoose a game ID or an option: "
+#define INTERFACE_LISTING_ROOMS "-1 - Next page\n-2 - Previous page\n-3 - Filter by synchronization and open slots\n0 - Back\nChoose a room ID or an option: "
+#define INTERFACE_STATISTICS_MENU "Game ID for detailed statistics and leaderboard (-1 - My best results, 0 - Back): "
 #define INTERFACE_POSSIBLE_SYNCHRONIZATION "1. Readers-Writers\n2. Barber-Shop with static priority\n3. Barber-shop with dynamic priority\n4. Barber-Shop with FIFO\n5. Back\n6. Exit\nChoose an option: "
 
 // Exibe o menu principal e processa as opções do utilizador.
@@ -36,6 +45,15 @@ void showPossibleSynchronizations(int *socketfd, clientConfig *config);
 // Exibe o menu de opções multiplayer.
 void showMultiPlayerMenu(int *socketfd, clientConfig *config);
 
+// Recebe e exibe uma página de uma listagem, até à linha "END".
+void receiveListing(int *socketfd, clientConfig *config, int *offset, int *count, int *total);
+
+// Pede ao servidor outra página de uma listagem e exibe-a.
+void requestListing(int *socketfd, clientConfig *config, char *request, int *offset, int *count, int *total);
+
+// Calcula o offset da página seguinte ou anterior de uma listagem.
+int nextListingOffset(int option, int offset, int count, int total);
+
 // Solicita e exibe as salas multiplayer disponíveis.
 void showMultiplayerRooms(int *socketfd, clientConfig *config);
 
@@ -45,8 +63,8 @@ void showGames(int *socketfd, clientConfig *config, bool isSinglePlayer);
 // Recebe um temporizador do servidor e atualiza o tempo restante.
 void receiveTimer(int *socketfd, clientConfig *config);
 
-// Inicia um jogo single player aleatório.
-void playSinglePlayerGame(int *socketfd, clientConfig *config);
+// Inicia um jogo single player aleatório, com a dificuldade pedida (0 para qualquer).
+void playSinglePlayerGame(int *socketfd, clientConfig *config, int difficulty);
 
 // Inicia um jogo multiplayer aleatório.
 void playMultiPlayerGame(int *socketfd, clientConfig *config, char *synchronization);
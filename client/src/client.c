@@ -1,111 +1,133 @@
-#include <stdlib.h>
-#include <stdio.h>
-#include <time.h>
-#include "../../utils/logs/logs-common.h"
-#include "../../utils/network/network.h"
-#include "../../utils/parson/parson.h"
-#include "../config/config.h"
-#include "../logs/logs.h"
-#include "client-game.h"
-
-
-/**
- * Função principal que inicializa o cliente, liga-se ao servidor e gere a interação com o mesmo.
- *
- * @param argc O número de argumentos da linha de comando.
- * @param argv Um array de strings que contém os argumentos da linha de comando.
- * @return 0 se o programa for executado com sucesso, ou 1 em caso de erro.
- *
- * @details Esta função faz o seguinte:
- * - Verifica se o argumento de configuração foi fornecido.
- * - Inicializa a seed para a geração de números aleatórios.
- * - Carrega a configuração do cliente a partir do ficheiro especificado.
- * - Configura e cria um socket para se ligar ao servidor.
- * - Envia um pedido de ID de cliente ao servidor e recebe a resposta.
- * - Regista os eventos de envio e receção de mensagens no ficheiro de log.
- * - Entra num ciclo principal onde mostra um menu, envia linhas ao servidor e verifica o estado do jogo.
- * - Fecha o socket e termina o programa de forma limpa.
- */
-
- int main(int argc, char *argv[]) {
-    
-    if (argc < 2) {
-        printf("Erro: Faltam argumentos de configuracao!\n");
-        return 1;
-    }
-
-    // Garante que os ids aleatórios são diferentes
-    srand(time(NULL));
-
-    // Carrega a configuracao do cliente
-    clientConfig *config = getClientConfig(argv[1]);
-
-    /* inicializa variaveis para socket
-    socket descriptor
-    sockaddr_in: estrutura para endereços de internet
-    serv_addr: estrutura para endereços de internet
-    */
-    int sockfd;
-    struct sockaddr_in serv_addr;
-
-    // Conectar ao servidor
-    connectToServer(&serv_addr, &sockfd, config);
-
-    // Set buffer size and clear it
-    char buffer[BUFFER_SIZE];
-    memset(buffer, 0, sizeof(buffer));
-
-    // send client premium status to server
-    if (config->isPremium) {
-        sprintf(buffer, "premium");
-    } else {
-        sprintf(buffer, "not premium");
-    }
-
-    if (send(sockfd, buffer, strlen(buffer), 0) < 0) {
-        // erro ao enviar status premium para o servidor
-        err_dump_client(config->logPath, 0, 0, "can't send premium status", EVENT_MESSAGE_CLIENT_NOT_SENT);
-    } else {
-        char logMessage[256];
-        snprintf(logMessage, sizeof(logMessage), "%s: sent premium status", EVENT_MESSAGE_CLIENT_SENT);
-        writeLogJSON(config->logPath, 0, config->clientID, logMessage);
-    }
-
-    // receive client ID from server
-    memset(buffer, 0, sizeof(buffer));
-    if (recv(sockfd, buffer, sizeof(buffer), 0) < 0) {
-        // erro ao receber ID do cliente do servidor
-        err_dump_client(config->logPath, 0, 0, "can't receive client ID", EVENT_MESSAGE_CLIENT_NOT_RECEIVED);
-    } else {
-        config->clientID = atoi(buffer);
-        printf("ID do cliente: %d\n", config->clientID);
-
-        // add real client id
-        char logPath[512];
-        snprintf(logPath, sizeof(logPath), "%sclient-%d-logs.json", config->sourceLogPath, config->clientID);
-        // set logPath to the new logPath
-        strcpy(config->logPath, logPath);
-
-        char logMessage[256];
-        snprintf(logMessage, sizeof(logMessage), "%s: received client ID %d", EVENT_MESSAGE_CLIENT_RECEIVED, config->clientID);
-        writeLogJSON(config->logPath, 0, config->clientID, logMessage);
-    }
-
-    bool continueLoop = true;
-
-    while (continueLoop) {
-
-        // Imprimir menu
-        showMenu(&sockfd, config);
-
-        // send lines to server
-        playGame(&sockfd, config);
-    }
-    
-    // Fechar o socket
-    close(sockfd);
-
-    free(config);
-
-    exit(0);
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <signal.h>
+#include "../../utils/logs/logs-common.h"
+#include "../../utils/network/network.h"
+#include "../../utils/parson/parson.h"
+#include "../config/config.h"
+#include "../logs/logs.h"
+#include "client-game.h"
+#include "client-comms.h"
+
+
+/**
+ * Função principal que inicializa o cliente, liga-se ao servidor e gere a interação com o mesmo.
+ *
+ * @param argc O número de argumentos da linha de comando.
+ * @param argv Um array de strings que contém os argumentos da linha de comando.
+ * @return 0 se o programa for executado com sucesso, ou 1 em caso de erro.
+ *
+ * @details Esta função faz o seguinte:
+ * - Verifica se o argumento de configuração foi fornecido.
+ * - Inicializa a seed para a geração de números aleatórios.
+ * - Carrega a configuração do cliente a partir do ficheiro especificado.
+ * - Configura e cria um socket para se ligar ao servidor.
+ * - Envia um pedido de ID de cliente ao servidor e recebe a resposta.
+ * - Regista os eventos de envio e receção de mensagens no ficheiro de log.
+ * - Entra num ciclo principal onde mostra um menu, envia linhas ao servidor e verifica o estado do jogo.
+ * - Fecha o socket e termina o programa de forma limpa.
+ */
+
+ int main(int argc, char *argv[]) {
+    
+    if (argc < 2) {
+        printf("Erro: Faltam argumentos de configuracao!\n");
+        return 1;
+    }
+
+    // Garante que os ids aleatórios são diferentes
+    srand(time(NULL));
+
+    // uma ligação perdida é tratada nos próprios envios (para retomar a sessão), não pelo sinal
+    signal(SIGPIPE, SIG_IGN);
+
+    // Carrega a configuracao do cliente
+    clientConfig *config = getClientConfig(argv[1]);
+
+    // Os logs são escritos por uma thread própria, sem o jogo esperar pelo disco
+    startClientLog(config);
+
+    /* inicializa variaveis para socket
+    socket descriptor
+    sockaddr_in: estrutura para endereços de internet
+    serv_addr: estrutura para endereços de internet
+    */
+    int sockfd;
+    struct sockaddr_in serv_addr;
+
+    // Conectar ao servidor
+    connectToServer(&serv_addr, &sockfd, config);
+
+    // Set buffer size and clear it
+    char buffer[BUFFER_SIZE];
+    memset(buffer, 0, sizeof(buffer));
+
+    // send client premium status to server
+    if (config->isPremium) {
+        sprintf(buffer, "premium");
+    } else {
+        sprintf(buffer, "not premium");
+    }
+
+    if (send(sockfd, buffer, strlen(buffer), 0) < 0) {
+        // erro ao enviar status premium para o servidor
+        err_dump_client(config, 0, 0, "can't send premium status", EVENT_MESSAGE_CLIENT_NOT_SENT);
+    } else {
+        char logMessage[256];
+        snprintf(logMessage, sizeof(logMessage), "%s: sent premium status", EVENT_MESSAGE_CLIENT_SENT);
+        produceClientLog(config, 0, config->clientID, logMessage);
+    }
+
+    // receive client ID from server
+    memset(buffer, 0, sizeof(buffer));
+    if (recv(sockfd, buffer, sizeof(buffer), 0) < 0) {
+        // erro ao receber ID do cliente do servidor
+        err_dump_client(config, 0, 0, "can't receive client ID", EVENT_MESSAGE_CLIENT_NOT_RECEIVED);
+    } else if (strncmp(buffer, "BUSY", 4) == 0) {
+        // o servidor está sobrecarregado: "BUSY <segundos>" diz quando vale a pena tentar outra vez
+        int retryAfter = 1;
+        sscanf(buffer, "BUSY %d", &retryAfter);
+        printf("Servidor ocupado, tente novamente daqui a %d segundo(s)\n", retryAfter);
+        produceClientLog(config, 0, 0, "Server busy, connection refused");
+
+        close(sockfd);
+        free(config);
+        exit(1);
+    } else {
+        config->clientID = atoi(buffer);
+        printf("ID do cliente: %d\n", config->clientID);
+
+        // the server may add a token to resume the session after a disconnect
+        config->sessionToken[0] = '\0';
+        sscanf(buffer, "%*d %32s", config->sessionToken);
+
+        // add real client id
+        char logPath[512];
+        snprintf(logPath, sizeof(logPath), CLIENT_LOG_FILE_FORMAT, config->sourceLogPath, config->clientID);
+        // set logPath to the new logPath
+        strcpy(config->logPath, logPath);
+
+        char logMessage[256];
+        snprintf(logMessage, sizeof(logMessage), "%s: received client ID %d", EVENT_MESSAGE_CLIENT_RECEIVED, config->clientID);
+        produceClientLog(config, 0, config->clientID, logMessage);
+    }
+
+    bool continueLoop = true;
+
+    while (continueLoop) {
+
+        // Imprimir menu
+        showMenu(&sockfd, config);
+
+        // send lines to server
+        playGame(&sockfd, config);
+    }
+    
+    // Fechar o socket
+    close(sockfd);
+
+    free(config);
+
+    exit(0);
 } 
\ No newline at end of file
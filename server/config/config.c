@@ -1,182 +1,370 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <errno.h>
-#include "config.h"
-#include "../logs/logs.h"
-#include "../../utils/logs/logs-common.h"
-
-/**
- * Lê as configurações do servidor a partir de um ficheiro de configuração e
- * inicializa uma estrutura `ServerConfig` com os valores lidos.
- *
- * @param configPath O caminho para o ficheiro de configuração que contém as definições do servidor.
- * @return Um pointer para uma estrutura `ServerConfig` inicializada, ou NULL se a alocação de memória falhar.
- *
- * @details Esta função faz o seguinte:
- * - Aloca memória para uma estrutura `ServerConfig` e inicializa os seus campos com zeros.
- * - Abre o ficheiro de configuração especificado em modo de leitura.
- * - Lê as definições do ficheiro, como a porta do servidor, o caminho do jogo, o caminho do log, 
- *   o número máximo de salas, e o número máximo de jogadores por sala, 
- *   e preenche os respetivos campos da estrutura.
- * - Aloca memória para um array de pointers de `Room` e inicializa cada pointer a NULL.
- * - Regista o evento de início do servidor no ficheiro de log.
- * - Imprime as configurações do servidor na consola.
- * - Se ocorrer um erro ao abrir o ficheiro ou a alocar memória, 
-*    imprime uma mensagem de erro e termina o programa.
- */
-
-ServerConfig *getServerConfig(char *configPath) {
-
-    ServerConfig *config = (ServerConfig *)malloc(sizeof(ServerConfig));
-    if (config == NULL) {
-        fprintf(stderr, "Memory allocation failed\n");
-        return NULL;
-    }
-    memset(config, 0, sizeof(ServerConfig));  // Initialize Room struct
-
-    // Abre o ficheiro 'config.txt' em modo de leitura
-    FILE *file;
-    file = fopen(configPath, "r");
-
-    // Se o ficheiro não existir, imprime uma mensagem de erro e termina o programa
-    if (file == NULL) {
-        fprintf(stderr, "Couldn't open %s: %s\n", configPath, strerror(errno));
-        exit(1);
-    }
-
-    char line[256];
-
-    if (fgets(line, sizeof(line), file) != NULL) {
-        // Remover a nova linha, se houver
-        line[strcspn(line, "\n")] = 0;
-        sscanf(line, "SERVER_PORT = %d", &config->serverPort);
-    }
-
-    if (fgets(line, sizeof(line), file) != NULL) {
-        // Remover a nova linha, se houver
-        line[strcspn(line, "\n")] = 0;
-        sscanf(line, "GAME_PATH = %s", config->gamePath);
-    }
-
-    if (fgets(line, sizeof(line), file) != NULL) {
-        // Remover a nova linha, se houver
-        line[strcspn(line, "\n")] = 0;
-        sscanf(line, "SERVER_LOG_PATH = %s", config->logPath);
-    }
-
-    if (fgets(line, sizeof(line), file) != NULL) {
-        // Remover a nova linha, se houver
-        line[strcspn(line, "\n")] = 0;
-        sscanf(line, "MAX_ROOMS = %d", &config->maxRooms);
-    }
-
-    if (fgets(line, sizeof(line), file) != NULL) {
-        // Remover a nova linha, se houver
-        line[strcspn(line, "\n")] = 0;
-        sscanf(line, "MAX_PLAYERS_PER_ROOM = %d", &config->maxClientsPerRoom);
-    }
-
-    if (fgets(line, sizeof(line), file) != NULL) {
-        // Remover a nova linha, se houver
-        line[strcspn(line, "\n")] = 0;
-        sscanf(line, "MAX_PLAYERS_ON_SERVER = %d", &config->maxClientsOnline);
-    }
-
-    if (fgets(line, sizeof(line), file) != NULL) {
-        // Remover a nova linha, se houver
-        line[strcspn(line, "\n")] = 0;
-        sscanf(line, "MAX_WAITING_TIME = %d", &config->maxWaitingTime);
-    }
-
-    // Fecha o ficheiro
-    fclose(file);
-
-    // Inicializa as salas
-    config->rooms = (Room **)malloc(config->maxRooms * sizeof(Room));
-    if (config->rooms == NULL) {
-        fprintf(stderr, "Memory allocation failed for rooms\n");
-        exit(1);  // Handle the error as appropriate
-    }
-
-    // initialize each Room pointer to NULL
-    for (int i = 0; i < config->maxRooms; i++) {
-        config->rooms[i] = NULL;  // Initialize each pointer
-    }
-
-    // initialize clients
-    config->clients = (Client **)malloc(config->maxClientsOnline * sizeof(Client));
-    if (config->clients == NULL) {
-        fprintf(stderr, "Memory allocation failed for clients\n");
-        exit(1);  // Handle the error as appropriate
-    }
-
-    // initialize each Client pointer to NULL
-    for (int i = 0; i < config->maxClientsOnline; i++) {
-        config->clients[i] = NULL;  // Initialize each pointer
-    }
-
-    // Inicializa o número de salas e jogadores online
-    config->numRooms = 0;
-    config->numClientsOnline = 0;
-
-    // producer-consumer for writing logs
-    sem_init(&config->mutexLogSemaphore, 0, 1); // mutex to grant exclusive access
-    sem_init(&config->itemsLogSemaphore, 0, 0); // semaphore to signal when there are items to consume
-    sem_init(&config->spacesSemaphore, 0, 10); // semaphore to signal when there are spaces to produce
-
-    // mutex
-    pthread_mutex_init(&config->mutex, NULL);
-
-    // produce log message
-    writeLogJSON(config->logPath, 0, 0, "Server started");
-
-    // Imprime as configurações do servidor na consola
-    printf("PORTA DO SERVIDOR: %d\n", config->serverPort);
-    printf("PATH DO JOGO: %s\n", config->gamePath);
-    printf("PATH DO LOG: %s\n", config->logPath);
-    printf("MAXIMO DE JOGADORES POR SALA: %d\n", config->maxClientsPerRoom);
-    printf("MAXIMO DE SALAS: %d\n", config->maxRooms);
-    printf("MAXIMO DE JOGADORES ONLINE: %d\n", config->maxClientsOnline);
-    printf("MAXIMO DE TEMPO DE ESPERA: %d\n", config->maxWaitingTime);
-
-    // Retorna a variável config
-    return config;
-}
-
-void addClient(ServerConfig *config, Client *client) {
-    
-    // add client to clients array
-    for (int i = 0; i < config->maxClientsOnline; i++) {
-        if (config->clients[i] == NULL) {
-            config->clients[i] = client;
-            break;
-        }
-    }
-
-    config->numClientsOnline++;
-    //printf("NUMERO DE JOGADORES ONLINE: %d\n", config->numClientsOnline);
-}
-
-void removeClient(ServerConfig *config, Client *client) {
-    
-    // remove client from clients array
-    for (int i = 0; i < config->maxClientsOnline; i++) {
-        if (config->clients[i] != NULL && config->clients[i]->socket_fd == client->socket_fd) {
-            free(config->clients[i]);
-            config->clients[i] = NULL;
-            break;
-        }
-    }
-
-    // shift clients
-    for (int i = 0; i < config->maxClientsOnline; i++) {
-        if (config->clients[i] == NULL && config->clients[i + 1] != NULL) {
-            config->clients[i] = config->clients[i + 1];
-            config->clients[i + 1] = NULL;
-        }
-    }
-
-    // decrement number of clients online
-    config->numClientsOnline--;
-}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include "config.h"
+#include "../logs/logs.h"
+#include "../../utils/logs/logs-common.h"
+
+/**
+ * Lê as configurações do servidor a partir de um ficheiro de configuração e
+ * inicializa uma estrutura `ServerConfig` com os valores lidos.
+ *
+ * @param configPath O caminho para o ficheiro de configuração que contém as definições do servidor.
+ * @return Um pointer para uma estrutura `ServerConfig` inicializada, ou NULL se a alocação de memória falhar.
+ *
+ * @details Esta função faz o seguinte:
+ * - Aloca memória para uma estrutura `ServerConfig` e inicializa os seus campos com zeros.
+ * - Abre o ficheiro de configuração especificado em modo de leitura.
+ * - Lê as definições do ficheiro, como a porta do servidor, o caminho do jogo, o caminho do log, 
+ *   o número máximo de salas, e o número máximo de jogadores por sala, 
+ *   e preenche os respetivos campos da estrutura.
+ * - Aloca memória para um array de pointers de `Room` e inicializa cada pointer a NULL.
+ * - Regista o evento de início do servidor no ficheiro de log.
+ * - Imprime as configurações do servidor na consola.
+ * - Se ocorrer um erro ao abrir o ficheiro ou a alocar memória, 
+*    imprime uma mensagem de erro e termina o programa.
+ */
+
+ServerConfig *getServerConfig(char *configPath) {
+
+    ServerConfig *config = (ServerConfig *)malloc(sizeof(ServerConfig));
+    if (config == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    memset(config, 0, sizeof(ServerConfig));  // Initialize Room struct
+
+    // Abre o ficheiro 'config.txt' em modo de leitura
+    FILE *file;
+    file = fopen(configPath, "r");
+
+    // Se o ficheiro não existir, imprime uma mensagem de erro e termina o programa
+    if (file == NULL) {
+        fprintf(stderr, "Couldn't open %s: %s\n", configPath, strerror(errno));
+        exit(1);
+    }
+
+    char line[256];
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "SERVER_PORT = %d", &config->serverPort);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "GAME_PATH = %s", config->gamePath);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "SERVER_LOG_PATH = %s", config->logPath);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "MAX_ROOMS = %d", &config->maxRooms);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "MAX_PLAYERS_PER_ROOM = %d", &config->maxClientsPerRoom);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "MAX_PLAYERS_ON_SERVER = %d", &config->maxClientsOnline);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "MAX_WAITING_TIME = %d", &config->maxWaitingTime);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "GAME_DB_PATH = %s", config->gameDBPath);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "STATISTICS_PATH = %s", config->statisticsPath);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "LEADERBOARD_PATH = %s", config->leaderboardPath);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "GENERATOR_WORKERS = %d", &config->generatorWorkers);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "GENERATOR_STOCK = %d", &config->generatorStock);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "GENERATOR_CLUES = %d", &config->generatorClues);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "SESSION_GRACE_PERIOD = %d", &config->sessionGracePeriod);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "SNAPSHOT_PATH = %s", config->snapshotPath);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "DRAIN_TIMEOUT = %d", &config->drainTimeout);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "LISTEN_BACKLOG = %d", &config->listenBacklog);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "ADMISSION_RATE = %d", &config->admissionRate);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "ADMISSION_BURST = %d", &config->admissionBurst);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "PREMIUM_RESERVE = %d", &config->premiumReserve);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "ACCEPTOR_THREADS = %d", &config->acceptorThreads);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "SESSION_WORKERS = %d", &config->sessionWorkers);
+    }
+
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // Remover a nova linha, se houver
+        line[strcspn(line, "\n")] = 0;
+        sscanf(line, "WAL_PATH = %s", config->walPath);
+    }
+
+    // Fecha o ficheiro
+    fclose(file);
+
+    // older config files have no admission settings
+    if (config->listenBacklog <= 0) {
+        config->listenBacklog = SOMAXCONN;
+    }
+    if (config->admissionBurst <= 0) {
+        config->admissionBurst = 1;
+    }
+    if (config->premiumReserve < 0 || config->premiumReserve >= config->maxClientsOnline) {
+        config->premiumReserve = 0;
+    }
+    if (config->acceptorThreads <= 0) {
+        config->acceptorThreads = 1;
+    }
+    if (config->acceptorThreads > ACCEPTOR_MAX_THREADS) {
+        config->acceptorThreads = ACCEPTOR_MAX_THREADS;
+    }
+
+    // a worker only holds a session while it handles one message, so by default two per CPU
+    // (a slow socket can still block a send); more workers than clients online would never be busy
+    if (config->sessionWorkers <= 0) {
+        config->sessionWorkers = 2 * (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (config->sessionWorkers <= 0 || config->sessionWorkers > config->maxClientsOnline) {
+        config->sessionWorkers = config->maxClientsOnline;
+    }
+
+    // Inicializa as salas
+    config->rooms = (Room **)malloc(config->maxRooms * sizeof(Room));
+    if (config->rooms == NULL) {
+        fprintf(stderr, "Memory allocation failed for rooms\n");
+        exit(1);  // Handle the error as appropriate
+    }
+
+    // initialize each Room pointer to NULL
+    for (int i = 0; i < config->maxRooms; i++) {
+        config->rooms[i] = NULL;  // Initialize each pointer
+    }
+
+    // initialize clients
+    config->clients = (Client **)malloc(config->maxClientsOnline * sizeof(Client));
+    if (config->clients == NULL) {
+        fprintf(stderr, "Memory allocation failed for clients\n");
+        exit(1);  // Handle the error as appropriate
+    }
+
+    // initialize each Client pointer to NULL
+    for (int i = 0; i < config->maxClientsOnline; i++) {
+        config->clients[i] = NULL;  // Initialize each pointer
+    }
+
+    // Inicializa o número de salas e jogadores online
+    config->numRooms = 0;
+    config->numClientsOnline = 0;
+
+    // producer-consumer for writing logs
+    sem_init(&config->mutexLogSemaphore, 0, 1); // mutex to grant exclusive access
+    sem_init(&config->itemsLogSemaphore, 0, 0); // semaphore to signal when there are items to consume
+    sem_init(&config->spacesSemaphore, 0, LOG_BUFFER_SIZE); // semaphore to signal when there are spaces to produce
+    config->logIn = 0;
+    config->logOut = 0;
+    config->logPending = 0;
+
+    // registry locks
+    pthread_rwlock_init(&config->roomsLock, NULL);
+    pthread_mutex_init(&config->clientsMutex, NULL);
+    pthread_mutex_init(&config->gamesFileMutex, NULL);
+
+    // produce log message (written once the log consumer starts)
+    produceLog(config, "Server started", EVENT_SERVER_START, 0, 0);
+
+    // Imprime as configurações do servidor na consola
+    printf("PORTA DO SERVIDOR: %d\n", config->serverPort);
+    printf("PATH DO JOGO: %s\n", config->gamePath);
+    printf("PATH DO LOG: %s\n", config->logPath);
+    if (config->gameDBPath[0] != '\0') {
+        printf("BASE DE DADOS DE JOGOS: %s\n", config->gameDBPath);
+    }
+    if (config->statisticsPath[0] != '\0') {
+        printf("PATH DAS ESTATISTICAS: %s\n", config->statisticsPath);
+    }
+    if (config->leaderboardPath[0] != '\0') {
+        printf("PATH DO LEADERBOARD: %s\n", config->leaderboardPath);
+    }
+    printf("MAXIMO DE JOGADORES POR SALA: %d\n", config->maxClientsPerRoom);
+    printf("MAXIMO DE SALAS: %d\n", config->maxRooms);
+    printf("MAXIMO DE JOGADORES ONLINE: %d\n", config->maxClientsOnline);
+    printf("MAXIMO DE TEMPO DE ESPERA: %d\n", config->maxWaitingTime);
+    if (config->generatorWorkers > 0) {
+        printf("GERADOR DE JOGOS: %d threads, stock de %d jogos com %d pistas\n", config->generatorWorkers, config->generatorStock, config->generatorClues);
+    }
+    if (config->sessionGracePeriod > 0) {
+        printf("TEMPO PARA RETOMAR UMA SESSAO: %d segundos\n", config->sessionGracePeriod);
+    }
+    if (config->snapshotPath[0] != '\0') {
+        printf("PATH DAS SALAS GUARDADAS: %s\n", config->snapshotPath);
+    }
+    printf("TEMPO PARA OS JOGOS ACABAREM AO DESLIGAR: %d segundos\n", config->drainTimeout);
+    printf("BACKLOG DE LIGACOES: %d\n", config->listenBacklog);
+    if (config->admissionRate > 0) {
+        printf("ADMISSAO: %d sessoes/s (burst de %d), %d lugares premium\n", config->admissionRate, config->admissionBurst, config->premiumReserve);
+    } else if (config->premiumReserve > 0) {
+        printf("ADMISSAO: %d lugares premium\n", config->premiumReserve);
+    }
+    printf("THREADS DE ACCEPT: %d\n", config->acceptorThreads);
+    printf("WORKERS DAS SESSOES: %d\n", config->sessionWorkers);
+    if (config->walPath[0] != '\0') {
+        printf("PATH DO WAL DOS JOGOS: %s\n", config->walPath);
+    }
+
+    // Retorna a variável config
+    return config;
+}
+
+bool addClient(ServerConfig *config, Client *client) {
+
+    bool isAdded = false;
+
+    pthread_mutex_lock(&config->clientsMutex);
+
+    // add client to clients array (the array holds exactly maxClientsOnline clients)
+    for (int i = 0; i < config->maxClientsOnline; i++) {
+        if (config->clients[i] == NULL) {
+            config->clients[i] = client;
+            config->numClientsOnline++;
+            isAdded = true;
+            break;
+        }
+    }
+
+    //printf("NUMERO DE JOGADORES ONLINE: %d\n", config->numClientsOnline);
+
+    pthread_mutex_unlock(&config->clientsMutex);
+
+    return isAdded;
+}
+
+void removeClient(ServerConfig *config, Client *client) {
+
+    pthread_mutex_lock(&config->clientsMutex);
+
+    // remove client from clients array
+    for (int i = 0; i < config->maxClientsOnline; i++) {
+        if (config->clients[i] == client) {
+            free(config->clients[i]);
+            config->clients[i] = NULL;
+            config->numClientsOnline--;
+            break;
+        }
+    }
+
+    // shift clients
+    for (int i = 0; i < config->maxClientsOnline - 1; i++) {
+        if (config->clients[i] == NULL && config->clients[i + 1] != NULL) {
+            config->clients[i] = config->clients[i + 1];
+            config->clients[i + 1] = NULL;
+        }
+    }
+
+    pthread_mutex_unlock(&config->clientsMutex);
+}
+
+Client *findClient(ServerConfig *config, int clientID) {
+
+    Client *client = NULL;
+
+    pthread_mutex_lock(&config->clientsMutex);
+
+    for (int i = 0; i < config->maxClientsOnline; i++) {
+        if (config->clients[i] != NULL && config->clients[i]->clientID == clientID) {
+            client = config->clients[i];
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&config->clientsMutex);
+
+    return client;
+}
@@ -1,152 +1,309 @@
-#ifndef CONFIG_H
-#define CONFIG_H
-
-#include <stdbool.h>
-#include <semaphore.h>
-#include <pthread.h>
-
-#include "../../utils/queues/queues.h"
-
-/**
- * Estrutura que representa um jogo, incluindo o tabuleiro e a solução correta.
- *
- * @param id O identificador único do jogo.
- * @param board O tabuleiro de jogo, representado como uma matriz de 9x9.
- * @param solution A solução correta do jogo, também representada como uma matriz de 9x9.
- * @param currentLine O número da linha atual a resolver no jogo.
- */
-
-typedef struct {
-    int id;        
-    char board[9][9];
-    char solution[9][9];
-    int currentLine;
-} Game;
-
-// Estrutura que contém dados do cliente, incluindo o descritor de socket e a configuração do servidor.
-typedef struct {
-    int socket_fd;
-    int clientID;
-    bool isPremium;
-    bool startAgain;
-    // self semaphore to be used on barber shop
-    sem_t selfSemaphore;
-} Client;
-
-/**
- * Estrutura que representa uma sala de jogo.
- *
- * @param id O identificador único da sala.
- * @param maxClients O número máximo de jogadores que a sala pode conter.
- * @param numClients O número atual de jogadores na sala.
- * @param Clients Um pointer para um array que contém os IDs dos jogadores na sala.
- * @param game Um pointer para o jogo associado à sala.
- */
-
-typedef struct {
-    int id;
-    int maxClients;
-    int numClients;
-    Client **clients;
-    int timer;
-    bool isGameRunning;
-    bool isSinglePlayer;
-    bool isFinished;
-    Game *game;
-    time_t startTime;
-    double elapsedTime; 
-
-    pthread_mutex_t timerMutex;
-    pthread_mutex_t mutex;
-
-    // Priority Queue
-    PriorityQueue *enterRoomQueue;
-
-    // Reader-writer locks
-    pthread_mutex_t readMutex;
-    pthread_mutex_t writeMutex;
-    sem_t writeSemaphore;
-    sem_t readSemaphore;
-    sem_t nonPremiumWriteSemaphore;
-    int readerCount;
-    int writerCount;
-
-    // Priority queue barbershop
-    int customers;
-    pthread_mutex_t barberShopMutex;
-    sem_t costumerSemaphore;
-    sem_t costumerDoneSemaphore;
-    sem_t barberDoneSemaphore;
-    PriorityQueue *barberShopQueue;
-    pthread_t barberThread;
-
-    // bool to decide if the game is reader-writer or barbershop
-    bool isReaderWriter;
-    int priorityQueueType; // 0 static priority, 1 dynamic priority, 2 FIFO
-    int maxWaitingTime;
-
-    // barrier to start the game and end the game
-    int waitingCount;
-    sem_t mutexSemaphore;
-    sem_t turnsTileSemaphore1;
-    sem_t turnsTileSemaphore2;
-
-    bool savedStatistics;
-
-} Room;
-
-
-/**
- * Estrutura que representa a configuração do servidor.
- *
- * @param serverPort O número da porta que o servidor utiliza para comunicação.
- * @param gamePath O caminho para o ficheiro que contém os dados do jogo.
- * @param logPath O caminho para o ficheiro onde os logs do servidor são guardados.
- * @param maxRooms O número máximo de salas que o servidor pode gerir.
- * @param maxClientsPerRoom O número máximo de jogadores que cada sala pode conter.
- * @param numRooms O número atual de salas criadas no servidor.
- * @param rooms Um pointer para um array de pointers de `Room`, 
- * que representa as salas de jogo geridas pelo servidor.
- */
-
-typedef struct {
-    int serverPort;
-    char gamePath[256];
-    char logPath[256];
-    int maxRooms;
-    int maxClientsPerRoom;
-    int maxClientsOnline;
-    int numClientsOnline;
-    int numRooms;
-    int maxWaitingTime;
-
-    Room **rooms;
-    Client **clients;
-
-    // producer-consumer for writing logs
-    sem_t mutexLogSemaphore; // mutex to grant exclusive access
-    sem_t itemsLogSemaphore; // sempaphore to signal when there are items to consume
-    sem_t spacesSemaphore; // semaphore to signal when there are spaces to produce
-
-    char logBuffer[10][256]; // buffer to store log messages
-
-    // mutex
-    pthread_mutex_t mutex;
-} ServerConfig;
-
-typedef struct {
-    Client *client;
-    ServerConfig *config;
-} client_data;
-
-
-// Obter a configuração do servidor
-ServerConfig *getServerConfig(char *configPath);
-
-// Adicionar um cliente à lista de clientes online
-void addClient(ServerConfig *config, Client *client);
-
-// Remover um cliente da lista de clientes online
-void removeClient(ServerConfig *config, Client *client);
-
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <semaphore.h>
+#include <pthread.h>
+
+#include "../../utils/queues/queues.h"
+#include "../../utils/gamedb/gamedb.h"
+#include "../../utils/board/board.h"
+#include "../../utils/logs/logs-binary.h"
+
+/**
+ * Estrutura que representa um jogo, incluindo o tabuleiro e a solução correta.
+ *
+ * @param id O identificador único do jogo.
+ * @param size O número de linhas e colunas do tabuleiro (9, 16 ou 25).
+ * @param boxSize O lado das caixas do tabuleiro (3, 4 ou 5).
+ * @param currentLine O número da linha atual a resolver no jogo.
+ * @param board O tabuleiro de jogo, uma linha por cada BOARD_ROW_STRIDE bytes (células a mais a zeros).
+ * @param solution A solução correta do jogo, com a mesma disposição do tabuleiro.
+ */
+
+typedef struct {
+    int id;
+    int size;
+    int boxSize;
+    int currentLine;
+    char board[BOARD_MAX_SIZE][BOARD_ROW_STRIDE] __attribute__((aligned(64)));
+    char solution[BOARD_MAX_SIZE][BOARD_ROW_STRIDE] __attribute__((aligned(64)));
+} Game;
+
+/**
+ * Índice em memória do catálogo de jogos, ordenado por ID.
+ *
+ * @param numGames O número de jogos no catálogo.
+ * @param entries O ID e a dificuldade (1 a CATALOG_DIFFICULTIES) de cada jogo.
+ * @param buckets Para cada dificuldade, os índices em `entries` dos jogos dessa dificuldade.
+ * @param bucketSizes O número de jogos de cada dificuldade.
+ * @param gameDB A base de dados binária mapeada de onde o catálogo foi lido (NULL se foi lido de `gamePath`).
+ * @param version O número da versão do catálogo: 1 no arranque, mais um em cada recarga.
+ */
+
+#define CATALOG_DIFFICULTIES 5
+
+typedef struct {
+    int id;
+    int difficulty;
+} CatalogEntry;
+
+typedef struct {
+    int numGames;
+    CatalogEntry *entries;
+    int *buckets[CATALOG_DIFFICULTIES + 1];
+    int bucketSizes[CATALOG_DIFFICULTIES + 1];
+    GameDB *gameDB;
+    int version;
+} GameCatalog;
+
+/**
+ * Buffer de logs: os produtores copiam registos binários de tamanho fixo (`LogRecord`, em
+ * utils/logs/logs-binary.h) e o consumidor escreve-os no ficheiro tal como estão, em lotes.
+ * O texto só é formatado fora do servidor, pelo tools/log-decode.
+ */
+
+#define LOG_BUFFER_SIZE 256
+
+/**
+ * Resultado de um jogador num jogo terminado, à espera de ser escrito pelo estágio de resultados
+ * (recordes do jogo e leaderboard).
+ *
+ * @param gameID O identificador do jogo.
+ * @param playerID O identificador do jogador.
+ * @param elapsedTime O tempo do jogo, em segundos.
+ * @param accuracy A precisão do jogador.
+ * @param timestamp O instante em que o jogo terminou.
+ * @param queuedAt O instante (monotónico) em que o resultado entrou na fila, para medir a latência até ao disco.
+ */
+
+typedef struct {
+    int gameID;
+    int playerID;
+    int elapsedTime;
+    float accuracy;
+    time_t timestamp;
+    struct timespec queuedAt;
+} GameResult;
+
+#define CLIENT_PENDING_SIZE 4096 // as much as a multiplexed session's LineReader can have buffered
+
+// O que um worker faz com a sessão de um cliente quando a tira da fila.
+typedef enum {
+    STEP_OPEN,      // the first message: the premium status or "resume <token>"
+    STEP_MENU,      // a menu request
+    STEP_MUX,       // the requests of a multiplexed connection
+    STEP_JOIN,      // the join delay is over: take a seat in the room
+    STEP_COUNTDOWN, // one more second of the countdown of the room the client created
+    STEP_START,     // the countdown is over: send the first board
+    STEP_LINE,      // a line of the board, or the grace period of a lost connection ran out
+    STEP_RESUMED,   // the player is back on a new connection: send the board again
+    STEP_ACCURACY,  // the lines are done: receive the accuracy
+    STEP_FINISH     // the room is done and the accuracy is in: send the time
+} SessionStep;
+
+// O que acontece a uma sessão depois de um passo tratado por um worker.
+typedef enum {
+    SESSION_CONTINUE,    // the session waits for its next message
+    SESSION_CLOSED,      // the connection ended: close the session
+    SESSION_HANDED_OVER, // the socket went to the session the client resumed: only the placeholder is gone
+    SESSION_HELD         // waits for a timer, its room or the player to resume: whoever ends the wait queues it again
+} SessionStatus;
+
+struct Room;
+struct MuxConnection;
+
+// Estrutura que contém dados do cliente, incluindo o descritor de socket e a configuração do servidor.
+typedef struct {
+    int socket_fd; // changes when the client resumes its session on a new connection
+    int clientID;
+    bool isPremium;
+    bool startAgain;
+    bool isConnected; // false once the connection is lost and the session wasn't resumed
+    int sessionSlot;  // slot in the sessions table, -1 without a session
+    // bytes already read from the socket that the next menu request starts with
+    char pending[CLIENT_PENDING_SIZE];
+    int pendingLength;
+    // where the session is between two messages: the step, the room of its game and what it needs
+    SessionStep step;
+    struct Room *room;
+    float accuracy;             // received while the other players were still on their lines
+    struct MuxConnection *mux;  // the games of a multiplexed connection
+    struct timespec queuedAt;
+    // self semaphore to be used on barber shop
+    sem_t selfSemaphore;
+} Client;
+
+/**
+ * Estrutura que representa uma sala de jogo.
+ *
+ * @param id O identificador único da sala.
+ * @param maxClients O número máximo de jogadores que a sala pode conter.
+ * @param numClients O número atual de jogadores na sala.
+ * @param Clients Um pointer para um array que contém os IDs dos jogadores na sala.
+ * @param game Um pointer para o jogo associado à sala.
+ */
+
+typedef struct Room {
+    int id;
+    int maxClients;
+    int numClients;
+    Client **clients;
+    int timer;
+    bool isGameRunning;
+    bool isSinglePlayer;
+    bool isFinished;
+    bool isFrozen; // saved by the drain snapshot: no more lines are applied (protected by mutex)
+    bool isRestored; // saved by the previous run: each player finishes on their own
+    Game *game;
+    time_t startTime;
+    double elapsedTime; 
+
+    pthread_mutex_t timerMutex;
+    pthread_mutex_t mutex;
+
+    // Priority Queue
+    PriorityQueue *enterRoomQueue;
+
+    // Reader-writer locks
+    pthread_mutex_t readMutex;
+    pthread_mutex_t writeMutex;
+    sem_t writeSemaphore;
+    sem_t readSemaphore;
+    sem_t nonPremiumWriteSemaphore;
+    int readerCount;
+    int writerCount;
+
+    // Priority queue barbershop
+    int customers;
+    pthread_mutex_t barberShopMutex;
+    sem_t costumerSemaphore;
+    sem_t costumerDoneSemaphore;
+    sem_t barberDoneSemaphore;
+    PriorityQueue *barberShopQueue;
+    pthread_t barberThread;
+
+    // bool to decide if the game is reader-writer or barbershop
+    bool isReaderWriter;
+    int priorityQueueType; // 0 static priority, 1 dynamic priority, 2 FIFO
+    int synchronizationType; // 0 readers-writers, 1 static priority, 2 dynamic priority, 3 FIFO
+    int maxWaitingTime;
+
+    // players held without a worker until the room starts, or until every player is past the last
+    // line; whoever starts or completes the room queues them again (protected by mutex)
+    Client **waitingClients;
+    int numWaiting;
+    int numDone; // players past their last line (protected by mutex)
+
+    // number of client sessions holding a pointer to the room (protected by mutex)
+    int refCount;
+
+    // board snapshots for the spectators (outlives the room while someone is watching)
+    struct SpectatorFeed *feed;
+
+    // copy of the room in the write-ahead log, NULL until the game starts (protected by the WAL mutex)
+    struct WalRoom *walRoom;
+
+} Room;
+
+
+/**
+ * Estrutura que representa a configuração do servidor.
+ *
+ * @param serverPort O número da porta que o servidor utiliza para comunicação.
+ * @param gamePath O caminho para o ficheiro que contém os dados do jogo.
+ * @param gameDBPath O caminho opcional para a base de dados binária de jogos (vazio para usar `gamePath`).
+ * @param logPath O caminho para o ficheiro onde os logs do servidor são guardados.
+ * @param statisticsPath O caminho para o ficheiro onde as estatísticas agregadas são persistidas (vazio para não persistir).
+ * @param leaderboardPath O caminho para o ficheiro append-only do leaderboard (vazio para não persistir).
+ * @param generatorWorkers O número de threads que geram puzzles (0 desliga o gerador).
+ * @param generatorStock O número de jogos gerados mantidos prontos.
+ * @param generatorClues O número de pistas pretendido nos puzzles gerados.
+ * @param sessionGracePeriod Os segundos que um jogador desligado a meio de um jogo tem para retomar a sessão (0 desliga).
+ * @param snapshotPath O caminho para o ficheiro onde as salas a decorrer são guardadas ao desligar (vazio para não guardar).
+ * @param drainTimeout Os segundos que os jogos a decorrer têm para acabar depois de um SIGTERM.
+ * @param listenBacklog O número de ligações que o kernel guarda à espera do accept.
+ * @param admissionRate O número de sessões novas admitidas por segundo (0 desliga o limite).
+ * @param admissionBurst O número de sessões novas que podem ser admitidas de seguida.
+ * @param premiumReserve O número de lugares de `maxClientsOnline` guardados para clientes premium.
+ * @param acceptorThreads O número de threads de accept, cada uma com o seu socket de escuta na mesma porta.
+ * @param sessionWorkers O número de workers que tratam as mensagens dos clientes, uma de cada vez (no máximo `maxClientsOnline`).
+ * @param walPath O caminho para o write-ahead log das linhas aceites, relido no arranque depois de um crash (vazio para não o escrever).
+ * @param maxRooms O número máximo de salas que o servidor pode gerir.
+ * @param maxClientsPerRoom O número máximo de jogadores que cada sala pode conter.
+ * @param numRooms O número atual de salas criadas no servidor.
+ * @param rooms Um pointer para um array de pointers de `Room`, 
+ * que representa as salas de jogo geridas pelo servidor.
+ */
+
+#define ACCEPTOR_MAX_THREADS 64 // acceptor threads (and listening sockets) at most
+
+typedef struct {
+    int serverPort;
+    char gamePath[256];
+    char logPath[256];
+    char gameDBPath[256];
+    char statisticsPath[256];
+    char leaderboardPath[256];
+    int maxRooms;
+    int maxClientsPerRoom;
+    int maxClientsOnline;
+    int numClientsOnline;
+    int numRooms;
+    int maxWaitingTime;
+    int generatorWorkers;
+    int generatorStock;
+    int generatorClues;
+    int sessionGracePeriod;
+    char snapshotPath[256];
+    int drainTimeout;
+    int listenBacklog;
+    int admissionRate;
+    int admissionBurst;
+    int premiumReserve;
+    int acceptorThreads;
+    int sessionWorkers;
+    char walPath[256];
+
+    // set once by the signal thread: no new rooms while the server drains
+    atomic_bool isDraining;
+
+    Room **rooms;
+    Client **clients;
+
+    // in-memory index of the games (and the database it was read from), used for listings,
+    // random selection and loads; replaced on SIGHUP, so read it between enterCatalog and leaveCatalog
+    GameCatalog *_Atomic catalog;
+
+    // producer-consumer for writing logs
+    sem_t mutexLogSemaphore; // mutex to grant exclusive access
+    sem_t itemsLogSemaphore; // sempaphore to signal when there are items to consume
+    sem_t spacesSemaphore; // semaphore to signal when there are spaces to produce
+
+    LogRecord logBuffer[LOG_BUFFER_SIZE]; // circular buffer of log records
+    int logIn;  // next slot to produce
+    int logOut; // next slot to consume
+    int logPending; // entries produced and not yet written (protected by mutexLogSemaphore)
+
+    // registry locks (never held during socket I/O)
+    pthread_rwlock_t roomsLock;     // rooms array: readers list/lookup, writers create/delete
+    pthread_mutex_t clientsMutex;   // clients array
+    pthread_mutex_t gamesFileMutex; // exclusive access to the games file
+} ServerConfig;
+
+
+// Obter a configuração do servidor
+ServerConfig *getServerConfig(char *configPath);
+
+// Adicionar um cliente à lista de clientes online (false se o servidor já está cheio)
+bool addClient(ServerConfig *config, Client *client);
+
+// Remover um cliente da lista de clientes online
+void removeClient(ServerConfig *config, Client *client);
+
+// Procurar um cliente online pelo seu ID
+Client *findClient(ServerConfig *config, int clientID);
+
 #endif // CONFIG_H
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <unistd.h>
 #include "logs.h"
 #include "../../utils/logs/logs-common.h"
 
@@ -15,96 +16,148 @@ void err_dump(ServerConfig * config, int idJogo, int idJogador, char *msg, char
 	exit(1);
 }
 
-// add message to log buffer
-void addLogMessage(ServerConfig *config, char *message) {
+// add record to log buffer
+void addLogRecord(ServerConfig *config, const LogRecord *record) {
 
-    // add message to log buffer
-    for (int i = 0; i < 10; i++) {
-        if (config->logBuffer[i][0] == '\0') {
-            strcpy(config->logBuffer[i], message);
-            break;
-        }
-    }
+    config->logBuffer[config->logIn] = *record;
+    config->logIn = (config->logIn + 1) % LOG_BUFFER_SIZE;
+    config->logPending++;
 }
 
-// get message from log buffer
-char *getLogMessage(ServerConfig *config) {
-    
-    // get message from log buffer
-    for (int i = 0; i < 10; i++) {
-        if (config->logBuffer[i][0] != '\0') {
-            return config->logBuffer[i];
-        }
-    }
+// take the oldest record from log buffer
+void takeLogRecord(ServerConfig *config, LogRecord *record) {
 
-    return NULL;
+    *record = config->logBuffer[config->logOut];
+    config->logOut = (config->logOut + 1) % LOG_BUFFER_SIZE;
 }
 
-// remove message from log buffer
-void removeLogMessage(ServerConfig *config) {
-    
-    // remove message from log buffer
-    for (int i = 0; i < 10; i++) {
-        if (config->logBuffer[i][0] != '\0') {
-            memset(config->logBuffer[i], 0, sizeof(config->logBuffer[i]));
-            break;
+// open the log for appending records, starting it with the header when it is new
+static FILE *openLogFile(const char *path) {
+
+    // a log in another format (the old JSON one) is kept aside instead of being mixed in
+    FILE *file = fopen(path, "rb");
+    if (file != NULL) {
+        LogFileHeader header;
+        size_t headerBytes = fread(&header, 1, sizeof(header), file);
+        fclose(file);
+
+        if (headerBytes > 0 && (headerBytes < sizeof(header) || !isLogFileHeader(&header))) {
+            char oldPath[512];
+            snprintf(oldPath, sizeof(oldPath), "%s.old", path);
+            if (rename(path, oldPath) == 0) {
+                printf("O log antigo foi mudado para %s\n", oldPath);
+            }
         }
     }
-}
 
+    file = fopen(path, "ab");
+    if (file == NULL) {
+        perror(path);
+        return NULL;
+    }
 
-void *consumeLog(void *arg) {
-
-    while (1) {
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) == 0) {
+        LogFileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, LOG_FILE_MAGIC, sizeof(header.magic));
+        header.version = LOG_FILE_VERSION;
+        header.recordSize = sizeof(LogRecord);
+        fwrite(&header, sizeof(header), 1, file);
+    }
 
-        ServerConfig* config = (ServerConfig*) arg; // get config
+    return file;
+}
 
-        sem_wait(&config->itemsLogSemaphore);   // check if there are items to consume
+void *consumeLog(void *arg) {
 
-        //printf("SERVER detects a log to write!\n");
+    ServerConfig* config = (ServerConfig*) arg; // get config
 
-        sem_wait(&config->mutexLogSemaphore);   // lock the buffer
+    FILE *file = openLogFile(config->logPath);
 
-        //printf("SERVER writing a log message\n");
+    LogRecord *batch = (LogRecord *)malloc(sizeof(LogRecord) * LOG_BUFFER_SIZE);
+    if (batch == NULL) {
+        fprintf(stderr, "Memory allocation failed for the log consumer\n");
+        return NULL;
+    }
 
-        char *message = getLogMessage(config);  // get message from buffer
-        if (message != NULL) {                  
+    while (1) {
 
-            // break message into gameID, playerID and message through \n
-            char *token = strtok(message, "\n");
-            int gameID = atoi(token);
-            token = strtok(NULL, "\n");
-            int playerID = atoi(token);
-            token = strtok(NULL, "\n");
-            char *message = token;
+        sem_wait(&config->itemsLogSemaphore);   // check if there are items to consume
 
-            writeLogJSON(config->logPath, gameID, playerID, message);  // write the message on the log
-            removeLogMessage(config);           // remove message from buffer
+        // take this record and every other one already produced
+        int numRecords = 0;
+        do {
+            sem_wait(&config->mutexLogSemaphore);   // lock the buffer
+            takeLogRecord(config, &batch[numRecords++]);
+            sem_post(&config->mutexLogSemaphore);   // unlock the buffer
+            sem_post(&config->spacesSemaphore);     // signal that there are spaces to produce
+        } while (numRecords < LOG_BUFFER_SIZE && sem_trywait(&config->itemsLogSemaphore) == 0);
+
+        // the records are written as they are: one write for the whole batch
+        if (file != NULL) {
+            fwrite(batch, sizeof(LogRecord), numRecords, file);
+            fflush(file);
         }
-        sem_post(&config->mutexLogSemaphore);   // unlock the buffer
 
-        //printf("SERVER finished writing a log message\n");
-        sem_post(&config->spacesSemaphore);     // signal that there are spaces to produce
-       // printf("SERVER signaled that there are spaces to produce\n");
+        sem_wait(&config->mutexLogSemaphore);
+        config->logPending -= numRecords;       // the records are on disk now
+        sem_post(&config->mutexLogSemaphore);
     }
 
     return NULL;
 }
 
-void produceLog(ServerConfig *config, char *msg, char* event, int idJogo, int idJogador) {
+bool flushLogs(ServerConfig *config, int timeoutMs) {
 
-    //printf("CLIENT %d : wants to write a log message\n", idJogador);
+    for (int waited = 0; ; waited += 10) {
 
-    sem_wait(&config->spacesSemaphore);     // check if there is space to produce
+        sem_wait(&config->mutexLogSemaphore);
+        int pending = config->logPending;
+        sem_post(&config->mutexLogSemaphore);
 
-    //printf("THERE's space to CLIENT %d write a log message!\n", idJogador);
+        if (pending == 0) {
+            return true;
+        }
+        if (waited >= timeoutMs) {
+            return false;
+        }
+
+        usleep(10000);
+    }
+}
+
+static void produceRecord(ServerConfig *config, const LogRecord *record) {
+
+    sem_wait(&config->spacesSemaphore);     // check if there is space to produce
     sem_wait(&config->mutexLogSemaphore);   // lock the buffer
 
-    //printf("CLIENT %d : writing a log message\n", idJogador);
-    char *message = concatenateInfo(msg, event, idJogo, idJogador);  // concatenate info
-    addLogMessage(config, message);         // add message to buffer
-    free(message);                          // free message
+    addLogRecord(config, record);           // add record to buffer
 
     sem_post(&config->mutexLogSemaphore);   // unlock the buffer
     sem_post(&config->itemsLogSemaphore);   // signal that there are items to consume
-}
\ No newline at end of file
+}
+
+void produceLog(ServerConfig *config, char *msg, char* event, int idJogo, int idJogador) {
+
+    LogRecord record;
+    fillLogRecord(&record, findLogEvent(event), idJogo, idJogador, 0, msg);
+
+    produceRecord(config, &record);
+}
+
+void produceLineLog(ServerConfig *config, LogEvent event, int idJogo, int idJogador, int lineNumber, const char *line) {
+
+    LogRecord record;
+    fillLogRecord(&record, event, idJogo, idJogador, lineNumber, line);
+
+    produceRecord(config, &record);
+}
+
+void produceEventLog(ServerConfig *config, LogEvent event, int idJogo, int idJogador, int value) {
+
+    LogRecord record;
+    fillLogRecord(&record, event, idJogo, idJogador, value, NULL);
+
+    produceRecord(config, &record);
+}
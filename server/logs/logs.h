@@ -6,19 +6,25 @@
 // Função externa para registar um erro no log e terminar o programa.
 void err_dump(ServerConfig *config, int idJogo, int idJogador, char *msg, char *event);
 
-// add message to log buffer
-void addLogMessage(ServerConfig *config, char *message);
+// add record to log buffer
+void addLogRecord(ServerConfig *config, const LogRecord *record);
 
-// get message from log buffer
-char *getLogMessage(ServerConfig *config);
-
-// remove message from log buffer
-void removeLogMessage(ServerConfig *config);
+// take the oldest record from log buffer
+void takeLogRecord(ServerConfig *config, LogRecord *record);
 
 // consume log message
 void *consumeLog(void *arg);
 
+// wait until every produced entry is written (false if the timeout ran out first)
+bool flushLogs(ServerConfig *config, int timeoutMs);
+
 // produce log message
 void produceLog(ServerConfig *config, char *msg, char* event, int idJogo, int idJogador);
 
+// produce a submitted line record (the line is copied as received)
+void produceLineLog(ServerConfig *config, LogEvent event, int idJogo, int idJogador, int lineNumber, const char *line);
+
+// produce a record with a number instead of a message (nothing is formatted)
+void produceEventLog(ServerConfig *config, LogEvent event, int idJogo, int idJogador, int value);
+
 #endif // LOGS_H
\ No newline at end of file
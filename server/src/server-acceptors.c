@@ -0,0 +1,131 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <errno.h>
+#include <unistd.h>
+#include "../../utils/logs/logs-common.h"
+#include "../../utils/network/network.h"
+#include "../logs/logs.h"
+#include "server-comms.h"
+#include "server-admission.h"
+#include "server-workers.h"
+#include "server-acceptors.h"
+
+/*
+ * Threads de accept: cada uma tem o seu próprio socket de escuta na mesma porta (SO_REUSEPORT),
+ * e o kernel reparte as ligações novas por eles. Assim um pico de ligações (o início de um torneio)
+ * não fica em fila atrás de um só accept, e cada socket tem o seu backlog de LISTEN_BACKLOG ligações.
+ * Com ACCEPTOR_THREADS = 1 há um só socket, sem SO_REUSEPORT, como antes.
+ * As ligações aceites não criam threads: a sessão vai para os workers (server-workers).
+ */
+
+typedef struct {
+    ServerConfig *config;
+    int sockfd;
+    pthread_t thread;
+} Acceptor;
+
+static Acceptor acceptors[ACCEPTOR_MAX_THREADS];
+static int numAcceptors = 0;
+
+// hand an accepted connection to the session workers
+static void dispatchConnection(ServerConfig *config, int newSockfd) {
+
+    Client *client = (Client *) malloc(sizeof(Client));
+    if (client == NULL) {
+        // erro ao alocar memoria
+        produceLog(config, "can't allocate memory", MEMORY_ERROR, 0, 0);
+        close(newSockfd);
+        return;
+    }
+
+    client->socket_fd = newSockfd;
+    client->clientID = 0;
+    client->isConnected = true;
+    client->sessionSlot = -1;
+    client->pendingLength = 0;
+    client->room = NULL;
+    client->mux = NULL;
+
+    // hard limit of MAX_PLAYERS_ON_SERVER: answer "BUSY" without queueing the session
+    if (!addClient(config, client)) {
+        free(client);
+        rejectConnection(config, newSockfd, 1);
+        return;
+    }
+
+    // only a failed malloc or epoll_ctl
+    if (!dispatchClient(config, client)) {
+        removeClient(config, client);
+        rejectConnection(config, newSockfd, 1);
+    }
+}
+
+static void *acceptConnections(void *arg) {
+
+    Acceptor *acceptor = (Acceptor *)arg;
+    ServerConfig *config = acceptor->config;
+
+    // Aguardar por conexões até o servidor ser desligado
+    while (!config->isDraining) {
+
+        int newSockfd = accept(acceptor->sockfd, (struct sockaddr *) 0, 0);
+
+        if (newSockfd >= 0) {
+            dispatchConnection(config, newSockfd);
+            continue;
+        }
+
+        // a shutdown signal closed the socket
+        if (config->isDraining) {
+            break;
+        }
+
+        // out of descriptors or a connection reset while queued: overload, not a reason to stop
+        if (errno == EINTR || errno == ECONNABORTED || errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+            produceLog(config, "accept error", EVENT_CONNECTION_SERVER_ERROR, 0, 0);
+            usleep(errno == EMFILE || errno == ENFILE ? 10000 : 0);
+            continue;
+        }
+
+        // erro ao aceitar ligacao
+        err_dump(config, 0, 0, "accept error", EVENT_CONNECTION_SERVER_ERROR);
+    }
+
+    close(acceptor->sockfd);
+
+    return NULL;
+}
+
+void startAcceptors(ServerConfig *config) {
+
+    numAcceptors = config->acceptorThreads;
+
+    // every socket is bound before any thread accepts, so a bind error stops the start cleanly
+    for (int i = 0; i < numAcceptors; i++) {
+        struct sockaddr_in serv_addr;
+        acceptors[i].config = config;
+        initializeSocket(&serv_addr, &acceptors[i].sockfd, config);
+    }
+
+    for (int i = 0; i < numAcceptors; i++) {
+        if (pthread_create(&acceptors[i].thread, NULL, acceptConnections, (void *)&acceptors[i]) != 0) {
+            err_dump(config, 0, 0, "can't create acceptor thread", EVENT_THREAD_NOT_CREATE);
+        }
+    }
+}
+
+void stopAcceptors(void) {
+
+    // accept() returns at once on a socket that was shut down
+    for (int i = 0; i < numAcceptors; i++) {
+        shutdown(acceptors[i].sockfd, SHUT_RDWR);
+    }
+}
+
+void joinAcceptors(void) {
+
+    for (int i = 0; i < numAcceptors; i++) {
+        pthread_join(acceptors[i].thread, NULL);
+    }
+}
@@ -0,0 +1,15 @@
+#ifndef SERVER_ACCEPTORS_H
+#define SERVER_ACCEPTORS_H
+
+#include "../config/config.h"
+
+// Abre ACCEPTOR_THREADS sockets de escuta na porta do servidor e uma thread de accept por cada um.
+void startAcceptors(ServerConfig *config);
+
+// Fecha os sockets de escuta para as threads de accept acabarem (chamada pela thread dos sinais).
+void stopAcceptors(void);
+
+// Espera que todas as threads de accept acabem.
+void joinAcceptors(void);
+
+#endif // SERVER_ACCEPTORS_H
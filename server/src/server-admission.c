@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "../../utils/logs/logs-common.h"
+#include "../../utils/network/network.h"
+#include "../logs/logs.h"
+#include "server-admission.h"
+
+/*
+ * Controlo de admissão: quando o servidor está sobrecarregado, as ligações a mais são recusadas
+ * depressa, com "BUSY <segundos>", em vez de ficarem à espera ou de ocuparem uma thread.
+ * - À saída do accept só se verifica o limite de MAX_PLAYERS_ON_SERVER ligações.
+ * - Depois do estado premium, cada sessão nova gasta um token de um token bucket (ADMISSION_RATE
+ *   por segundo, até ADMISSION_BURST acumulados), e os últimos PREMIUM_RESERVE lugares ficam para
+ *   os clientes premium.
+ * - Um cliente premium pode ainda endividar o bucket até -ADMISSION_BURST: passa à frente, e são os
+ *   não premium seguintes que esperam pelos tokens que ele gastou.
+ */
+
+// token bucket (protected by bucketMutex)
+static pthread_mutex_t bucketMutex = PTHREAD_MUTEX_INITIALIZER;
+static double tokens = 0;
+static struct timespec lastRefill;
+
+// rejections since the last summary in the log (protected by bucketMutex)
+static int numRejected = 0;
+static time_t lastRejectionLog = 0;
+
+void initAdmission(ServerConfig *config) {
+
+    pthread_mutex_lock(&bucketMutex);
+    tokens = config->admissionBurst;
+    clock_gettime(CLOCK_MONOTONIC, &lastRefill);
+    pthread_mutex_unlock(&bucketMutex);
+}
+
+// add the tokens earned since the last refill (caller holds bucketMutex)
+static void refillTokens(ServerConfig *config) {
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    double elapsed = (now.tv_sec - lastRefill.tv_sec) + (now.tv_nsec - lastRefill.tv_nsec) / 1e9;
+    lastRefill = now;
+
+    tokens += elapsed * config->admissionRate;
+    if (tokens > config->admissionBurst) {
+        tokens = config->admissionBurst;
+    }
+}
+
+// one log line per second under overload, not one per rejected connection
+static void noteRejection(ServerConfig *config) {
+
+    pthread_mutex_lock(&bucketMutex);
+
+    numRejected++;
+
+    time_t now = time(NULL);
+    int rejected = 0;
+    if (now != lastRejectionLog) {
+        rejected = numRejected;
+        numRejected = 0;
+        lastRejectionLog = now;
+    }
+
+    pthread_mutex_unlock(&bucketMutex);
+
+    if (rejected > 0) {
+        char logMessage[128];
+        snprintf(logMessage, sizeof(logMessage), "Servidor ocupado: %d ligacoes recusadas", rejected);
+        produceLog(config, logMessage, EVENT_CONNECTION_SERVER_ERROR, 0, 0);
+    }
+}
+
+void rejectConnection(ServerConfig *config, int socket_fd, int retryAfter) {
+
+    char reply[32];
+    snprintf(reply, sizeof(reply), "BUSY %d\n", retryAfter);
+
+    // never wait for a client the server has no room for
+    send(socket_fd, reply, strlen(reply), MSG_DONTWAIT | MSG_NOSIGNAL);
+    close(socket_fd);
+
+    noteRejection(config);
+}
+
+bool admitSession(ServerConfig *config, Client *client, int *retryAfter) {
+
+    *retryAfter = 1;
+
+    // the last slots are kept for premium clients (the client itself is already counted)
+    if (!client->isPremium) {
+        pthread_mutex_lock(&config->clientsMutex);
+        bool isReserved = config->numClientsOnline > config->maxClientsOnline - config->premiumReserve;
+        pthread_mutex_unlock(&config->clientsMutex);
+
+        if (isReserved) {
+            noteRejection(config);
+            return false;
+        }
+    }
+
+    if (config->admissionRate <= 0) {
+        return true;
+    }
+
+    pthread_mutex_lock(&bucketMutex);
+
+    refillTokens(config);
+
+    double floor = client->isPremium ? 1 - config->admissionBurst : 1;
+    bool isAdmitted = tokens >= floor;
+
+    if (isAdmitted) {
+        tokens -= 1;
+    } else {
+        // whole seconds until the missing tokens are earned, rounded up
+        *retryAfter = (int)((floor - tokens) / config->admissionRate) + 1;
+    }
+
+    pthread_mutex_unlock(&bucketMutex);
+
+    if (!isAdmitted) {
+        noteRejection(config);
+    }
+
+    return isAdmitted;
+}
@@ -0,0 +1,16 @@
+#ifndef SERVER_ADMISSION_H
+#define SERVER_ADMISSION_H
+
+#include <stdbool.h>
+#include "../config/config.h"
+
+// Prepara o token bucket das novas sessões com o ritmo e o burst da configuração.
+void initAdmission(ServerConfig *config);
+
+// Recusa uma ligação logo à saída do accept, sem criar uma thread: responde "BUSY <segundos>" e fecha-a.
+void rejectConnection(ServerConfig *config, int socket_fd, int retryAfter);
+
+// Decide se um cliente já identificado (premium ou não) pode abrir uma sessão; se não, diz quando tentar outra vez.
+bool admitSession(ServerConfig *config, Client *client, int *retryAfter);
+
+#endif // SERVER_ADMISSION_H
@@ -0,0 +1,285 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "../../utils/logs/logs-common.h"
+#include "../../utils/gamestream/gamestream.h"
+#include "../../utils/epoch/epoch.h"
+#include "../../utils/solver/rating.h"
+#include "../logs/logs.h"
+#include "server-catalog.h"
+
+/*
+ * Catálogo de jogos: um índice só de leitura, publicado em `config->catalog`. Uma recarga
+ * (SIGHUP) constrói um catálogo novo ao lado, troca o pointer de uma vez e retira o antigo,
+ * que é libertado (com a base de dados que mapeia) quando nenhum leitor o pode estar a usar.
+ * Quem lê o catálogo nunca espera pela recarga: fica com a versão que encontrou ao entrar.
+ * As salas guardam uma cópia do jogo, por isso um jogo a decorrer não depende do catálogo.
+ */
+
+#define CATALOG_INITIAL_CAPACITY 1024 // entries, doubled while the games file is read
+
+// loads never overlap: the startup, then the reload thread
+static int numVersions = 0;
+
+static int compareEntries(const void *a, const void *b) {
+    const CatalogEntry *entryA = (const CatalogEntry *)a;
+    const CatalogEntry *entryB = (const CatalogEntry *)b;
+    return (entryA->id > entryB->id) - (entryA->id < entryB->id);
+}
+
+// the catalog rates 9x9 boards only
+static bool readBoard(const GameRecord *record, char board[9][9]) {
+
+    if (record->boardSize != 9) {
+        return false;
+    }
+
+    for (int i = 0; i < 9; i++) {
+        memcpy(board[i], record->board[i], 9);
+    }
+
+    return true;
+}
+
+// rate games stored without a valid difficulty (unrated boards count as the hardest)
+static int validDifficulty(int difficulty, const char board[9][9]) {
+
+    if (difficulty >= 1 && difficulty <= CATALOG_DIFFICULTIES) {
+        return difficulty;
+    }
+
+    int rating = board != NULL ? ratePuzzle(board) : 0;
+    return rating > 0 ? rating : CATALOG_DIFFICULTIES;
+}
+
+// one array of entry indices per difficulty, for O(1) random picks
+static bool buildBuckets(GameCatalog *catalog) {
+
+    memset(catalog->bucketSizes, 0, sizeof(catalog->bucketSizes));
+
+    for (int i = 0; i < catalog->numGames; i++) {
+        catalog->bucketSizes[catalog->entries[i].difficulty]++;
+    }
+
+    for (int difficulty = 1; difficulty <= CATALOG_DIFFICULTIES; difficulty++) {
+        catalog->buckets[difficulty] = (int *)malloc(sizeof(int) * (catalog->bucketSizes[difficulty] > 0 ? catalog->bucketSizes[difficulty] : 1));
+        if (catalog->buckets[difficulty] == NULL) {
+            return false;
+        }
+        catalog->bucketSizes[difficulty] = 0;
+    }
+
+    for (int i = 0; i < catalog->numGames; i++) {
+        int difficulty = catalog->entries[i].difficulty;
+        catalog->buckets[difficulty][catalog->bucketSizes[difficulty]++] = i;
+    }
+
+    return true;
+}
+
+static GameCatalog *allocCatalog(int numGames) {
+
+    GameCatalog *catalog = (GameCatalog *)malloc(sizeof(GameCatalog));
+    if (catalog == NULL) {
+        return NULL;
+    }
+
+    catalog->numGames = 0;
+    catalog->gameDB = NULL;
+    catalog->version = 0;
+    memset(catalog->buckets, 0, sizeof(catalog->buckets));
+    catalog->entries = (CatalogEntry *)malloc(sizeof(CatalogEntry) * (numGames > 0 ? numGames : 1));
+
+    if (catalog->entries == NULL) {
+        free(catalog);
+        return NULL;
+    }
+
+    return catalog;
+}
+
+GameCatalog *loadCatalog(ServerConfig *config) {
+
+    GameCatalog *catalog;
+
+    // binary database: records are already sorted by id
+    if (config->gameDBPath[0] != '\0') {
+
+        // every version maps the file again, so a replaced database is picked up by the reload
+        GameDB *gameDB = (GameDB *)malloc(sizeof(GameDB));
+        if (gameDB == NULL || openGameDB(gameDB, config->gameDBPath) < 0) {
+            fprintf(stderr, "Couldn't open games database %s\n", config->gameDBPath);
+            free(gameDB);
+            return NULL;
+        }
+
+        catalog = allocCatalog(gameDB->numRecords);
+        if (catalog == NULL) {
+            closeGameDB(gameDB);
+            free(gameDB);
+            return NULL;
+        }
+        catalog->gameDB = gameDB;
+
+        for (int i = 0; i < gameDB->numRecords; i++) {
+
+            const GameDBRecord *record = &gameDB->records[i];
+            char board[9][9];
+
+            // databases written by gamedb-convert are already rated
+            bool isRated = record->difficulty >= 1 && record->difficulty <= CATALOG_DIFFICULTIES;
+            if (!isRated) {
+                unpackCells(record->board, board);
+            }
+
+            catalog->entries[i].id = record->id;
+            catalog->entries[i].difficulty = validDifficulty(record->difficulty, isRated ? NULL : (const char (*)[9])board);
+        }
+        catalog->numGames = gameDB->numRecords;
+
+        if (!buildBuckets(catalog)) {
+            freeCatalog(catalog);
+            return NULL;
+        }
+
+        catalog->version = ++numVersions;
+        return catalog;
+    }
+
+    // games file: read it one game at a time, never the whole tree
+    GameStream *stream = (GameStream *)malloc(sizeof(GameStream));
+    GameRecord *record = (GameRecord *)malloc(sizeof(GameRecord));
+    int capacity = CATALOG_INITIAL_CAPACITY;
+
+    catalog = allocCatalog(capacity);
+    if (stream == NULL || record == NULL || catalog == NULL) {
+        free(stream);
+        free(record);
+        freeCatalog(catalog);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&config->gamesFileMutex);
+
+    int result = GAME_STREAM_ERROR;
+
+    if (openGameStream(stream, config->gamePath)) {
+
+        while ((result = nextGameRecord(stream, record)) == GAME_STREAM_RECORD) {
+
+            if (catalog->numGames == capacity) {
+                CatalogEntry *entries = (CatalogEntry *)realloc(catalog->entries, sizeof(CatalogEntry) * capacity * 2);
+                if (entries == NULL) {
+                    result = GAME_STREAM_ERROR;
+                    break;
+                }
+                catalog->entries = entries;
+                capacity *= 2;
+            }
+
+            char board[9][9];
+            bool hasBoard = readBoard(record, board);
+
+            CatalogEntry *entry = &catalog->entries[catalog->numGames++];
+            entry->id = record->id;
+            entry->difficulty = validDifficulty(record->difficulty, hasBoard ? (const char (*)[9])board : NULL);
+        }
+
+        closeGameStream(stream);
+    }
+
+    pthread_mutex_unlock(&config->gamesFileMutex);
+
+    free(stream);
+    free(record);
+
+    if (result == GAME_STREAM_ERROR) {
+        freeCatalog(catalog);
+        return NULL;
+    }
+
+    // listings and lookups expect the catalog sorted by id
+    qsort(catalog->entries, catalog->numGames, sizeof(CatalogEntry), compareEntries);
+
+    if (!buildBuckets(catalog)) {
+        freeCatalog(catalog);
+        return NULL;
+    }
+
+    catalog->version = ++numVersions;
+    return catalog;
+}
+
+GameCatalog *enterCatalog(ServerConfig *config) {
+
+    // the epoch is announced before the pointer is read
+    epochEnter();
+    return atomic_load(&config->catalog);
+}
+
+void leaveCatalog(void) {
+    epochLeave();
+}
+
+static void retireCatalog(void *catalog) {
+    freeCatalog((GameCatalog *)catalog);
+}
+
+bool reloadCatalog(ServerConfig *config) {
+
+    // built off to the side: readers keep using the current version meanwhile
+    GameCatalog *catalog = loadCatalog(config);
+    if (catalog == NULL) {
+        produceLog(config, "can't reload the games catalog, keeping the current one", EVENT_GAME_NOT_LOAD, 0, 0);
+        return false;
+    }
+
+    GameCatalog *previous = atomic_exchange(&config->catalog, catalog);
+
+    // without a place in the retired list the old version is never freed, rather than freed too soon
+    if (!epochRetire(previous, retireCatalog)) {
+        produceLog(config, "can't allocate memory", MEMORY_ERROR, 0, 0);
+    }
+
+    char logMessage[100];
+    snprintf(logMessage, sizeof(logMessage), "Catalogo de jogos recarregado: versao %d, %d jogos", catalog->version, catalog->numGames);
+    produceLog(config, logMessage, EVENT_GAME_LOAD, 0, 0);
+
+    return true;
+}
+
+int pickCatalogGame(GameCatalog *catalog, int difficulty) {
+
+    if (difficulty >= 1 && difficulty <= CATALOG_DIFFICULTIES) {
+        if (catalog->bucketSizes[difficulty] == 0) {
+            return -1;
+        }
+        return catalog->entries[catalog->buckets[difficulty][rand() % catalog->bucketSizes[difficulty]]].id;
+    }
+
+    if (catalog->numGames == 0) {
+        return -1;
+    }
+
+    return catalog->entries[rand() % catalog->numGames].id;
+}
+
+void freeCatalog(GameCatalog *catalog) {
+
+    if (catalog == NULL) {
+        return;
+    }
+
+    for (int difficulty = 1; difficulty <= CATALOG_DIFFICULTIES; difficulty++) {
+        free(catalog->buckets[difficulty]);
+    }
+
+    if (catalog->gameDB != NULL) {
+        closeGameDB(catalog->gameDB);
+        free(catalog->gameDB);
+    }
+
+    free(catalog->entries);
+    free(catalog);
+}
@@ -0,0 +1,24 @@
+#ifndef SERVER_CATALOG_H
+#define SERVER_CATALOG_H
+
+#include "../config/config.h"
+
+// Constrói o índice do catálogo a partir da base de dados binária ou do ficheiro 'games.json'.
+GameCatalog *loadCatalog(ServerConfig *config);
+
+// Entra numa secção de leitura e devolve a versão publicada do catálogo, válida até leaveCatalog.
+GameCatalog *enterCatalog(ServerConfig *config);
+
+// Acaba a secção de leitura começada por enterCatalog.
+void leaveCatalog(void);
+
+// Constrói um catálogo novo e publica-o no lugar do atual, que é libertado quando já ninguém o lê.
+bool reloadCatalog(ServerConfig *config);
+
+// Escolhe um jogo aleatório com a dificuldade pedida (0 para qualquer); devolve -1 se não houver nenhum.
+int pickCatalogGame(GameCatalog *catalog, int difficulty);
+
+// Liberta o índice do catálogo.
+void freeCatalog(GameCatalog *catalog);
+
+#endif // SERVER_CATALOG_H
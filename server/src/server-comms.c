@@ -1,487 +1,572 @@
-#include <pthread.h>
-#include <sys/select.h>
-#include <time.h>
-#include "../../utils/parson/parson.h"
-#include "../../utils/network/network.h"
-#include "../../utils/logs/logs-common.h"
-#include "server-comms.h"
-#include "../logs/logs.h"
-
-
-static int nextClientID = 1;
-
-
-/**
- * Gera um ID de cliente único.
- *
- * @return Um ID de cliente único, incrementando o valor de `nextClientID`.
- *
- * @details Esta função usa uma variável global `nextClientID` para gerar IDs únicos para clientes.
- * Cada vez que a função é chamada, o valor de `nextClientID` é retornado e, em seguida, incrementado.
- * Isto garante que cada cliente receba um ID único e sequencial.
- */
-
-int generateUniqueClientId() {
-    return nextClientID++;
-}
-
-/**
- * Função que gere a comunicação com um cliente ligado ao servidor.
- *
- * @param arg Um pointer genérico (void *) que é convertido para um pointer `client`,
- * contendo as informações do cliente e a configuração do servidor.
- * @return Retorna NULL (a função é utilizada como um manipulador de threads, 
- * por isso o valor de retorno não é usado).
- *
- * @details Esta função faz o seguinte:
- * - Obtém os dados do cliente a partir do argumento `arg` e inicializa as variáveis necessárias.
- * - Recebe o pedido de ID do cliente, gera um ID único, e envia-o de volta ao cliente.
- * - Entra num ciclo principal onde recebe comandos do cliente e executa as ações correspondentes:
- *   - Criar um novo jogo single Client ou MultiPlayer.
- *   - Listar e selecionar jogos ou salas existentes.
- *   - Receber e enviar dados relacionados com o estado do jogo e ações do cliente.
- * - Gere a comunicação com o cliente, incluindo o envio e a receção de mensagens, 
- *   e regista eventos no ficheiro de log.
- * - Trata erros de forma apropriada, terminando a conexão e a thread se necessário.
- * - Fecha a ligação com o cliente, liberta a memória alocada e termina a execução da thread.
- */
-
-void *handleClient(void *arg) {
-
-    // Obter dados do cliente
-    client_data *data = (client_data *)arg;
-    Client *client = data->client;
-    ServerConfig *serverConfig = data->config;
-    int newSockfd = client->socket_fd;
-
-    // receber buffer do cliente
-    char buffer[BUFFER_SIZE];
-    memset(buffer, 0, sizeof(buffer));
-
-    Room *room;
-    int currentLine = 1;
-
-    //printf("A AGUARDAR POR PEDIDOS DO CLIENTE\n");
-
-    // receber premium status
-    if (recv(newSockfd, buffer, sizeof(buffer), 0) < 0) {
-        // erro ao receber status premium
-        err_dump(serverConfig, 0, client->clientID, "can't receive premium status", EVENT_MESSAGE_SERVER_NOT_RECEIVED);
-    } else if (strcmp(buffer, "premium") == 0) {
-        client->isPremium = true;
-    } else {
-        client->isPremium = false;
-    }
-
-    // send id to client
-    client->clientID = generateUniqueClientId();
-    sprintf(buffer, "%d", client->clientID);
-
-    if (send(newSockfd, buffer, strlen(buffer), 0) < 0) {
-        // erro ao enviar ID do jogador
-        err_dump(serverConfig, 0, 0, "can't send client ID", EVENT_MESSAGE_SERVER_NOT_SENT);
-    } else {
-        printf("ID atribuido ao novo cliente: %d (%s)\n", client->clientID, client->isPremium ? "premium" : "not premium");
-        produceLog(serverConfig, "Conexao estabelecida com um novo cliente", EVENT_CONNECTION_SERVER_ESTABLISHED, 0, client->clientID);
-    }
-    
-    bool continueLoop = true;
-
-    while (continueLoop) {
-
-        //printf("A aguardar por pedidos do cliente %d\n", client->clientID);
-
-        client->startAgain = false;
-        memset(buffer, 0, sizeof(buffer));
-
-        // Receber menu status
-        if (recv(newSockfd, buffer, sizeof(buffer), 0) < 0) {
-            // erro ao receber modo de jogo
-            err_dump(serverConfig, 0, client->clientID, "can't receive menu status", EVENT_MESSAGE_SERVER_NOT_RECEIVED);
-        } else {
-
-            //printf("BUFFER RECEBIDO: %s\n", buffer);
-            
-            // cliente quer ver as estatisticas
-            if(strcmp(buffer, "GET_STATS") == 0){
-
-                pthread_mutex_lock(&serverConfig->mutex);
-
-                sendRoomStatistics(serverConfig, client);
-                client->startAgain = true;
-
-                pthread_mutex_unlock(&serverConfig->mutex);
-
-            } else if (strcmp(buffer, "newSinglePlayerGame") == 0) {
-
-                pthread_mutex_lock(&serverConfig->mutex);
-
-                // criar novo jogo single player
-                room = createRoomAndGame(serverConfig, client, true, true, 0, 0);
-
-                pthread_mutex_unlock(&serverConfig->mutex);
-
-            } else if(strcmp(buffer, "newMultiPlayerGameReadersWriters") == 0) {
-
-                printf("Cliente %d solicitou um novo jogo rando multiplayer game com readers-writers\n", client->clientID);
-
-                // lock mutex
-                pthread_mutex_lock(&serverConfig->mutex);
-
-                room = createRoomAndGame(serverConfig, client, false, true, 0, 0);
-
-                // unlock mutex
-                pthread_mutex_unlock(&serverConfig->mutex);
-
-                // adicionar timer
-                handleTimer(serverConfig, room, client);
-
-            } else if (strcmp(buffer, "newMultiPlayerGameBarberShopStaticPriority") == 0) {
-
-                
-                pthread_mutex_lock(&serverConfig->mutex);
-
-                room = createRoomAndGame(serverConfig, client, false, true, 0, 1);
-
-                pthread_mutex_unlock(&serverConfig->mutex);
-
-                // adicionar timer
-                handleTimer(serverConfig, room, client);
-
-            } else if (strcmp(buffer, "newMultiPlayerGameBarberShopDynamicPriority") == 0) {
-
-                printf("Cliente %d solicitou um novo jogo rando multiplayer game com barber shop dynamic priority\n", client->clientID);
-
-                // lock mutex
-                pthread_mutex_lock(&serverConfig->mutex);
-
-                room = createRoomAndGame(serverConfig, client, false, true, 0, 2);
-
-                // unlock mutex
-                pthread_mutex_unlock(&serverConfig->mutex);
-
-                // adicionar timer
-                handleTimer(serverConfig, room, client);
-
-            } else if (strcmp(buffer, "newMultiPlayerGameBarberShopFIFO") == 0) {
-
-                printf("Cliente %d solicitou um novo jogo rando multiplayer game com barber shop fifo\n", client->clientID);
-
-                // lock mutex
-                pthread_mutex_lock(&serverConfig->mutex);
-
-                room = createRoomAndGame(serverConfig, client, false, true, 0, 3);
-
-                // unlock mutex
-                pthread_mutex_unlock(&serverConfig->mutex);
-
-                // adicionar timer
-                handleTimer(serverConfig, room, client);
-
-            } else if (strcmp(buffer, "selectSinglePlayerGames") == 0 || strcmp(buffer, "selectMultiPlayerGames") == 0) {
-
-                bool isSinglePlayer = strncmp(buffer, "selectSinglePlayerGames", strlen("selectSinglePlayerGames")) == 0;
-                // Receber jogos existentes
-                char buffer[BUFFER_SIZE];
-                memset(buffer, 0, sizeof(buffer));
-
-                // lock mutex
-                pthread_mutex_lock(&serverConfig->mutex);
-                // Obter jogos existentes
-                char *games = getGames(serverConfig);
-
-                //printf("Jogos existentes: %s\n", games);
-
-                // unlock mutex
-                pthread_mutex_unlock(&serverConfig->mutex);
-
-                bool leave = false;
-
-                while (!leave) {
-                    // Enviar jogos existentes ao cliente
-                    if (send(newSockfd, games, strlen(games), 0) < 0) {
-                        free(games);
-                        err_dump(serverConfig, 0, client->clientID, "can't send existing games to client", EVENT_MESSAGE_SERVER_NOT_SENT);
-                    } else {
-                        produceLog(serverConfig, "Jogos enviados para o cliente", EVENT_SERVER_GAMES_SENT, 0, client->clientID);
-                    }
-
-                    memset(buffer, 0, sizeof(buffer));
-
-                    // receber ID do jogo
-                    if (recv(newSockfd, buffer, sizeof(buffer), 0) < 0) {
-                        free(games);
-                        err_dump(serverConfig, 0, client->clientID, "can't receive game ID from client", EVENT_MESSAGE_SERVER_NOT_RECEIVED);
-                    } else if (atoi(buffer) == 0) {
-                        printf("Cliente %d voltou atras no menu\n", client->clientID);
-                        leave = true;
-                        client->startAgain = true;
-                    } else {
-                          printf("Cliente %d escolheu o jogo com o ID: %s\n", client->clientID, buffer);
-
-                        // obter ID do jogo
-                        int gameID = atoi(buffer);
-
-                        int synchronizationType;
-
-                        // need to receive synchronization type
-                        if (!isSinglePlayer) {
-
-                            // receive synchronization type
-                            memset(buffer, 0, sizeof(buffer));
-
-                            if (recv(newSockfd, buffer, sizeof(buffer), 0) < 0) {
-                                    err_dump(serverConfig, 0, client->clientID, "can't receive synchronization type from client", EVENT_MESSAGE_SERVER_NOT_RECEIVED);
-                            } else {
-                                //printf("BUFFER RECEBIDO PARA SYNCHRONIZATION TYPE: %s\n", buffer);
-                                if (strcmp(buffer, "newMultiPlayerGameReadersWriters") == 0) {
-                                    printf("Cliente %d escolheu o jogo com readers-writers\n", client->clientID);
-                                    synchronizationType = 0;
-                                } else if (strcmp(buffer, "newMultiPlayerGameBarberShopStaticPriority") == 0) {
-                                    printf("Cliente %d escolheu o jogo com barber shop priority\n", client->clientID);
-                                    synchronizationType = 1;
-                                } else if (strcmp(buffer, "newMultiPlayerGameBarberShopDynamicPriority") == 0) {
-                                    printf("Cliente %d escolheu o jogo com barber shop dynamic priority\n", client->clientID);
-                                    synchronizationType = 2;
-                                } else if (strcmp(buffer, "newMultiPlayerGameBarberShopFIFO") == 0) {
-                                    printf("Cliente %d escolheu o jogo com barber shop fifo\n", client->clientID);
-                                    synchronizationType = 3;
-                                } else if (strcmp(buffer, "0") == 0) {
-                                    printf("Cliente %d voltou atras no menu\n", client->clientID);
-                                    leave = true;
-                                    client->startAgain = true;
-                                    break;
-                                }
-                            }
-
-                            //printf("Synchronization type: %d\n", synchronizationType);
-                        }
-
-                        // lock mutex
-                        pthread_mutex_lock(&serverConfig->mutex);
-
-                        room = createRoomAndGame(serverConfig, client, isSinglePlayer, false, gameID, synchronizationType);
-
-                        // unlock mutex
-                        pthread_mutex_unlock(&serverConfig->mutex);
-
-                        if (!isSinglePlayer) {
-                            // adicionar timer
-                            handleTimer(serverConfig, room, client);
-                        }
-
-                        leave = true;
-                    }
-                }
-
-                free(games);
-                games = NULL;
-
-            } else if (strcmp(buffer, "existingRooms") == 0) {
-                  // Receber jogos existentes
-                char buffer[BUFFER_SIZE];
-                memset(buffer, 0, sizeof(buffer));
-                // Obter salas existentes
-
-                pthread_mutex_lock(&serverConfig->mutex);
-
-                char *rooms = getRooms(serverConfig);
-
-                //printf("Rooms existentes: %s\n", rooms);
-
-                pthread_mutex_unlock(&serverConfig->mutex);
-
-                bool leave = false;
-
-                while (!leave) {
-                    // Enviar salas existentes ao cliente
-                    if (send(newSockfd, rooms, strlen(rooms), 0) < 0) {
-                        free(rooms);
-                        err_dump(serverConfig, 0, client->clientID, "can't send existing games to client", EVENT_MESSAGE_SERVER_NOT_SENT);
-                    } else {
-                        produceLog(serverConfig, "Jogos enviados para o cliente", EVENT_SERVER_GAMES_SENT, 0, client->clientID);
-                    }
-                    //printf("RECEBER IDS DAS ROOMS\n");
-                    memset(buffer, 0, sizeof(buffer));
-
-                    // receber ID da sala
-                    if (recv(newSockfd, buffer, sizeof(buffer), 0) < 0) {
-                        free(rooms);
-                        err_dump(serverConfig, 0, client->clientID, "can't receive room ID from client", EVENT_MESSAGE_SERVER_NOT_RECEIVED);
-                    } else if (atoi(buffer) == 0) {
-                        printf("Cliente %d voltou atras no menu\n", client->clientID);
-                        leave = true;
-                        client->startAgain = true;
-                    } else {
-                        int roomID = atoi(buffer);
-
-                        //printf("ROOM ID NO SERVIDOR: %d\n", roomID);
-
-                        // lock mutex
-                        pthread_mutex_lock(&serverConfig->mutex);
-
-                        // get the room
-                        room = getRoom(serverConfig, roomID, client->clientID);
-
-                        // unlock mutex
-                        pthread_mutex_unlock(&serverConfig->mutex);
-
-                        // add the Client to the queue
-                        //printf("ENQUEING CLIENT %d which is %s\n", client->clientID, client->isPremium ? "premium" : "not premium");
-                        enqueueWithPriority(room->enterRoomQueue, client->clientID, client->isPremium);
-
-                        //printf("BEFORE SLEEP\n");
-
-                        // sleep thread for test
-                        sleep(5);
-
-                        //printf("AFTER SLEEP\n");
-
-                        // Join room all clients in queue
-                        pthread_mutex_lock(&room->mutex);
-
-
-                        for (int i = 0; i < room->maxClients * 2; i++) {
-
-                            if (room->enterRoomQueue->front == NULL) {
-                                break;
-
-                            } else {
-
-                                Client *clientTemp;
-
-                                int clientIDJoin = dequeue(room->enterRoomQueue);
-
-                                // get client socket
-                                for (int i = 0; i < serverConfig->numClientsOnline; i++) {
-                                    if (serverConfig->clients[i] != NULL && serverConfig->clients[i]->clientID == clientIDJoin) {
-                                        clientTemp = serverConfig->clients[i];
-                                        break;
-                                    }
-                                }
-
-                                // check if room is full so the client doesnt join
-                                //printf("CHECKING IF ROOM IS FULL FOR CLIENT %d\n", clientTemp->clientID);
-                                if (room->numClients >= room->maxClients) {
-                                    
-                                    // send message to client
-                                    if (send(clientTemp->socket_fd, "Room is full", strlen("Room is full"), 0) < 0) {
-                                        err_dump(serverConfig, 0, client->clientID, "can't send message to client", EVENT_MESSAGE_SERVER_NOT_SENT);
-                                    } else {
-                                        produceLog(serverConfig, "Room is full", EVENT_ROOM_NOT_JOIN, 0, clientTemp->clientID);
-                                    }
-
-                                    clientTemp->startAgain = true;
-
-                                } else {
-                                    
-                                    joinRoom(serverConfig, room, clientTemp);
-                                }
-                            }
-                        }
-
-                        pthread_mutex_unlock(&room->mutex);
-
-                        // atualizar tempo de espera para este Client
-                        handleTimer(serverConfig, room, client);
-
-                        leave = true;
- 
-                    }
-                }
-                //printf("Rooms pointer before free: %p\n", (void*)rooms);
-                free(rooms);
-                //rooms = NULL;
-
-            } else if (strcmp(buffer, "closeConnection") == 0) {
-                continueLoop = false;
-                break;
-            } else if (strcmp(buffer, "0") == 0) {
-                printf("Cliente %d voltou atras no menu\n", client->clientID);
-                client->startAgain = true;
-            }
-
-            if (!client->startAgain) {
-                room->isGameRunning = true;
-                room->startTime = time(NULL);
-
-                // barreira para começar o jogo
-                if (!room->isSinglePlayer) {//Se o jogo for multiplayer
-                    acquireTurnsTileSemaphore(room, client);//Garante que todas as threads estao prontas antes de avançar para a fase critica
-                }
-
-                // receber linhas do cliente
-                receiveLines(serverConfig, room, client, &currentLine);
-
-                if (!room->isSinglePlayer) {
-                    // barreira para terminar o jogo
-                    releaseTurnsTileSemaphore(room, client);
-                }
-
-                // mutex para terminar o jogo
-                pthread_mutex_lock(&serverConfig->mutex);
-                
-                // terminar o jogo
-                finishGame(serverConfig, room, &newSockfd);
-
-                // unlock mutex
-                pthread_mutex_unlock(&serverConfig->mutex);
-            }
-        }
-    }
-
-    // fechar a ligação com o cliente
-    close(newSockfd);
-    printf("Conexao terminada com o cliente %d\n", client->clientID);
-    produceLog(serverConfig, "Conexao terminada com o cliente", EVENT_SERVER_CONNECTION_FINISH, 0, client->clientID);
-
-    // libertar a memória alocada
-    removeClient(serverConfig, client);
-    free(data);
-
-    // terminar a thread
-    pthread_exit(NULL);
-}
-
-
-
-/**
- * Inicializa o socket do servidor, associando-o a um endereço e porta especificados na configuração.
- *
- * @param serv_addr Um pointer para a estrutura `sockaddr_in` que será preenchida com as informações do endereço do servidor.
- * @param sockfd Um pointer para o descritor de socket, que será inicializado e associado ao endereço.
- * @param config Um pointer para a estrutura `ServerConfig` que contém as configurações do servidor, incluindo a porta.
- *
- * @details Esta função faz o seguinte:
- * - Cria um socket do tipo `SOCK_STREAM` para comunicações baseadas em TCP.
- * - Limpa a estrutura do socket com `memset` para garantir que todos os campos são inicializados corretamente.
- * - Preenche a estrutura do socket com a família de endereços `AF_INET`, 
- *   o endereço `INADDR_ANY` (para aceitar conexões de qualquer endereço) e a porta especificada na configuração do servidor.
- * - Usa `bind` para associar o socket ao endereço e porta definidos. Se a operação falhar, 
- *   a função regista um erro no log e termina o programa.
- * - Coloca o socket em modo de escuta com a função `listen`, permitindo que o servidor aceite conexões.
- */
-
-void initializeSocket(struct sockaddr_in *serv_addr, int *sockfd, ServerConfig *config) {
-
-    // Criar socket
-    if ((*sockfd = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
-        err_dump(config, 0, 0, "can't open stream socket", EVENT_CONNECTION_SERVER_ERROR);
-    }
-
-    // Limpar a estrutura do socket
-    memset((char *) serv_addr, 0, sizeof(*serv_addr));
-
-    // Preencher a estrutura do socket
-    serv_addr->sin_family = AF_INET;
-    serv_addr->sin_addr.s_addr = htonl(INADDR_ANY);
-    serv_addr->sin_port = htons(config->serverPort);
-
-    // Associar o socket a um endereco qualquer
-    if (bind(*sockfd, (struct sockaddr *)serv_addr, sizeof(*serv_addr)) < 0) {
-        err_dump(config, 0, 0, "can't bind local address", EVENT_CONNECTION_SERVER_ERROR);
-    }
-
-    // Ouvir o socket
-    listen(*sockfd, 1);
-}
+#include <pthread.h>
+#include <sys/select.h>
+#include <time.h>
+#include "../../utils/parson/parson.h"
+#include "../../utils/network/network.h"
+#include "../../utils/logs/logs-common.h"
+#include "server-comms.h"
+#include "server-leaderboard.h"
+#include "server-mux.h"
+#include "server-spectators.h"
+#include "server-sessions.h"
+#include "server-snapshot.h"
+#include "server-wal.h"
+#include "server-admission.h"
+#include "../logs/logs.h"
+
+
+static int nextClientID = 1;
+static pthread_mutex_t nextClientIDMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+/**
+ * Gera um ID de cliente único.
+ *
+ * @return Um ID de cliente único, incrementando o valor de `nextClientID`.
+ *
+ * @details Esta função usa uma variável global `nextClientID` para gerar IDs únicos para clientes.
+ * Cada vez que a função é chamada, o valor de `nextClientID` é retornado e, em seguida, incrementado.
+ * Isto garante que cada cliente receba um ID único e sequencial.
+ */
+
+int generateUniqueClientId() {
+    pthread_mutex_lock(&nextClientIDMutex);
+    int id = nextClientID++;
+    pthread_mutex_unlock(&nextClientIDMutex);
+    return id;
+}
+
+void reserveClientIds(int lastClientID) {
+    pthread_mutex_lock(&nextClientIDMutex);
+    if (nextClientID <= lastClientID) {
+        nextClientID = lastClientID + 1;
+    }
+    pthread_mutex_unlock(&nextClientIDMutex);
+}
+
+/**
+ * Começa a sessão de um cliente acabado de ligar ao servidor.
+ *
+ * @param serverConfig Um pointer para a estrutura `ServerConfig` com a configuração do servidor.
+ * @param client Um pointer para o cliente, já na lista de clientes online.
+ * @return `SESSION_CONTINUE` se o cliente fica à espera do menu (ou da próxima linha de uma sala restaurada),
+ * `SESSION_CLOSED` se a ligação acabou, ou `SESSION_HANDED_OVER` se o socket passou para a sessão que o
+ * cliente retomou.
+ *
+ * @details Esta função faz o seguinte:
+ * - Recebe o estado premium do cliente, ou o pedido "resume <token>" de um cliente que perdeu a ligação.
+ * - Se o cliente retoma uma sessão, entrega o socket ao cliente que espera por ele, que volta para a fila
+ *   dos workers, e retira este cliente provisório da lista; se retoma um lugar numa sala restaurada, o
+ *   resto desse jogo continua nos passos seguintes da sessão.
+ * - Caso contrário, decide se o cliente é admitido, gera um ID único e envia-o com o token da sessão.
+ */
+
+SessionStatus openClientSession(ServerConfig *serverConfig, Client *client) {
+
+    // receber buffer do cliente
+    char buffer[BUFFER_SIZE];
+    memset(buffer, 0, sizeof(buffer));
+
+    bool continueLoop = true;
+
+    // receber premium status, ou o pedido para retomar uma sessão
+    if (recv(client->socket_fd, buffer, sizeof(buffer) - 1, 0) <= 0) {
+        // a ligação caiu antes de começar
+        produceLog(serverConfig, "can't receive premium status", EVENT_MESSAGE_SERVER_NOT_RECEIVED, 0, 0);
+        continueLoop = false;
+
+    } else if (strncmp(buffer, "resume ", strlen("resume ")) == 0) {
+
+        // resume <token>: esta ligação passa para o cliente que ficou à espera do jogador
+        char token[SESSION_TOKEN_SIZE];
+        memset(token, 0, sizeof(token));
+        sscanf(buffer, "resume %32s", token);
+
+        if (resumeSession(serverConfig, token, client->socket_fd)) {
+            // the socket now belongs to the resumed client, only this placeholder goes away
+            removeClient(serverConfig, client);
+            return SESSION_HANDED_OVER;
+        }
+
+        // a room saved by the previous run of the server: this session plays the rest of the game
+        Room *room = claimRestoredSeat(serverConfig, client, token);
+
+        if (room == NULL) {
+            send(client->socket_fd, "EXPIRED\n", strlen("EXPIRED\n"), 0);
+            continueLoop = false;
+        } else {
+            sprintf(buffer, "RESUMED %d\n", client->clientID);
+            if (writen(client->socket_fd, buffer, strlen(buffer)) < 0) {
+                // the drop shows up on the next recv, where the player can resume again
+                produceLog(serverConfig, "can't send resume reply to client", EVENT_MESSAGE_SERVER_NOT_SENT, 0, client->clientID);
+            }
+
+            return playRestoredRoom(serverConfig, room, client);
+        }
+
+    } else {
+
+        client->isPremium = strcmp(buffer, "premium") == 0;
+
+        // send id to client, with the token that resumes the session if the connection drops
+        char token[SESSION_TOKEN_SIZE];
+        int retryAfter = 0;
+
+        if (!admitSession(serverConfig, client, &retryAfter)) {
+
+            // sobrecarga: recusar já, antes de gastar um ID ou uma sessão
+            sprintf(buffer, "BUSY %d\n", retryAfter);
+            send(client->socket_fd, buffer, strlen(buffer), 0);
+            continueLoop = false;
+
+        } else {
+
+            client->clientID = generateUniqueClientId();
+
+            if (createSession(serverConfig, client, token)) {
+                sprintf(buffer, "%d %s", client->clientID, token);
+            } else {
+                sprintf(buffer, "%d", client->clientID);
+            }
+
+            if (send(client->socket_fd, buffer, strlen(buffer), 0) < 0) {
+                // erro ao enviar ID do jogador
+                produceLog(serverConfig, "can't send client ID", EVENT_MESSAGE_SERVER_NOT_SENT, 0, client->clientID);
+                continueLoop = false;
+            } else {
+                printf("ID atribuido ao novo cliente: %d (%s)\n", client->clientID, client->isPremium ? "premium" : "not premium");
+                produceLog(serverConfig, "Conexao estabelecida com um novo cliente", EVENT_CONNECTION_SERVER_ESTABLISHED, 0, client->clientID);
+            }
+        }
+    }
+
+    client->step = STEP_MENU;
+    return continueLoop ? SESSION_CONTINUE : SESSION_CLOSED;
+}
+
+/**
+ * Entrega a ligação de um cliente novo à sessão que ele retoma, sem passar por um worker.
+ *
+ * @param serverConfig Um pointer para a estrutura `ServerConfig` com a configuração do servidor.
+ * @param client Um pointer para o cliente provisório da ligação, cujo socket já tem a primeira mensagem para ler.
+ * @return `true` se o socket passou para a sessão retomada (o cliente provisório já foi retirado da lista).
+ *
+ * @details Esta função faz o seguinte:
+ * - Espreita a primeira mensagem sem a tirar do socket; se não é "resume <token>" de uma sessão à espera
+ *   (um cliente novo, ou o lugar de uma sala restaurada), não faz nada e `openClientSession` trata-a.
+ * - Caso contrário, lê a mensagem e responde "RESUMED <id>" com `resumeSession`, que volta a pôr o
+ *   jogador na fila dos workers. O jogo dele está parado desde que a ligação caiu, por isso o pedido
+ *   que o acorda não fica atrás dos pedidos do menu à espera de um worker livre.
+ * - Se a sessão expirou entretanto (ou a ligação caiu), responde "EXPIRED" e fecha a ligação.
+ */
+
+bool handOverResume(ServerConfig *serverConfig, Client *client) {
+
+    char buffer[BUFFER_SIZE];
+    memset(buffer, 0, sizeof(buffer));
+
+    ssize_t length = recv(client->socket_fd, buffer, sizeof(buffer) - 1, MSG_PEEK | MSG_DONTWAIT);
+    if (length <= 0 || strncmp(buffer, "resume ", strlen("resume ")) != 0) {
+        return false;
+    }
+
+    char token[SESSION_TOKEN_SIZE];
+    memset(token, 0, sizeof(token));
+    sscanf(buffer, "resume %32s", token);
+
+    if (!isSessionDetached(token)) {
+        return false;
+    }
+
+    // the request leaves the socket before the game can read from it
+    if (recv(client->socket_fd, buffer, length, MSG_DONTWAIT) != length || !resumeSession(serverConfig, token, client->socket_fd)) {
+        send(client->socket_fd, "EXPIRED\n", strlen("EXPIRED\n"), MSG_DONTWAIT | MSG_NOSIGNAL);
+        closeClientSession(serverConfig, client);
+        return true;
+    }
+
+    // the socket now belongs to the resumed client, only this placeholder goes away
+    removeClient(serverConfig, client);
+    return true;
+}
+
+// the next menu request: the bytes a multiplexed session left behind come first, as if one recv had returned them
+static ssize_t receiveMenuRequest(Client *client, char *buffer, size_t size) {
+
+    if (client->pendingLength == 0) {
+        return recv(client->socket_fd, buffer, size, 0);
+    }
+
+    int length = client->pendingLength < (int)size - 1 ? client->pendingLength : (int)size - 1;
+    memcpy(buffer, client->pending, length);
+    buffer[length] = '\0';
+
+    client->pendingLength -= length;
+    memmove(client->pending, client->pending + length, client->pendingLength);
+
+    return length;
+}
+
+/**
+ * Função que trata um pedido do menu de um cliente ligado ao servidor.
+ *
+ * @param serverConfig Um pointer para a estrutura `ServerConfig` com a configuração do servidor.
+ * @param client Um pointer para o cliente, cujo socket já tem um pedido para ler.
+ * @return `SESSION_CONTINUE` se o cliente fica à espera da próxima mensagem, `SESSION_HELD` se espera
+ * por um temporizador ou pela sala, ou `SESSION_CLOSED` se a ligação acabou.
+ *
+ * @details Esta função faz o seguinte:
+ * - Recebe um comando do cliente e executa a ação correspondente:
+ *   - Criar um novo jogo single Client ou MultiPlayer.
+ *   - Listar e selecionar jogos ou salas existentes.
+ *   - Receber e enviar dados relacionados com o estado do jogo e ações do cliente.
+ * - Um jogo começado por este pedido não é jogado aqui: a contagem decrescente, a espera para entrar
+ *   numa sala e cada linha são passos seguintes da sessão, tratados por `playGameStep` quando chegar
+ *   a sua vez, e o worker volta logo para o pool.
+ * - Gere a comunicação com o cliente, incluindo o envio e a receção de mensagens, 
+ *   e regista eventos no ficheiro de log.
+ * - Trata erros de forma apropriada, indicando que a ligação deve ser fechada.
+ */
+
+SessionStatus serveClientRequest(ServerConfig *serverConfig, Client *client) {
+
+    // receber buffer do cliente
+    char buffer[BUFFER_SIZE];
+
+    Room *room = NULL;
+
+    bool continueLoop = true;
+
+    //printf("A aguardar por pedidos do cliente %d\n", client->clientID);
+
+    client->startAgain = false;
+    memset(buffer, 0, sizeof(buffer));
+
+    // Receber menu status
+    if (receiveMenuRequest(client, buffer, sizeof(buffer)) <= 0) {
+        // a ligação foi fechada fora de um jogo: não há nada para retomar
+        produceLog(serverConfig, "can't receive menu status", EVENT_MESSAGE_SERVER_NOT_RECEIVED, 0, client->clientID);
+        continueLoop = false;
+    } else {
+
+        //printf("BUFFER RECEBIDO: %s\n", buffer);
+        
+        // cliente quer ver as estatisticas
+        if(strncmp(buffer, "GET_STATS", strlen("GET_STATS")) == 0){
+
+            // GET_STATS [gameID]
+            int gameID = 0;
+            sscanf(buffer, "GET_STATS %d", &gameID);
+            sendStatistics(serverConfig, client, gameID);
+            client->startAgain = true;
+
+        } else if (strncmp(buffer, "GET_LEADERBOARD", strlen("GET_LEADERBOARD")) == 0) {
+
+            // GET_LEADERBOARD <gameID>
+            int gameID = 0;
+            sscanf(buffer, "GET_LEADERBOARD %d", &gameID);
+            sendLeaderboard(serverConfig, client, gameID);
+            client->startAgain = true;
+
+        } else if (strncmp(buffer, "GET_PLAYER_BESTS", strlen("GET_PLAYER_BESTS")) == 0) {
+
+            // GET_PLAYER_BESTS [playerID], by default the client itself
+            int playerID = client->clientID;
+            sscanf(buffer, "GET_PLAYER_BESTS %d", &playerID);
+            sendPlayerBests(serverConfig, client, playerID);
+            client->startAgain = true;
+
+        } else if (strncmp(buffer, "newSinglePlayerGame", strlen("newSinglePlayerGame")) == 0) {
+
+            // criar novo jogo single player, opcionalmente com a dificuldade pedida
+            int difficulty = 0;
+            sscanf(buffer, "newSinglePlayerGame %d", &difficulty);
+            if (difficulty < 0 || difficulty > CATALOG_DIFFICULTIES) {
+                difficulty = 0;
+            }
+
+            room = createRoomAndGame(serverConfig, client, true, true, 0, 0, difficulty);
+
+        } else if(strcmp(buffer, "newMultiPlayerGameReadersWriters") == 0) {
+
+            printf("Cliente %d solicitou um novo jogo rando multiplayer game com readers-writers\n", client->clientID);
+
+            room = createRoomAndGame(serverConfig, client, false, true, 0, 0, 0);
+
+        } else if (strcmp(buffer, "newMultiPlayerGameBarberShopStaticPriority") == 0) {
+
+            
+            room = createRoomAndGame(serverConfig, client, false, true, 0, 1, 0);
+
+        } else if (strcmp(buffer, "newMultiPlayerGameBarberShopDynamicPriority") == 0) {
+
+            printf("Cliente %d solicitou um novo jogo rando multiplayer game com barber shop dynamic priority\n", client->clientID);
+
+            room = createRoomAndGame(serverConfig, client, false, true, 0, 2, 0);
+
+        } else if (strcmp(buffer, "newMultiPlayerGameBarberShopFIFO") == 0) {
+
+            printf("Cliente %d solicitou um novo jogo rando multiplayer game com barber shop fifo\n", client->clientID);
+
+            room = createRoomAndGame(serverConfig, client, false, true, 0, 3, 0);
+
+        } else if (strcmp(buffer, "selectSinglePlayerGames") == 0 || strcmp(buffer, "selectMultiPlayerGames") == 0) {
+
+            bool isSinglePlayer = strncmp(buffer, "selectSinglePlayerGames", strlen("selectSinglePlayerGames")) == 0;
+            // Receber jogos existentes
+            char buffer[BUFFER_SIZE];
+            memset(buffer, 0, sizeof(buffer));
+
+            // Enviar a primeira página de jogos
+            sendGamesPage(serverConfig, client, 0, LISTING_PAGE_SIZE, 0);
+
+            bool leave = false;
+
+            while (!leave) {
+
+                memset(buffer, 0, sizeof(buffer));
+
+                // receber ID do jogo ou pedido de outra página
+                if (recv(client->socket_fd, buffer, sizeof(buffer), 0) <= 0) {
+                    // back to the main loop, which ends the connection
+                    produceLog(serverConfig, "can't receive game ID from client", EVENT_MESSAGE_SERVER_NOT_RECEIVED, 0, client->clientID);
+                    leave = true;
+                    client->startAgain = true;
+                } else if (strncmp(buffer, "LIST", strlen("LIST")) == 0) {
+
+                    // LIST <offset> <limit> <difficulty>
+                    int offset = 0, limit = LISTING_PAGE_SIZE, difficulty = 0;
+                    sscanf(buffer, "LIST %d %d %d", &offset, &limit, &difficulty);
+                    sendGamesPage(serverConfig, client, offset, limit, difficulty);
+
+                } else if (atoi(buffer) == 0) {
+                    printf("Cliente %d voltou atras no menu\n", client->clientID);
+                    leave = true;
+                    client->startAgain = true;
+                } else {
+                      printf("Cliente %d escolheu o jogo com o ID: %s\n", client->clientID, buffer);
+
+                    // obter ID do jogo
+                    int gameID = atoi(buffer);
+
+                    int synchronizationType;
+
+                    // need to receive synchronization type
+                    if (!isSinglePlayer) {
+
+                        // receive synchronization type
+                        memset(buffer, 0, sizeof(buffer));
+
+                        if (recv(client->socket_fd, buffer, sizeof(buffer), 0) <= 0) {
+                            produceLog(serverConfig, "can't receive synchronization type from client", EVENT_MESSAGE_SERVER_NOT_RECEIVED, 0, client->clientID);
+                            leave = true;
+                            client->startAgain = true;
+                            break;
+                        } else {
+                            //printf("BUFFER RECEBIDO PARA SYNCHRONIZATION TYPE: %s\n", buffer);
+                            if (strcmp(buffer, "newMultiPlayerGameReadersWriters") == 0) {
+                                printf("Cliente %d escolheu o jogo com readers-writers\n", client->clientID);
+                                synchronizationType = 0;
+                            } else if (strcmp(buffer, "newMultiPlayerGameBarberShopStaticPriority") == 0) {
+                                printf("Cliente %d escolheu o jogo com barber shop priority\n", client->clientID);
+                                synchronizationType = 1;
+                            } else if (strcmp(buffer, "newMultiPlayerGameBarberShopDynamicPriority") == 0) {
+                                printf("Cliente %d escolheu o jogo com barber shop dynamic priority\n", client->clientID);
+                                synchronizationType = 2;
+                            } else if (strcmp(buffer, "newMultiPlayerGameBarberShopFIFO") == 0) {
+                                printf("Cliente %d escolheu o jogo com barber shop fifo\n", client->clientID);
+                                synchronizationType = 3;
+                            } else if (strcmp(buffer, "0") == 0) {
+                                printf("Cliente %d voltou atras no menu\n", client->clientID);
+                                leave = true;
+                                client->startAgain = true;
+                                break;
+                            }
+                        }
+
+                        //printf("Synchronization type: %d\n", synchronizationType);
+                    }
+
+                    room = createRoomAndGame(serverConfig, client, isSinglePlayer, false, gameID, synchronizationType, 0);
+
+                    if (room == NULL) {
+                        client->startAgain = true;
+                    }
+
+                    leave = true;
+                }
+            }
+
+        } else if (strcmp(buffer, "existingRooms") == 0) {
+              // Receber jogos existentes
+            char buffer[BUFFER_SIZE];
+            memset(buffer, 0, sizeof(buffer));
+            // Enviar a primeira página de salas
+            sendRoomsPage(serverConfig, client, 0, LISTING_PAGE_SIZE, -1, 0);
+
+            bool leave = false;
+
+            while (!leave) {
+
+                memset(buffer, 0, sizeof(buffer));
+
+                // receber ID da sala ou pedido de outra página
+                if (recv(client->socket_fd, buffer, sizeof(buffer), 0) <= 0) {
+                    produceLog(serverConfig, "can't receive room ID from client", EVENT_MESSAGE_SERVER_NOT_RECEIVED, 0, client->clientID);
+                    leave = true;
+                    client->startAgain = true;
+                } else if (strncmp(buffer, "LIST", strlen("LIST")) == 0) {
+
+                    // LIST <offset> <limit> <synchronizationType> <minOpenSlots>
+                    int offset = 0, limit = LISTING_PAGE_SIZE, synchronizationType = -1, minOpenSlots = 0;
+                    sscanf(buffer, "LIST %d %d %d %d", &offset, &limit, &synchronizationType, &minOpenSlots);
+                    sendRoomsPage(serverConfig, client, offset, limit, synchronizationType, minOpenSlots);
+
+                } else if (atoi(buffer) == 0) {
+                    printf("Cliente %d voltou atras no menu\n", client->clientID);
+                    leave = true;
+                    client->startAgain = true;
+                } else {
+                    int roomID = atoi(buffer);
+
+                    //printf("ROOM ID NO SERVIDOR: %d\n", roomID);
+
+                    // get the room (holding a reference to it)
+                    room = getRoom(serverConfig, roomID, client->clientID);
+
+                    if (room == NULL || room->isSinglePlayer) {
+                        // room no longer exists
+                        if (room != NULL) {
+                            releaseRoom(serverConfig, room);
+                        }
+                        if (send(client->socket_fd, "Room is full", strlen("Room is full"), 0) < 0) {
+                            err_dump(serverConfig, 0, client->clientID, "can't send message to client", EVENT_MESSAGE_SERVER_NOT_SENT);
+                        }
+                        client->startAgain = true;
+                        leave = true;
+                        continue;
+                    }
+
+                    // the seat is decided when the join delay is over, without holding this worker
+                    return waitToJoinRoom(serverConfig, room, client);
+                }
+            }
+
+        } else if (strncmp(buffer, "spectateRoom", strlen("spectateRoom")) == 0) {
+
+            // ver uma sala sem ocupar um lugar: spectateRoom <roomID>
+            int roomID = 0;
+            sscanf(buffer, "spectateRoom %d", &roomID);
+            return spectateRoom(serverConfig, client, roomID);
+
+        } else if (strcmp(buffer, "MUX") == 0) {
+
+            // vários jogos single player nesta ligação, até o cliente enviar "END"
+            return startMultiplexedSessions(serverConfig, client);
+
+        } else if (strcmp(buffer, "closeConnection") == 0) {
+            return SESSION_CLOSED;
+        } else if (strcmp(buffer, "0") == 0) {
+            printf("Cliente %d voltou atras no menu\n", client->clientID);
+            client->startAgain = true;
+        }
+
+        if (!client->startAgain && room == NULL) {
+            // no room was created (server full)
+            client->startAgain = true;
+        }
+
+        if (!client->startAgain) {
+            // o jogo continua nos passos seguintes da sessão, um de cada vez
+            return startGame(serverConfig, room, client);
+        }
+    }
+
+    return continueLoop ? SESSION_CONTINUE : SESSION_CLOSED;
+}
+
+SessionStatus serveSessionStep(ServerConfig *serverConfig, Client *client) {
+
+    switch (client->step) {
+
+        case STEP_OPEN:
+            return openClientSession(serverConfig, client);
+
+        case STEP_MENU:
+            return serveClientRequest(serverConfig, client);
+
+        case STEP_MUX:
+            return serveMultiplexedRequests(serverConfig, client);
+
+        default:
+            return playGameStep(serverConfig, client);
+    }
+}
+
+void closeClientSession(ServerConfig *serverConfig, Client *client) {
+
+    // fechar a ligação com o cliente (não há socket se a sessão expirou)
+    if (client->socket_fd >= 0) {
+        close(client->socket_fd);
+    }
+    endSession(serverConfig, client);
+    printf("Conexao terminada com o cliente %d\n", client->clientID);
+    produceLog(serverConfig, "Conexao terminada com o cliente", EVENT_SERVER_CONNECTION_FINISH, 0, client->clientID);
+
+    // libertar a memória alocada
+    removeClient(serverConfig, client);
+}
+
+
+
+/**
+ * Inicializa o socket do servidor, associando-o a um endereço e porta especificados na configuração.
+ *
+ * @param serv_addr Um pointer para a estrutura `sockaddr_in` que será preenchida com as informações do endereço do servidor.
+ * @param sockfd Um pointer para o descritor de socket, que será inicializado e associado ao endereço.
+ * @param config Um pointer para a estrutura `ServerConfig` que contém as configurações do servidor, incluindo a porta.
+ *
+ * @details Esta função faz o seguinte:
+ * - Cria um socket do tipo `SOCK_STREAM` para comunicações baseadas em TCP.
+ * - Limpa a estrutura do socket com `memset` para garantir que todos os campos são inicializados corretamente.
+ * - Preenche a estrutura do socket com a família de endereços `AF_INET`, 
+ *   o endereço `INADDR_ANY` (para aceitar conexões de qualquer endereço) e a porta especificada na configuração do servidor.
+ * - Usa `bind` para associar o socket ao endereço e porta definidos. Se a operação falhar, 
+ *   a função regista um erro no log e termina o programa.
+ * - Coloca o socket em modo de escuta com a função `listen`, permitindo que o servidor aceite conexões.
+ */
+
+void initializeSocket(struct sockaddr_in *serv_addr, int *sockfd, ServerConfig *config) {
+
+    // Criar socket
+    if ((*sockfd = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
+        err_dump(config, 0, 0, "can't open stream socket", EVENT_CONNECTION_SERVER_ERROR);
+    }
+
+    // a restart binds again right away, even with connections of the previous run in TIME_WAIT
+    int reuse = 1;
+    setsockopt(*sockfd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    // one listening socket per acceptor thread on the same port: the kernel spreads the connections
+    if (config->acceptorThreads > 1 && setsockopt(*sockfd, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse)) < 0) {
+        err_dump(config, 0, 0, "can't share the port between acceptors", EVENT_CONNECTION_SERVER_ERROR);
+    }
+
+    // Limpar a estrutura do socket
+    memset((char *) serv_addr, 0, sizeof(*serv_addr));
+
+    // Preencher a estrutura do socket
+    serv_addr->sin_family = AF_INET;
+    serv_addr->sin_addr.s_addr = htonl(INADDR_ANY);
+    serv_addr->sin_port = htons(config->serverPort);
+
+    // Associar o socket a um endereco qualquer
+    if (bind(*sockfd, (struct sockaddr *)serv_addr, sizeof(*serv_addr)) < 0) {
+        err_dump(config, 0, 0, "can't bind local address", EVENT_CONNECTION_SERVER_ERROR);
+    }
+
+    // Ouvir o socket: the backlog absorbs bursts of connections while the accept loop sheds the excess
+    if (listen(*sockfd, config->listenBacklog) < 0) {
+        err_dump(config, 0, 0, "can't listen on local address", EVENT_CONNECTION_SERVER_ERROR);
+    }
+}
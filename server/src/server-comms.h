@@ -1,16 +1,32 @@
-#ifndef SERVER_COMMS_H
-#define SERVER_COMMS_H
-
-#include <stdbool.h>
-#include "server-game.h"
-
-// Gera um ID único para um cliente.
-int generateUniqueClientId();
-
-// Função para lidar com a comunicação com um cliente.
-void *handleClient(void *arg);
-
-// Inicializa o socket do servidor e associa-o a um endereço.
-void initializeSocket(struct sockaddr_in *serv_addr, int *sockfd, ServerConfig *config);
-
+#ifndef SERVER_COMMS_H
+#define SERVER_COMMS_H
+
+#include <stdbool.h>
+#include "../../utils/network/network.h"
+#include "server-game.h"
+
+// Gera um ID único para um cliente.
+int generateUniqueClientId();
+
+// Garante que os próximos IDs de clientes são maiores do que este (IDs de jogadores restaurados).
+void reserveClientIds(int lastClientID);
+
+// Recebe o estado premium (ou "resume <token>") de um cliente novo e responde com o ID.
+SessionStatus openClientSession(ServerConfig *config, Client *client);
+
+// Se o cliente novo pediu "resume <token>" de uma sessão à espera, entrega-lhe o socket sem esperar por um worker.
+bool handOverResume(ServerConfig *config, Client *client);
+
+// Recebe e trata um pedido do menu de um cliente (um jogo começado continua nos passos seguintes da sessão).
+SessionStatus serveClientRequest(ServerConfig *config, Client *client);
+
+// Trata o próximo passo da sessão de um cliente, consoante `client->step`.
+SessionStatus serveSessionStep(ServerConfig *config, Client *client);
+
+// Fecha a ligação e a sessão de um cliente e retira-o da lista de clientes online.
+void closeClientSession(ServerConfig *config, Client *client);
+
+// Inicializa o socket do servidor e associa-o a um endereço.
+void initializeSocket(struct sockaddr_in *serv_addr, int *sockfd, ServerConfig *config);
+
 #endif
\ No newline at end of file
@@ -1,1161 +1,1588 @@
-#include <stdio.h>  // Usar FILE, fopen(), fclose()
-#include <stdlib.h> 
-#include <string.h> // Usar strings (strcpy(), strcmp())
-#include <time.h>   // Usar time()
-#include <stdbool.h> // Usar bool
-#include <pthread.h>
-#include <unistd.h>
-#include "../../utils/logs/logs-common.h"
-#include "../../utils/parson/parson.h"
-#include "../../utils/network/network.h"
-#include "server-game.h"
-#include "../logs/logs.h"
-
-static int nextRoomID = 1;
-
-/**
- * Gera um identificador único para uma nova sala de jogo.
- *
- * @return Um identificador único para a sala, incrementando o valor de `nextRoomID`.
- *
- * @details Esta função utiliza uma variável estática `nextRoomID` para gerar IDs únicos 
- * e sequenciais para as salas de jogo.
- * Cada vez que a função é chamada, o valor de `nextRoomID` é retornado e, em seguida, incrementado,
- * garantindo que cada sala criada tenha um ID exclusivo.
- */
-
-int generateUniqueId() {
-    return nextRoomID++;
-}
-
-/**
- * Carrega um jogo a partir do ficheiro 'games.json' com base no ID do jogo.
- *
- * @param config Um pointer para a estrutura `ServerConfig` que contém o caminho 
- * para o ficheiro 'games.json' e o ficheiro de log.
- * @param gameID O identificador do jogo que se pretende carregar.
- * @param playerID O identificador do jogador que está a tentar carregar o jogo, 
- * usado para o registo no log.
- * @return Um pointer para a estrutura `Game` carregada, ou NULL se o jogo não for encontrado ou ocorrer um erro.
- *
- * @details Esta função faz o seguinte:
- * - Aloca memória para a estrutura `Game` e inicializa-a a zeros.
- * - Abre o ficheiro 'games.json' e lê o seu conteúdo. Se ocorrer um erro, regista-o no log e devolve NULL.
- * - Faz o parse do conteúdo JSON e percorre o array de jogos para encontrar o jogo com o ID correspondente.
- * - Se o jogo for encontrado, preenche o tabuleiro (`board`) e a solução (`solution`) na estrutura `Game`.
- * - Regista o carregamento bem-sucedido no log e devolve o pointer para o jogo.
- * - Se o jogo não for encontrado, regista o erro no log, imprime uma mensagem de erro no terminal, e devolve NULL.
- * - Liberta a memória alocada para o conteúdo JSON e a estrutura `Game` em caso de falha.
- */
-
-Game *loadGame(ServerConfig *config, int gameID, int playerID) {
-
-    Game *game = (Game *)malloc(sizeof(Game));
-    if (game == NULL) {
-        fprintf(stderr, "Memory allocation failed\n");
-        return NULL;
-    }
-    memset(game, 0, sizeof(Game));  // Initialize game struct
-
-    FILE *file = fopen(config->gamePath, "r");
-
-    if (file == NULL) {
-        produceLog(config, "Erro ao abrir o ficheiro de jogos.", EVENT_GAME_NOT_LOAD, gameID, playerID);
-        free(game);  // Free allocated memory before exiting
-        return NULL;
-    }
-
-    // Ler o ficheiro JSON
-    fseek(file, 0, SEEK_END);
-    long file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
-
-    char *file_content = malloc(file_size + 1);
-    if (file_content == NULL) {
-        fclose(file);
-        fprintf(stderr, "Memory allocation failed\n");
-        return NULL;
-    }
-
-    fread(file_content, 1, file_size, file);
-    file_content[file_size] = '\0';
-    fclose(file);
-
-    // Parse do JSON
-    JSON_Value *root_value = json_parse_string(file_content);
-    JSON_Object *root_object = json_value_get_object(root_value);
-    free(file_content);
-
-    // Get the "games" array
-    JSON_Array *games_array = json_object_get_array(root_object, "games");
-
-    // Iterate over the games array to find the matching ID
-    for (int i = 0; i < json_array_get_count(games_array); i++) {
-
-        // get json object
-        JSON_Object *game_object = json_array_get_object(games_array, i);
-
-        // get current id from Json object
-        int currentID = (int)json_object_get_number(game_object, "id");
-        
-        // se o game for encontrado
-        if (currentID == gameID) {
-
-            // set game id as currentID
-            game->id = currentID;
-
-            // set current line as 1
-            game->currentLine = 1;
-
-             // Obter o board e a solution do JSON
-            for (int row = 0; row < 9; row++) {
-
-                JSON_Array *board_row = json_array_get_array(json_object_get_array(game_object, "board"), row);
-                JSON_Array *solution_row = json_array_get_array(json_object_get_array(game_object, "solution"), row);
-
-                for (int col = 0; col < 9; col++) {
-                    game->board[row][col] = (int)json_array_get_number(board_row, col);
-                    game->solution[row][col] = (int)json_array_get_number(solution_row, col);
-                }
-            }
-      
-            // game has been loaded successfully
-            produceLog(config, "Jogo carregado com sucesso", EVENT_GAME_LOAD, gameID, playerID);
-
-            // if game has been found leave loop
-            json_value_free(root_value);
-            return game; // Return the game immediately
-        } 
-    }
-
-    // Game not found
-    if (game->id == 0) {
-        
-        // cria mensagem mais detalhada
-        char logMessage[100];
-        snprintf(logMessage, sizeof(logMessage), "game com ID %d nao encontrado", gameID);
-        produceLog(config, logMessage, EVENT_GAME_NOT_FOUND, gameID, playerID);
-
-        // mostra no terminal e encerra programa
-        fprintf(stderr, "game com ID %d nao encontrado.\n", gameID);
-        free(game);
-        return NULL;
-    }
-
-    // Limpar memoria alocada ao JSON
-    json_value_free(root_value);
-
-    return game;
-}
-
-
-/**
- * Carrega um jogo aleatório a partir do ficheiro 'games.json'.
- *
- * @param config Um pointer para a estrutura `ServerConfig` que contém o caminho 
- * para o ficheiro 'games.json' e o caminho do log.
- * @param playerID O identificador do jogador que está a solicitar um jogo aleatório, 
- * usado para o registo no log.
- * @return Um pointer para a estrutura `Game` carregada, ou NULL se ocorrer um erro.
- *
- * @details Esta função faz o seguinte:
- * - Abre o ficheiro 'games.json' para leitura. Se o ficheiro não puder ser aberto, 
- * regista um erro no log e termina o programa.
- * - Lê o conteúdo do ficheiro e garante que a string termina com um caractere nulo.
- * - Faz o parse do conteúdo JSON e obtém o array de jogos.
- * - Usa uma semente baseada no tempo atual para gerar um ID de jogo aleatório.
- * - Chama a função `loadGame` para carregar o jogo aleatório selecionado.
- * - Liberta a memória alocada para o conteúdo JSON e retorna o jogo carregado.
- */
-
-Game *loadRandomGame(ServerConfig *config, int playerID) {
-
-    // open the file
-    FILE *file = fopen(config->gamePath, "r");
-
-    // check if file is opened
-    if (file == NULL) {
-        err_dump(config, 0, playerID, "Erro ao abrir o ficheiro de jogos.", EVENT_GAME_NOT_LOAD);
-    }
-
-    // get the size of the file
-    fseek(file, 0, SEEK_END);
-    long file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
-
-    // read the file content
-    char *file_content = malloc(file_size + 1);
-    fread(file_content, 1, file_size, file);
-
-    // add null terminator to the end of the file content
-    file_content[file_size] = '\0';
-
-    // close the file
-    fclose(file);
-
-    // parse the JSON
-    JSON_Value *root_value = json_parse_string(file_content);
-    JSON_Object *root_object = json_value_get_object(root_value);
-
-    // free the file content
-    free(file_content);
-
-    // get the games array
-    JSON_Array *games_array = json_object_get_array(root_object, "games");
-
-    // get the number of games
-    int numberOfGames = json_array_get_count(games_array);
-
-    // get seed for random number generator
-    srand(time(NULL));
-
-    // get a random game ID
-    int randomGameID = rand() % numberOfGames + 1;
-    printf("Random game ID selected: %d from %d games\n", randomGameID, numberOfGames);
-    
-    // free the JSON object
-    json_value_free(root_value);
-
-    // return the loaded game
-    return loadGame(config, randomGameID, playerID);
-}
-
-
-/**
- * Verifica se uma linha inserida pelo jogador está correta em relação à solução do jogo.
- *
- * @param logFileName O caminho para o ficheiro de log onde os eventos são registados.
- * @param solutionSent Uma string que representa a solução enviada pelo jogador.
- * @param game Um pointer para a estrutura `Game` que contém o estado atual do tabuleiro e a solução correta.
- * @param insertLine Um array de 9 inteiros que representa a linha inserida pelo jogador.
- * @param lineNumber O número da linha a ser verificada (0-indexado).
- * @param playerID O identificador do jogador que enviou a linha.
- * @return 1 se a linha estiver correta, 0 se estiver incorreta ou incompleta.
- *
- * @details Esta função faz o seguinte:
- * - Regista no log a solução enviada pelo jogador, incluindo o ID do jogador, o ID do jogo, e o número da linha.
- * - Itera sobre os 9 valores da linha inserida e compara cada valor com a solução do jogo.
- * - Se o valor estiver correto, atualiza o tabuleiro do jogo com o valor inserido.
- * - Imprime no terminal a posição da linha, o valor esperado, e o valor recebido para facilitar o debug.
- * - Verifica se a linha está correta usando a função `isLineCorrect`.
- * - Regista no log se a linha foi validada como correta ou incorreta e devolve 1 ou 0, respetivamente.
- */
-
-int verifyLine(ServerConfig *config, Game *game, char * solutionSent, int insertLine[9], int playerID) {
-
-    char logMessage[100];
-    
-    sprintf(logMessage, "O jogador %d no jogo %d para a linha %d: %s", playerID, game->id, game->currentLine, solutionSent);
-    produceLog(config, logMessage, EVENT_SOLUTION_SENT, game->id, playerID);
-    
-    for (int j = 0; j < 9; j++) {
-
-        // verifica se o valor inserido é igual ao valor da solução
-        if (insertLine[j] == game->solution[game->currentLine - 1][j]) {
-            
-            // se for igual, atualiza o tabuleiro
-            game->board[game->currentLine - 1][j] = insertLine[j];
-
-        // se o valor inserido for diferente do valor da solução
-        } 
-
-        //printf("Posição %d: esperado %d, recebido %d\n", j + 1, game->solution[game->currentLine - 1][j], insertLine[j]);
-    }
-
-    // limpa logMessage
-    memset(logMessage, 0, sizeof(logMessage));
-
-    // verifica se a linha está correta
-    if (isLineCorrect(game, game->currentLine - 1)) {
-
-        // linha correta
-        snprintf(logMessage, sizeof(logMessage), "Linha enviada (%s) validada como CERTA", solutionSent);
-        produceLog(config, logMessage, EVENT_SOLUTION_CORRECT, game->id, playerID);
-        return 1;
-
-    } else {
-
-        // linha incorreta
-        snprintf(logMessage, sizeof(logMessage), "Linha enviada (%s) validada como ERRADA/INCOMPLETA", solutionSent);
-        produceLog(config, logMessage, EVENT_SOLUTION_INCORRECT, game->id, playerID);
-        return 0;
-    }
-}
-
-/**
- * Verifica se uma linha específica do tabuleiro do jogo está correta em relação à solução.
- *
- * @param game Um pointer para a estrutura `Game` que contém o tabuleiro atual e a solução correta.
- * @param row O número da linha (0-indexado) que deve ser verificada.
- * @return `true` se todos os valores da linha estiverem corretos, `false` caso contrário.
- *
- * @details Esta função percorre os 9 valores da linha especificada no tabuleiro do jogo.
- * Se algum valor da linha atual não corresponder ao valor na solução, a função devolve `false`.
- * Se todos os valores forem iguais, a função devolve `true`, indicando que a linha está correta.
- */
-
-bool isLineCorrect(Game *game, int row) {
-    for (int i = 0; i < 9; i++) {
-        if (game->board[row][i] != game->solution[row][i]) {
-            return false;
-        }
-    }
-    return true;
-}
-
-
-/**
- * Cria uma nova sala de jogo e inicializa os seus campos.
- *
- * @param config Um pointer para a estrutura `ServerConfig` que contém as configurações do servidor, 
- * incluindo o número máximo de salas e o caminho para o ficheiro de log.
- * @return Um pointer para a nova estrutura `Room` criada, ou NULL se a alocação de memória falhar.
- *
- * @details Esta função faz o seguinte:
- * - Aloca memória para uma nova estrutura `Room` e inicializa os seus campos a zeros.
- * - Gera um identificador único para a sala usando `generateUniqueId`.
- * - Aloca memória para o array de jogadores da sala, com o tamanho máximo definido em `config`.
- * - Inicializa o array `config->rooms` a zeros para garantir que todos os campos estão corretamente definidos.
- * - Incrementa o número de salas ativas no servidor.
- * - Regista a criação da sala no ficheiro de log.
- * - Devolve o pointer para a sala criada, ou NULL se a alocação de memória falhar.
- */
-
-Room *createRoom(ServerConfig *config, int playerID, bool isSinglePlayer, int synchronizationType) {
-
-    Room *room = (Room *)malloc(sizeof(Room));
-    if (room == NULL) {
-        err_dump(config, 0, playerID, "Memory allocation failed", EVENT_ROOM_NOT_LOAD);
-        return NULL;
-    }
-    memset(room, 0, sizeof(Room));  // Initialize Room struct
-
-    room->id = generateUniqueId();
-    printf("Room ID na criação da room: %d\n", room->id);
-    room->timer = 60;
-    room->isGameRunning = false;
-    room->isFinished = false;
-    room->isSinglePlayer = isSinglePlayer;
-    room->maxClients = room->isSinglePlayer ? 1 : config->maxClientsPerRoom;
-    room->clients = (Client **)malloc(sizeof(Client *) * room->maxClients);
-    room->maxWaitingTime = config->maxWaitingTime;
-    room->savedStatistics = false;
-
-    // we dont need synchronization for single player games
-    if (!room->isSinglePlayer) {
-
-        // Inicializar priority queue
-        room->enterRoomQueue = (PriorityQueue *)malloc(sizeof(PriorityQueue));
-        initPriorityQueue(room->enterRoomQueue, room->maxClients * 2);
-
-        // Initialize reader-writer locks
-        sem_init(&room->writeSemaphore, 0, 1); // Inicializar semáforo para escrita e começa a aceitar 1 escritor
-        sem_init(&room->readSemaphore, 0, 1); // Inicializar semáforo para leitura e começa a aceitar 1 leitor
-        sem_init(&room->nonPremiumWriteSemaphore, 0, 0); //
-        pthread_mutex_init(&room->readMutex, NULL); // Inicializar mutex para leitura
-        pthread_mutex_init(&room->writeMutex, NULL); // Inicializar mutex para escrita
-        room->readerCount = 0;
-        room->writerCount = 0;
-
-        // Inicializar barreira para começar e terminar o jogo
-        room->waitingCount = 0;
-        sem_init(&room->mutexSemaphore, 0, 1);
-        sem_init(&room->turnsTileSemaphore1, 0, 0);
-        sem_init(&room->turnsTileSemaphore2, 0, 0);
-
-        // barber shop initialization
-        room->customers = 0;
-        pthread_mutex_init(&room->barberShopMutex, NULL);
-        sem_init(&room->costumerSemaphore, 0, 0);
-        sem_init(&room->costumerDoneSemaphore, 0, 0);
-        sem_init(&room->barberDoneSemaphore, 0, 0);
-        room->barberShopQueue = (PriorityQueue *)malloc(sizeof(PriorityQueue));
-        initPriorityQueue(room->barberShopQueue, room->maxClients);
-
-        // check if the game is reader-writer or barber shop
-        if (synchronizationType == 0) {
-            room->isReaderWriter = true;
-        }
-
-        if (synchronizationType == 1) { // barber shop with static priority
-            room->isReaderWriter = false;
-            room->priorityQueueType = 0;
-        }
-
-        if (synchronizationType == 2) { // barber shop with dynamic priority
-            room->isReaderWriter = false;
-            room->priorityQueueType = 1;
-        }
-
-        if (synchronizationType == 3) { // barber shop with FIFO
-            room->isReaderWriter = false;
-            room->priorityQueueType = 2;
-        }
-
-        if (!room->isReaderWriter) {
-            // initialize thread for barber
-            if(pthread_create(&room->barberThread, NULL, handleBarber, (void *)room)) {
-                err_dump(config, 0, playerID, "Erro ao criar a thread do barbeiro", EVENT_THREAD_NOT_CREATE);
-            }
-            produceLog(config, "Barbeiro criado com sucesso", EVENT_BARBER_CREATED, room->id, playerID);
-        }
-        
-        // initialize mutexes
-        pthread_mutex_init(&room->mutex, NULL);
-        pthread_mutex_init(&room->timerMutex, NULL);
-    }
-
-    // add the room to the list of rooms and increment the number of rooms
-    config->rooms[config->numRooms++] = room;
-
-    // log room creation
-    produceLog(config, "Sala criada com sucesso", EVENT_ROOM_LOAD, room->id, playerID);
-    return room;
-}
-
-Room *getRoom(ServerConfig *config, int roomID, int playerID) {
-
-    // check if roomID is valid
-    if (roomID < 1) {
-        err_dump(config, 0, playerID, "Room ID is invalid", EVENT_ROOM_NOT_JOIN);
-        return NULL;
-    }
-
-    // get the room by looping through the rooms
-    Room *room = NULL;
-    for (int i = 0; i < config->numRooms; i++) {
-        //printf("i: %d\n", i);
-        //printf("NR rooms: %d\n", config->numRooms);
-        //printf("ROOM ID: %d\n", config->rooms[i]->id);
-        if (config->rooms[i]->id == roomID) {
-            room = config->rooms[i];
-            break;
-        }
-    }
-
-    return room;
-}
-
-void deleteRoom(ServerConfig *config, int roomID) {
-    for (int i = 0; i < config->numRooms; i++) {
-        if (config->rooms[i]->id == roomID) {
-            printf("FREEING MEMORY FOR ROOM %d\n", roomID);
-            
-            free(config->rooms[i]->clients); 
-
-            free(config->rooms[i]->game);
-
-            // Destruir mutexes e semáforos
-            if (!config->rooms[i]->isSinglePlayer) {
-                pthread_mutex_destroy(&config->rooms[i]->mutex);
-                pthread_mutex_destroy(&config->rooms[i]->timerMutex);
-                pthread_mutex_destroy(&config->rooms[i]->readMutex);
-                pthread_mutex_destroy(&config->rooms[i]->writeMutex);
-                pthread_mutex_destroy(&config->rooms[i]->barberShopMutex);
-                sem_destroy(&config->rooms[i]->mutexSemaphore);
-                sem_destroy(&config->rooms[i]->turnsTileSemaphore1);
-                sem_destroy(&config->rooms[i]->turnsTileSemaphore2);
-                sem_destroy(&config->rooms[i]->writeSemaphore);
-                sem_destroy(&config->rooms[i]->readSemaphore);
-                sem_destroy(&config->rooms[i]->nonPremiumWriteSemaphore);
-                sem_destroy(&config->rooms[i]->costumerSemaphore);
-                sem_destroy(&config->rooms[i]->costumerDoneSemaphore);
-                sem_destroy(&config->rooms[i]->barberDoneSemaphore);
-
-                // destroy barber
-                if (!config->rooms[i]->isReaderWriter) {
-                    pthread_cancel(config->rooms[i]->barberThread);
-                }
-
-                // free priority queue
-                freePriorityQueue(config->rooms[i]->enterRoomQueue);
-                freePriorityQueue(config->rooms[i]->barberShopQueue);
-            }
-
-            free(config->rooms[i]);
-
-            // shift all rooms to the left
-            for (int j = i; j < config->numRooms - 1; j++) {
-                config->rooms[j] = config->rooms[j + 1];
-            }
-
-            // decrement number of rooms
-            config->numRooms--;
-
-            // log room deletion
-            produceLog(config, "Sala eliminada com sucesso", EVENT_ROOM_DELETE, roomID, 0);
-
-            break;
-        }
-    }
-
-    
-}
-
-/**
- * Obtém uma lista de identificadores de jogos a partir do ficheiro 'games.json'.
- *
- * @param config Um pointer para a estrutura `ServerConfig` que contém 
- * o caminho para o ficheiro 'games.json' e o caminho do log.
- * @return Uma string que contém os IDs de todos os jogos, formatados com 
- * "Game ID: [ID]", ou NULL se ocorrer um erro na leitura do ficheiro.
- *
- * @details Esta função faz o seguinte:
- * - Abre o ficheiro 'games.json' e lê todo o seu conteúdo. Se o ficheiro não puder ser aberto,
- * regista o erro no log e termina o programa.
- * - Faz o parse do conteúdo JSON para obter o array de jogos.
- * - Itera sobre cada jogo no array e extrai o ID do jogo.
- * - Concatena todos os IDs numa string, cada um formatado como "Game ID: [ID]".
- * - Liberta a memória alocada para o conteúdo JSON e devolve a string que contém os IDs.
- * 
- * @note O tamanho da string `games` é limitado a 1024 caracteres, o que pode ser ajustado 
- * conforme necessário para evitar overflow.
- */
-
-char *getGames(ServerConfig *config) {
-
-    // open the file
-    FILE *file = fopen(config->gamePath, "r");
-
-    // check if file is opened
-    if (file == NULL) {
-        err_dump(config, 0, 0, "Erro ao abrir o ficheiro de jogos.", EVENT_GAME_NOT_LOAD);
-    }
-
-    // get the size of the file
-    fseek(file, 0, SEEK_END);
-    long file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
-
-    // read the file content
-    char *file_content = malloc(file_size + 1);
-    fread(file_content, 1, file_size, file);
-
-    // add null terminator to the end of the file content
-    file_content[file_size] = '\0';
-
-    // close the file
-    fclose(file);
-
-    // get ids of the games
-    JSON_Value *root_value = json_parse_string(file_content);
-    JSON_Object *root_object = json_value_get_object(root_value);
-
-    // free the file content
-    free(file_content);
-
-    // get the games array
-    JSON_Array *games_array = json_object_get_array(root_object, "games");
-
-    // get the number of games
-    int numberOfGames = json_array_get_count(games_array);
-
-    // create a string to store the ids of the games
-    char *games = (char *)malloc(1024);
-    memset(games, 0, 1024);
-
-    // iterate over the games array
-    for (int i = 0; i < numberOfGames; i++) {
-        JSON_Object *game_object = json_array_get_object(games_array, i);
-        int gameID = (int)json_object_get_number(game_object, "id");
-        char gameIDString[10];
-        sprintf(gameIDString, "%d", gameID);
-        strcat(games, "Game ID: ");
-        strcat(games, gameIDString);
-        strcat(games, "\n");
-    }
-
-    // free the JSON object
-    json_value_free(root_value);
-
-    // return the games
-    return games;
-}
-
-/**
- * Obtém uma lista de salas de jogo ativas no servidor, incluindo o ID da sala, o número de jogadores, 
- * o número máximo de jogadores, e o ID do jogo associado.
- *
- * @param config Um pointer para a estrutura `ServerConfig` que contém as informações sobre as salas de jogo.
- * @return Uma string que contém a lista de salas de jogo formatada, 
- * ou uma mensagem "No rooms available\n" se não houver salas ativas.
- *
- * @details Esta função faz o seguinte:
- * - Verifica se há salas disponíveis. Se o número de salas for zero, devolve a mensagem "No rooms available\n".
- * - Cria uma string para armazenar as informações de cada sala, incluindo o ID da sala, o número de jogadores atuais, 
- *   o número máximo de jogadores, e o ID do jogo.
- * - Itera sobre todas as salas e concatena as informações formatadas de cada sala na string `rooms`.
- * - Devolve a string `rooms` contendo as informações de todas as salas. A memória alocada para esta 
- * string deve ser libertada pelo chamador.
- *
- * @note O tamanho da string `rooms` é limitado a 1024 caracteres, o que pode ser ajustado
- * se houver um número elevado de salas.
- */
-
-char *getRooms(ServerConfig *config) {
-
-        // create a string to store the rooms
-        char *rooms = (char *)malloc(BUFFER_SIZE);
-        memset(rooms, 0, 1024);
-
-        // iterate over the rooms
-        if (config->numRooms == 0) {
-            strcpy(rooms, "No rooms available\n");
-        }
-
-        for (int i = 0; i < config->numRooms; i++) {
-            if (config->rooms[i] == NULL) {
-                continue;
-            }
-            // can only join rooms that are not running
-            if (config->rooms[i]->isGameRunning == false) {
-                // show number of players in the room, max players in the room and the game ID
-                char roomString[100];
-                sprintf(roomString, "Room ID: %d, Players: %d/%d, Game ID: %d\n", config->rooms[i]->id, config->rooms[i]->numClients, config->rooms[i]->maxClients, config->rooms[i]->game->id);
-                strcat(rooms, roomString);
-            }
-        }
-
-        // if no rooms are available
-        if (strlen(rooms) == 0) {
-            strcpy(rooms, "No rooms available\n");
-        }
-
-        // return the rooms
-        return rooms;
-}
-
-/**
- * Cria uma nova sala de jogo e carrega um jogo associado, atribuindo-o a um jogador.
- *
- * @param newSockfd Um pointer para o descritor de socket do cliente, usado para enviar mensagens.
- * @param config Um pointer para a estrutura `ServerConfig` que contém as configurações do servidor.
- * @param ClientID O identificador do jogador que irá participar na sala.
- * @param isSinglePlayer Um valor booleano que indica se o jogo é single Client (true) ou MultiPlayer (false).
- * @param isRandom Um valor booleano que indica se o jogo deve ser carregado aleatoriamente (true),
- * ou se um jogo específico deve ser carregado (false).
- * @param gameID O identificador do jogo a ser carregado, usado se `isRandom` for false.
- * @return Um pointer para a estrutura `Room` criada, ou NULL se não houver salas disponíveis.
- *
- * @details Esta função faz o seguinte:
- * - Verifica se o número máximo de salas foi atingido. 
- *   Se não houver salas disponíveis, envia uma mensagem ao cliente e regista o evento no ficheiro de log.
- * - Cria uma nova sala e adiciona-a à lista de salas do servidor.
- * - Carrega um jogo, seja de forma aleatória ou usando o `gameID` especificado.
- * - Se o jogo for carregado com sucesso, associa-o à sala criada.
- * - Define o número máximo de jogadores para 1 se for um jogo single Client, 
- *   ou para o valor definido na configuração se for MultiPlayer.
- * - Adiciona o jogador à sala e inicializa o número de jogadores da sala.
- * - Imprime uma mensagem de confirmação e retorna a sala criada.
- */
-
-Room *createRoomAndGame(ServerConfig *config, Client *client, bool isSinglePlayer, bool isRandom, int gameID, int synchronizationType) {
-
-    // check if there's config->rooms is full by looping
-    if (config->numRooms >= config->maxRooms) {
-        // send message to client
-        send(client->socket_fd, "No rooms available", strlen("No rooms available"), 0);
-        // write log
-        produceLog(config, "No rooms available", EVENT_ROOM_NOT_CREATED, 0, client->clientID);
-        return NULL;
-    }
-
-    // create room
-    Room *room = createRoom(config, client->clientID, isSinglePlayer, synchronizationType);
-
-    // load game
-    Game *game;
-
-    if (isRandom) {
-        game = loadRandomGame(config, client->clientID);
-    } else {
-        game = loadGame(config, gameID, client->clientID);
-    }
-
-    if (game == NULL) {
-        fprintf(stderr, "Error loading random game\n");
-        exit(1);
-    }
-
-    // add game to room
-    room->game = game;
-    
-    joinRoom(config, room, client);
-
-    char buffer[BUFFER_SIZE];
-    memset(buffer, 0, sizeof(buffer));
-
-    strcpy(buffer, "");
-
-    if (!room->isSinglePlayer && !room->isReaderWriter) {
-        if (room->priorityQueueType == 0) {
-            strcpy(buffer, " and STATIC PRIORITIES queue");
-        } else if (room->priorityQueueType == 1) {
-            strcpy(buffer, " and DYNAMIC PRIORITIES queue");
-        } else if (room->priorityQueueType == 2) {
-            strcpy(buffer, " and FIFO queue");
-        }
-    }
-
-    // Mensagem de criação da sala
-    printf("New game created by client %d with game %d and room is synchronized by %s%s. Client %d is %s.\n", 
-            client->clientID, room->game->id, 
-            !room->isSinglePlayer ? (room->isReaderWriter ? "READER-WRITER" : "BARBER SHOP") : "",
-            buffer,
-            client->clientID, client->isPremium ? "Premium" : "Non-premium");
-    
-    if (!room->isSinglePlayer) {
-        printf("Waiting for more Clients to join in room %d\n", room->id);
-    }
-    
-
-    return room;
-}
-
-/**
- * Adiciona um jogador a uma sala de jogo existente.
- *
- * @param config Um pointer para a estrutura `ServerConfig` que contém as informações 
- * de configuração do servidor, incluindo a lista de salas.
- * @param roomID O identificador da sala que o jogador pretende entrar.
- * @param ClientID O identificador do jogador que deseja juntar-se à sala.
- * @return Um pointer para a sala `Room` se o jogador for adicionado com sucesso, 
- * ou NULL se a sala estiver cheia ou se o `roomID` for inválido.
- *
- * @details Esta função faz o seguinte:
- * - Verifica se o `roomID` fornecido é válido (dentro dos limites das salas existentes).
- * - Obtém a sala correspondente a partir da lista de salas no servidor.
- * - Verifica se a sala já está cheia. Se estiver, devolve NULL e imprime uma mensagem de erro no terminal.
- * - Se houver espaço na sala, adiciona o jogador ao array de jogadores da sala e incrementa o número de jogadores.
- * - Regista no ficheiro de log que o jogador entrou na sala.
- * - Devolve um pointer para a sala `Room` atualizada.
- */
-void joinRoom(ServerConfig *config, Room *room, Client *client) {
-
-    // check if room is full
-    if (room->numClients == room->maxClients) {
-        err_dump(config, 0, client->clientID, "Room is full", EVENT_ROOM_NOT_JOIN);
-        return;
-    }
-
-    // check if room is running
-    if (room->isGameRunning) {
-        err_dump(config, 0, client->clientID, "Room is running", EVENT_ROOM_NOT_JOIN);
-        return;
-    }
-
-    //printf("Client %d joined room %d\n", client->clientID, room->id);
-
-    // add client to room
-    room->clients[room->numClients] = client;
-
-    // increment number of clients
-    room->numClients++;
-
-    // Log de entrada do jogador na sala
-    char logMessage[256];
-    snprintf(logMessage, sizeof(logMessage), "Client %d joined room %d", client->clientID, room->id);
-    produceLog(config, logMessage, EVENT_ROOM_JOIN, room->game->id, client->clientID);
-
-    printf("Client %d (Premium: %s) joined room %d with socket %d\n",
-           client->clientID, client->isPremium ? "Yes" : "No", room->id, client->socket_fd);
-}
-
-/**
- * Envia o tabuleiro do jogo ao cliente em formato JSON.
- *
- * @param socket Um pointer para o descritor de socket utilizado para enviar o tabuleiro ao cliente.
- * @param game Um pointer para a estrutura `Game` que contém o tabuleiro a ser enviado.
- * @param config Um pointer para a estrutura `ServerConfig` que contém a configuração do servidor, 
- * incluindo o caminho do ficheiro de log.
- *
- * @details Esta função faz o seguinte:
- * - Cria uma estrutura JSON que representa o tabuleiro do jogo, incluindo o ID do jogo.
- * - Converte o tabuleiro 9x9 num array de arrays em formato JSON.
- * - Serializa o objeto JSON para uma string e envia-a ao cliente através do socket.
- * - Em caso de erro ao enviar o tabuleiro, regista a mensagem de erro no log e termina a execução da função.
- * - Liberta a memória alocada para a string serializada e o objeto JSON.
- */
-
-void sendBoard(ServerConfig *config, Room* room, Client *client) {
-
-    // Enviar board ao cliente em formato JSON
-    JSON_Value *root_value = json_value_init_object();
-    JSON_Object *root_object = json_value_get_object(root_value);
-    json_object_set_number(root_object, "id", room->game->id);
-    JSON_Value *board_value = json_value_init_array();
-    JSON_Array *board_array = json_value_get_array(board_value);
-
-    for (int i = 0; i < 9; i++) {
-        JSON_Value *linha_value = json_value_init_array();
-        JSON_Array *linha_array = json_value_get_array(linha_value);
-        for (int j = 0; j < 9; j++) {
-            json_array_append_number(linha_array, room->game->board[i][j]);
-        }
-        json_array_append_value(board_array, linha_value);
-    }
-
-    json_object_set_value(root_object, "board", board_value);
-    char *serialized_string = json_serialize_to_string(root_value);
-
-    //adicionar a linha atual como um inteiro à string
-    char buffer[10];
-    sprintf(buffer, "\n%d", room->game->currentLine);
-    char *temp = malloc(strlen(serialized_string) + strlen(buffer) + 1);
-    strcpy(temp, serialized_string);
-    strcat(temp, buffer);
-
-    //printf("Enviando tabuleiro ao cliente %d do jogo %d\n", client->clientID, room->game->id);
-    //printf("Enviando board e linha atual: %s\n", temp);
-    // Enviar tabuleiro e linha atual ao cliente
-    if (send(client->socket_fd, temp, strlen(temp), 0) < 0) {
-        err_dump(config, room->game->id, 0, "can't send board and line to client", EVENT_MESSAGE_SERVER_NOT_SENT);
-        return;
-    }
-
-    // escrever no log
-    produceLog(config, "Tabuleiro enviado ao cliente", EVENT_MESSAGE_SERVER_SENT, room->game->id, client->clientID);
-
-    free(temp);
-    json_free_serialized_string(serialized_string);
-    json_value_free(root_value);
-}
-
-
-/**
- * Recebe linhas do cliente, valida-as, e atualiza o tabuleiro do jogo.
- *
- * @param newSockfd Um pointer para o descritor de socket usado para comunicação com o cliente.
- * @param game Um pointer para a estrutura `Game` que contém o estado atual do tabuleiro.
- * @param ClientID O identificador do jogador que está a enviar as linhas.
- * @param config Um pointer para a estrutura `ServerConfig` que contém a configuração do servidor, 
- * incluindo o caminho do ficheiro de log.
- *
- * @details Esta função faz o seguinte:
- * - Itera sobre as 9 linhas do tabuleiro, recebendo e validando cada linha enviada pelo cliente.
- * - Recebe cada linha do cliente como uma string de 9 caracteres e converte-a em valores inteiros.
- * - Usa a função `verifyLine` para validar a linha recebida. Se a linha estiver correta, 
- *   continua para a próxima; caso contrário, solicita ao cliente que envie novamente.
- * - Se ocorrer um erro ao receber uma linha, regista o erro no ficheiro de log e termina a execução da função.
- * - Após cada validação, envia o tabuleiro atualizado ao cliente.
- * - Adiciona um atraso de 1 segundo (`sleep(1)`) antes de enviar o tabuleiro para garantir que o cliente tem 
- *   tempo para processar as atualizações.
- */
-
-void receiveLines(ServerConfig *config, Room *room, Client *client, int *currentLine) {
-
-    // pre condition reader
-    if (!room->isSinglePlayer) {
-        if (room->isReaderWriter) {
-            acquireReadLock(room);
-        } else {
-            enterBarberShop(room, client);
-        }
-    }
-
-    //printf("---------------------------------------------\n");
-    //printf("INÍCIO DA SECÇÃO CRÍTICA DE LEITURA para o cliente %d na sala %d\n", client->clientID, room->id);
-
-    int correctLine = 0;
-
-    // critical section reader
-    sendBoard(config, room, client);
-
-    //printf("FIM DA SECÇÃO CRÍTICA DE LEITURA para o cliente %d na sala %d\n", client->clientID, room->id);
-    //printf("---------------------------------------------\n");
-
-    // post condition reader
-    if (!room->isSinglePlayer) {
-        if (room->isReaderWriter) {
-            releaseReadLock(room);
-        } else {
-            leaveBarberShop(room, client);
-        }
-    }
-
-    // Receber e validar as linhas do cliente
-    while (room->game->currentLine <= 9) {
-
-        //printf("Recebendo linha %d do cliente %d\n", *currentLine, ClientID);
-
-        char line[10];
-
-        // Limpar linha
-        memset(line, '0', sizeof(line));
-
-        // Receber linha do cliente
-        if (recv(client->socket_fd, line, sizeof(line), 0) < 0) {
-            err_dump(config, room->game->id, client->clientID, "can't receive line from client", EVENT_MESSAGE_SERVER_NOT_RECEIVED);
-            return;
-        } else {
-
-            printf("Cliente %d %s quer resolver a linha %d na sala %d com o jogo %d\n", 
-            client->clientID, client->isPremium ? "(PREMIUM)" : "(NOT PREMIUM)",
-            room->id, room->game->id, room->game->currentLine);
-
-            // pre condition writer
-            if (!room->isSinglePlayer) {
-                if (room->isReaderWriter) {
-                    acquireWriteLock(room, client);
-                } else {
-                    enterBarberShop(room, client);
-                }
-            }
-
-            //printf("-----------------------------------------------------\n");
-            //printf("INÍCIO DA SECÇÃO CRÍTICA DE ESCRITA para o cliente %d na sala %d\n", client->clientID, room->id);
-
-            // **Adicionei print para verificar a linha recebida**
-            //printf("Linha recebida do cliente %d: %s\n", client->clientID, line); 
-
-            // Converte a linha recebida em valores inteiros
-            int insertLine[9];
-            for (int j = 0; j < 9; j++) {
-                insertLine[j] = line[j] - '0';
-            }
-
-            printf("Verificando linha %d do cliente %d na sala %d com o o jogo %d\n", 
-            room->game->currentLine, client->clientID, room->id, room->game->id);
-            // critical section writer
-            // Verificar a linha recebida com a função verifyLine
-            correctLine = verifyLine(config, room->game, line, insertLine, client->clientID);
-
-            if (correctLine == 1) {
-                // linha correta
-                //printf("Linha %d correta enviada pelo cliente %d\n", room->game->currentLine, client->clientID);
-                (room->game->currentLine)++;
-
-            } else {
-                // linha incorreta
-                //printf("Linha %d incorreta enviada pelo cliente %d\n", room->game->currentLine, client->clientID);
-            }
-
-            //printf("FIM DA SECÇÃO CRÍTICA DE ESCRITA para o cliente %d na sala %d\n", client->clientID, room->id);
-            //printf("-----------------------------------------------------\n");
-
-            // post condition writer
-            if (!room->isSinglePlayer) {
-                if (room->isReaderWriter) {
-                    releaseWriteLock(room, client);
-                } else {
-                    leaveBarberShop(room, client);
-                }
-            }
-
-            // add a random delay to appear more natural
-            //int delay = rand() % 3;
-            //sleep(delay);
-            
-            // pre condition reader
-            if (!room->isSinglePlayer) {
-                if (room->isReaderWriter) {
-                    acquireReadLock(room);
-                } else {
-                    enterBarberShop(room, client);
-                }
-            }
-
-            sendBoard(config, room, client);
-            printf("-----------------------------------------------------\n");
-            // post condition reader
-            if (!room->isSinglePlayer) {
-                if (room->isReaderWriter) {
-                    releaseReadLock(room);
-                } else {
-                    leaveBarberShop(room, client);
-                }
-            }
-        } 
-    } 
-}
-
-
-/**
- * Termina o jogo e limpa os recursos associados à sala de jogo.
- *
- * @param socket Um pointer para o descritor de socket utilizado para comunicação com o cliente 
- * (não usado diretamente na função).
- * @param room Um pointer para a estrutura `Room` que representa a sala de jogo que deve ser terminada.
- * @param ClientID O identificador do jogador (não usado diretamente na função).
- * @param config Um pointer para a estrutura `ServerConfig` que contém a configuração do servidor, 
- * incluindo o número atual de salas.
- *
- * @details Esta função faz o seguinte:
- * - Remove todos os jogadores da sala, definindo os IDs dos jogadores para 0.
- * - Restaura o número de jogadores da sala e o número máximo de jogadores a 0.
- * - Liberta a memória alocada para o jogo e a sala, prevenindo fugas de memória.
- * - Decrementa o contador do número de salas no servidor na configuração.
- */
-
-void finishGame(ServerConfig *config, Room *room, int *socket) {
-
-    // lock mutex
-    pthread_mutex_lock(&room->mutex);
-
-    if (room == NULL) {
-        return;
-    }
-
-    if (!room->isFinished) {
-        time_t endTime = time(NULL);
-        room->elapsedTime = difftime(endTime, room->startTime);
-    
-        // check if is single Client
-        if (!room->isSinglePlayer) {
-            // Substract 60 seconds from elapsed time
-            room->elapsedTime = room->elapsedTime;
-        }
-
-        printf("Jogo na sala %d terminou. Tempo total: %.2f segundos\n", room->id, room->elapsedTime);
-
-        // for every Client in the room
-        for (int i = 0; i < room->numClients; i++) {
-
-            // get accuracy from client
-            char accuracy[10];
-            memset(accuracy, 0, sizeof(accuracy));
-            if (recv(room->clients[i]->socket_fd, accuracy, sizeof(accuracy), 0) < 0) {
-                // erro ao receber accuracy
-                err_dump(config, room->game->id, room->clients[i]->clientID, "can't receive accuracy from client", EVENT_MESSAGE_SERVER_NOT_RECEIVED);
-            }
-
-            printf("A accuracy recebida foi de: %s\n", accuracy);
-
-            // convert accuracy to float
-            float accuracyFloat = atof(accuracy);
-
-            char timeMessage[256];
-            snprintf(timeMessage, sizeof(timeMessage), "A accuracy recebida foi de: %.2f %%\n", accuracyFloat);
-            produceLog(config, timeMessage, EVENT_MESSAGE_SERVER_RECEIVED, room->game->id, room->clients[i]->clientID);
-
-            // Envia o tempo decorrido ao cliente
-            
-            snprintf(timeMessage, sizeof(timeMessage), "O jogo terminou! Tempo total: %.2f segundos\n", room->elapsedTime);
-            if (send(room->clients[i]->socket_fd, timeMessage, strlen(timeMessage), 0) < 0) {
-                // erro ao enviar mensagem
-                err_dump(config, room->game->id, room->clients[i]->clientID, "can't send time message to client", EVENT_MESSAGE_SERVER_NOT_SENT);
-            }
-
-            // escrever no log timeMessage with EVENT_MESSAGE_SERVER_SENT
-            snprintf(timeMessage, sizeof(timeMessage), "Time elapsed: %.2f seconds", room->elapsedTime);
-            produceLog(config, timeMessage, EVENT_MESSAGE_SERVER_SENT, room->game->id, room->clients[i]->clientID);
-
-            // save on games.json the record
-            updateGameStatistics(config, room->game->id, room->elapsedTime, accuracyFloat);
-
-            // Save room statistics in log
-            if (!room->savedStatistics) {
-                saveRoomStatistics(room->id, room->elapsedTime);
-                room->savedStatistics = true;
-            }
-        }
-
-        // set room as finished
-        room->isFinished = true;
-
-        // remove room
-        deleteRoom(config, room->id);
-    }
-
-    // unlock mutex
-    pthread_mutex_unlock(&room->mutex);
-  
-}  
-
-void handleTimer(ServerConfig *config, Room *room, Client *client) {
-    fd_set readfds;
-    struct timeval tv;
-
-    // lock mutex
-    pthread_mutex_lock(&room->timerMutex);
-
-    if (room->timer == 0) {
-        pthread_mutex_unlock(&room->timerMutex);
-        return;
-    }
-
-    while (room->timer > 0) {
-        FD_ZERO(&readfds);
-        FD_SET(client->socket_fd, &readfds);
-        tv.tv_sec = 1;
-        tv.tv_usec = 0;
-
-        int result = select(FD_SETSIZE, &readfds, NULL, NULL, &tv);
-        //printf("Timer: %d\n", room->timer);
-        //printf("Result: %d\n", result);
-        //printf("Current thread: %ld\n", pthread_self());
-
-        if (result > 0) {
-            // Recebe mensagem do cliente (se necessário)
-        } else if (result == 0) {
-            if (room->timer == 0) {
-                break;
-            }
-
-            // Verificar se todos os jogadores se juntaram
-            if (room->numClients == room->maxClients) {
-                pthread_mutex_lock(&room->mutex);
-                room->timer = 0;
-                printf("All Clients have joined the room %d\n", room->id);
-                printf("Starting game in room %d\n", room->id);
-
-                // Enviar atualização do timer para todos os jogadores
-                for (int i = 0; i < room->numClients; i++) {
-                    
-                    //printf("Sending timer update to Client %d with the socket: %d\n", room->Clients[i], room->clientSockets[i]);
-                    sendTimerUpdate(config, room, room->clients[i]);
-                    //printf("Sent timer update to Client %d on socket %d\n", room->clients[i]->clientID, room->clients[i]->socket_fd);
-                    
-                }
-                pthread_mutex_unlock(&room->mutex);
-                break;
-            }
-
-            // Enviar atualização do timer a cada 10 segundos ou quando o timer for inferior a 5 segundos
-            if (room->timer % 10 == 0 || room->timer <= 5) {
-                //pthread_mutex_lock(&room->mutex);
-                for (int i = 0; i < room->numClients; i++) {
-                    //printf("Sending timer update to Client %d with the socket: %d\n", room->Clients[i], room->clientSockets[i]);
-                    sendTimerUpdate(config, room, room->clients[i]);
-                }
-                //pthread_mutex_lock(&room->mutex);
-            }
-
-            // Decrementa o timer
-            room->timer--;
-
-        } else {
-            perror("select");
-        }
-    }
-
-    // Iniciar jogo
-    printf("Jogo na sala %d iniciado às %s\n", room->id, ctime(&room->startTime));
-
-    pthread_mutex_unlock(&room->timerMutex);
-}
-
-// Função que envia atualizações do timer para o cliente, considerando o status premium
-void sendTimerUpdate(ServerConfig *config, Room *room, Client *client) {
-
-    // Preparar a mensagem de atualização do timer
-    char buffer[BUFFER_SIZE];
-    memset(buffer, 0, sizeof(buffer));
-
-    sprintf(buffer, "TIMERUPDATE\n%d\n%d\n%d\n%d\n", 
-            room->timer, room->id, room->game->id, room->numClients);
-
-    // Enviar a mensagem de atualização
-    if (send(client->socket_fd, buffer, strlen(buffer), 0) < 0) {
-        // erro ao enviar mensagem
-        err_dump(config, room->game->id, client->clientID, "can't send update to client", EVENT_MESSAGE_SERVER_NOT_SENT);
-    } else {
-        // Escrever no log a atualização enviada, considerando o status premium
-        char logMessage[256];
-        snprintf(logMessage, sizeof(logMessage), "Sent update to Client %d %s - Time left: %d seconds - Room ID: %d - Game ID: %d - Clients joined: %d", 
-                client->clientID, client->isPremium ? "(Premium User)" : "(Non Premium User)", room->timer, room->id, room->game->id, room->numClients);
-        
-        produceLog(config, logMessage, EVENT_MESSAGE_SERVER_SENT, room->game->id, client->clientID);
-        printf("%s\n", logMessage);
-    }
-}
+#include <stdio.h>  // Usar FILE, fopen(), fclose()
+#include <stdlib.h> 
+#include <string.h> // Usar strings (strcpy(), strcmp())
+#include <time.h>   // Usar time()
+#include <stdbool.h> // Usar bool
+#include <pthread.h>
+#include <unistd.h>
+#include "../../utils/logs/logs-common.h"
+#include "../../utils/network/network.h"
+#include "../../utils/arena/arena.h"
+#include "../../utils/jsonwriter/jsonwriter.h"
+#include "../../utils/gamestream/gamestream.h"
+#include "server-game.h"
+#include "server-leaderboard.h"
+#include "server-results.h"
+#include "server-generator.h"
+#include "server-catalog.h"
+#include "server-spectators.h"
+#include "server-sessions.h"
+#include "server-wal.h"
+#include "server-workers.h"
+#include "../logs/logs.h"
+
+// {"id":..,"size":..,"board":[..]} of the biggest board, and the current line after it
+#define BOARD_MESSAGE_SIZE (BOARD_MAX_SIZE * (BOARD_MAX_SIZE * 3 + 3) + 96)
+
+static int nextRoomID = 1;
+static pthread_mutex_t nextRoomIDMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Gera um identificador único para uma nova sala de jogo.
+ *
+ * @return Um identificador único para a sala, incrementando o valor de `nextRoomID`.
+ *
+ * @details Esta função utiliza uma variável estática `nextRoomID` para gerar IDs únicos 
+ * e sequenciais para as salas de jogo.
+ * Cada vez que a função é chamada, o valor de `nextRoomID` é retornado e, em seguida, incrementado,
+ * garantindo que cada sala criada tenha um ID exclusivo.
+ */
+
+int generateUniqueId() {
+    pthread_mutex_lock(&nextRoomIDMutex);
+    int id = nextRoomID++;
+    pthread_mutex_unlock(&nextRoomIDMutex);
+    return id;
+}
+
+/**
+ * Aloca um jogo vazio com um tabuleiro de `size` x `size` células.
+ *
+ * @param size O número de linhas e colunas do tabuleiro (tem de ser um quadrado perfeito até 25).
+ * @return Um pointer para o jogo, alinhado à linha de cache, ou NULL se o tamanho não for suportado
+ * ou a alocação falhar.
+ *
+ * @details As células para lá do tamanho do tabuleiro ficam a zeros no tabuleiro e na solução,
+ * para que cada linha possa ser comparada inteira com uma instrução vetorial.
+ */
+
+Game *allocGame(int size) {
+
+    int boxSize = boardBoxSize(size);
+    if (boxSize == 0) {
+        return NULL;
+    }
+
+    Game *game = (Game *)aligned_alloc(64, sizeof(Game));
+    if (game == NULL) {
+        return NULL;
+    }
+
+    memset(game, 0, sizeof(Game));
+    game->size = size;
+    game->boxSize = boxSize;
+    game->currentLine = 1;
+
+    return game;
+}
+
+void setClassicBoards(Game *game, const char board[9][9], const char solution[9][9]) {
+
+    for (int row = 0; row < 9; row++) {
+        memcpy(game->board[row], board[row], 9);
+        memcpy(game->solution[row], solution[row], 9);
+    }
+}
+
+/**
+ * Carrega um jogo a partir do ficheiro 'games.json' com base no ID do jogo.
+ *
+ * @param config Um pointer para a estrutura `ServerConfig` que contém o caminho 
+ * para o ficheiro 'games.json' e o ficheiro de log.
+ * @param gameID O identificador do jogo que se pretende carregar.
+ * @param playerID O identificador do jogador que está a tentar carregar o jogo, 
+ * usado para o registo no log.
+ * @return Um pointer para a estrutura `Game` carregada, ou NULL se o jogo não for encontrado ou ocorrer um erro.
+ *
+ * @details Esta função faz o seguinte:
+ * - Aloca memória para a estrutura `Game` e inicializa-a a zeros.
+ * - Abre o ficheiro 'games.json'. Se ocorrer um erro, regista-o no log e devolve NULL.
+ * - Lê o array de jogos em streaming (`nextGameRecord`), um jogo de cada vez, até encontrar o ID correspondente.
+ * - Se o jogo for encontrado, preenche o tabuleiro (`board`) e a solução (`solution`) na estrutura `Game`.
+ * - Regista o carregamento bem-sucedido no log e devolve o pointer para o jogo.
+ * - Se o jogo não for encontrado, regista o erro no log, imprime uma mensagem de erro no terminal, e devolve NULL.
+ * - Liberta a estrutura `Game` em caso de falha.
+ */
+
+Game *loadGame(ServerConfig *config, int gameID, int playerID) {
+
+    Game *game = allocGame(9);
+    if (game == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+
+    // binary database: O(1) record lookup, nothing to parse
+    GameCatalog *catalog = enterCatalog(config);
+    if (catalog->gameDB != NULL) {
+
+        const GameDBRecord *record = findGameRecord(catalog->gameDB, gameID);
+
+        if (record == NULL) {
+            leaveCatalog();
+            char logMessage[100];
+            snprintf(logMessage, sizeof(logMessage), "game com ID %d nao encontrado", gameID);
+            produceLog(config, logMessage, EVENT_GAME_NOT_FOUND, gameID, playerID);
+            fprintf(stderr, "game com ID %d nao encontrado.\n", gameID);
+            free(game);
+            return NULL;
+        }
+
+        // the database only holds 9x9 games
+        char board[9][9], solution[9][9];
+        unpackCells(record->board, board);
+        unpackCells(record->solution, solution);
+
+        game->id = record->id;
+        leaveCatalog();
+        setClassicBoards(game, (const char (*)[9])board, (const char (*)[9])solution);
+
+        produceLog(config, "Jogo carregado com sucesso", EVENT_GAME_LOAD, gameID, playerID);
+        return game;
+    }
+    leaveCatalog();
+
+    // ler o ficheiro de jogos um jogo de cada vez, até encontrar o ID (sem construir a árvore do ficheiro)
+    GameStream *stream = (GameStream *)arenaMalloc(sizeof(GameStream));
+    GameRecord *record = (GameRecord *)arenaMalloc(sizeof(GameRecord));
+    if (stream == NULL || record == NULL) {
+        arenaFree(stream);
+        arenaFree(record);
+        fprintf(stderr, "Memory allocation failed\n");
+        free(game);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&config->gamesFileMutex);
+
+    if (!openGameStream(stream, config->gamePath)) {
+        pthread_mutex_unlock(&config->gamesFileMutex);
+        produceLog(config, "Erro ao abrir o ficheiro de jogos.", EVENT_GAME_NOT_LOAD, gameID, playerID);
+        arenaFree(stream);
+        arenaFree(record);
+        free(game);  // Free allocated memory before exiting
+        return NULL;
+    }
+
+    bool isFound = false;
+    while (nextGameRecord(stream, record) == GAME_STREAM_RECORD) {
+        if (record->id == gameID) {
+            isFound = true;
+            break;
+        }
+    }
+
+    closeGameStream(stream);
+    pthread_mutex_unlock(&config->gamesFileMutex);
+    arenaFree(stream);
+
+    // se o game for encontrado
+    if (isFound) {
+
+        // set game id as currentID
+        game->id = record->id;
+
+        // tamanho do tabuleiro (9x9 se não for indicado)
+        int size = record->size;
+
+        if (boardBoxSize(size) == 0) {
+            char logMessage[100];
+            snprintf(logMessage, sizeof(logMessage), "game com ID %d tem um tamanho invalido (%d)", gameID, size);
+            produceLog(config, logMessage, EVENT_GAME_NOT_LOAD, gameID, playerID);
+            arenaFree(record);
+            free(game);
+            return NULL;
+        }
+
+        game->size = size;
+        game->boxSize = boardBoxSize(size);
+
+        // Obter o board e a solution do registo
+        for (int row = 0; row < size; row++) {
+            for (int col = 0; col < size; col++) {
+                game->board[row][col] = record->board[row][col];
+                game->solution[row][col] = record->solution[row][col];
+            }
+        }
+
+        arenaFree(record);
+
+        // game has been loaded successfully
+        produceLog(config, "Jogo carregado com sucesso", EVENT_GAME_LOAD, gameID, playerID);
+        return game;
+    }
+
+    arenaFree(record);
+
+    // Game not found: cria mensagem mais detalhada
+    char logMessage[100];
+    snprintf(logMessage, sizeof(logMessage), "game com ID %d nao encontrado", gameID);
+    produceLog(config, logMessage, EVENT_GAME_NOT_FOUND, gameID, playerID);
+
+    // mostra no terminal
+    fprintf(stderr, "game com ID %d nao encontrado.\n", gameID);
+    free(game);
+    return NULL;
+}
+
+
+/**
+ * Carrega um jogo aleatório a partir do ficheiro 'games.json'.
+ *
+ * @param config Um pointer para a estrutura `ServerConfig` que contém o caminho 
+ * para o ficheiro 'games.json' e o caminho do log.
+ * @param playerID O identificador do jogador que está a solicitar um jogo aleatório, 
+ * usado para o registo no log.
+ * @param difficulty A dificuldade pedida (1 a 5), ou 0 para qualquer dificuldade.
+ * @return Um pointer para a estrutura `Game` carregada, ou NULL se ocorrer um erro.
+ *
+ * @details Esta função faz o seguinte:
+ * - Se não for pedida uma dificuldade e houver um jogo gerado pronto no stock do gerador, devolve-o sem bloquear.
+ * - Caso contrário, escolhe uma entrada aleatória do catálogo de jogos em memória (o catálogo é
+ * construído no arranque a partir do ficheiro 'games.json' ou da base de dados binária),
+ * usando o balde da dificuldade pedida. Se não houver jogos dessa dificuldade, escolhe qualquer jogo.
+ * - Chama a função `loadGame` para carregar o jogo aleatório selecionado.
+ */
+
+Game *loadRandomGame(ServerConfig *config, int playerID, int difficulty) {
+
+    // a freshly generated game, if one is ready (the stock is not rated)
+    if (difficulty == 0) {
+        Game *game = takeGeneratedGame(config, playerID);
+        if (game != NULL) {
+            printf("Generated game ID selected: %d\n", game->id);
+            return game;
+        }
+    }
+
+    GameCatalog *catalog = enterCatalog(config);
+    int randomGameID = pickCatalogGame(catalog, difficulty);
+
+    if (randomGameID < 0 && difficulty != 0) {
+        char logMessage[100];
+        snprintf(logMessage, sizeof(logMessage), "Nao ha jogos com dificuldade %d, a escolher qualquer jogo", difficulty);
+        produceLog(config, logMessage, EVENT_GAME_NOT_LOAD, 0, playerID);
+        randomGameID = pickCatalogGame(catalog, 0);
+    }
+
+    if (randomGameID < 0) {
+        err_dump(config, 0, playerID, "O catalogo de jogos esta vazio.", EVENT_GAME_NOT_LOAD);
+    }
+
+    printf("Random game ID selected: %d from %d games (difficulty %d)\n", randomGameID, catalog->numGames, difficulty);
+    leaveCatalog();
+
+    // return the loaded game
+    return loadGame(config, randomGameID, playerID);
+}
+
+
+/**
+ * Verifica se uma linha inserida pelo jogador está correta em relação à solução do jogo.
+ *
+ * @param config Um pointer para a estrutura `ServerConfig` usada para registar os eventos no log.
+ * @param game Um pointer para a estrutura `Game` que contém o estado atual do tabuleiro e a solução correta.
+ * @param solutionSent Uma string que representa a solução enviada pelo jogador.
+ * @param insertLine A linha inserida pelo jogador, com BOARD_ROW_STRIDE bytes alinhados (células a mais a zeros).
+ * @param playerID O identificador do jogador que enviou a linha.
+ * @return 1 se a linha estiver correta, 0 se estiver incorreta ou incompleta.
+ *
+ * @details Esta função faz o seguinte:
+ * - Regista no log a solução enviada pelo jogador, copiada tal como chegou para um registo binário.
+ * - Com `mergeBoardRow`, compara a linha inserida com a solução, copia para o tabuleiro os valores
+ *   certos e obtém a máscara das células certas, tudo com algumas instruções vetoriais e sem saltos.
+ * - A linha está correta quando todas as células da máscara estão certas.
+ * - Regista no log se a linha foi validada como correta ou incorreta e devolve 1 ou 0, respetivamente.
+ */
+
+int verifyLine(ServerConfig *config, Game *game, char * solutionSent, const char *insertLine, int playerID) {
+
+    int row = game->currentLine - 1;
+
+    produceLineLog(config, LOG_EVENT_LINE_SENT, game->id, playerID, game->currentLine, solutionSent);
+
+    // merge the right cells and check the whole row at once
+    bool isCorrect = mergeBoardRow(game->board[row], game->solution[row], insertLine) == BOARD_ROW_COMPLETE;
+
+    produceLineLog(config, isCorrect ? LOG_EVENT_LINE_CORRECT : LOG_EVENT_LINE_INCORRECT, game->id, playerID, game->currentLine, solutionSent);
+
+    return isCorrect ? 1 : 0;
+}
+
+/**
+ * Verifica se uma linha específica do tabuleiro do jogo está correta em relação à solução.
+ *
+ * @param game Um pointer para a estrutura `Game` que contém o tabuleiro atual e a solução correta.
+ * @param row O número da linha (0-indexado) que deve ser verificada.
+ * @return `true` se todos os valores da linha estiverem corretos, `false` caso contrário.
+ *
+ * @details Esta função compara a linha inteira do tabuleiro com a linha da solução numa só
+ * comparação vetorial (as células para lá do tamanho do tabuleiro são zero em ambos).
+ * Se algum valor da linha atual não corresponder ao valor na solução, a função devolve `false`.
+ * Se todos os valores forem iguais, a função devolve `true`, indicando que a linha está correta.
+ */
+
+bool isLineCorrect(Game *game, int row) {
+    return boardRowsEqual(game->board[row], game->solution[row]);
+}
+
+
+/**
+ * Cria uma nova sala de jogo e inicializa os seus campos.
+ *
+ * @param config Um pointer para a estrutura `ServerConfig` que contém as configurações do servidor, 
+ * incluindo o número máximo de salas e o caminho para o ficheiro de log.
+ * @return Um pointer para a nova estrutura `Room` criada, ou NULL se a alocação de memória falhar.
+ *
+ * @details Esta função faz o seguinte:
+ * - Aloca memória para uma nova estrutura `Room` e inicializa os seus campos a zeros.
+ * - Gera um identificador único para a sala usando `generateUniqueId`.
+ * - Aloca memória para o array de jogadores da sala, com o tamanho máximo definido em `config`.
+ * - Regista a criação da sala no ficheiro de log.
+ * - Devolve o pointer para a sala criada, ou NULL se a alocação de memória falhar.
+ *
+ * @note A sala não fica visível para os outros clientes até ser registada com `registerRoom`.
+ */
+
+Room *createRoom(ServerConfig *config, int playerID, bool isSinglePlayer, int synchronizationType) {
+
+    Room *room = (Room *)malloc(sizeof(Room));
+    if (room == NULL) {
+        err_dump(config, 0, playerID, "Memory allocation failed", EVENT_ROOM_NOT_LOAD);
+        return NULL;
+    }
+    memset(room, 0, sizeof(Room));  // Initialize Room struct
+
+    room->id = generateUniqueId();
+    printf("Room ID na criação da room: %d\n", room->id);
+    room->timer = 60;
+    room->isGameRunning = false;
+    room->isFinished = false;
+    room->isSinglePlayer = isSinglePlayer;
+    room->maxClients = room->isSinglePlayer ? 1 : config->maxClientsPerRoom;
+    room->clients = (Client **)malloc(sizeof(Client *) * room->maxClients);
+    room->waitingClients = (Client **)malloc(sizeof(Client *) * room->maxClients);
+    room->maxWaitingTime = config->maxWaitingTime;
+    room->synchronizationType = isSinglePlayer ? 0 : synchronizationType;
+
+    // the creator holds the first reference
+    room->refCount = 1;
+    pthread_mutex_init(&room->mutex, NULL);
+
+    // spectators watch the room through its feed
+    room->feed = createSpectatorFeed(room->id);
+
+    // we dont need synchronization for single player games
+    if (!room->isSinglePlayer) {
+
+        // Inicializar priority queue
+        room->enterRoomQueue = (PriorityQueue *)malloc(sizeof(PriorityQueue));
+        initPriorityQueue(room->enterRoomQueue, room->maxClients * 2);
+
+        // Initialize reader-writer locks
+        sem_init(&room->writeSemaphore, 0, 1); // Inicializar semáforo para escrita e começa a aceitar 1 escritor
+        sem_init(&room->readSemaphore, 0, 1); // Inicializar semáforo para leitura e começa a aceitar 1 leitor
+        sem_init(&room->nonPremiumWriteSemaphore, 0, 0); //
+        pthread_mutex_init(&room->readMutex, NULL); // Inicializar mutex para leitura
+        pthread_mutex_init(&room->writeMutex, NULL); // Inicializar mutex para escrita
+        room->readerCount = 0;
+        room->writerCount = 0;
+
+        // barber shop initialization
+        room->customers = 0;
+        pthread_mutex_init(&room->barberShopMutex, NULL);
+        sem_init(&room->costumerSemaphore, 0, 0);
+        sem_init(&room->costumerDoneSemaphore, 0, 0);
+        sem_init(&room->barberDoneSemaphore, 0, 0);
+        room->barberShopQueue = (PriorityQueue *)malloc(sizeof(PriorityQueue));
+        initPriorityQueue(room->barberShopQueue, room->maxClients);
+
+        // check if the game is reader-writer or barber shop
+        if (synchronizationType == 0) {
+            room->isReaderWriter = true;
+        }
+
+        if (synchronizationType == 1) { // barber shop with static priority
+            room->isReaderWriter = false;
+            room->priorityQueueType = 0;
+        }
+
+        if (synchronizationType == 2) { // barber shop with dynamic priority
+            room->isReaderWriter = false;
+            room->priorityQueueType = 1;
+        }
+
+        if (synchronizationType == 3) { // barber shop with FIFO
+            room->isReaderWriter = false;
+            room->priorityQueueType = 2;
+        }
+
+        if (!room->isReaderWriter) {
+            // initialize thread for barber
+            if(pthread_create(&room->barberThread, NULL, handleBarber, (void *)room)) {
+                err_dump(config, 0, playerID, "Erro ao criar a thread do barbeiro", EVENT_THREAD_NOT_CREATE);
+            }
+            produceLog(config, "Barbeiro criado com sucesso", EVENT_BARBER_CREATED, room->id, playerID);
+        }
+        
+        // initialize mutexes
+        pthread_mutex_init(&room->timerMutex, NULL);
+    }
+
+    // log room creation
+    produceLog(config, "Sala criada com sucesso", EVENT_ROOM_LOAD, room->id, playerID);
+    return room;
+}
+
+bool registerRoom(ServerConfig *config, Room *room) {
+
+    bool registered = false;
+
+    pthread_rwlock_wrlock(&config->roomsLock);
+
+    // add the room to the list of rooms and increment the number of rooms (none while draining)
+    if (config->numRooms < config->maxRooms && !config->isDraining) {
+        config->rooms[config->numRooms++] = room;
+        registered = true;
+    }
+
+    pthread_rwlock_unlock(&config->roomsLock);
+
+    return registered;
+}
+
+Room *getRoom(ServerConfig *config, int roomID, int playerID) {
+
+    // check if roomID is valid
+    if (roomID < 1) {
+        err_dump(config, 0, playerID, "Room ID is invalid", EVENT_ROOM_NOT_JOIN);
+        return NULL;
+    }
+
+    // get the room by looping through the rooms
+    Room *room = NULL;
+
+    pthread_rwlock_rdlock(&config->roomsLock);
+
+    for (int i = 0; i < config->numRooms; i++) {
+        //printf("i: %d\n", i);
+        //printf("NR rooms: %d\n", config->numRooms);
+        //printf("ROOM ID: %d\n", config->rooms[i]->id);
+        if (config->rooms[i]->id == roomID) {
+            room = config->rooms[i];
+
+            // take a reference while the registry guarantees the room is alive
+            pthread_mutex_lock(&room->mutex);
+            room->refCount++;
+            pthread_mutex_unlock(&room->mutex);
+            break;
+        }
+    }
+
+    pthread_rwlock_unlock(&config->roomsLock);
+
+    return room;
+}
+
+// remove a room from the registry (caller must hold roomsLock as writer)
+static void unregisterRoom(ServerConfig *config, Room *room) {
+    for (int i = 0; i < config->numRooms; i++) {
+        if (config->rooms[i] == room) {
+
+            // shift all rooms to the left
+            for (int j = i; j < config->numRooms - 1; j++) {
+                config->rooms[j] = config->rooms[j + 1];
+            }
+
+            // decrement number of rooms
+            config->numRooms--;
+            break;
+        }
+    }
+}
+
+void destroyRoom(ServerConfig *config, Room *room) {
+
+    int roomID = room->id;
+    printf("FREEING MEMORY FOR ROOM %d\n", roomID);
+
+    free(room->clients);
+    free(room->waitingClients);
+
+    // the room leaves the write-ahead log, finished or not
+    walRoomFinished(config, room);
+
+    // tell the spectators the room is over (the feed lives on while they are watching)
+    closeSpectatorFeed(room->feed);
+
+    free(room->game);
+
+    // Destruir mutexes e semáforos
+    pthread_mutex_destroy(&room->mutex);
+    if (!room->isSinglePlayer) {
+        pthread_mutex_destroy(&room->timerMutex);
+        pthread_mutex_destroy(&room->readMutex);
+        pthread_mutex_destroy(&room->writeMutex);
+        pthread_mutex_destroy(&room->barberShopMutex);
+        sem_destroy(&room->writeSemaphore);
+        sem_destroy(&room->readSemaphore);
+        sem_destroy(&room->nonPremiumWriteSemaphore);
+        sem_destroy(&room->costumerSemaphore);
+        sem_destroy(&room->costumerDoneSemaphore);
+        sem_destroy(&room->barberDoneSemaphore);
+
+        // destroy barber
+        if (!room->isReaderWriter) {
+            pthread_cancel(room->barberThread);
+        }
+
+        // free priority queue
+        freePriorityQueue(room->enterRoomQueue);
+        freePriorityQueue(room->barberShopQueue);
+    }
+
+    free(room);
+
+    // log room deletion
+    produceLog(config, "Sala eliminada com sucesso", EVENT_ROOM_DELETE, roomID, 0);
+}
+
+void deleteRoom(ServerConfig *config, int roomID) {
+
+    Room *room = NULL;
+
+    pthread_rwlock_wrlock(&config->roomsLock);
+
+    for (int i = 0; i < config->numRooms; i++) {
+        if (config->rooms[i]->id == roomID) {
+            room = config->rooms[i];
+            unregisterRoom(config, room);
+            break;
+        }
+    }
+
+    pthread_rwlock_unlock(&config->roomsLock);
+
+    if (room != NULL) {
+        destroyRoom(config, room);
+    }
+}
+
+void releaseRoom(ServerConfig *config, Room *room) {
+
+    // the registry lock makes "last reference dropped" and "unregistered" atomic for getRoom
+    pthread_rwlock_wrlock(&config->roomsLock);
+
+    pthread_mutex_lock(&room->mutex);
+    bool isLastReference = --room->refCount == 0;
+    pthread_mutex_unlock(&room->mutex);
+
+    if (isLastReference) {
+        unregisterRoom(config, room);
+    }
+
+    pthread_rwlock_unlock(&config->roomsLock);
+
+    if (isLastReference) {
+        destroyRoom(config, room);
+    }
+}
+
+/**
+ * Acrescenta uma linha ao bloco da listagem, enviando o bloco ao cliente quando este fica cheio.
+ *
+ * @param config Um pointer para a estrutura `ServerConfig` usada para registar erros.
+ * @param client O cliente que recebe a listagem.
+ * @param chunk O bloco atual, com `BUFFER_SIZE` bytes.
+ * @param used O número de bytes já ocupados no bloco.
+ * @param line A linha a acrescentar (terminada em '\n').
+ */
+
+static void appendListingLine(ServerConfig *config, Client *client, char *chunk, int *used, const char *line) {
+
+    int length = strlen(line);
+
+    // flush the chunk before it overflows
+    if (*used + length > BUFFER_SIZE) {
+        if (writen(client->socket_fd, chunk, *used) != *used) {
+            produceLog(config, "can't send listing to client", EVENT_MESSAGE_SERVER_NOT_SENT, 0, client->clientID);
+        }
+        *used = 0;
+    }
+
+    memcpy(chunk + *used, line, length);
+    *used += length;
+}
+
+/**
+ * Termina a listagem com a linha "END <offset> <count> <total>" e envia o último bloco.
+ */
+
+static void finishListing(ServerConfig *config, Client *client, char *chunk, int *used, int offset, int count, int total) {
+
+    char line[64];
+    snprintf(line, sizeof(line), "END %d %d %d\n", offset, count, total);
+    appendListingLine(config, client, chunk, used, line);
+
+    if (writen(client->socket_fd, chunk, *used) != *used) {
+        produceLog(config, "can't send listing to client", EVENT_MESSAGE_SERVER_NOT_SENT, 0, client->clientID);
+    }
+    *used = 0;
+}
+
+/**
+ * Ajusta o offset e o limite pedidos pelo cliente para valores válidos.
+ */
+
+static void clampPage(int *offset, int *limit) {
+
+    if (*offset < 0) {
+        *offset = 0;
+    }
+
+    if (*limit <= 0) {
+        *limit = LISTING_PAGE_SIZE;
+    } else if (*limit > LISTING_MAX_PAGE_SIZE) {
+        *limit = LISTING_MAX_PAGE_SIZE;
+    }
+}
+
+/**
+ * Envia ao cliente uma página da lista de jogos, a partir do catálogo em memória.
+ *
+ * @param config Um pointer para a estrutura `ServerConfig` que contém o catálogo de jogos.
+ * @param client O cliente que pediu a listagem.
+ * @param offset A posição do primeiro jogo da página (entre os jogos que passam o filtro).
+ * @param limit O número máximo de jogos na página.
+ * @param difficulty A dificuldade pedida, ou 0 para qualquer dificuldade.
+ *
+ * @details Esta função faz o seguinte:
+ * - Percorre o catálogo (ordenado por ID) e escolhe os jogos da página pedida,
+ *   formatados como "Game ID: [ID] (difficulty [D])".
+ * - Envia as linhas em blocos de `BUFFER_SIZE` bytes, à medida que são preenchidos.
+ * - Termina com a linha "END <offset> <count> <total>", onde `total` é o número de
+ *   jogos que passam o filtro.
+ *
+ * @note O ficheiro de jogos não é lido; o catálogo é construído no arranque do servidor e
+ *       reconstruído em cada SIGHUP.
+ */
+
+void sendGamesPage(ServerConfig *config, Client *client, int offset, int limit, int difficulty) {
+
+    char chunk[BUFFER_SIZE];
+    int used = 0;
+    int count = 0;
+    int total = 0;
+    // the version found here is the one listed, even if a reload publishes another meanwhile
+    GameCatalog *catalog = enterCatalog(config);
+
+    clampPage(&offset, &limit);
+
+    for (int i = 0; i < catalog->numGames; i++) {
+
+        CatalogEntry *entry = &catalog->entries[i];
+
+        if (difficulty != 0 && entry->difficulty != difficulty) {
+            continue;
+        }
+
+        // only the entries inside the requested page are sent
+        if (total >= offset && count < limit) {
+            char line[64];
+            snprintf(line, sizeof(line), "Game ID: %d (difficulty %d)\n", entry->id, entry->difficulty);
+            appendListingLine(config, client, chunk, &used, line);
+            count++;
+        }
+        total++;
+    }
+
+    leaveCatalog();
+
+    finishListing(config, client, chunk, &used, offset, count, total);
+
+    produceLog(config, "Jogos enviados para o cliente", EVENT_SERVER_GAMES_SENT, 0, client->clientID);
+}
+
+typedef struct {
+    int id;
+    int numClients;
+    int maxClients;
+    int gameID;
+    int synchronizationType;
+} RoomListing;
+
+static const char *synchronizationName(int synchronizationType) {
+
+    switch (synchronizationType) {
+        case 0: return "Readers-Writers";
+        case 1: return "Barber-Shop static priority";
+        case 2: return "Barber-Shop dynamic priority";
+        case 3: return "Barber-Shop FIFO";
+        default: return "Unknown";
+    }
+}
+
+/**
+ * Envia ao cliente uma página da lista de salas multiplayer à espera de jogadores.
+ *
+ * @param config Um pointer para a estrutura `ServerConfig` que contém as salas de jogo.
+ * @param client O cliente que pediu a listagem.
+ * @param offset A posição da primeira sala da página (entre as salas que passam os filtros).
+ * @param limit O número máximo de salas na página.
+ * @param synchronizationType O tipo de sincronização pedido, ou -1 para qualquer tipo.
+ * @param minOpenSlots O número mínimo de lugares livres na sala.
+ *
+ * @details Esta função faz o seguinte:
+ * - Com o lock de leitura das salas, copia apenas as salas da página pedida e conta as
+ *   salas que passam os filtros.
+ * - Sem nenhum lock, formata as salas como
+ *   "Room ID: [ID], Players: [N]/[MAX], Game ID: [ID], Sync: [TIPO]" e envia-as em blocos.
+ * - Envia "No rooms available" se nenhuma sala passar os filtros.
+ * - Termina com a linha "END <offset> <count> <total>".
+ */
+
+void sendRoomsPage(ServerConfig *config, Client *client, int offset, int limit, int synchronizationType, int minOpenSlots) {
+
+    char chunk[BUFFER_SIZE];
+    int used = 0;
+    int count = 0;
+    int total = 0;
+
+    clampPage(&offset, &limit);
+
+    RoomListing *page = (RoomListing *)arenaMalloc(sizeof(RoomListing) * limit);
+    if (page == NULL) {
+        err_dump(config, 0, client->clientID, "Memory allocation failed", EVENT_ROOM_NOT_LOAD);
+        return;
+    }
+
+    pthread_rwlock_rdlock(&config->roomsLock);
+
+    for (int i = 0; i < config->numRooms; i++) {
+
+        Room *room = config->rooms[i];
+
+        // can only join multiplayer rooms that are not running
+        if (room == NULL || room->isSinglePlayer || room->isGameRunning) {
+            continue;
+        }
+
+        if (synchronizationType >= 0 && room->synchronizationType != synchronizationType) {
+            continue;
+        }
+
+        if (room->maxClients - room->numClients < minOpenSlots) {
+            continue;
+        }
+
+        if (total >= offset && count < limit) {
+            page[count].id = room->id;
+            page[count].numClients = room->numClients;
+            page[count].maxClients = room->maxClients;
+            page[count].gameID = room->game->id;
+            page[count].synchronizationType = room->synchronizationType;
+            count++;
+        }
+        total++;
+    }
+
+    pthread_rwlock_unlock(&config->roomsLock);
+
+    if (total == 0) {
+        appendListingLine(config, client, chunk, &used, "No rooms available\n");
+    }
+
+    for (int i = 0; i < count; i++) {
+        char line[128];
+        snprintf(line, sizeof(line), "Room ID: %d, Players: %d/%d, Game ID: %d, Sync: %s\n",
+                 page[i].id, page[i].numClients, page[i].maxClients, page[i].gameID,
+                 synchronizationName(page[i].synchronizationType));
+        appendListingLine(config, client, chunk, &used, line);
+    }
+
+    arenaFree(page);
+
+    finishListing(config, client, chunk, &used, offset, count, total);
+
+    produceLog(config, "Salas enviadas para o cliente", EVENT_SERVER_GAMES_SENT, 0, client->clientID);
+}
+
+/**
+ * Cria uma nova sala de jogo e carrega um jogo associado, atribuindo-o a um jogador.
+ *
+ * @param newSockfd Um pointer para o descritor de socket do cliente, usado para enviar mensagens.
+ * @param config Um pointer para a estrutura `ServerConfig` que contém as configurações do servidor.
+ * @param ClientID O identificador do jogador que irá participar na sala.
+ * @param isSinglePlayer Um valor booleano que indica se o jogo é single Client (true) ou MultiPlayer (false).
+ * @param isRandom Um valor booleano que indica se o jogo deve ser carregado aleatoriamente (true),
+ * ou se um jogo específico deve ser carregado (false).
+ * @param gameID O identificador do jogo a ser carregado, usado se `isRandom` for false.
+ * @param synchronizationType O tipo de sincronização da sala MultiPlayer.
+ * @param difficulty A dificuldade do jogo aleatório (0 para qualquer), usada se `isRandom` for true.
+ * @return Um pointer para a estrutura `Room` criada, ou NULL se não houver salas disponíveis
+ * ou o jogo não existir.
+ *
+ * @details Esta função faz o seguinte:
+ * - Verifica se o número máximo de salas foi atingido. 
+ *   Se não houver salas disponíveis, envia uma mensagem ao cliente e regista o evento no ficheiro de log.
+ * - Cria uma nova sala e adiciona-a à lista de salas do servidor.
+ * - Carrega um jogo, seja de forma aleatória ou usando o `gameID` especificado. Se o jogo não
+ *   existir (por exemplo, saiu do catálogo num SIGHUP), envia "Game not found" ao cliente e o
+ *   pedido acaba sem sala, voltando o cliente ao menu.
+ * - Se o jogo for carregado com sucesso, associa-o à sala criada.
+ * - Define o número máximo de jogadores para 1 se for um jogo single Client, 
+ *   ou para o valor definido na configuração se for MultiPlayer.
+ * - Adiciona o jogador à sala e inicializa o número de jogadores da sala.
+ * - Imprime uma mensagem de confirmação e retorna a sala criada.
+ */
+
+Room *createRoomAndGame(ServerConfig *config, Client *client, bool isSinglePlayer, bool isRandom, int gameID, int synchronizationType, int difficulty) {
+
+    // fail fast if there's no free room (checked again when registering)
+    pthread_rwlock_rdlock(&config->roomsLock);
+    bool isFull = config->numRooms >= config->maxRooms || config->isDraining;
+    pthread_rwlock_unlock(&config->roomsLock);
+
+    if (isFull) {
+        // send message to client
+        send(client->socket_fd, "No rooms available", strlen("No rooms available"), 0);
+        // write log
+        produceLog(config, "No rooms available", EVENT_ROOM_NOT_CREATED, 0, client->clientID);
+        return NULL;
+    }
+
+    // load game
+    Game *game;
+
+    if (isRandom) {
+        game = loadRandomGame(config, client->clientID, difficulty);
+    } else {
+        game = loadGame(config, gameID, client->clientID);
+    }
+
+    // an unknown ID (a stale listing, or a game a catalog reload removed) only fails this request
+    if (game == NULL) {
+        send(client->socket_fd, "Game not found", strlen("Game not found"), 0);
+        produceLog(config, "Game not found", EVENT_GAME_NOT_FOUND, gameID, client->clientID);
+        return NULL;
+    }
+
+    // create room
+    Room *room = createRoom(config, client->clientID, isSinglePlayer, synchronizationType);
+
+    // add game to room
+    room->game = game;
+    publishRoomSnapshot(room);
+    
+    joinRoom(config, room, client);
+
+    // publish the room only once it is fully built
+    if (!registerRoom(config, room)) {
+        destroyRoom(config, room);
+        send(client->socket_fd, "No rooms available", strlen("No rooms available"), 0);
+        produceLog(config, "No rooms available", EVENT_ROOM_NOT_CREATED, 0, client->clientID);
+        return NULL;
+    }
+
+    char buffer[BUFFER_SIZE];
+    memset(buffer, 0, sizeof(buffer));
+
+    strcpy(buffer, "");
+
+    if (!room->isSinglePlayer && !room->isReaderWriter) {
+        if (room->priorityQueueType == 0) {
+            strcpy(buffer, " and STATIC PRIORITIES queue");
+        } else if (room->priorityQueueType == 1) {
+            strcpy(buffer, " and DYNAMIC PRIORITIES queue");
+        } else if (room->priorityQueueType == 2) {
+            strcpy(buffer, " and FIFO queue");
+        }
+    }
+
+    // Mensagem de criação da sala
+    printf("New game created by client %d with game %d and room is synchronized by %s%s. Client %d is %s.\n", 
+            client->clientID, room->game->id, 
+            !room->isSinglePlayer ? (room->isReaderWriter ? "READER-WRITER" : "BARBER SHOP") : "",
+            buffer,
+            client->clientID, client->isPremium ? "Premium" : "Non-premium");
+    
+    if (!room->isSinglePlayer) {
+        printf("Waiting for more Clients to join in room %d\n", room->id);
+    }
+    
+
+    return room;
+}
+
+/**
+ * Adiciona um jogador a uma sala de jogo existente.
+ *
+ * @param config Um pointer para a estrutura `ServerConfig` que contém as informações 
+ * de configuração do servidor, incluindo a lista de salas.
+ * @param roomID O identificador da sala que o jogador pretende entrar.
+ * @param ClientID O identificador do jogador que deseja juntar-se à sala.
+ * @return Um pointer para a sala `Room` se o jogador for adicionado com sucesso, 
+ * ou NULL se a sala estiver cheia ou se o `roomID` for inválido.
+ *
+ * @details Esta função faz o seguinte:
+ * - Verifica se o `roomID` fornecido é válido (dentro dos limites das salas existentes).
+ * - Obtém a sala correspondente a partir da lista de salas no servidor.
+ * - Verifica se a sala já está cheia. Se estiver, devolve NULL e imprime uma mensagem de erro no terminal.
+ * - Se houver espaço na sala, adiciona o jogador ao array de jogadores da sala e incrementa o número de jogadores.
+ * - Regista no ficheiro de log que o jogador entrou na sala.
+ * - Devolve um pointer para a sala `Room` atualizada.
+ */
+void joinRoom(ServerConfig *config, Room *room, Client *client) {
+
+    // check if room is full
+    if (room->numClients == room->maxClients) {
+        err_dump(config, 0, client->clientID, "Room is full", EVENT_ROOM_NOT_JOIN);
+        return;
+    }
+
+    // check if room is running
+    if (room->isGameRunning) {
+        err_dump(config, 0, client->clientID, "Room is running", EVENT_ROOM_NOT_JOIN);
+        return;
+    }
+
+    //printf("Client %d joined room %d\n", client->clientID, room->id);
+
+    // add client to room
+    room->clients[room->numClients] = client;
+
+    // increment number of clients
+    room->numClients++;
+
+    // Log de entrada do jogador na sala
+    produceEventLog(config, LOG_EVENT_ROOM_JOINED, room->game->id, client->clientID, room->id);
+
+    printf("Client %d (Premium: %s) joined room %d with socket %d\n",
+           client->clientID, client->isPremium ? "Yes" : "No", room->id, client->socket_fd);
+}
+
+/**
+ * Envia o tabuleiro do jogo ao cliente em formato JSON.
+ *
+ * @param socket Um pointer para o descritor de socket utilizado para enviar o tabuleiro ao cliente.
+ * @param game Um pointer para a estrutura `Game` que contém o tabuleiro a ser enviado.
+ * @param config Um pointer para a estrutura `ServerConfig` que contém a configuração do servidor, 
+ * incluindo o caminho do ficheiro de log.
+ *
+ * @details Esta função faz o seguinte:
+ * - Representa o tabuleiro do jogo em JSON, com o ID do jogo, o tamanho em `size` e o
+ *   tabuleiro NxN como um array de arrays.
+ * - Escreve o JSON diretamente numa mensagem na stack (`jsonBoard`), sem árvore do parson e sem
+ *   alocar memória, seguido da linha atual, e envia-a ao cliente.
+ * - Em caso de erro ao enviar o tabuleiro, regista a mensagem de erro no log e termina a execução da função.
+ */
+
+void sendBoard(ServerConfig *config, Room* room, Client *client) {
+
+    // Enviar board ao cliente em formato JSON, escrito diretamente na mensagem
+    char message[BOARD_MESSAGE_SIZE];
+    JsonWriter writer;
+    jsonWriterInit(&writer, message, sizeof(message) - 16);
+    jsonBoard(&writer, room->game->id, room->game->size, &room->game->board[0][0], BOARD_ROW_STRIDE);
+
+    size_t boardLength = jsonWriterFinish(&writer);
+    if (boardLength == 0) {
+        produceLog(config, "can't serialize board", EVENT_MESSAGE_SERVER_NOT_SENT, room->game->id, client->clientID);
+        return;
+    }
+
+    // adicionar a linha atual como um inteiro; o '\n' final marca o fim da mensagem,
+    // que pode ocupar mais do que um segmento nos tabuleiros grandes
+    int length = boardLength + sprintf(message + boardLength, "\n%d\n", room->game->currentLine);
+
+    //printf("Enviando tabuleiro ao cliente %d do jogo %d\n", client->clientID, room->game->id);
+    //printf("Enviando board e linha atual: %s\n", message);
+    // Enviar tabuleiro e linha atual ao cliente
+    // a lost connection shows up on the next recv, where the player can resume the session
+    if (writen(client->socket_fd, message, length) < 0) {
+        produceLog(config, "can't send board and line to client", EVENT_MESSAGE_SERVER_NOT_SENT, room->game->id, client->clientID);
+    } else {
+        // escrever no log
+        produceEventLog(config, LOG_EVENT_BOARD_SENT, room->game->id, client->clientID, room->game->currentLine);
+    }
+}
+
+
+// the reader and writer sections of a multiplayer room (a single player room has nobody to share it with)
+static void enterReaderSection(Room *room, Client *client) {
+    if (!room->isSinglePlayer) {
+        if (room->isReaderWriter) {
+            acquireReadLock(room);
+        } else {
+            enterBarberShop(room, client);
+        }
+    }
+}
+
+static void leaveReaderSection(Room *room, Client *client) {
+    if (!room->isSinglePlayer) {
+        if (room->isReaderWriter) {
+            releaseReadLock(room);
+        } else {
+            leaveBarberShop(room, client);
+        }
+    }
+}
+
+static void enterWriterSection(Room *room, Client *client) {
+    if (!room->isSinglePlayer) {
+        if (room->isReaderWriter) {
+            acquireWriteLock(room, client);
+        } else {
+            enterBarberShop(room, client);
+        }
+    }
+}
+
+static void leaveWriterSection(Room *room, Client *client) {
+    if (!room->isSinglePlayer) {
+        if (room->isReaderWriter) {
+            releaseWriteLock(room, client);
+        } else {
+            leaveBarberShop(room, client);
+        }
+    }
+}
+
+// wake the players the room was holding (each one with its step already set)
+static void wakeWaitingClients(Room *room) {
+
+    pthread_mutex_lock(&room->mutex);
+    int numWaiting = room->numWaiting;
+    Client *waitingClients[room->maxClients];
+    memcpy(waitingClients, room->waitingClients, sizeof(Client *) * numWaiting);
+    room->numWaiting = 0;
+    pthread_mutex_unlock(&room->mutex);
+
+    for (int i = 0; i < numWaiting; i++) {
+        wakeSession(waitingClients[i]);
+    }
+}
+
+/**
+ * Termina as linhas de um jogador, que já não tem mais nenhuma para enviar.
+ *
+ * @param config Um pointer para a estrutura `ServerConfig` com a configuração do servidor.
+ * @param room A sala do jogador.
+ * @param client O jogador.
+ * @return `SESSION_CONTINUE` se o jogador vai enviar a accuracy, ou `SESSION_CLOSED` se saiu do jogo.
+ *
+ * @details Esta função faz o seguinte:
+ * - Conta o jogador como terminado. O último jogador da sala a terminar (ou qualquer jogador de uma
+ *   sala restaurada, onde os outros podem nunca voltar) pára o relógio da sala e acorda os jogadores
+ *   que já enviaram a accuracy e esperam pelo tempo final.
+ * - Um jogador que perdeu a ligação e não a retomou liberta a sua referência para a sala.
+ */
+
+static SessionStatus finishLines(ServerConfig *config, Room *room, Client *client) {
+
+    pthread_mutex_lock(&room->mutex);
+    room->numDone++;
+    bool isRoomDone = room->isRestored || room->numDone >= room->numClients;
+    pthread_mutex_unlock(&room->mutex);
+
+    if (isRoomDone) {
+        stopGameClock(room);
+        wakeWaitingClients(room);
+    }
+
+    // the player left for good: only give the room back
+    if (!client->isConnected) {
+        releaseRoom(config, room);
+        client->room = NULL;
+        return SESSION_CLOSED;
+    }
+
+    client->step = STEP_ACCURACY;
+    return SESSION_CONTINUE;
+}
+
+// send the board as a reader of the room; the player's lines are over once it is complete
+static SessionStatus sendBoardAndContinue(ServerConfig *config, Room *room, Client *client) {
+
+    enterReaderSection(room, client);
+    sendBoard(config, room, client);
+    leaveReaderSection(room, client);
+
+    if (room->game->currentLine > room->game->size) {
+        return finishLines(config, room, client);
+    }
+
+    return SESSION_CONTINUE;
+}
+
+// the game starts for this player: the board, then its lines
+static SessionStatus startSeat(ServerConfig *config, Room *room, Client *client) {
+
+    walRoomStarted(config, room, client);
+
+    client->step = STEP_LINE;
+    return sendBoardAndContinue(config, room, client);
+}
+
+/**
+ * Recebe uma linha do cliente, valida-a e atualiza o tabuleiro do jogo.
+ *
+ * @param config Um pointer para a estrutura `ServerConfig` que contém a configuração do servidor.
+ * @param room A sala do jogador.
+ * @param client O jogador, cujo socket já tem a linha para ler.
+ * @return `SESSION_CONTINUE` se o jogador fica à espera da próxima mensagem, `SESSION_HELD` se a
+ * ligação caiu e a sessão espera que ele a retome, ou `SESSION_CLOSED` se saiu do jogo.
+ *
+ * @details Esta função faz o seguinte:
+ * - Recebe uma linha (um carácter por célula) e converte-a em valores inteiros.
+ * - Usa a função `verifyLine` para validar a linha, como escritor da sala. Se a linha estiver
+ *   correta, o jogo passa para a próxima; caso contrário, o cliente volta a enviá-la.
+ * - Envia o tabuleiro atualizado ao cliente, como leitor da sala.
+ * - Se a ligação caiu, larga o socket, sem locks da sala, e deixa a sessão à espera que o jogador
+ *   a retome; o worker volta logo para o pool.
+ * - Quando o servidor está a desligar e a sala já foi guardada (`isFrozen`), as linhas deixam de ser
+ *   aplicadas e ficam sem resposta; o jogador volta a enviá-las depois de retomar a sessão.
+ * - Uma linha que chega depois de outro jogador completar o tabuleiro só recebe o tabuleiro final.
+ */
+
+static SessionStatus receiveLine(ServerConfig *config, Room *room, Client *client) {
+
+    // uma linha tem um carácter por célula e o terminador que o cliente envia, e sobra um byte para o nosso
+    char line[BOARD_LINE_MESSAGE_SIZE];
+
+    // Limpar linha
+    memset(line, 0, sizeof(line));
+
+    // Receber linha do cliente
+    if (recv(client->socket_fd, line, sizeof(line) - 1, 0) <= 0) {
+
+        // a ligação caiu: sem locks da sala, a sessão espera que o jogador a retome
+        if (detachSession(config, client)) {
+            return SESSION_HELD;
+        }
+
+        return finishLines(config, room, client);
+    }
+
+    printf("Cliente %d %s quer resolver a linha %d na sala %d com o jogo %d\n", 
+    client->clientID, client->isPremium ? "(PREMIUM)" : "(NOT PREMIUM)",
+    room->id, room->game->id, room->game->currentLine);
+
+    // pre condition writer
+    enterWriterSection(room, client);
+
+    // Converte a linha recebida em valores inteiros
+    char insertLine[BOARD_ROW_STRIDE] __attribute__((aligned(32)));
+    memset(insertLine, 0, sizeof(insertLine));
+    for (int j = 0; j < room->game->size; j++) {
+        int value = decodeCell(line[j]);
+        insertLine[j] = value > 0 ? value : 0;
+    }
+
+    printf("Verificando linha %d do cliente %d na sala %d com o o jogo %d\n", 
+    room->game->currentLine, client->clientID, room->id, room->game->id);
+
+    // critical section writer
+    int row = room->game->currentLine - 1;
+
+    // the line is applied under the room mutex, where the drain snapshot copies the board
+    pthread_mutex_lock(&room->mutex);
+    bool isFrozen = room->isFrozen;
+    bool isApplied = !isFrozen && row < room->game->size;
+    if (isApplied && verifyLine(config, room->game, line, insertLine, client->clientID) == 1) {
+        // linha correta
+        (room->game->currentLine)++;
+    }
+    pthread_mutex_unlock(&room->mutex);
+
+    // the room is saved and the server is going down: the line gets no reply and is sent
+    // again after the restart, when the player resumes the session
+    if (isFrozen) {
+        leaveWriterSection(room, client);
+        return SESSION_CONTINUE;
+    }
+
+    if (isApplied) {
+        // the merged row goes to the write-ahead log, in the order the writers apply them
+        walLineVerified(room, row);
+
+        // encode the new board once for every spectator, still inside the writer section
+        publishRoomSnapshot(room);
+    }
+
+    // post condition writer
+    leaveWriterSection(room, client);
+
+    SessionStatus status = sendBoardAndContinue(config, room, client);
+    printf("-----------------------------------------------------\n");
+
+    return status;
+}
+
+/**
+ * Termina o jogo de um cliente e liberta a sua referência para a sala de jogo.
+ *
+ * @param config Um pointer para a estrutura `ServerConfig` que contém a configuração do servidor.
+ * @param room Um pointer para a estrutura `Room` que representa a sala de jogo que deve ser terminada.
+ * @param client O cliente que está a terminar o jogo, com a accuracy já recebida.
+ * @return `SESSION_CONTINUE`: o cliente volta ao menu.
+ *
+ * @details Esta função faz o seguinte:
+ * - Envia ao cliente o tempo total do jogo, medido até o último jogador da sala terminar as linhas,
+ *   sem qualquer lock partilhado, para que um cliente lento não bloqueie os restantes.
+ * - Acrescenta o resultado às estatísticas e põe-no na fila do estágio de resultados, que escreve
+ *   os recordes do jogo e o leaderboard em lotes com os resultados das outras salas.
+ * - Liberta a referência do cliente; a sala é eliminada quando o último cliente sai.
+ */
+
+static SessionStatus finishGame(ServerConfig *config, Room *room, Client *client) {
+
+    double elapsedTime = stopGameClock(room);
+    int gameID = room->game->id;
+
+    // Envia o tempo decorrido ao cliente
+    char timeMessage[256];
+    snprintf(timeMessage, sizeof(timeMessage), "O jogo terminou! Tempo total: %.2f segundos\n", elapsedTime);
+    if (send(client->socket_fd, timeMessage, strlen(timeMessage), 0) < 0) {
+        // erro ao enviar mensagem
+        produceLog(config, "can't send time message to client", EVENT_MESSAGE_SERVER_NOT_SENT, gameID, client->clientID);
+    }
+
+    // escrever no log o tempo enviado
+    produceEventLog(config, LOG_EVENT_TIME_SENT, gameID, client->clientID, (int)(elapsedTime * 100));
+
+    recordGameResult(config, room, client, elapsedTime, client->accuracy);
+
+    // remove room when the last client leaves
+    releaseRoom(config, room);
+    client->room = NULL;
+
+    client->step = STEP_MENU;
+    return SESSION_CONTINUE;
+}
+
+// receive the player's accuracy; the time is sent once every player of the room is done
+static SessionStatus receiveAccuracy(ServerConfig *config, Room *room, Client *client) {
+
+    // get accuracy from client
+    char accuracy[10];
+    memset(accuracy, 0, sizeof(accuracy));
+    if (recv(client->socket_fd, accuracy, sizeof(accuracy) - 1, 0) <= 0) {
+        // erro ao receber accuracy: a ligação acaba aqui e o jogo fica abandonado, sem resultado
+        produceLog(config, "can't receive accuracy from client", EVENT_MESSAGE_SERVER_NOT_RECEIVED, room->game->id, client->clientID);
+        client->isConnected = false;
+        releaseRoom(config, room);
+        client->room = NULL;
+        return SESSION_CLOSED;
+    }
+
+    printf("A accuracy recebida foi de: %s\n", accuracy);
+
+    // convert accuracy to float
+    client->accuracy = atof(accuracy);
+
+    produceEventLog(config, LOG_EVENT_ACCURACY_RECEIVED, room->game->id, client->clientID, (int)(client->accuracy * 100));
+
+    // the others are still playing: the room wakes this player when the last one is done
+    pthread_mutex_lock(&room->mutex);
+    bool isWaiting = !room->isFinished;
+    if (isWaiting) {
+        client->step = STEP_FINISH;
+        room->waitingClients[room->numWaiting++] = client;
+    }
+    pthread_mutex_unlock(&room->mutex);
+
+    if (isWaiting) {
+        return SESSION_HELD;
+    }
+
+    return finishGame(config, room, client);
+}
+
+// the countdown is over: start the game for the players waiting in the room, and for the creator
+static SessionStatus startRoom(ServerConfig *config, Room *room, Client *client) {
+
+    pthread_mutex_lock(&room->mutex);
+    room->isGameRunning = true;
+    room->startTime = time(NULL);
+    pthread_mutex_unlock(&room->mutex);
+
+    printf("Jogo na sala %d iniciado às %s\n", room->id, ctime(&room->startTime));
+
+    wakeWaitingClients(room);
+
+    return startSeat(config, room, client);
+}
+
+/**
+ * Trata mais um segundo da contagem decrescente de uma sala multiplayer, no worker do jogador que a criou.
+ *
+ * @param config Um pointer para a estrutura `ServerConfig` com a configuração do servidor.
+ * @param room A sala criada pelo jogador.
+ * @param client O jogador que criou a sala.
+ * @return `SESSION_HELD` enquanto a contagem continua, ou o resultado do início do jogo.
+ *
+ * @details Esta função faz o seguinte:
+ * - Decide o segundo com os locks da sala, copiando os jogadores e os valores a enviar, e envia as
+ *   atualizações do temporizador sem nenhum lock.
+ * - A contagem acaba quando o tempo chega a 0 ou quando a sala fica cheia. Até lá, o próximo segundo
+ *   é um temporizador da thread das sessões paradas, por isso a contagem não ocupa nenhum worker.
+ */
+
+static SessionStatus countDown(ServerConfig *config, Room *room, Client *client) {
+
+    // decide the tick under the locks, copying the clients and the values to send
+    Client *clients[room->maxClients];
+    bool isUpdateDue = false;
+
+    pthread_mutex_lock(&room->timerMutex);
+    pthread_mutex_lock(&room->mutex);
+    int numClients = room->numClients;
+    for (int i = 0; i < numClients; i++) {
+        clients[i] = room->clients[i];
+    }
+    pthread_mutex_unlock(&room->mutex);
+
+    // Verificar se todos os jogadores se juntaram
+    if (numClients == room->maxClients) {
+        room->timer = 0;
+        isUpdateDue = true;
+        printf("All Clients have joined the room %d\n", room->id);
+        printf("Starting game in room %d\n", room->id);
+    } else if (room->timer % 10 == 0 || room->timer <= 5) {
+        // Enviar atualização do timer a cada 10 segundos ou quando o timer for inferior a 5 segundos
+        isUpdateDue = true;
+    }
+
+    int timer = room->timer;
+
+    // Decrementa o timer
+    if (room->timer > 0) {
+        room->timer--;
+    }
+
+    bool isCountingDown = room->timer > 0;
+    pthread_mutex_unlock(&room->timerMutex);
+
+    // the updates go out with no lock held
+    for (int i = 0; i < numClients && isUpdateDue; i++) {
+        sendTimerUpdate(config, room, clients[i], timer, numClients);
+    }
+
+    if (isCountingDown) {
+        scheduleSession(client, 1000);
+        return SESSION_HELD;
+    }
+
+    return startRoom(config, room, client);
+}
+
+/**
+ * Senta na sala os jogadores que pediram para entrar, quando a espera de um deles acaba.
+ *
+ * @param config Um pointer para a estrutura `ServerConfig` com a configuração do servidor.
+ * @param room A sala onde o jogador pediu para entrar.
+ * @param client O jogador cuja espera acabou.
+ * @return `SESSION_HELD` se o jogador fica à espera do início do jogo, `SESSION_CONTINUE` se volta ao
+ * menu sem lugar, ou o resultado do início do jogo se a sala já começou.
+ *
+ * @details Esta função faz o seguinte:
+ * - Tira da fila da sala todos os jogadores à espera, por ordem de prioridade, e senta-os enquanto houver
+ *   lugares e o jogo não tiver começado. Os outros recebem "Room is full" depois de os locks serem libertados.
+ * - Um jogador sentado por outro fica sentado quando a sua própria espera acaba.
+ * - Se o jogador ficou sem lugar, liberta a referência para a sala e volta ao menu.
+ */
+
+static SessionStatus takeSeat(ServerConfig *config, Room *room, Client *client) {
+
+    // Join room all clients in queue; the ones left out are told after the lock is released
+    Client *rejectedClients[room->maxClients * 2];
+    int numRejected = 0;
+
+    pthread_mutex_lock(&room->mutex);
+
+    for (int i = 0; i < room->maxClients * 2; i++) {
+
+        if (room->enterRoomQueue->front == NULL) {
+            break;
+
+        } else {
+
+            int clientIDJoin = dequeue(room->enterRoomQueue);
+
+            // get client socket
+            Client *clientTemp = findClient(config, clientIDJoin);
+            if (clientTemp == NULL) {
+                continue;
+            }
+
+            // check if room is full (or already playing) so the client doesnt join
+            if (room->numClients >= room->maxClients || room->isGameRunning) {
+
+                clientTemp->startAgain = true;
+                rejectedClients[numRejected++] = clientTemp;
+
+            } else {
+                
+                joinRoom(config, room, clientTemp);
+            }
+        }
+    }
+
+    bool isSeated = false;
+    for (int i = 0; i < room->numClients; i++) {
+        isSeated = isSeated || room->clients[i] == client;
+    }
+
+    // wait for the countdown in the room, which wakes the player when the game starts
+    bool isWaiting = isSeated && !room->isGameRunning;
+    if (isWaiting) {
+        client->step = STEP_START;
+        room->waitingClients[room->numWaiting++] = client;
+    }
+
+    pthread_mutex_unlock(&room->mutex);
+
+    for (int i = 0; i < numRejected; i++) {
+        // send message to client
+        if (send(rejectedClients[i]->socket_fd, "Room is full", strlen("Room is full"), 0) < 0) {
+            produceLog(config, "can't send message to client", EVENT_MESSAGE_SERVER_NOT_SENT, 0, rejectedClients[i]->clientID);
+        } else {
+            produceLog(config, "Room is full", EVENT_ROOM_NOT_JOIN, 0, rejectedClients[i]->clientID);
+        }
+    }
+
+    if (isWaiting) {
+        return SESSION_HELD;
+    }
+
+    // client didn't get a seat in the room
+    if (!isSeated) {
+        releaseRoom(config, room);
+        client->room = NULL;
+        client->step = STEP_MENU;
+        return SESSION_CONTINUE;
+    }
+
+    return startSeat(config, room, client);
+}
+
+SessionStatus startGame(ServerConfig *config, Room *room, Client *client) {
+
+    client->room = room;
+
+    // the creator of a multiplayer room counts down, one second at a time, before the game starts
+    if (!room->isSinglePlayer) {
+        client->step = STEP_COUNTDOWN;
+        scheduleSession(client, 1000);
+        return SESSION_HELD;
+    }
+
+    room->isGameRunning = true;
+    room->startTime = time(NULL);
+
+    return startSeat(config, room, client);
+}
+
+SessionStatus waitToJoinRoom(ServerConfig *config, Room *room, Client *client) {
+
+    // add the Client to the queue
+    enqueueWithPriority(room->enterRoomQueue, client->clientID, client->isPremium);
+
+    // the players who asked in the next seconds are seated together, by priority
+    client->room = room;
+    client->step = STEP_JOIN;
+    scheduleSession(client, ROOM_JOIN_DELAY_MS);
+
+    return SESSION_HELD;
+}
+
+SessionStatus playGameStep(ServerConfig *config, Client *client) {
+
+    Room *room = client->room;
+
+    switch (client->step) {
+
+        case STEP_COUNTDOWN:
+            return countDown(config, room, client);
+
+        case STEP_JOIN:
+            return takeSeat(config, room, client);
+
+        case STEP_START:
+            return startSeat(config, room, client);
+
+        case STEP_LINE:
+            // the grace period ran out: the game goes on without the player
+            if (!client->isConnected) {
+                return finishLines(config, room, client);
+            }
+            return receiveLine(config, room, client);
+
+        case STEP_RESUMED:
+            // o jogador voltou: enviar o tabuleiro atual na nova ligação
+            client->step = STEP_LINE;
+            return sendBoardAndContinue(config, room, client);
+
+        case STEP_ACCURACY:
+            return receiveAccuracy(config, room, client);
+
+        case STEP_FINISH:
+            return finishGame(config, room, client);
+
+        default:
+            return SESSION_CLOSED;
+    }
+}
+
+double stopGameClock(Room *room) {
+
+    // the first client to finish stops the clock
+    pthread_mutex_lock(&room->mutex);
+
+    if (!room->isFinished) {
+        time_t endTime = time(NULL);
+        room->elapsedTime = difftime(endTime, room->startTime);
+        room->isFinished = true;
+
+        printf("Jogo na sala %d terminou. Tempo total: %.2f segundos\n", room->id, room->elapsedTime);
+    }
+
+    double elapsedTime = room->elapsedTime;
+
+    pthread_mutex_unlock(&room->mutex);
+
+    return elapsedTime;
+}
+
+void recordGameResult(ServerConfig *config, Room *room, Client *client, double elapsedTime, float accuracy) {
+
+    // aggregate the result for GET_STATS
+    recordGameStatistics(config, room, client, elapsedTime, accuracy);
+
+    // the game records and the leaderboards are written in batches, off the player's path
+    queueGameResult(config, room->game->id, client->clientID, (int)elapsedTime, accuracy);
+}
+
+// Função que envia atualizações do timer para o cliente, considerando o status premium
+void sendTimerUpdate(ServerConfig *config, Room *room, Client *client, int timer, int numClients) {
+
+    // Preparar a mensagem de atualização do timer
+    char buffer[BUFFER_SIZE];
+    memset(buffer, 0, sizeof(buffer));
+
+    sprintf(buffer, "TIMERUPDATE\n%d\n%d\n%d\n%d\n", 
+            timer, room->id, room->game->id, numClients);
+
+    // Enviar a mensagem de atualização
+    if (send(client->socket_fd, buffer, strlen(buffer), 0) < 0) {
+        // erro ao enviar mensagem
+        produceLog(config, "can't send update to client", EVENT_MESSAGE_SERVER_NOT_SENT, room->game->id, client->clientID);
+    } else {
+        // Escrever no log a atualização enviada
+        produceEventLog(config, LOG_EVENT_TIMER_SENT, room->game->id, client->clientID, timer);
+        printf("Sent update to Client %d %s - Time left: %d seconds - Room ID: %d - Game ID: %d - Clients joined: %d\n",
+               client->clientID, client->isPremium ? "(Premium User)" : "(Non Premium User)", timer, room->id, room->game->id, numClients);
+    }
+}
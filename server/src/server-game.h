@@ -1,61 +1,88 @@
-#ifndef SERVER_GAME_H
-#define SERVER_GAME_H
-
-#include "../config/config.h"
-#include "server-barber.h"
-#include "server-barrier.h"
-#include "server-readerWriter.h"
-#include "server-statistics.h"
-
-// Gera um ID único para uma sala.
-int generateUniqueId();
-
-// Verifica se a linha inserida pelo jogador está correta.
-int verifyLine(ServerConfig *config, Game *game, char *solutionSent, int insertLine[9], int playerID);
-
-// Verifica se uma linha do tabuleiro está correta.
-bool isLineCorrect(Game *game, int row);
-
-// Cria uma sala e um jogo, configurando-os com base nos parâmetros fornecidos.
-Room *createRoomAndGame(ServerConfig *config, Client *client, bool isSinglePlayer, bool isRandom, int gameID, int synchronizationType);
-
-// Cria uma nova sala de jogo.
-Room *createRoom(ServerConfig *config, int playerID, bool isSinglePlayer, int synchronizationType);
-
-// Obtém uma sala de jogo a partir do ID.
-Room *getRoom(ServerConfig *config, int roomID, int playerID);
-
-// Junta um jogador a uma sala existente.
-void joinRoom(ServerConfig *config, Room *room, Client *client);
-
-// delete room
-void deleteRoom(ServerConfig *config, int roomID);
-
-// Obtém uma lista das salas de jogo disponíveis.
-char *getRooms(ServerConfig *config);
-
-// Obtém uma lista de IDs dos jogos disponíveis.
-char *getGames(ServerConfig *config);
-
-// Carrega um jogo específico a partir do ficheiro 'games.json'.
-Game *loadGame(ServerConfig *config, int gameID, int playerID);
-
-// Carrega um jogo aleatório do ficheiro 'games.json'.
-Game *loadRandomGame(ServerConfig *config, int playerID);
-
-// Envia o tabuleiro atual ao cliente em formato JSON.
-void sendBoard(ServerConfig *config, Room* room, Client *client);
-
-// Recebe as linhas enviadas pelo cliente e processa-as.
-void receiveLines(ServerConfig *config, Room *room, Client *client, int *currentLine);
-
-// Termina o jogo e limpa os recursos associados à sala.
-void finishGame(ServerConfig *config, Room *room, int *socket);
-
-// Trata o temporizador de espera do cliente.
-void handleTimer(ServerConfig *config, Room *room, Client *client);
-
-// Envia uma mensagem de atualização do temporizador ao cliente.
-void sendTimerUpdate(ServerConfig *config, Room *room, Client *client);
-
+#ifndef SERVER_GAME_H
+#define SERVER_GAME_H
+
+#include "../config/config.h"
+#include "server-barber.h"
+#include "server-readerWriter.h"
+#include "server-statistics.h"
+
+// Número de entradas por página nas listagens de jogos e salas.
+#define LISTING_PAGE_SIZE 20
+#define LISTING_MAX_PAGE_SIZE 100
+
+// Os jogadores que pedem para entrar numa sala durante este tempo são sentados juntos, por prioridade.
+#define ROOM_JOIN_DELAY_MS 5000
+
+// Gera um ID único para uma sala.
+int generateUniqueId();
+
+// Verifica se a linha inserida pelo jogador está correta.
+int verifyLine(ServerConfig *config, Game *game, char *solutionSent, const char *insertLine, int playerID);
+
+// Verifica se uma linha do tabuleiro está correta.
+bool isLineCorrect(Game *game, int row);
+
+// Cria uma sala e um jogo, configurando-os com base nos parâmetros fornecidos.
+Room *createRoomAndGame(ServerConfig *config, Client *client, bool isSinglePlayer, bool isRandom, int gameID, int synchronizationType, int difficulty);
+
+// Cria uma nova sala de jogo.
+Room *createRoom(ServerConfig *config, int playerID, bool isSinglePlayer, int synchronizationType);
+
+// Publica uma sala no registo do servidor (falha se não houver salas livres).
+bool registerRoom(ServerConfig *config, Room *room);
+
+// Obtém uma sala de jogo a partir do ID e adquire uma referência para ela.
+Room *getRoom(ServerConfig *config, int roomID, int playerID);
+
+// Liberta uma referência para a sala; a última referência elimina a sala.
+void releaseRoom(ServerConfig *config, Room *room);
+
+// Liberta a memória e os recursos de sincronização de uma sala.
+void destroyRoom(ServerConfig *config, Room *room);
+
+// Junta um jogador a uma sala existente.
+void joinRoom(ServerConfig *config, Room *room, Client *client);
+
+// delete room
+void deleteRoom(ServerConfig *config, int roomID);
+
+// Envia uma página da lista de salas multiplayer, filtrada por sincronização e lugares livres.
+void sendRoomsPage(ServerConfig *config, Client *client, int offset, int limit, int synchronizationType, int minOpenSlots);
+
+// Envia uma página da lista de jogos do catálogo, filtrada por dificuldade.
+void sendGamesPage(ServerConfig *config, Client *client, int offset, int limit, int difficulty);
+
+// Aloca um jogo vazio com um tabuleiro de size x size células.
+Game *allocGame(int size);
+
+// Copia um tabuleiro e uma solução 9x9 para um jogo.
+void setClassicBoards(Game *game, const char board[9][9], const char solution[9][9]);
+
+// Carrega um jogo específico a partir do ficheiro 'games.json'.
+Game *loadGame(ServerConfig *config, int gameID, int playerID);
+
+// Carrega um jogo aleatório do ficheiro 'games.json'.
+Game *loadRandomGame(ServerConfig *config, int playerID, int difficulty);
+
+// Envia o tabuleiro atual ao cliente em formato JSON.
+void sendBoard(ServerConfig *config, Room* room, Client *client);
+
+// Começa o jogo de quem criou a sala: já, num jogo single player, ou depois da contagem decrescente.
+SessionStatus startGame(ServerConfig *config, Room *room, Client *client);
+
+// Põe o cliente na fila para entrar numa sala multiplayer; o lugar é decidido quando a espera acaba.
+SessionStatus waitToJoinRoom(ServerConfig *config, Room *room, Client *client);
+
+// Trata o próximo passo do jogo de um cliente (em `client->step`), na sala `client->room`.
+SessionStatus playGameStep(ServerConfig *config, Client *client);
+
+// Pára o relógio da sala (só o primeiro a terminar) e devolve o tempo decorrido.
+double stopGameClock(Room *room);
+
+// Regista o resultado de um jogo nas estatísticas, no agregado e nas classificações.
+void recordGameResult(ServerConfig *config, Room *room, Client *client, double elapsedTime, float accuracy);
+
+// Envia ao cliente uma atualização do temporizador, com os valores copiados pelo chamador.
+void sendTimerUpdate(ServerConfig *config, Room *room, Client *client, int timer, int numClients);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include "../../utils/logs/logs-common.h"
+#include "../../utils/queues/ring.h"
+#include "../../utils/solver/generator.h"
+#include "../logs/logs.h"
+#include "server-generator.h"
+#include "server-game.h"
+
+// ready games, shared lock-free between the workers and the client threads
+static RingQueue gameStock;
+static bool generatorEnabled = false;
+
+// one token per free place in the stock; the workers sleep on it when the stock is full
+static sem_t refillSemaphore;
+
+static atomic_int nextGeneratedID = GENERATED_GAME_BASE_ID;
+
+static void *generatorWorker(void *arg) {
+
+    ServerConfig *config = (ServerConfig *)arg;
+    unsigned int seed = (unsigned int)time(NULL) ^ (unsigned int)(size_t)pthread_self();
+
+    for (;;) {
+
+        // wait until a game is taken from the stock
+        sem_wait(&refillSemaphore);
+
+        Game *game = allocGame(9);
+        if (game == NULL) {
+            sem_post(&refillSemaphore);
+            produceLog(config, "can't allocate generated game", MEMORY_ERROR, 0, 0);
+            continue;
+        }
+
+        char board[9][9], solution[9][9];
+        generatePuzzle(board, solution, config->generatorClues, &seed);
+        setClassicBoards(game, (const char (*)[9])board, (const char (*)[9])solution);
+        game->id = atomic_fetch_add(&nextGeneratedID, 1);
+
+        // there's always room: each token stands for a free place
+        if (!ringEnqueue(&gameStock, game)) {
+            free(game);
+            sem_post(&refillSemaphore);
+        }
+    }
+
+    return NULL;
+}
+
+void initGenerator(ServerConfig *config) {
+
+    if (config->generatorWorkers <= 0 || config->generatorStock <= 0) {
+        return;
+    }
+
+    if (!initRingQueue(&gameStock, config->generatorStock)) {
+        fprintf(stderr, "Couldn't allocate the generated games stock\n");
+        exit(1);
+    }
+
+    sem_init(&refillSemaphore, 0, config->generatorStock);
+    generatorEnabled = true;
+
+    for (int i = 0; i < config->generatorWorkers; i++) {
+        pthread_t worker;
+        if (pthread_create(&worker, NULL, generatorWorker, (void *)config) != 0) {
+            err_dump(config, 0, 0, "can't create generator thread", EVENT_THREAD_NOT_CREATE);
+        }
+        pthread_detach(worker);
+    }
+}
+
+Game *takeGeneratedGame(ServerConfig *config, int playerID) {
+
+    if (!generatorEnabled) {
+        return NULL;
+    }
+
+    Game *game = (Game *)ringDequeue(&gameStock);
+    if (game == NULL) {
+        return NULL;
+    }
+
+    // let a worker generate a replacement
+    sem_post(&refillSemaphore);
+
+    produceLog(config, "Jogo gerado carregado com sucesso", EVENT_GAME_LOAD, game->id, playerID);
+    return game;
+}
+
+bool isGeneratedGame(int gameID) {
+    return gameID >= GENERATED_GAME_BASE_ID;
+}
@@ -0,0 +1,18 @@
+#ifndef SERVER_GENERATOR_H
+#define SERVER_GENERATOR_H
+
+#include <stdbool.h>
+#include "../config/config.h"
+
+#define GENERATED_GAME_BASE_ID 1000000 // generated games get IDs from here on, apart from the catalog
+
+// Inicia as threads que mantêm o stock de jogos gerados (GENERATOR_WORKERS em server.conf).
+void initGenerator(ServerConfig *config);
+
+// Retira um jogo gerado do stock sem bloquear (NULL se o stock estiver vazio ou o gerador desligado).
+Game *takeGeneratedGame(ServerConfig *config, int playerID);
+
+// Indica se um ID pertence a um jogo gerado (que não existe no catálogo).
+bool isGeneratedGame(int gameID);
+
+#endif // SERVER_GENERATOR_H
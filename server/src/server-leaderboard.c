@@ -0,0 +1,411 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "../../utils/logs/logs-common.h"
+#include "../../utils/network/network.h"
+#include "../logs/logs.h"
+#include "server-leaderboard.h"
+
+// best results of one game (ranked by player) or one player (ranked by game)
+typedef struct {
+    int key; // game or player ID, 0 marks an empty slot
+    int count;
+    LeaderboardEntry entries[LEADERBOARD_SIZE];
+} LeaderboardSlot;
+
+// open addressing table keyed by game or player ID
+typedef struct {
+    LeaderboardSlot *slots;
+    int capacity;
+    int count;
+} LeaderboardTable;
+
+// leaderboards (protected by leaderboardLock)
+static pthread_rwlock_t leaderboardLock = PTHREAD_RWLOCK_INITIALIZER;
+static LeaderboardTable gameBoards;
+static LeaderboardTable playerBests;
+static int liveEntries = 0;
+
+// append-only file (protected by leaderboardFileMutex)
+static pthread_mutex_t leaderboardFileMutex = PTHREAD_MUTEX_INITIALIZER;
+static FILE *leaderboardFile = NULL;
+static long recordsInFile = 0;
+
+static unsigned int hashKey(int key) {
+    return (unsigned int)key * 2654435761u;
+}
+
+static LeaderboardSlot *findSlot(LeaderboardSlot *slots, int capacity, int key) {
+
+    unsigned int mask = capacity - 1;
+    unsigned int index = hashKey(key) & mask;
+
+    while (slots[index].key != 0 && slots[index].key != key) {
+        index = (index + 1) & mask;
+    }
+
+    return &slots[index];
+}
+
+static bool growTable(LeaderboardTable *table) {
+
+    int capacity = table->capacity == 0 ? 64 : table->capacity * 2;
+    LeaderboardSlot *slots = (LeaderboardSlot *)calloc(capacity, sizeof(LeaderboardSlot));
+    if (slots == NULL) {
+        return false;
+    }
+
+    for (int i = 0; i < table->capacity; i++) {
+        if (table->slots[i].key != 0) {
+            *findSlot(slots, capacity, table->slots[i].key) = table->slots[i];
+        }
+    }
+
+    free(table->slots);
+    table->slots = slots;
+    table->capacity = capacity;
+    return true;
+}
+
+static LeaderboardSlot *getSlot(LeaderboardTable *table, int key, bool create) {
+
+    if (table->capacity > 0) {
+        LeaderboardSlot *slot = findSlot(table->slots, table->capacity, key);
+        if (slot->key == key) {
+            return slot;
+        }
+    }
+
+    if (!create || key == 0) {
+        return NULL;
+    }
+
+    // keep the load factor under 70%
+    if ((table->count + 1) * 10 > table->capacity * 7 && !growTable(table)) {
+        return NULL;
+    }
+
+    LeaderboardSlot *slot = findSlot(table->slots, table->capacity, key);
+    memset(slot, 0, sizeof(LeaderboardSlot));
+    slot->key = key;
+    table->count++;
+
+    return slot;
+}
+
+// faster time wins, then higher accuracy, then the oldest result
+static bool isBetter(const LeaderboardEntry *a, const LeaderboardEntry *b) {
+
+    if (a->time != b->time) {
+        return a->time < b->time;
+    }
+    if (a->accuracy != b->accuracy) {
+        return a->accuracy > b->accuracy;
+    }
+    return a->timestamp < b->timestamp;
+}
+
+/**
+ * Insere um resultado numa lista ordenada de no máximo `LEADERBOARD_SIZE` resultados,
+ * com no máximo um resultado por jogador (`byPlayer`) ou por jogo.
+ *
+ * @return true se a lista mudou.
+ */
+
+static bool insertEntry(LeaderboardSlot *slot, const LeaderboardEntry *entry, bool byPlayer) {
+
+    int existing = -1;
+    for (int i = 0; i < slot->count; i++) {
+        if (byPlayer ? slot->entries[i].playerID == entry->playerID : slot->entries[i].gameID == entry->gameID) {
+            existing = i;
+            break;
+        }
+    }
+
+    if (existing >= 0) {
+        // keep only the best result of each player (or game)
+        if (!isBetter(entry, &slot->entries[existing])) {
+            return false;
+        }
+        memmove(&slot->entries[existing], &slot->entries[existing + 1], sizeof(LeaderboardEntry) * (slot->count - existing - 1));
+        slot->count--;
+        liveEntries--;
+    } else if (slot->count == LEADERBOARD_SIZE) {
+        if (!isBetter(entry, &slot->entries[LEADERBOARD_SIZE - 1])) {
+            return false;
+        }
+        // drop the worst result
+        slot->count--;
+        liveEntries--;
+    }
+
+    int position = slot->count;
+    while (position > 0 && isBetter(entry, &slot->entries[position - 1])) {
+        slot->entries[position] = slot->entries[position - 1];
+        position--;
+    }
+    slot->entries[position] = *entry;
+    slot->count++;
+    liveEntries++;
+
+    return true;
+}
+
+// apply a result to both indexes (caller holds the write lock)
+static bool applyEntry(const LeaderboardEntry *entry) {
+
+    bool changed = false;
+
+    LeaderboardSlot *gameSlot = getSlot(&gameBoards, entry->gameID, true);
+    if (gameSlot != NULL) {
+        changed |= insertEntry(gameSlot, entry, true);
+    }
+
+    LeaderboardSlot *playerSlot = getSlot(&playerBests, entry->playerID, true);
+    if (playerSlot != NULL) {
+        changed |= insertEntry(playerSlot, entry, false);
+    }
+
+    return changed;
+}
+
+static int writeTable(FILE *file, LeaderboardTable *table) {
+
+    int written = 0;
+
+    for (int i = 0; i < table->capacity; i++) {
+        LeaderboardSlot *slot = &table->slots[i];
+        if (slot->key != 0 && slot->count > 0) {
+            if (fwrite(slot->entries, sizeof(LeaderboardEntry), slot->count, file) != (size_t)slot->count) {
+                return -1;
+            }
+            written += slot->count;
+        }
+    }
+
+    return written;
+}
+
+/**
+ * Reescreve o ficheiro só com os resultados que ainda estão no leaderboard
+ * (caller holds leaderboardFileMutex).
+ *
+ * @details O ficheiro novo é escrito num ficheiro temporário e depois renomeado,
+ * e volta a ser aberto em modo append.
+ */
+
+static void compactLeaderboard(ServerConfig *config) {
+
+    char tempPath[512];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", config->leaderboardPath);
+
+    FILE *file = fopen(tempPath, "wb");
+    if (file == NULL) {
+        produceLog(config, "can't compact leaderboard", EVENT_GAME_NOT_LOAD, 0, 0);
+        return;
+    }
+
+    // both indexes are written; replaying a result already applied is a no-op
+    pthread_rwlock_rdlock(&leaderboardLock);
+    int gameRecords = writeTable(file, &gameBoards);
+    int playerRecords = writeTable(file, &playerBests);
+    pthread_rwlock_unlock(&leaderboardLock);
+
+    if (fclose(file) != 0 || gameRecords < 0 || playerRecords < 0 || rename(tempPath, config->leaderboardPath) != 0) {
+        produceLog(config, "can't compact leaderboard", EVENT_GAME_NOT_LOAD, 0, 0);
+        return;
+    }
+
+    if (leaderboardFile != NULL) {
+        fclose(leaderboardFile);
+    }
+    leaderboardFile = fopen(config->leaderboardPath, "ab");
+    recordsInFile = gameRecords + playerRecords;
+}
+
+void initLeaderboard(ServerConfig *config) {
+
+    if (config->leaderboardPath[0] == '\0') {
+        return;
+    }
+
+    // replay the results saved by previous runs
+    FILE *file = fopen(config->leaderboardPath, "rb");
+    if (file != NULL) {
+
+        LeaderboardEntry entry;
+
+        pthread_rwlock_wrlock(&leaderboardLock);
+        while (fread(&entry, sizeof(entry), 1, file) == 1) {
+            applyEntry(&entry);
+            recordsInFile++;
+        }
+        pthread_rwlock_unlock(&leaderboardLock);
+
+        fclose(file);
+        printf("Leaderboard carregado de %s (%ld resultados, %d jogos)\n", config->leaderboardPath, recordsInFile, gameBoards.count);
+    }
+
+    pthread_mutex_lock(&leaderboardFileMutex);
+
+    if (recordsInFile > LEADERBOARD_COMPACT_RATIO * liveEntries) {
+        compactLeaderboard(config);
+    } else {
+        leaderboardFile = fopen(config->leaderboardPath, "ab");
+    }
+
+    if (leaderboardFile == NULL) {
+        pthread_mutex_unlock(&leaderboardFileMutex);
+        fprintf(stderr, "Couldn't open leaderboard %s\n", config->leaderboardPath);
+        exit(1);
+    }
+
+    pthread_mutex_unlock(&leaderboardFileMutex);
+}
+
+long updateLeaderboard(ServerConfig *config, const GameResult *results, int numResults) {
+
+    LeaderboardEntry *entries = (LeaderboardEntry *)malloc(sizeof(LeaderboardEntry) * (numResults > 0 ? numResults : 1));
+    if (entries == NULL) {
+        produceLog(config, "can't allocate memory to update the leaderboard", MEMORY_ERROR, 0, 0);
+        return 0;
+    }
+
+    // the whole batch goes in under one write lock
+    int numChanged = 0;
+    pthread_rwlock_wrlock(&leaderboardLock);
+
+    for (int i = 0; i < numResults; i++) {
+
+        LeaderboardEntry *entry = &entries[numChanged];
+        memset(entry, 0, sizeof(*entry));
+        entry->gameID = results[i].gameID;
+        entry->playerID = results[i].playerID;
+        entry->time = results[i].elapsedTime;
+        entry->accuracy = results[i].accuracy;
+        entry->timestamp = (int64_t)results[i].timestamp;
+
+        // only results that entered a leaderboard are persisted
+        if (applyEntry(entry)) {
+            numChanged++;
+        }
+    }
+
+    pthread_rwlock_unlock(&leaderboardLock);
+
+    for (int i = 0; i < numChanged; i++) {
+        char logMessage[100];
+        snprintf(logMessage, sizeof(logMessage), "Jogador %d entrou no leaderboard do jogo %d com %d segundos", entries[i].playerID, entries[i].gameID, entries[i].time);
+        produceLog(config, logMessage, EVENT_NEW_RECORD, entries[i].gameID, entries[i].playerID);
+    }
+
+    long bytesWritten = 0;
+
+    pthread_mutex_lock(&leaderboardFileMutex);
+
+    // one append and one sync for the batch
+    if (leaderboardFile != NULL && numChanged > 0) {
+        if (fwrite(entries, sizeof(LeaderboardEntry), numChanged, leaderboardFile) != (size_t)numChanged ||
+            fflush(leaderboardFile) != 0 || fdatasync(fileno(leaderboardFile)) != 0) {
+            produceLog(config, "can't write to leaderboard", EVENT_GAME_NOT_LOAD, 0, 0);
+        } else {
+            recordsInFile += numChanged;
+            bytesWritten = sizeof(LeaderboardEntry) * numChanged;
+        }
+
+        pthread_rwlock_rdlock(&leaderboardLock);
+        bool compact = recordsInFile > LEADERBOARD_COMPACT_RATIO * liveEntries;
+        pthread_rwlock_unlock(&leaderboardLock);
+
+        if (compact) {
+            compactLeaderboard(config);
+        }
+    }
+
+    pthread_mutex_unlock(&leaderboardFileMutex);
+
+    free(entries);
+
+    return bytesWritten;
+}
+
+static int copyEntries(LeaderboardTable *table, int key, LeaderboardEntry *entries) {
+
+    int count = 0;
+
+    pthread_rwlock_rdlock(&leaderboardLock);
+    LeaderboardSlot *slot = getSlot(table, key, false);
+    if (slot != NULL) {
+        count = slot->count;
+        memcpy(entries, slot->entries, sizeof(LeaderboardEntry) * count);
+    }
+    pthread_rwlock_unlock(&leaderboardLock);
+
+    return count;
+}
+
+static void sendEntries(ServerConfig *config, Client *client, char *message, int length) {
+
+    if (writen(client->socket_fd, message, length) != length) {
+        err_dump(config, 0, client->clientID, "can't send leaderboard to client", EVENT_MESSAGE_SERVER_NOT_SENT);
+    } else {
+        produceLog(config, "Leaderboard enviado ao cliente", EVENT_MESSAGE_SERVER_SENT, 0, client->clientID);
+    }
+}
+
+void sendLeaderboard(ServerConfig *config, Client *client, int gameID) {
+
+    LeaderboardEntry entries[LEADERBOARD_SIZE];
+    int count = copyEntries(&gameBoards, gameID, entries);
+
+    char message[BUFFER_SIZE];
+    int length = 0;
+
+    if (count == 0) {
+        length += snprintf(message + length, sizeof(message) - length, "No results for game %d\n", gameID);
+    }
+
+    for (int i = 0; i < count; i++) {
+        length += snprintf(message + length, sizeof(message) - length, "%d. Player %d - %ds (accuracy %.1f%%)\n",
+                           i + 1, entries[i].playerID, entries[i].time, entries[i].accuracy);
+    }
+
+    length += snprintf(message + length, sizeof(message) - length, "END 0 %d %d\n", count, count);
+
+    sendEntries(config, client, message, length);
+}
+
+void sendPlayerBests(ServerConfig *config, Client *client, int playerID) {
+
+    LeaderboardEntry entries[LEADERBOARD_SIZE];
+    int count = copyEntries(&playerBests, playerID, entries);
+
+    char message[BUFFER_SIZE];
+    int length = 0;
+
+    if (count == 0) {
+        length += snprintf(message + length, sizeof(message) - length, "No results for player %d\n", playerID);
+    }
+
+    for (int i = 0; i < count; i++) {
+        length += snprintf(message + length, sizeof(message) - length, "Game %d - %ds (accuracy %.1f%%)\n",
+                           entries[i].gameID, entries[i].time, entries[i].accuracy);
+    }
+
+    length += snprintf(message + length, sizeof(message) - length, "END 0 %d %d\n", count, count);
+
+    sendEntries(config, client, message, length);
+}
+
+void closeLeaderboard() {
+
+    pthread_mutex_lock(&leaderboardFileMutex);
+    if (leaderboardFile != NULL) {
+        fclose(leaderboardFile);
+        leaderboardFile = NULL;
+    }
+    pthread_mutex_unlock(&leaderboardFileMutex);
+}
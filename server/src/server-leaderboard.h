@@ -0,0 +1,34 @@
+#ifndef SERVER_LEADERBOARD_H
+#define SERVER_LEADERBOARD_H
+
+#include <stdint.h>
+#include "../config/config.h"
+
+#define LEADERBOARD_SIZE 10     // best results kept per game and per player
+#define LEADERBOARD_COMPACT_RATIO 4 // rewrite the file when it holds this many records per live entry
+
+// Um resultado no leaderboard (também é o registo do ficheiro append-only).
+typedef struct {
+    int32_t gameID;
+    int32_t playerID;
+    int32_t time;
+    float accuracy;
+    int64_t timestamp;
+} LeaderboardEntry;
+
+// Carrega o leaderboard a partir do ficheiro e abre-o para acrescentar novos resultados.
+void initLeaderboard(ServerConfig *config);
+
+// Acrescenta um lote de resultados aos leaderboards dos jogos e dos jogadores, com uma só escrita; devolve os bytes escritos.
+long updateLeaderboard(ServerConfig *config, const GameResult *results, int numResults);
+
+// Envia ao cliente os melhores tempos de um jogo.
+void sendLeaderboard(ServerConfig *config, Client *client, int gameID);
+
+// Envia ao cliente os melhores resultados de um jogador.
+void sendPlayerBests(ServerConfig *config, Client *client, int playerID);
+
+// Fecha o ficheiro do leaderboard.
+void closeLeaderboard();
+
+#endif // SERVER_LEADERBOARD_H
@@ -0,0 +1,395 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../../utils/logs/logs-common.h"
+#include "../../utils/network/network.h"
+#include "../../utils/board/board.h"
+#include "../logs/logs.h"
+#include "server-mux.h"
+#include "server-game.h"
+#include "server-spectators.h"
+#include "server-wal.h"
+
+/*
+ * Protocolo multiplexado: depois de "MUX", cada pedido e cada resposta é uma linha de texto e
+ * os pedidos de um jogo levam o ID da sala, por isso o cliente pode mandar vários seguidos sem
+ * esperar pelas respostas (que chegam pela mesma ordem).
+ *
+ *   NEW [dificuldade]          -> GAME <sala> <jogo> <tamanho> <linha atual> <células>
+ *   LINE <sala> <linha>        -> BOARD <sala> <linha atual> <células>
+ *   FINISH <sala> <accuracy>   -> DONE <sala> <tempo>
+ *   QUIT <sala>                -> CLOSED <sala>
+ *   END                        -> BYE
+ *
+ * As células são as tamanho x tamanho células do tabuleiro, linha a linha, um carácter cada.
+ * Um pedido inválido recebe "ERROR <sala> <motivo>" (sala 0 se não se aplicar a nenhuma).
+ */
+
+#define MUX_LINE_SIZE 128
+
+_Static_assert(CLIENT_PENDING_SIZE >= LINE_READER_SIZE, "the client can't take what the reader buffered");
+#define MUX_REPLY_SIZE (BOARD_MAX_SIZE * BOARD_MAX_SIZE + 128)
+
+// the games open on one connection, looked up by room ID
+typedef struct {
+    Room *rooms[MUX_MAX_SESSIONS];
+    int numSessions;
+} MuxSessions;
+
+// what a multiplexed connection keeps between two reads: its games and the unfinished line
+typedef struct MuxConnection {
+    MuxSessions sessions;
+    LineReader reader;
+} MuxConnection;
+
+static int findSession(MuxSessions *sessions, int roomID) {
+
+    for (int i = 0; i < sessions->numSessions; i++) {
+        if (sessions->rooms[i]->id == roomID) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static void closeSession(ServerConfig *config, MuxSessions *sessions, int index) {
+
+    releaseRoom(config, sessions->rooms[index]);
+    sessions->rooms[index] = sessions->rooms[--sessions->numSessions];
+}
+
+static bool sendReply(ServerConfig *config, Client *client, int gameID, const char *reply) {
+
+    // a lost connection only ends this client's sessions (err_dump would stop the server)
+    if (writen(client->socket_fd, (char *)reply, strlen(reply)) < 0) {
+        produceLog(config, "can't send multiplexed reply to client", EVENT_MESSAGE_SERVER_NOT_SENT, gameID, client->clientID);
+        return false;
+    }
+
+    return true;
+}
+
+static bool sendError(ServerConfig *config, Client *client, int roomID, const char *reason) {
+
+    char reply[MUX_LINE_SIZE];
+    snprintf(reply, sizeof(reply), "ERROR %d %s\n", roomID, reason);
+    return sendReply(config, client, 0, reply);
+}
+
+// append the board cells and the newline that ends the reply
+static void appendCells(char *reply, int used, Game *game) {
+
+    used += encodeBoardCells(reply + used, (const char (*)[BOARD_ROW_STRIDE])game->board, game->size);
+    reply[used++] = '\n';
+    reply[used] = '\0';
+}
+
+// a running single player room for the client, without any message on failure
+static Room *openSession(ServerConfig *config, Client *client, int difficulty) {
+
+    Game *game = loadRandomGame(config, client->clientID, difficulty);
+    if (game == NULL) {
+        return NULL;
+    }
+
+    Room *room = createRoom(config, client->clientID, true, 0);
+    if (room == NULL) {
+        free(game);
+        return NULL;
+    }
+
+    room->game = game;
+    publishRoomSnapshot(room);
+    joinRoom(config, room, client);
+
+    if (!registerRoom(config, room)) {
+        destroyRoom(config, room);
+        produceLog(config, "No rooms available", EVENT_ROOM_NOT_CREATED, 0, client->clientID);
+        return NULL;
+    }
+
+    room->isGameRunning = true;
+    room->startTime = time(NULL);
+    walRoomStarted(config, room, client);
+
+    printf("Cliente %d abriu o jogo %d na sala %d (multiplexado)\n", client->clientID, game->id, room->id);
+
+    return room;
+}
+
+static bool handleNew(ServerConfig *config, Client *client, MuxSessions *sessions, const char *request) {
+
+    int difficulty = 0;
+    sscanf(request, "NEW %d", &difficulty);
+    if (difficulty < 0 || difficulty > CATALOG_DIFFICULTIES) {
+        difficulty = 0;
+    }
+
+    if (sessions->numSessions == MUX_MAX_SESSIONS) {
+        return sendError(config, client, 0, "too many games");
+    }
+
+    Room *room = openSession(config, client, difficulty);
+    if (room == NULL) {
+        return sendError(config, client, 0, "no rooms available");
+    }
+
+    sessions->rooms[sessions->numSessions++] = room;
+
+    Game *game = room->game;
+    char reply[MUX_REPLY_SIZE];
+    int used = snprintf(reply, sizeof(reply), "GAME %d %d %d %d ", room->id, game->id, game->size, game->currentLine);
+    appendCells(reply, used, game);
+
+    return sendReply(config, client, game->id, reply);
+}
+
+static bool handleLine(ServerConfig *config, Client *client, MuxSessions *sessions, const char *request) {
+
+    int roomID = 0;
+    char line[MUX_LINE_SIZE];
+    memset(line, 0, sizeof(line));
+
+    if (sscanf(request, "LINE %d %100s", &roomID, line) != 2) {
+        return sendError(config, client, roomID, "malformed request");
+    }
+
+    int index = findSession(sessions, roomID);
+    if (index < 0) {
+        return sendError(config, client, roomID, "unknown room");
+    }
+
+    Room *room = sessions->rooms[index];
+    Game *game = room->game;
+
+    if (game->currentLine > game->size) {
+        return sendError(config, client, roomID, "game already solved");
+    }
+
+    if (strlen(line) != (size_t)game->size) {
+        return sendError(config, client, roomID, "invalid line");
+    }
+
+    char insertLine[BOARD_ROW_STRIDE] __attribute__((aligned(32)));
+    memset(insertLine, 0, sizeof(insertLine));
+    for (int j = 0; j < game->size; j++) {
+        int value = decodeCell(line[j]);
+        if (value < 0 || value > game->size) {
+            return sendError(config, client, roomID, "invalid line");
+        }
+        insertLine[j] = value;
+    }
+
+    // single player rooms need no other lock: only this thread writes to them, and the room mutex
+    // keeps the line and the drain snapshot apart
+    int row = game->currentLine - 1;
+    pthread_mutex_lock(&room->mutex);
+    bool isFrozen = room->isFrozen;
+    if (!isFrozen && verifyLine(config, game, line, insertLine, client->clientID) == 1) {
+        game->currentLine++;
+    }
+    pthread_mutex_unlock(&room->mutex);
+
+    if (isFrozen) {
+        return sendError(config, client, roomID, "server shutting down");
+    }
+    walLineVerified(room, row);
+    publishRoomSnapshot(room);
+
+    char reply[MUX_REPLY_SIZE];
+    int used = snprintf(reply, sizeof(reply), "BOARD %d %d ", room->id, game->currentLine);
+    appendCells(reply, used, game);
+
+    return sendReply(config, client, game->id, reply);
+}
+
+static bool handleFinish(ServerConfig *config, Client *client, MuxSessions *sessions, const char *request) {
+
+    int roomID = 0;
+    float accuracy = 0;
+
+    if (sscanf(request, "FINISH %d %f", &roomID, &accuracy) < 1) {
+        return sendError(config, client, 0, "malformed request");
+    }
+
+    int index = findSession(sessions, roomID);
+    if (index < 0) {
+        return sendError(config, client, roomID, "unknown room");
+    }
+
+    Room *room = sessions->rooms[index];
+    int gameID = room->game->id;
+
+    if (room->game->currentLine <= room->game->size) {
+        return sendError(config, client, roomID, "game not solved");
+    }
+
+    double elapsedTime = stopGameClock(room);
+
+    produceEventLog(config, LOG_EVENT_ACCURACY_RECEIVED, gameID, client->clientID, (int)(accuracy * 100));
+
+    recordGameResult(config, room, client, elapsedTime, accuracy);
+    closeSession(config, sessions, index);
+
+    char reply[MUX_LINE_SIZE];
+    snprintf(reply, sizeof(reply), "DONE %d %.2f\n", roomID, elapsedTime);
+
+    return sendReply(config, client, gameID, reply);
+}
+
+static bool handleQuit(ServerConfig *config, Client *client, MuxSessions *sessions, const char *request) {
+
+    int roomID = 0;
+    sscanf(request, "QUIT %d", &roomID);
+
+    int index = findSession(sessions, roomID);
+    if (index < 0) {
+        return sendError(config, client, roomID, "unknown room");
+    }
+
+    closeSession(config, sessions, index);
+
+    char reply[MUX_LINE_SIZE];
+    snprintf(reply, sizeof(reply), "CLOSED %d\n", roomID);
+
+    return sendReply(config, client, 0, reply);
+}
+
+// the next complete line the reader already has, split like readBufferedLine (0 if there's none yet)
+static int takeBufferedLine(LineReader *reader, char *line, int maxlen) {
+
+    int available = reader->end - reader->start;
+    char *newline = memchr(reader->buffer + reader->start, '\n', available);
+
+    int length;
+    if (newline != NULL && newline - (reader->buffer + reader->start) + 1 <= maxlen - 1) {
+        length = newline - (reader->buffer + reader->start) + 1;
+    } else if (available >= maxlen - 1) {
+        // a line too long for the request buffer is taken in pieces, as readBufferedLine would
+        length = maxlen - 1;
+    } else {
+        return 0;
+    }
+
+    memcpy(line, reader->buffer + reader->start, length);
+    line[length] = '\0';
+    reader->start += length;
+
+    return length;
+}
+
+SessionStatus startMultiplexedSessions(ServerConfig *config, Client *client) {
+
+    char reply[MUX_LINE_SIZE];
+    snprintf(reply, sizeof(reply), "MUX OK %d\n", MUX_MAX_SESSIONS);
+    if (!sendReply(config, client, 0, reply)) {
+        return SESSION_CLOSED;
+    }
+
+    produceLog(config, "Cliente entrou no modo multiplexado", EVENT_MESSAGE_SERVER_RECEIVED, 0, client->clientID);
+
+    MuxConnection *mux = (MuxConnection *)malloc(sizeof(MuxConnection));
+    if (mux == NULL) {
+        produceLog(config, "Memory allocation failed", MEMORY_ERROR, 0, client->clientID);
+        return SESSION_CLOSED;
+    }
+    memset(&mux->sessions, 0, sizeof(mux->sessions));
+    initLineReader(&mux->reader, client->socket_fd);
+
+    client->mux = mux;
+    client->step = STEP_MUX;
+
+    return SESSION_CONTINUE;
+}
+
+/**
+ * Trata os pedidos que chegaram numa ligação multiplexada, com uma só leitura do socket.
+ *
+ * @param config Um pointer para a estrutura `ServerConfig` com a configuração do servidor.
+ * @param client O cliente no modo multiplexado, cujo socket já tem bytes para ler.
+ * @return `SESSION_CONTINUE` se a ligação fica à espera dos próximos pedidos (ou voltou ao menu com
+ * "END"), ou `SESSION_CLOSED` se a ligação foi fechada.
+ *
+ * @details Esta função faz o seguinte:
+ * - Lê o que o socket tem para o buffer da ligação, pelo que vários pedidos enviados de seguida custam
+ *   uma só leitura, e trata cada linha completa. Uma linha incompleta fica no buffer até à próxima
+ *   leitura; entre leituras a ligação não ocupa nenhum worker.
+ * - Encaminha cada pedido para o jogo com o ID da sala indicado, numa tabela própria da ligação.
+ * - Cada jogo é uma sala single player registada como as outras: aparece nas estatísticas e,
+ *   ao terminar, o resultado é registado como em `finishGame`.
+ * - Liberta as salas que ficaram abertas quando o cliente sai ou a ligação cai.
+ * - Os bytes que o leitor já tinha lido depois de "END" passam para `client->pending`, onde o
+ *   pedido seguinte do menu os vai buscar antes de ler o socket.
+ *
+ * @note Só os jogos single player podem ser multiplexados: os jogos multiplayer esperam pelos
+ * outros jogadores e pela fila da barbearia, o que atrasaria os restantes jogos da ligação.
+ */
+
+SessionStatus serveMultiplexedRequests(ServerConfig *config, Client *client) {
+
+    MuxConnection *mux = client->mux;
+    LineReader *reader = &mux->reader;
+
+    // make room after the unfinished line, then one read for everything that arrived
+    if (reader->start > 0) {
+        memmove(reader->buffer, reader->buffer + reader->start, reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->start = 0;
+    }
+
+    int n = read(client->socket_fd, reader->buffer + reader->end, LINE_READER_SIZE - reader->end);
+    bool isConnected = n > 0 || (n < 0 && errno == EINTR);
+    bool isDone = false;
+
+    if (n > 0) {
+        reader->end += n;
+    }
+
+    char request[MUX_LINE_SIZE];
+
+    while (isConnected && !isDone && takeBufferedLine(reader, request, sizeof(request)) > 0) {
+
+        request[strcspn(request, "\r\n")] = '\0';
+
+        if (strncmp(request, "NEW", 3) == 0) {
+            isConnected = handleNew(config, client, &mux->sessions, request);
+        } else if (strncmp(request, "LINE ", 5) == 0) {
+            isConnected = handleLine(config, client, &mux->sessions, request);
+        } else if (strncmp(request, "FINISH ", 7) == 0) {
+            isConnected = handleFinish(config, client, &mux->sessions, request);
+        } else if (strncmp(request, "QUIT ", 5) == 0) {
+            isConnected = handleQuit(config, client, &mux->sessions, request);
+        } else if (strcmp(request, "END") == 0) {
+            isConnected = sendReply(config, client, 0, "BYE\n");
+            isDone = true;
+        } else {
+            isConnected = sendError(config, client, 0, "unknown request");
+        }
+    }
+
+    if (isConnected && !isDone) {
+        return SESSION_CONTINUE;
+    }
+
+    // whatever the reader buffered after END is the start of the next menu request
+    if (isDone && reader->end > reader->start) {
+        client->pendingLength = reader->end - reader->start;
+        memcpy(client->pending, reader->buffer + reader->start, client->pendingLength);
+    }
+
+    // games left open are abandoned
+    while (mux->sessions.numSessions > 0) {
+        closeSession(config, &mux->sessions, mux->sessions.numSessions - 1);
+    }
+
+    free(mux);
+    client->mux = NULL;
+    client->step = STEP_MENU;
+
+    return isConnected ? SESSION_CONTINUE : SESSION_CLOSED;
+}
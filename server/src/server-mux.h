@@ -0,0 +1,16 @@
+#ifndef SERVER_MUX_H
+#define SERVER_MUX_H
+
+#include <stdbool.h>
+#include "../config/config.h"
+
+#define MUX_MAX_SESSIONS 16 // single player games one connection can play at once
+
+// Responde a "MUX" e passa a ligação para o modo multiplexado: vários jogos single player na mesma
+// ligação, identificados pelo ID da sala em cada pedido.
+SessionStatus startMultiplexedSessions(ServerConfig *config, Client *client);
+
+// Trata os pedidos que chegaram numa ligação multiplexada (volta ao menu depois de "END").
+SessionStatus serveMultiplexedRequests(ServerConfig *config, Client *client);
+
+#endif // SERVER_MUX_H
@@ -0,0 +1,254 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include "../../utils/logs/logs-common.h"
+#include "../logs/logs.h"
+#include "server-statistics.h"
+#include "server-leaderboard.h"
+#include "server-generator.h"
+#include "server-results.h"
+
+/*
+ * Estágio de resultados: quem acaba um jogo só põe o resultado numa fila e continua.
+ * Uma thread junta os resultados que chegam durante RESULTS_BATCH_WINDOW_MS (de todas as salas)
+ * e escreve-os de uma vez: uma reescrita de games.json (ou escritas na base de dados) com um
+ * sync, e um append com um sync no leaderboard, por lote em vez de por jogador.
+ * Vários resultados do mesmo jogo no lote contam como um só para os recordes.
+ */
+
+static ServerConfig *resultsConfig;
+
+// queue of results (protected by resultsMutex)
+static pthread_mutex_t resultsMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t resultsReady;   // on CLOCK_MONOTONIC, for the batch window
+static pthread_cond_t resultsWritten = PTHREAD_COND_INITIALIZER;
+static GameResult resultsQueue[RESULTS_QUEUE_SIZE];
+static int resultsIn = 0;
+static int resultsCount = 0;
+static bool isWriting = false;
+static bool isFlushing = false;
+
+// counters (protected by resultsMutex)
+static long queuedResults = 0;
+static long writtenResults = 0;
+static long writtenBatches = 0;
+static long writtenBytes = 0;
+static long fullQueueWaits = 0;
+static double totalQueueUs = 0;
+static double totalDurableMs = 0;
+static double maxDurableMs = 0;
+
+static double elapsedMs(const struct timespec *start, const struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) * 1e3 + (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+static int compareGameIDs(const void *a, const void *b) {
+    const GameResult *resultA = (const GameResult *)a;
+    const GameResult *resultB = (const GameResult *)b;
+    return (resultA->gameID > resultB->gameID) - (resultA->gameID < resultB->gameID);
+}
+
+// one result per game with the best time and accuracy of the batch, sorted by ID (generated games have no records)
+static int coalesceResults(const GameResult *batch, int numResults, GameResult *games) {
+
+    int numGames = 0;
+
+    for (int i = 0; i < numResults; i++) {
+        if (!isGeneratedGame(batch[i].gameID)) {
+            games[numGames++] = batch[i];
+        }
+    }
+
+    qsort(games, numGames, sizeof(GameResult), compareGameIDs);
+
+    int numMerged = 0;
+
+    for (int i = 0; i < numGames; i++) {
+
+        if (numMerged > 0 && games[numMerged - 1].gameID == games[i].gameID) {
+            GameResult *merged = &games[numMerged - 1];
+            if (games[i].elapsedTime < merged->elapsedTime) {
+                merged->elapsedTime = games[i].elapsedTime;
+            }
+            if (games[i].accuracy > merged->accuracy) {
+                merged->accuracy = games[i].accuracy;
+            }
+            continue;
+        }
+
+        games[numMerged++] = games[i];
+    }
+
+    return numMerged;
+}
+
+// wait for the first result, then for the rest of its window; returns the batch size
+static int takeBatch(GameResult *batch) {
+
+    pthread_mutex_lock(&resultsMutex);
+
+    while (resultsCount == 0) {
+        pthread_cond_wait(&resultsReady, &resultsMutex);
+    }
+
+    // the window starts when the oldest result was queued
+    int first = (resultsIn - resultsCount + RESULTS_QUEUE_SIZE) % RESULTS_QUEUE_SIZE;
+    struct timespec deadline = resultsQueue[first].queuedAt;
+    deadline.tv_nsec += RESULTS_BATCH_WINDOW_MS * 1000000L;
+    deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+    deadline.tv_nsec %= 1000000000L;
+
+    while (resultsCount < RESULTS_BATCH_EARLY && !isFlushing) {
+        if (pthread_cond_timedwait(&resultsReady, &resultsMutex, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+
+    int numResults = resultsCount;
+    first = (resultsIn - resultsCount + RESULTS_QUEUE_SIZE) % RESULTS_QUEUE_SIZE;
+    for (int i = 0; i < numResults; i++) {
+        batch[i] = resultsQueue[(first + i) % RESULTS_QUEUE_SIZE];
+    }
+    resultsCount = 0;
+    isWriting = true;
+
+    // players waiting for room in the queue can go on
+    pthread_cond_broadcast(&resultsWritten);
+    pthread_mutex_unlock(&resultsMutex);
+
+    return numResults;
+}
+
+static void *writeResults(void *arg) {
+
+    GameResult *batch = (GameResult *)malloc(sizeof(GameResult) * RESULTS_QUEUE_SIZE);
+    GameResult *games = (GameResult *)malloc(sizeof(GameResult) * RESULTS_QUEUE_SIZE);
+    if (batch == NULL || games == NULL) {
+        err_dump(resultsConfig, 0, 0, "can't allocate memory for the results writer", MEMORY_ERROR);
+    }
+
+    for (;;) {
+
+        int numResults = takeBatch(batch);
+
+        int numGames = coalesceResults(batch, numResults, games);
+
+        long bytesWritten = 0;
+        if (numGames > 0) {
+            bytesWritten += updateGameStatistics(resultsConfig, games, numGames);
+        }
+        bytesWritten += updateLeaderboard(resultsConfig, batch, numResults);
+
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        pthread_mutex_lock(&resultsMutex);
+
+        for (int i = 0; i < numResults; i++) {
+            double durableMs = elapsedMs(&batch[i].queuedAt, &now);
+            totalDurableMs += durableMs;
+            if (durableMs > maxDurableMs) {
+                maxDurableMs = durableMs;
+            }
+        }
+        writtenResults += numResults;
+        writtenBatches++;
+        writtenBytes += bytesWritten;
+
+        isWriting = false;
+        pthread_cond_broadcast(&resultsWritten);
+        pthread_mutex_unlock(&resultsMutex);
+    }
+
+    return NULL;
+}
+
+void initResults(ServerConfig *config) {
+
+    resultsConfig = config;
+
+    pthread_condattr_t attributes;
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    pthread_cond_init(&resultsReady, &attributes);
+    pthread_condattr_destroy(&attributes);
+
+    pthread_t writerThread;
+    if (pthread_create(&writerThread, NULL, writeResults, NULL) != 0) {
+        err_dump(config, 0, 0, "can't create results thread", EVENT_THREAD_NOT_CREATE);
+    }
+    pthread_detach(writerThread);
+}
+
+void queueGameResult(ServerConfig *config, int gameID, int playerID, int elapsedTime, float accuracy) {
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    pthread_mutex_lock(&resultsMutex);
+
+    // a full queue is the only case where a player waits for the disk
+    if (resultsCount == RESULTS_QUEUE_SIZE) {
+        fullQueueWaits++;
+        while (resultsCount == RESULTS_QUEUE_SIZE) {
+            pthread_cond_wait(&resultsWritten, &resultsMutex);
+        }
+    }
+
+    GameResult *result = &resultsQueue[resultsIn];
+    result->gameID = gameID;
+    result->playerID = playerID;
+    result->elapsedTime = elapsedTime;
+    result->accuracy = accuracy;
+    result->timestamp = time(NULL);
+    result->queuedAt = start;
+
+    resultsIn = (resultsIn + 1) % RESULTS_QUEUE_SIZE;
+    resultsCount++;
+    queuedResults++;
+
+    // the writer only needs waking for a new window or an early write
+    if (resultsCount == 1 || resultsCount == RESULTS_BATCH_EARLY) {
+        pthread_cond_signal(&resultsReady);
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    totalQueueUs += elapsedMs(&start, &now) * 1e3;
+
+    pthread_mutex_unlock(&resultsMutex);
+}
+
+void flushResults(void) {
+
+    pthread_mutex_lock(&resultsMutex);
+
+    // the window is cut short: what is queued is written now
+    isFlushing = true;
+    pthread_cond_signal(&resultsReady);
+
+    while (resultsCount > 0 || isWriting) {
+        pthread_cond_wait(&resultsWritten, &resultsMutex);
+    }
+
+    isFlushing = false;
+    pthread_mutex_unlock(&resultsMutex);
+}
+
+void getResultsCounters(ResultsCounters *counters) {
+
+    pthread_mutex_lock(&resultsMutex);
+
+    counters->results = writtenResults;
+    counters->batches = writtenBatches;
+    counters->bytesWritten = writtenBytes;
+    counters->fullQueueWaits = fullQueueWaits;
+    counters->meanQueueUs = queuedResults > 0 ? totalQueueUs / queuedResults : 0;
+    counters->meanDurableMs = writtenResults > 0 ? totalDurableMs / writtenResults : 0;
+    counters->maxDurableMs = maxDurableMs;
+
+    pthread_mutex_unlock(&resultsMutex);
+}
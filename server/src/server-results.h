@@ -0,0 +1,33 @@
+#ifndef SERVER_RESULTS_H
+#define SERVER_RESULTS_H
+
+#include "../config/config.h"
+
+#define RESULTS_QUEUE_SIZE 1024     // finished results waiting for the writer; a full queue makes players wait
+#define RESULTS_BATCH_WINDOW_MS 100 // results queued this long after the first one share its write
+#define RESULTS_BATCH_EARLY 256     // results that start the write before the window ends
+
+// Contadores do estágio de resultados, enviados no GET_STATS.
+typedef struct {
+    long results;         // results written since the start
+    long batches;         // writes of the records and the leaderboard (one sync each per batch)
+    long bytesWritten;    // bytes written to the games file or database and to the leaderboard
+    long fullQueueWaits;  // results that waited for room in the queue
+    double meanQueueUs;   // time a player spends queueing a result
+    double meanDurableMs; // from queueing to the end of the batch write
+    double maxDurableMs;
+} ResultsCounters;
+
+// Inicia a thread que escreve os resultados dos jogos em lotes.
+void initResults(ServerConfig *config);
+
+// Põe o resultado de um jogador na fila; os recordes do jogo e o leaderboard são escritos no lote seguinte.
+void queueGameResult(ServerConfig *config, int gameID, int playerID, int elapsedTime, float accuracy);
+
+// Espera que os resultados na fila sejam escritos (ao desligar o servidor).
+void flushResults(void);
+
+// Lê os contadores do estágio de resultados.
+void getResultsCounters(ResultsCounters *counters);
+
+#endif // SERVER_RESULTS_H
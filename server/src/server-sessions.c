@@ -0,0 +1,337 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/random.h>
+#include "../../utils/logs/logs-common.h"
+#include "../../utils/network/network.h"
+#include "../logs/logs.h"
+#include "server-sessions.h"
+#include "server-workers.h"
+
+/*
+ * Sessões: quando a ligação de um jogador cai a meio de um jogo, o cliente larga o socket e fica
+ * na tabela de sessões, sem ocupar um worker, durante o tempo de graça em que o jogador pode voltar
+ * a ligar-se com "resume <token>". A sala, o tabuleiro e a linha atual nunca saem da memória; a nova
+ * ligação é só entregue ao cliente, que volta para a fila dos workers. A thread das sessões paradas
+ * expira, uma vez por segundo, as sessões cujo tempo de graça acabou. A tabela de sessões é reservada
+ * no arranque e os lugares são reutilizados através de uma lista livre, por isso as religações não
+ * fazem alocações.
+ */
+
+typedef enum {
+    SESSION_FREE,
+    SESSION_ATTACHED,
+    SESSION_DETACHED, // waiting for the player to come back
+    SESSION_RESUMING, // a new connection is taking the session over
+    SESSION_EXPIRED   // the grace period ran out, the token no longer works
+} SessionState;
+
+typedef struct {
+    SessionState state;
+    char token[SESSION_TOKEN_SIZE];
+    Client *client;
+    struct timespec expiresAt; // end of the grace period, while detached
+} Session;
+
+// sessions table and its free list (protected by sessionsMutex)
+static pthread_mutex_t sessionsMutex = PTHREAD_MUTEX_INITIALIZER;
+static Session *sessions = NULL;
+static int numSessions = 0;
+static int *freeSlots = NULL;
+static int numFreeSlots = 0;
+
+// the clients whose sessions expired in a sweep, woken once sessionsMutex is released
+static Client **expiredClients = NULL;
+
+static void generateToken(char *token) {
+
+    unsigned char bytes[(SESSION_TOKEN_SIZE - 1) / 2];
+
+    if (getrandom(bytes, sizeof(bytes), 0) != sizeof(bytes)) {
+        // no entropy source: still unique, only less secret
+        unsigned int seed = (unsigned int)time(NULL) ^ (unsigned int)(size_t)token;
+        for (size_t i = 0; i < sizeof(bytes); i++) {
+            bytes[i] = rand_r(&seed) & 0xFF;
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        sprintf(token + 2 * i, "%02x", bytes[i]);
+    }
+}
+
+void initSessions(ServerConfig *config) {
+
+    if (config->sessionGracePeriod <= 0) {
+        return;
+    }
+
+    numSessions = config->maxClientsOnline;
+    sessions = (Session *)calloc(numSessions, sizeof(Session));
+    freeSlots = (int *)malloc(sizeof(int) * numSessions);
+    expiredClients = (Client **)malloc(sizeof(Client *) * numSessions);
+    if (sessions == NULL || freeSlots == NULL || expiredClients == NULL) {
+        err_dump(config, 0, 0, "can't allocate the sessions table", MEMORY_ERROR);
+    }
+
+    for (int i = 0; i < numSessions; i++) {
+        freeSlots[numFreeSlots++] = numSessions - 1 - i;
+    }
+}
+
+// take a free slot for the client, with a new token when none is given
+static bool openSession(Client *client, const char *knownToken, char *token) {
+
+    client->sessionSlot = -1;
+
+    if (sessions == NULL) {
+        return false;
+    }
+
+    pthread_mutex_lock(&sessionsMutex);
+
+    if (numFreeSlots == 0) {
+        pthread_mutex_unlock(&sessionsMutex);
+        return false;
+    }
+
+    int slot = freeSlots[--numFreeSlots];
+    Session *session = &sessions[slot];
+
+    session->state = SESSION_ATTACHED;
+    session->client = client;
+    if (knownToken != NULL) {
+        snprintf(session->token, sizeof(session->token), "%s", knownToken);
+    } else {
+        generateToken(session->token);
+    }
+    if (token != NULL) {
+        strcpy(token, session->token);
+    }
+    client->sessionSlot = slot;
+
+    pthread_mutex_unlock(&sessionsMutex);
+
+    return true;
+}
+
+bool createSession(ServerConfig *config, Client *client, char *token) {
+    return openSession(client, NULL, token);
+}
+
+bool adoptSession(ServerConfig *config, Client *client, const char *token) {
+    return openSession(client, token, NULL);
+}
+
+bool findSessionToken(const Client *client, int *clientID, bool *isPremium, char *token) {
+
+    bool isFound = false;
+
+    if (sessions == NULL) {
+        return false;
+    }
+
+    // the client is only read while its session is open (endSession runs before it is freed)
+    pthread_mutex_lock(&sessionsMutex);
+
+    for (int i = 0; i < numSessions; i++) {
+        if (sessions[i].state != SESSION_FREE && sessions[i].state != SESSION_EXPIRED && sessions[i].client == client) {
+            *clientID = client->clientID;
+            *isPremium = client->isPremium;
+            strcpy(token, sessions[i].token);
+            isFound = true;
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&sessionsMutex);
+
+    return isFound;
+}
+
+/**
+ * Desliga um jogador cuja ligação caiu e deixa a sessão à espera que ele a retome.
+ *
+ * @param config Um pointer para a estrutura `ServerConfig` com o tempo de graça.
+ * @param client O cliente que perdeu a ligação.
+ * @return `true` se a sessão fica à espera do jogador, `false` se as sessões estão desligadas.
+ *
+ * @details Esta função faz o seguinte:
+ * - Fecha o socket perdido e marca a sessão como desligada, para que "resume <token>" a encontre.
+ * - Não espera: o worker volta para o pool, e o cliente só volta para a fila quando o jogador
+ *   retomar a sessão (com o novo socket em `client->socket_fd`) ou quando `expireDetachedSessions`
+ *   encontrar o tempo de graça esgotado (com `client->isConnected` a `false`).
+ * - Depois de devolver `true`, o cliente pode já estar a ser tratado por outro worker.
+ */
+
+bool detachSession(ServerConfig *config, Client *client) {
+
+    int slot = client->sessionSlot;
+
+    if (sessions == NULL || slot < 0) {
+        client->isConnected = false;
+        return false;
+    }
+
+    Session *session = &sessions[slot];
+
+    printf("Cliente %d desligou-se, tem %d segundos para retomar a sessao\n", client->clientID, config->sessionGracePeriod);
+    produceLog(config, "Ligacao perdida, a aguardar que o jogador retome a sessao", EVENT_SERVER_CONNECTION_FINISH, 0, client->clientID);
+
+    // the grace period is measured on the monotonic clock
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += config->sessionGracePeriod;
+
+    int lostSocket = client->socket_fd;
+
+    pthread_mutex_lock(&sessionsMutex);
+    client->socket_fd = -1;
+    session->expiresAt = deadline;
+    session->state = SESSION_DETACHED;
+    pthread_mutex_unlock(&sessionsMutex);
+
+    close(lostSocket);
+
+    return true;
+}
+
+void expireDetachedSessions(ServerConfig *config) {
+
+    if (sessions == NULL) {
+        return;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    int numExpired = 0;
+
+    pthread_mutex_lock(&sessionsMutex);
+
+    // a session being resumed is left alone whatever the deadline
+    for (int i = 0; i < numSessions; i++) {
+        Session *session = &sessions[i];
+        if (session->state == SESSION_DETACHED &&
+            (now.tv_sec > session->expiresAt.tv_sec ||
+             (now.tv_sec == session->expiresAt.tv_sec && now.tv_nsec >= session->expiresAt.tv_nsec))) {
+            session->state = SESSION_EXPIRED;
+            expiredClients[numExpired++] = session->client;
+        }
+    }
+
+    pthread_mutex_unlock(&sessionsMutex);
+
+    // their games go on without them: the step that lost the connection sees it and leaves the room
+    for (int i = 0; i < numExpired; i++) {
+        Client *client = expiredClients[i];
+        client->isConnected = false;
+        printf("Cliente %d nao retomou a sessao a tempo\n", client->clientID);
+        produceLog(config, "Sessao expirada", EVENT_SERVER_CONNECTION_FINISH, 0, client->clientID);
+        wakeSession(client);
+    }
+}
+
+bool isSessionDetached(const char *token) {
+
+    bool isDetached = false;
+
+    if (sessions == NULL || strlen(token) != SESSION_TOKEN_SIZE - 1) {
+        return false;
+    }
+
+    pthread_mutex_lock(&sessionsMutex);
+
+    for (int i = 0; i < numSessions; i++) {
+        if (sessions[i].state == SESSION_DETACHED && strcmp(sessions[i].token, token) == 0) {
+            isDetached = true;
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&sessionsMutex);
+
+    return isDetached;
+}
+
+bool resumeSession(ServerConfig *config, const char *token, int socket_fd) {
+
+    if (sessions == NULL || strlen(token) != SESSION_TOKEN_SIZE - 1) {
+        return false;
+    }
+
+    // claim the session, so it can't expire while the answer is sent
+    pthread_mutex_lock(&sessionsMutex);
+
+    Session *session = NULL;
+    for (int i = 0; i < numSessions; i++) {
+        if (sessions[i].state == SESSION_DETACHED && strcmp(sessions[i].token, token) == 0) {
+            session = &sessions[i];
+            break;
+        }
+    }
+
+    if (session == NULL) {
+        pthread_mutex_unlock(&sessionsMutex);
+        return false;
+    }
+
+    session->state = SESSION_RESUMING;
+    int clientID = session->client->clientID;
+
+    pthread_mutex_unlock(&sessionsMutex);
+
+    // answer before the game sends the board on this socket
+    char reply[64];
+    snprintf(reply, sizeof(reply), "RESUMED %d\n", clientID);
+    bool isSent = writen(socket_fd, reply, strlen(reply)) == (int)strlen(reply);
+
+    Client *client = session->client;
+
+    pthread_mutex_lock(&sessionsMutex);
+    if (isSent) {
+        client->socket_fd = socket_fd;
+        session->state = SESSION_ATTACHED;
+    } else {
+        session->state = SESSION_DETACHED;
+    }
+    pthread_mutex_unlock(&sessionsMutex);
+
+    if (!isSent) {
+        produceLog(config, "can't send resume reply to client", EVENT_MESSAGE_SERVER_NOT_SENT, 0, clientID);
+        return false;
+    }
+
+    printf("Cliente %d retomou a sessao\n", clientID);
+    produceLog(config, "Jogador retomou a sessao", EVENT_CONNECTION_SERVER_ESTABLISHED, 0, clientID);
+
+    // the game goes on from the same line, on a worker
+    client->isConnected = true;
+    client->step = STEP_RESUMED;
+    wakeSession(client);
+
+    return true;
+}
+
+void endSession(ServerConfig *config, Client *client) {
+
+    if (sessions == NULL || client->sessionSlot < 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&sessionsMutex);
+
+    Session *session = &sessions[client->sessionSlot];
+    session->state = SESSION_FREE;
+    session->client = NULL;
+    memset(session->token, 0, sizeof(session->token));
+    freeSlots[numFreeSlots++] = client->sessionSlot;
+
+    pthread_mutex_unlock(&sessionsMutex);
+
+    client->sessionSlot = -1;
+}
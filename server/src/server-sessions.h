@@ -0,0 +1,36 @@
+#ifndef SERVER_SESSIONS_H
+#define SERVER_SESSIONS_H
+
+#include <stdbool.h>
+#include "../config/config.h"
+
+#define SESSION_TOKEN_SIZE 33 // 128-bit token in hex and the terminator
+
+// Reserva a tabela de sessões (um lugar por jogador online, reutilizados sem novas alocações).
+void initSessions(ServerConfig *config);
+
+// Abre uma sessão para o cliente e escreve o token que a retoma (false se as sessões estão desligadas ou cheias).
+bool createSession(ServerConfig *config, Client *client, char *token);
+
+// Desliga o cliente da ligação perdida e deixa a sessão à espera que o jogador a retome, sem esperar (false se as sessões estão desligadas).
+bool detachSession(ServerConfig *config, Client *client);
+
+// Expira as sessões cujo tempo de graça acabou e volta a pôr os seus clientes na fila, desligados.
+void expireDetachedSessions(ServerConfig *config);
+
+// Verifica se a sessão com este token está à espera que o jogador volte.
+bool isSessionDetached(const char *token);
+
+// Passa a nova ligação para a sessão com este token, respondendo "RESUMED <id>", e volta a pôr o cliente na fila (false se não existe ou expirou).
+bool resumeSession(ServerConfig *config, const char *token, int socket_fd);
+
+// Abre uma sessão com um token já conhecido (o de um jogador de uma sala restaurada).
+bool adoptSession(ServerConfig *config, Client *client, const char *token);
+
+// Procura a sessão aberta de um cliente e copia o seu ID, o estado premium e o token (false se não tem sessão).
+bool findSessionToken(const Client *client, int *clientID, bool *isPremium, char *token);
+
+// Fecha a sessão do cliente.
+void endSession(ServerConfig *config, Client *client);
+
+#endif // SERVER_SESSIONS_H
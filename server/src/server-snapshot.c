@@ -0,0 +1,479 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../../utils/logs/logs-common.h"
+#include "../logs/logs.h"
+#include "server-game.h"
+#include "server-comms.h"
+#include "server-spectators.h"
+#include "server-snapshot.h"
+
+/*
+ * Salas guardadas: ao desligar, o servidor escreve as salas com jogos a decorrer (jogo, tabuleiro,
+ * solução, linha atual e os tokens das sessões dos jogadores) num ficheiro binário compacto. No
+ * arranque seguinte as salas são recriadas antes de aceitar ligações, e cada jogador volta à sua
+ * com o mesmo "resume <token>" que usa quando a ligação cai. As salas que ninguém retoma dentro do
+ * tempo de graça das sessões são eliminadas.
+ */
+
+typedef struct {
+    char token[SESSION_TOKEN_SIZE];
+    int clientID;
+    bool isPremium;
+    int roomIndex; // in restoredRooms
+    bool isClaimed;
+} RestoredSeat;
+
+// seats of the restored rooms (protected by seatsMutex)
+static pthread_mutex_t seatsMutex = PTHREAD_MUTEX_INITIALIZER;
+static RestoredSeat *seats = NULL;
+static int numSeats = 0;
+static int seatsCapacity = 0;
+static bool isSeatsExpired = false;
+
+// the restore holds one reference to each restored room until its seats are all claimed or
+// the grace period ends (NULL once given back, protected by seatsMutex)
+static Room **restoredRooms = NULL;
+static int numRestoredRooms = 0;
+static int restoredRoomsCapacity = 0;
+static bool isExpiryStarted = false;
+
+// write one running room, false if it has nobody who could come back to it
+static bool writeRoomRecord(FILE *file, Room *room) {
+
+    Client *clients[SNAPSHOT_MAX_PLAYERS];
+    int numClients = 0;
+
+    // players and progress are copied together, under the room mutex, where the lines are applied;
+    // from here on the room takes no more lines, so the record is what the players find on restart
+    pthread_mutex_lock(&room->mutex);
+
+    room->isFrozen = true;
+
+    bool isRunning = room->isGameRunning && !room->isFinished && room->game != NULL &&
+                     room->game->currentLine <= room->game->size;
+
+    for (int i = 0; i < room->numClients && i < SNAPSHOT_MAX_PLAYERS; i++) {
+        clients[numClients++] = room->clients[i];
+    }
+
+    SnapshotRoomRecord record;
+    memset(&record, 0, sizeof(record));
+
+    Game game;
+    if (isRunning) {
+        memcpy(&game, room->game, sizeof(Game));
+        record.gameID = game.id;
+        record.currentLine = game.currentLine;
+        record.elapsedSeconds = (int)difftime(time(NULL), room->startTime);
+        record.size = game.size;
+        record.isSinglePlayer = room->isSinglePlayer;
+        record.synchronizationType = room->synchronizationType;
+    }
+
+    pthread_mutex_unlock(&room->mutex);
+
+    if (!isRunning) {
+        return false;
+    }
+
+    // only players with an open session can reclaim their seat
+    SnapshotPlayerRecord players[SNAPSHOT_MAX_PLAYERS];
+    for (int i = 0; i < numClients; i++) {
+        SnapshotPlayerRecord *player = &players[record.numPlayers];
+        bool isPremium = false;
+        memset(player, 0, sizeof(SnapshotPlayerRecord));
+        if (findSessionToken(clients[i], &player->clientID, &isPremium, player->token)) {
+            player->isPremium = isPremium;
+            record.numPlayers++;
+        }
+    }
+
+    if (record.numPlayers == 0) {
+        return false;
+    }
+
+    char cells[2][BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    for (int row = 0; row < game.size; row++) {
+        memcpy(cells[0] + row * game.size, game.board[row], game.size);
+        memcpy(cells[1] + row * game.size, game.solution[row], game.size);
+    }
+
+    int numCells = game.size * game.size;
+
+    return fwrite(&record, sizeof(record), 1, file) == 1 &&
+           fwrite(cells[0], 1, numCells, file) == (size_t)numCells &&
+           fwrite(cells[1], 1, numCells, file) == (size_t)numCells &&
+           fwrite(players, sizeof(SnapshotPlayerRecord), record.numPlayers, file) == record.numPlayers;
+}
+
+int saveRoomsSnapshot(ServerConfig *config) {
+
+    if (config->snapshotPath[0] == '\0') {
+        return 0;
+    }
+
+    // hold a reference to every room, so none is destroyed while it is written
+    pthread_rwlock_rdlock(&config->roomsLock);
+
+    int numRooms = config->numRooms;
+    Room **rooms = (Room **)malloc(sizeof(Room *) * (numRooms > 0 ? numRooms : 1));
+    if (rooms == NULL) {
+        pthread_rwlock_unlock(&config->roomsLock);
+        produceLog(config, "can't allocate memory to save the rooms", MEMORY_ERROR, 0, 0);
+        return -1;
+    }
+
+    for (int i = 0; i < numRooms; i++) {
+        rooms[i] = config->rooms[i];
+        pthread_mutex_lock(&rooms[i]->mutex);
+        rooms[i]->refCount++;
+        pthread_mutex_unlock(&rooms[i]->mutex);
+    }
+
+    pthread_rwlock_unlock(&config->roomsLock);
+
+    // write to a temporary file and rename it, so a crash never leaves a truncated file
+    char tempPath[512];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", config->snapshotPath);
+
+    SnapshotFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.lastClientID = generateUniqueClientId();
+
+    FILE *file = fopen(tempPath, "wb");
+    bool written = file != NULL && fwrite(&header, sizeof(header), 1, file) == 1;
+
+    for (int i = 0; i < numRooms && written; i++) {
+        if (writeRoomRecord(file, rooms[i])) {
+            header.numRooms++;
+        } else if (ferror(file)) {
+            written = false;
+        }
+    }
+
+    // the header is written again once the number of rooms is known
+    if (written) {
+        written = fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+    }
+
+    if (file != NULL && fclose(file) != 0) {
+        written = false;
+    }
+
+    for (int i = 0; i < numRooms; i++) {
+        releaseRoom(config, rooms[i]);
+    }
+    free(rooms);
+
+    if (!written || rename(tempPath, config->snapshotPath) != 0) {
+        produceLog(config, "can't save the rooms snapshot", EVENT_ROOM_NOT_LOAD, 0, 0);
+        unlink(tempPath);
+        return -1;
+    }
+
+    printf("Salas guardadas em %s (%d salas)\n", config->snapshotPath, header.numRooms);
+
+    return header.numRooms;
+}
+
+// drop the seats nobody reclaimed and the restore references to the rooms
+static void *expireRestoredSeats(void *arg) {
+
+    ServerConfig *config = (ServerConfig *)arg;
+
+    sleep(config->sessionGracePeriod);
+
+    pthread_mutex_lock(&seatsMutex);
+    isSeatsExpired = true;
+    pthread_mutex_unlock(&seatsMutex);
+
+    // rooms with players still in them live on until those players finish
+    for (int i = 0; i < numRestoredRooms; i++) {
+        if (restoredRooms[i] != NULL) {
+            releaseRoom(config, restoredRooms[i]);
+        }
+    }
+
+    free(restoredRooms);
+    free(seats);
+    restoredRooms = NULL;
+    seats = NULL;
+
+    return NULL;
+}
+
+// room for one more restored room and its players
+static bool growRestored(int numPlayers) {
+
+    if (numRestoredRooms == restoredRoomsCapacity) {
+        int capacity = restoredRoomsCapacity > 0 ? restoredRoomsCapacity * 2 : 16;
+        Room **rooms = (Room **)realloc(restoredRooms, sizeof(Room *) * capacity);
+        if (rooms == NULL) {
+            return false;
+        }
+        restoredRooms = rooms;
+        restoredRoomsCapacity = capacity;
+    }
+
+    if (numSeats + numPlayers > seatsCapacity) {
+        int capacity = seatsCapacity > 0 ? seatsCapacity * 2 : 16 * SNAPSHOT_MAX_PLAYERS;
+        while (capacity < numSeats + numPlayers) {
+            capacity *= 2;
+        }
+        RestoredSeat *grown = (RestoredSeat *)realloc(seats, sizeof(RestoredSeat) * capacity);
+        if (grown == NULL) {
+            return false;
+        }
+        seats = grown;
+        seatsCapacity = capacity;
+    }
+
+    return true;
+}
+
+// rebuild one room from its record, NULL if it can't be restored
+static Room *restoreRoom(ServerConfig *config, const SnapshotRoomRecord *record, const char *board, const char *solution) {
+
+    Game *game = allocGame(record->size);
+    if (game == NULL) {
+        return NULL;
+    }
+
+    game->id = record->gameID;
+    game->currentLine = record->currentLine;
+    for (int row = 0; row < game->size; row++) {
+        memcpy(game->board[row], board + row * game->size, game->size);
+        memcpy(game->solution[row], solution + row * game->size, game->size);
+    }
+
+    Room *room = createRoom(config, 0, record->isSinglePlayer, record->synchronizationType);
+    if (room == NULL) {
+        free(game);
+        return NULL;
+    }
+
+    // the game was already running: nobody else can join and the clock goes on
+    room->game = game;
+    room->isGameRunning = true;
+    room->isRestored = true;
+    room->startTime = time(NULL) - record->elapsedSeconds;
+
+    if (!registerRoom(config, room)) {
+        destroyRoom(config, room);
+        return NULL;
+    }
+
+    publishRoomSnapshot(room);
+
+    return room;
+}
+
+int restoreRoomsSnapshot(ServerConfig *config) {
+
+    if (config->snapshotPath[0] == '\0') {
+        return 0;
+    }
+
+    FILE *file = fopen(config->snapshotPath, "rb");
+    if (file == NULL) {
+        return 0;
+    }
+
+    SnapshotFileHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SNAPSHOT_VERSION || header.numRooms < 0) {
+        fprintf(stderr, "Ignoring invalid rooms snapshot %s\n", config->snapshotPath);
+        fclose(file);
+        return 0;
+    }
+
+    // restored players keep their IDs, new ones continue after the last ID handed out
+    reserveClientIds(header.lastClientID);
+
+    int numRestored = 0;
+
+    for (int i = 0; i < header.numRooms; i++) {
+
+        SnapshotRoomRecord record;
+        char board[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+        char solution[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+        SnapshotPlayerRecord players[SNAPSHOT_MAX_PLAYERS];
+
+        if (fread(&record, sizeof(record), 1, file) != 1 || record.size > BOARD_MAX_SIZE || record.numPlayers > SNAPSHOT_MAX_PLAYERS) {
+            fprintf(stderr, "Truncated rooms snapshot %s\n", config->snapshotPath);
+            break;
+        }
+
+        int numCells = record.size * record.size;
+        if (fread(board, 1, numCells, file) != (size_t)numCells ||
+            fread(solution, 1, numCells, file) != (size_t)numCells ||
+            fread(players, sizeof(SnapshotPlayerRecord), record.numPlayers, file) != record.numPlayers) {
+            fprintf(stderr, "Truncated rooms snapshot %s\n", config->snapshotPath);
+            break;
+        }
+
+        if (restoreSavedRoom(config, &record, board, solution, players) != NULL) {
+            numRestored++;
+        }
+    }
+
+    fclose(file);
+
+    // restored once: a crash before the next drain must not bring back stale rooms
+    unlink(config->snapshotPath);
+
+    produceLog(config, "Salas restauradas do arranque anterior", EVENT_ROOM_LOAD, 0, 0);
+
+    return numRestored;
+}
+
+Room *restoreSavedRoom(ServerConfig *config, const SnapshotRoomRecord *record, const char *board, const char *solution, const SnapshotPlayerRecord *players) {
+
+    pthread_mutex_lock(&seatsMutex);
+    bool hasRoom = growRestored(record->numPlayers);
+    pthread_mutex_unlock(&seatsMutex);
+
+    if (!hasRoom) {
+        produceLog(config, "can't allocate memory to restore the rooms", MEMORY_ERROR, record->gameID, 0);
+        return NULL;
+    }
+
+    Room *room = restoreRoom(config, record, board, solution);
+    if (room == NULL) {
+        produceLog(config, "can't restore a saved room", EVENT_ROOM_NOT_LOAD, record->gameID, 0);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&seatsMutex);
+
+    restoredRooms[numRestoredRooms++] = room;
+
+    for (int p = 0; p < record->numPlayers; p++) {
+        RestoredSeat *seat = &seats[numSeats++];
+        memcpy(seat->token, players[p].token, SESSION_TOKEN_SIZE);
+        seat->token[SESSION_TOKEN_SIZE - 1] = '\0';
+        seat->clientID = players[p].clientID;
+        seat->isPremium = players[p].isPremium;
+        seat->roomIndex = numRestoredRooms - 1;
+        seat->isClaimed = false;
+    }
+
+    // the players have as long to come back as after a lost connection
+    bool startExpiry = !isExpiryStarted;
+    isExpiryStarted = true;
+
+    pthread_mutex_unlock(&seatsMutex);
+
+    if (startExpiry) {
+        pthread_t expireThread;
+        if (pthread_create(&expireThread, NULL, expireRestoredSeats, (void *)config) != 0) {
+            err_dump(config, 0, 0, "can't create the restored rooms thread", EVENT_THREAD_NOT_CREATE);
+        }
+        pthread_detach(expireThread);
+    }
+
+    printf("Sala %d restaurada: jogo %d na linha %d, %d jogador(es)\n", room->id, record->gameID, record->currentLine, record->numPlayers);
+
+    return room;
+}
+
+int getRestoredPlayers(Room *room, SnapshotPlayerRecord *players) {
+
+    int numPlayers = 0;
+
+    pthread_mutex_lock(&seatsMutex);
+
+    for (int i = 0; i < numSeats && !isSeatsExpired && numPlayers < SNAPSHOT_MAX_PLAYERS; i++) {
+        if (restoredRooms[seats[i].roomIndex] == room) {
+            SnapshotPlayerRecord *player = &players[numPlayers++];
+            memset(player, 0, sizeof(SnapshotPlayerRecord));
+            player->clientID = seats[i].clientID;
+            player->isPremium = seats[i].isPremium;
+            memcpy(player->token, seats[i].token, SESSION_TOKEN_SIZE);
+        }
+    }
+
+    pthread_mutex_unlock(&seatsMutex);
+
+    return numPlayers;
+}
+
+Room *claimRestoredSeat(ServerConfig *config, Client *client, const char *token) {
+
+    Room *room = NULL;
+    Room *fullRoom = NULL;
+
+    pthread_mutex_lock(&seatsMutex);
+
+    for (int i = 0; i < numSeats && !isSeatsExpired; i++) {
+
+        RestoredSeat *seat = &seats[i];
+        if (seat->isClaimed || strcmp(seat->token, token) != 0) {
+            continue;
+        }
+
+        // the restore reference keeps the room alive until then
+        Room *seatRoom = restoredRooms[seat->roomIndex];
+        pthread_mutex_lock(&seatRoom->mutex);
+        if (seatRoom->numClients < seatRoom->maxClients) {
+            seatRoom->refCount++;
+            seatRoom->clients[seatRoom->numClients++] = client;
+            room = seatRoom;
+        }
+        pthread_mutex_unlock(&seatRoom->mutex);
+
+        if (room == NULL) {
+            break;
+        }
+
+        seat->isClaimed = true;
+        client->clientID = seat->clientID;
+        client->isPremium = seat->isPremium;
+
+        // once every player is back, the room no longer needs the restore reference
+        bool isEveryoneBack = true;
+        for (int j = 0; j < numSeats; j++) {
+            if (seats[j].roomIndex == seat->roomIndex && !seats[j].isClaimed) {
+                isEveryoneBack = false;
+            }
+        }
+        if (isEveryoneBack) {
+            fullRoom = seatRoom;
+            restoredRooms[seat->roomIndex] = NULL;
+        }
+        break;
+    }
+
+    pthread_mutex_unlock(&seatsMutex);
+
+    if (fullRoom != NULL) {
+        releaseRoom(config, fullRoom);
+    }
+
+    // the same token keeps working if this connection drops too
+    if (room != NULL) {
+        adoptSession(config, client, token);
+    }
+
+    return room;
+}
+
+SessionStatus playRestoredRoom(ServerConfig *config, Room *room, Client *client) {
+
+    printf("Cliente %d voltou a sala restaurada %d na linha %d\n", client->clientID, room->id, room->game->currentLine);
+    produceLog(config, "Jogador voltou a uma sala restaurada", EVENT_ROOM_JOIN, room->game->id, client->clientID);
+
+    // the game started before the restart and the others may never come back, so each player
+    // just sends lines until the board is complete, from the board as it was saved
+    client->room = room;
+    client->step = STEP_RESUMED;
+
+    return playGameStep(config, client);
+}
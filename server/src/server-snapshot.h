@@ -0,0 +1,56 @@
+#ifndef SERVER_SNAPSHOT_H
+#define SERVER_SNAPSHOT_H
+
+#include <stdbool.h>
+#include "../config/config.h"
+#include "server-sessions.h"
+
+#define SNAPSHOT_MAGIC "SUDOKURS"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_MAX_PLAYERS 32 // players saved per room
+
+// Cabeçalho do ficheiro de salas guardadas ao desligar o servidor.
+typedef struct {
+    char magic[8];
+    int version;
+    int numRooms;
+    int lastClientID; // new IDs continue after it, so restored players keep theirs
+} SnapshotFileHeader;
+
+// Uma sala guardada, seguida de size*size células do tabuleiro, size*size da solução e dos jogadores.
+typedef struct {
+    int gameID;
+    int currentLine;
+    int elapsedSeconds;
+    unsigned char size;
+    unsigned char isSinglePlayer;
+    unsigned char synchronizationType;
+    unsigned char numPlayers;
+} SnapshotRoomRecord;
+
+// Um jogador de uma sala guardada: volta a ela com "resume <token>".
+typedef struct {
+    int clientID;
+    int isPremium;
+    char token[SESSION_TOKEN_SIZE];
+} SnapshotPlayerRecord;
+
+// Guarda as salas com jogos a decorrer em SNAPSHOT_PATH (devolve o número de salas guardadas, -1 se não as conseguiu guardar).
+int saveRoomsSnapshot(ServerConfig *config);
+
+// Recria as salas guardadas pelo arranque anterior e apaga o ficheiro (devolve o número de salas restauradas).
+int restoreRoomsSnapshot(ServerConfig *config);
+
+// Recria uma sala guardada e os lugares dos seus jogadores (NULL se não foi possível).
+Room *restoreSavedRoom(ServerConfig *config, const SnapshotRoomRecord *record, const char *board, const char *solution, const SnapshotPlayerRecord *players);
+
+// Copia os jogadores de uma sala restaurada que ainda podem voltar a ela (devolve quantos são).
+int getRestoredPlayers(Room *room, SnapshotPlayerRecord *players);
+
+// Entrega ao cliente o lugar de um jogador restaurado com este token (NULL se não existe ou expirou).
+Room *claimRestoredSeat(ServerConfig *config, Client *client, const char *token);
+
+// Continua um jogo restaurado: envia o tabuleiro, e as linhas seguintes são passos da sessão do cliente.
+SessionStatus playRestoredRoom(ServerConfig *config, Room *room, Client *client);
+
+#endif // SERVER_SNAPSHOT_H
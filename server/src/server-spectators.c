@@ -0,0 +1,529 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <time.h>
+#include "../../utils/logs/logs-common.h"
+#include "../../utils/network/network.h"
+#include "../../utils/board/board.h"
+#include "../logs/logs.h"
+#include "server-spectators.h"
+#include "server-game.h"
+#include "server-comms.h"
+#include "server-workers.h"
+
+/*
+ * Espectadores: cada alteração do tabuleiro de uma sala com espectadores é codificada uma vez num
+ * snapshot partilhado (com contagem de referências) e uma única thread envia-o a todos os
+ * espectadores com escritas não bloqueantes. Um espectador lento acaba o snapshot que está a
+ * receber e salta diretamente para o mais recente, sem acumular os intermédios. A mesma thread
+ * espera pelo "stopSpectating" de cada espectador, que não ocupa um worker enquanto vê a sala.
+ *
+ * Mensagens enviadas ao espectador, uma por linha:
+ *   SPECTATING <sala>                                          (resposta a "spectateRoom <sala>")
+ *   BOARD <sala> <jogo> <tamanho> <linha atual> <células>      (estado mais recente)
+ *   OVER <sala>                                                (a sala terminou)
+ *   STOPPED                                                    (resposta a "stopSpectating")
+ */
+
+#define SNAPSHOT_HEADER_SIZE 64
+#define SPECTATOR_LEAVE_TIMEOUT_MS 2000 // time a leaving spectator gets to take the rest of its snapshot
+
+// one watcher, owned by the fan-out thread once it is added
+typedef struct {
+    Client *client;             // held by the fan-out thread until the spectator leaves
+    SpectatorFeed *feed;
+    BoardSnapshot *sending;     // snapshot being written, NULL when up to date
+    int offset;                 // bytes of it already written
+    unsigned long sentVersion;
+    bool isLeaving;
+    bool hasFailed;
+    bool isCutShort;            // left in the middle of a snapshot: the stream isn't whole any more
+    struct timespec leaveDeadline;
+} Spectator;
+
+static ServerConfig *spectatorsConfig;
+
+// every spectator of every room (protected by spectatorsMutex)
+static pthread_mutex_t spectatorsMutex = PTHREAD_MUTEX_INITIALIZER;
+static Spectator **spectators = NULL;
+static int numSpectators = 0;
+static int spectatorsCapacity = 0;
+
+// written to wake the fan-out thread up from poll
+static int wakeupPipe[2] = {-1, -1};
+
+static void releaseSnapshot(BoardSnapshot *snapshot) {
+
+    if (snapshot != NULL && atomic_fetch_sub(&snapshot->refCount, 1) == 1) {
+        free(snapshot);
+    }
+}
+
+static void releaseFeed(SpectatorFeed *feed) {
+
+    if (atomic_fetch_sub(&feed->refCount, 1) == 1) {
+        releaseSnapshot(feed->latest);
+        pthread_mutex_destroy(&feed->mutex);
+        free(feed);
+    }
+}
+
+static void wakeFanOut() {
+
+    // the pipe is non-blocking: if it is full the thread is already going to wake up
+    char c = 0;
+    if (write(wakeupPipe[1], &c, 1) < 0 && errno != EAGAIN) {
+        perror("can't wake the spectators thread");
+    }
+}
+
+// replace the latest snapshot of a feed (takes the caller's reference)
+static void publishSnapshot(SpectatorFeed *feed, BoardSnapshot *snapshot) {
+
+    pthread_mutex_lock(&feed->mutex);
+    BoardSnapshot *previous = feed->latest;
+    snapshot->version = ++feed->version;
+    feed->latest = snapshot;
+    pthread_mutex_unlock(&feed->mutex);
+
+    releaseSnapshot(previous);
+
+    if (atomic_load(&feed->numSpectators) > 0) {
+        wakeFanOut();
+    }
+}
+
+static BoardSnapshot *allocSnapshot(int capacity) {
+
+    BoardSnapshot *snapshot = (BoardSnapshot *)malloc(sizeof(BoardSnapshot) + capacity);
+    if (snapshot != NULL) {
+        atomic_init(&snapshot->refCount, 1);
+        snapshot->length = 0;
+    }
+
+    return snapshot;
+}
+
+// a reference to the latest snapshot if the spectator hasn't sent it yet
+static BoardSnapshot *takeNewerSnapshot(SpectatorFeed *feed, unsigned long sentVersion) {
+
+    BoardSnapshot *snapshot = NULL;
+
+    pthread_mutex_lock(&feed->mutex);
+    if (feed->latest != NULL && feed->latest->version > sentVersion) {
+        snapshot = feed->latest;
+        atomic_fetch_add(&snapshot->refCount, 1);
+    }
+    pthread_mutex_unlock(&feed->mutex);
+
+    return snapshot;
+}
+
+// write as much as the socket takes; true if the spectator is waiting for room in its socket
+static bool pumpSpectator(Spectator *spectator) {
+
+    for (;;) {
+
+        if (spectator->sending == NULL) {
+            // a leaving spectator only finishes the snapshot it started
+            if (spectator->isLeaving) {
+                return false;
+            }
+
+            // skip straight to the latest snapshot
+            spectator->sending = takeNewerSnapshot(spectator->feed, spectator->sentVersion);
+            spectator->offset = 0;
+            if (spectator->sending == NULL) {
+                return false;
+            }
+        }
+
+        BoardSnapshot *snapshot = spectator->sending;
+        ssize_t n = send(spectator->client->socket_fd, snapshot->data + spectator->offset,
+                         snapshot->length - spectator->offset, MSG_DONTWAIT | MSG_NOSIGNAL);
+
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return true;
+            }
+
+            // the connection is gone: the spectator leaves on the next round
+            spectator->hasFailed = true;
+            releaseSnapshot(snapshot);
+            spectator->sending = NULL;
+            return false;
+        }
+
+        spectator->offset += n;
+
+        if (spectator->offset == snapshot->length) {
+            spectator->sentVersion = snapshot->version;
+            releaseSnapshot(snapshot);
+            spectator->sending = NULL;
+        }
+    }
+}
+
+static long millisecondsUntil(const struct timespec *deadline) {
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (deadline->tv_sec - now.tv_sec) * 1000 + (deadline->tv_nsec - now.tv_nsec) / 1000000;
+}
+
+static void startLeaving(Spectator *spectator) {
+
+    spectator->isLeaving = true;
+    clock_gettime(CLOCK_MONOTONIC, &spectator->leaveDeadline);
+    spectator->leaveDeadline.tv_sec += SPECTATOR_LEAVE_TIMEOUT_MS / 1000;
+    spectator->leaveDeadline.tv_nsec += (SPECTATOR_LEAVE_TIMEOUT_MS % 1000) * 1000000L;
+    if (spectator->leaveDeadline.tv_nsec >= 1000000000L) {
+        spectator->leaveDeadline.tv_sec++;
+        spectator->leaveDeadline.tv_nsec -= 1000000000L;
+    }
+}
+
+// the socket only carries "stopSpectating" from the client; anything after it is the next menu request
+static void readSpectator(Spectator *spectator) {
+
+    Client *client = spectator->client;
+    char buffer[BUFFER_SIZE];
+    memset(buffer, 0, sizeof(buffer));
+
+    ssize_t n = recv(client->socket_fd, buffer, sizeof(buffer) - 1, MSG_DONTWAIT);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return;
+    }
+
+    if (n <= 0) {
+        spectator->hasFailed = true;
+        startLeaving(spectator);
+        return;
+    }
+
+    if (strncmp(buffer, "stopSpectating", strlen("stopSpectating")) == 0) {
+        int rest = n - (int)strlen("stopSpectating");
+        if (rest > 0) {
+            memcpy(client->pending, buffer + strlen("stopSpectating"), rest);
+            client->pendingLength = rest;
+        }
+        startLeaving(spectator);
+    }
+}
+
+// the fan-out thread let go of the spectator: answer "STOPPED" and give the session back to the workers
+static void finishSpectator(Spectator *spectator) {
+
+    Client *client = spectator->client;
+    SpectatorFeed *feed = spectator->feed;
+    int roomID = feed->roomID;
+    bool isConnected = !spectator->hasFailed;
+
+    // the last message was cut: "STOPPED" would arrive in the middle of it
+    if (spectator->isCutShort) {
+        produceLog(spectatorsConfig, "Espectador lento retirado a meio de um estado", EVENT_SERVER_CONNECTION_FINISH, roomID, client->clientID);
+        isConnected = false;
+    }
+
+    atomic_fetch_sub(&feed->numSpectators, 1);
+    releaseFeed(feed);
+    free(spectator);
+
+    // a few bytes after a finished snapshot: the socket has room for them
+    if (isConnected) {
+        isConnected = send(client->socket_fd, "STOPPED\n", strlen("STOPPED\n"), MSG_DONTWAIT | MSG_NOSIGNAL) == (ssize_t)strlen("STOPPED\n");
+    }
+
+    if (isConnected) {
+        client->step = STEP_MENU;
+        continueSession(client);
+    } else {
+        closeClientSession(spectatorsConfig, client);
+    }
+}
+
+static void *fanOutWorker(void *arg) {
+
+    struct pollfd *fds = NULL;
+    Spectator **polled = NULL;
+    int fdsCapacity = 0;
+
+    for (;;) {
+
+        pthread_mutex_lock(&spectatorsMutex);
+
+        if (fdsCapacity < numSpectators + 1) {
+            fdsCapacity = spectatorsCapacity + 1;
+            fds = (struct pollfd *)realloc(fds, sizeof(struct pollfd) * fdsCapacity);
+            polled = (Spectator **)realloc(polled, sizeof(Spectator *) * fdsCapacity);
+            if (fds == NULL || polled == NULL) {
+                perror("can't allocate the spectators poll set");
+                exit(1);
+            }
+        }
+
+        fds[0].fd = wakeupPipe[0];
+        fds[0].events = POLLIN;
+        int numFds = 1;
+        int timeoutMs = -1;
+
+        for (int i = 0; i < numSpectators; ) {
+
+            Spectator *spectator = spectators[i];
+
+            // a lost connection leaves at once
+            if (spectator->hasFailed && !spectator->isLeaving) {
+                startLeaving(spectator);
+            }
+
+            // a leaving spectator gets the rest of the snapshot it was sent, so its stream stays whole,
+            // but only for a while: a stalled connection can't keep its session here
+            if (spectator->isLeaving && spectator->sending != NULL && !spectator->hasFailed) {
+                long remainingMs = millisecondsUntil(&spectator->leaveDeadline);
+                if (remainingMs <= 0) {
+                    spectator->isCutShort = true;
+                } else if (timeoutMs < 0 || remainingMs < timeoutMs) {
+                    timeoutMs = (int)remainingMs;
+                }
+            }
+
+            if (spectator->isLeaving && (spectator->sending == NULL || spectator->hasFailed || spectator->isCutShort)) {
+                releaseSnapshot(spectator->sending);
+                spectator->sending = NULL;
+                spectators[i] = spectators[--numSpectators];
+                // nothing here blocks: a non-blocking send and a hand-over to the workers
+                finishSpectator(spectator);
+                continue;
+            }
+
+            bool isWaitingToSend = !spectator->hasFailed && pumpSpectator(spectator);
+
+            // watch for "stopSpectating" (or a hang-up) until the spectator starts leaving
+            short events = (isWaitingToSend ? POLLOUT : 0) | (spectator->isLeaving ? 0 : POLLIN);
+            if (events != 0) {
+                fds[numFds].fd = spectator->client->socket_fd;
+                fds[numFds].events = events;
+                polled[numFds] = spectator;
+                numFds++;
+            }
+
+            i++;
+        }
+
+        pthread_mutex_unlock(&spectatorsMutex);
+
+        if (poll(fds, numFds, timeoutMs) < 0 && errno != EINTR) {
+            perror("spectators poll error");
+            continue;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            char drain[64];
+            while (read(wakeupPipe[0], drain, sizeof(drain)) > 0) {
+            }
+        }
+
+        // only this thread changes a spectator once it is added, so it is read without the lock
+        for (int i = 1; i < numFds; i++) {
+            if ((fds[i].revents & (POLLIN | POLLHUP | POLLERR)) && !polled[i]->isLeaving) {
+                readSpectator(polled[i]);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Inicia a thread que envia os estados das salas aos espectadores.
+ *
+ * @param config Um pointer para a estrutura `ServerConfig` com a configuração do servidor.
+ *
+ * @details Cria o pipe usado para acordar a thread quando há um estado novo ou um espectador
+ * entra ou sai (não bloqueante, para que quem publica nunca fique à espera) e lança a thread.
+ */
+
+void initSpectators(ServerConfig *config) {
+
+    spectatorsConfig = config;
+
+    if (pipe(wakeupPipe) < 0) {
+        err_dump(config, 0, 0, "can't create the spectators pipe", EVENT_SERVER_THREAD_ERROR);
+    }
+
+    fcntl(wakeupPipe[0], F_SETFL, fcntl(wakeupPipe[0], F_GETFL) | O_NONBLOCK);
+    fcntl(wakeupPipe[1], F_SETFL, fcntl(wakeupPipe[1], F_GETFL) | O_NONBLOCK);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, fanOutWorker, NULL) != 0) {
+        err_dump(config, 0, 0, "can't create the spectators thread", EVENT_SERVER_THREAD_ERROR);
+    }
+    pthread_detach(thread);
+}
+
+SpectatorFeed *createSpectatorFeed(int roomID) {
+
+    SpectatorFeed *feed = (SpectatorFeed *)calloc(1, sizeof(SpectatorFeed));
+    if (feed == NULL) {
+        return NULL;
+    }
+
+    feed->roomID = roomID;
+    pthread_mutex_init(&feed->mutex, NULL);
+    atomic_init(&feed->refCount, 1);
+    atomic_init(&feed->numSpectators, 0);
+
+    return feed;
+}
+
+// encode the room's board into a new snapshot of its feed
+static void encodeRoomSnapshot(Room *room) {
+
+    Game *game = room->game;
+    BoardSnapshot *snapshot = allocSnapshot(SNAPSHOT_HEADER_SIZE + game->size * game->size + 1);
+    if (snapshot == NULL) {
+        return;
+    }
+
+    int used = snprintf(snapshot->data, SNAPSHOT_HEADER_SIZE, "BOARD %d %d %d %d ", room->id, game->id, game->size, game->currentLine);
+    used += encodeBoardCells(snapshot->data + used, (const char (*)[BOARD_ROW_STRIDE])game->board, game->size);
+    snapshot->data[used++] = '\n';
+    snapshot->length = used;
+
+    publishSnapshot(room->feed, snapshot);
+}
+
+void publishRoomSnapshot(Room *room) {
+
+    // nobody is watching: the first spectator encodes the board when it arrives
+    if (room->feed == NULL || room->game == NULL || atomic_load(&room->feed->numSpectators) == 0) {
+        return;
+    }
+
+    encodeRoomSnapshot(room);
+}
+
+void closeSpectatorFeed(SpectatorFeed *feed) {
+
+    if (feed == NULL) {
+        return;
+    }
+
+    // the room is gone, so nobody can start watching it now
+    BoardSnapshot *snapshot = atomic_load(&feed->numSpectators) > 0 ? allocSnapshot(SNAPSHOT_HEADER_SIZE) : NULL;
+    if (snapshot != NULL) {
+        snapshot->length = snprintf(snapshot->data, SNAPSHOT_HEADER_SIZE, "OVER %d\n", feed->roomID);
+        publishSnapshot(feed, snapshot);
+    }
+
+    releaseFeed(feed);
+}
+
+/**
+ * Acompanha uma sala sem ocupar um lugar de jogador.
+ *
+ * @param config Um pointer para a estrutura `ServerConfig` com a configuração do servidor.
+ * @param client O cliente que quer ver a sala.
+ * @param roomID O identificador da sala.
+ * @return `SESSION_HELD` se o cliente passou a ver a sala, `SESSION_CONTINUE` se a sala não existe,
+ * ou `SESSION_CLOSED` se a ligação com o cliente foi fechada.
+ *
+ * @details Esta função faz o seguinte:
+ * - Obtém a sala e guarda uma referência ao seu feed (a sala pode terminar enquanto o cliente vê).
+ * - Responde "SPECTATING <sala>", codifica o estado atual da sala (as salas sem espectadores não
+ *   codificam os seus estados) e entrega o cliente à thread dos espectadores, que lhe envia o estado
+ *   mais recente e os seguintes sem bloquear. O worker volta logo para o pool.
+ * - A thread dos espectadores espera que o cliente envie "stopSpectating" (normalmente depois de
+ *   receber "OVER") ou feche a ligação, retira o espectador e, se o cliente continua ligado, responde
+ *   "STOPPED" e devolve a sessão ao pool, à espera do próximo pedido do menu.
+ * - Um espectador que sai a meio de um estado tem `SPECTATOR_LEAVE_TIMEOUT_MS` para o receber até
+ *   ao fim; se não o recebe, a ligação é fechada, porque a mensagem ficou cortada.
+ *
+ * @note Os espectadores não contam para `maxClients` nem seguram a sala: só o feed fica vivo.
+ */
+
+SessionStatus spectateRoom(ServerConfig *config, Client *client, int roomID) {
+
+    char buffer[BUFFER_SIZE];
+
+    // getRoom doesn't take invalid IDs
+    Room *room = roomID > 0 ? getRoom(config, roomID, client->clientID) : NULL;
+
+    if (room == NULL || room->feed == NULL) {
+        if (room != NULL) {
+            releaseRoom(config, room);
+        }
+        snprintf(buffer, sizeof(buffer), "ERROR %d unknown room\n", roomID);
+        return writen(client->socket_fd, buffer, strlen(buffer)) >= 0 ? SESSION_CONTINUE : SESSION_CLOSED;
+    }
+
+    SpectatorFeed *feed = room->feed;
+
+    Spectator *spectator = (Spectator *)calloc(1, sizeof(Spectator));
+    if (spectator == NULL) {
+        releaseRoom(config, room);
+        snprintf(buffer, sizeof(buffer), "ERROR %d out of memory\n", roomID);
+        return writen(client->socket_fd, buffer, strlen(buffer)) >= 0 ? SESSION_CONTINUE : SESSION_CLOSED;
+    }
+
+    // answer before the fan-out thread starts writing to the socket
+    snprintf(buffer, sizeof(buffer), "SPECTATING %d\n", roomID);
+    if (writen(client->socket_fd, buffer, strlen(buffer)) < 0) {
+        releaseRoom(config, room);
+        free(spectator);
+        return SESSION_CLOSED;
+    }
+
+    spectator->client = client;
+    spectator->feed = feed;
+    atomic_fetch_add(&feed->refCount, 1);
+
+    // from now on every change is published; the board as it is now goes first, under the mutex
+    // where the lines are applied, so a newer change can't be published before it
+    atomic_fetch_add(&feed->numSpectators, 1);
+    pthread_mutex_lock(&room->mutex);
+    if (room->game != NULL) {
+        encodeRoomSnapshot(room);
+    }
+    pthread_mutex_unlock(&room->mutex);
+
+    releaseRoom(config, room);
+
+    produceLog(config, "Cliente a ver a sala", EVENT_ROOM_JOIN, roomID, client->clientID);
+    printf("Cliente %d a ver a sala %d\n", client->clientID, roomID);
+
+    pthread_mutex_lock(&spectatorsMutex);
+    if (numSpectators == spectatorsCapacity) {
+        int capacity = spectatorsCapacity == 0 ? 64 : spectatorsCapacity * 2;
+        Spectator **grown = (Spectator **)realloc(spectators, sizeof(Spectator *) * capacity);
+        if (grown != NULL) {
+            spectators = grown;
+            spectatorsCapacity = capacity;
+        }
+    }
+    bool isAdded = numSpectators < spectatorsCapacity;
+    if (isAdded) {
+        spectators[numSpectators++] = spectator;
+    }
+    pthread_mutex_unlock(&spectatorsMutex);
+
+    if (!isAdded) {
+        atomic_fetch_sub(&feed->numSpectators, 1);
+        releaseFeed(feed);
+        free(spectator);
+        return writen(client->socket_fd, "STOPPED\n", strlen("STOPPED\n")) >= 0 ? SESSION_CONTINUE : SESSION_CLOSED;
+    }
+
+    // the client belongs to the fan-out thread now, which gives it back when the spectator leaves
+    wakeFanOut();
+
+    return SESSION_HELD;
+}
@@ -0,0 +1,42 @@
+#ifndef SERVER_SPECTATORS_H
+#define SERVER_SPECTATORS_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "../config/config.h"
+
+// Estado do tabuleiro codificado uma só vez e partilhado por todos os espectadores da sala.
+typedef struct {
+    atomic_int refCount;
+    unsigned long version;
+    int length;
+    char data[];
+} BoardSnapshot;
+
+// Último estado publicado de uma sala (uma referência da sala e uma por espectador).
+typedef struct SpectatorFeed {
+    int roomID;
+    pthread_mutex_t mutex;
+    BoardSnapshot *latest; // protected by mutex
+    unsigned long version; // protected by mutex
+    atomic_int refCount;
+    atomic_int numSpectators;
+} SpectatorFeed;
+
+// Inicia a thread que envia os estados das salas aos espectadores.
+void initSpectators(ServerConfig *config);
+
+// Cria o feed de uma sala acabada de criar.
+SpectatorFeed *createSpectatorFeed(int roomID);
+
+// Codifica o tabuleiro atual da sala e publica-o, se houver espectadores (chamar por quem altera o tabuleiro).
+void publishRoomSnapshot(Room *room);
+
+// Publica o fim da sala e larga a referência da sala ao feed.
+void closeSpectatorFeed(SpectatorFeed *feed);
+
+// Passa o cliente a acompanhar uma sala sem ocupar um lugar de jogador nem um worker, até enviar "stopSpectating".
+SessionStatus spectateRoom(ServerConfig *config, Client *client, int roomID);
+
+#endif // SERVER_SPECTATORS_H
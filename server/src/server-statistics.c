@@ -1,26 +1,546 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <unistd.h>
 #include "../../utils/logs/logs-common.h"
 #include "../../utils/parson/parson.h"
 #include "../../utils/network/network.h"
 #include "../logs/logs.h"
 #include "server-statistics.h"
+#include "server-catalog.h"
+#include "server-workers.h"
+#include "server-results.h"
+#include "server-wal.h"
 
+// upper bounds (seconds) of the solve time histogram buckets; the last bucket is open
+static const int timeBucketBounds[STATISTICS_TIME_BUCKETS - 1] = {
+    10, 20, 30, 45, 60, 90, 120, 150, 180, 240, 300, 420, 600, 900, 1200, 1800, 2700, 3600
+};
 
-void saveRoomStatistics(int roomId, double elapsedTime) {
-    FILE *file = fopen("room_stats.log", "a");  // Abre o ficheiro em modo de append
-    if (file != NULL) {
-        fprintf(file, "Sala %d - Tempo de resolução: %.2f segundos\n", roomId, elapsedTime);
-        fclose(file);
+static const char *classNames[STATISTICS_SYNC_CLASSES] = {
+    "Single player",
+    "Readers-Writers",
+    "Barber-Shop static priority",
+    "Barber-Shop dynamic priority",
+    "Barber-Shop FIFO"
+};
+
+typedef struct {
+    int gameID; // 0 marks an empty slot
+    StatisticsSummary summary;
+} GameStatisticsEntry;
+
+// aggregated statistics (protected by statisticsMutex)
+static pthread_mutex_t statisticsMutex = PTHREAD_MUTEX_INITIALIZER;
+static StatisticsSummary overallStatistics;
+static StatisticsSummary syncStatistics[STATISTICS_SYNC_CLASSES];
+static StatisticsSummary premiumStatistics[2];
+static GameStatisticsEntry *gameStatistics = NULL; // open addressing table keyed by game ID
+static int gameStatisticsCapacity = 0;
+static int gameStatisticsCount = 0;
+static bool statisticsDirty = false;
+
+// snapshot served to GET_STATS, rebuilt after each update
+static char statisticsSnapshot[STATISTICS_SNAPSHOT_SIZE];
+static int statisticsSnapshotLength = 0;
+static int statisticsSnapshotLines = 0;
+
+// exclusive access to the statistics file
+static pthread_mutex_t statisticsFileMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static unsigned int hashGameID(int gameID) {
+    return (unsigned int)gameID * 2654435761u;
+}
+
+// find the slot of a game, or the empty slot where it would go (caller holds statisticsMutex)
+static GameStatisticsEntry *findGameSlot(GameStatisticsEntry *table, int capacity, int gameID) {
+
+    unsigned int mask = capacity - 1;
+    unsigned int index = hashGameID(gameID) & mask;
+
+    while (table[index].gameID != 0 && table[index].gameID != gameID) {
+        index = (index + 1) & mask;
+    }
+
+    return &table[index];
+}
+
+static bool growGameStatistics() {
+
+    int capacity = gameStatisticsCapacity == 0 ? 64 : gameStatisticsCapacity * 2;
+    GameStatisticsEntry *table = (GameStatisticsEntry *)calloc(capacity, sizeof(GameStatisticsEntry));
+    if (table == NULL) {
+        return false;
+    }
+
+    for (int i = 0; i < gameStatisticsCapacity; i++) {
+        if (gameStatistics[i].gameID != 0) {
+            *findGameSlot(table, capacity, gameStatistics[i].gameID) = gameStatistics[i];
+        }
+    }
+
+    free(gameStatistics);
+    gameStatistics = table;
+    gameStatisticsCapacity = capacity;
+    return true;
+}
+
+// get the statistics of a game, creating them if needed (caller holds statisticsMutex)
+static StatisticsSummary *getGameSummary(int gameID, bool create) {
+
+    if (gameStatisticsCapacity > 0) {
+        GameStatisticsEntry *entry = findGameSlot(gameStatistics, gameStatisticsCapacity, gameID);
+        if (entry->gameID == gameID) {
+            return &entry->summary;
+        }
+    }
+
+    if (!create || gameID == 0) {
+        return NULL;
+    }
+
+    // keep the load factor under 70%
+    if ((gameStatisticsCount + 1) * 10 > gameStatisticsCapacity * 7 && !growGameStatistics()) {
+        return NULL;
+    }
+
+    GameStatisticsEntry *entry = findGameSlot(gameStatistics, gameStatisticsCapacity, gameID);
+    memset(entry, 0, sizeof(GameStatisticsEntry));
+    entry->gameID = gameID;
+    gameStatisticsCount++;
+
+    return &entry->summary;
+}
+
+static void addToSummary(StatisticsSummary *summary, int elapsedTime, float accuracy) {
+
+    if (summary->count == 0 || elapsedTime < summary->minTime) {
+        summary->minTime = elapsedTime;
+    }
+    if (elapsedTime > summary->maxTime) {
+        summary->maxTime = elapsedTime;
+    }
+
+    summary->count++;
+    summary->totalTime += elapsedTime;
+    summary->totalAccuracy += accuracy;
+
+    int bucket = 0;
+    while (bucket < STATISTICS_TIME_BUCKETS - 1 && elapsedTime > timeBucketBounds[bucket]) {
+        bucket++;
+    }
+    summary->timeHistogram[bucket]++;
+
+    int accuracyBucket = (int)(accuracy / 10);
+    if (accuracyBucket < 0) {
+        accuracyBucket = 0;
+    } else if (accuracyBucket >= STATISTICS_ACCURACY_BUCKETS) {
+        accuracyBucket = STATISTICS_ACCURACY_BUCKETS - 1;
+    }
+    summary->accuracyHistogram[accuracyBucket]++;
+}
+
+// percentile of the solve time, estimated by the upper bound of the histogram bucket
+static int timePercentile(const StatisticsSummary *summary, int percentile) {
+
+    int target = (summary->count * percentile + 99) / 100;
+    int cumulative = 0;
+
+    for (int bucket = 0; bucket < STATISTICS_TIME_BUCKETS - 1; bucket++) {
+        cumulative += summary->timeHistogram[bucket];
+        if (cumulative >= target) {
+            int bound = timeBucketBounds[bucket];
+            if (bound > summary->maxTime) {
+                return summary->maxTime;
+            }
+            return bound < summary->minTime ? summary->minTime : bound;
+        }
+    }
+
+    return summary->maxTime;
+}
+
+static int formatSummary(char *out, int size, const char *label, const StatisticsSummary *summary) {
+
+    if (summary->count == 0) {
+        return snprintf(out, size, "%s: no games finished\n", label);
+    }
+
+    return snprintf(out, size, "%s: %d finished | time min %ds mean %.1fs p50 ~%ds p95 ~%ds | accuracy mean %.1f%%\n",
+                    label, summary->count, summary->minTime,
+                    (double)summary->totalTime / summary->count,
+                    timePercentile(summary, 50), timePercentile(summary, 95),
+                    summary->totalAccuracy / summary->count);
+}
+
+static int formatAccuracyDistribution(char *out, int size, const StatisticsSummary *summary) {
+
+    int length = snprintf(out, size, "Accuracy distribution:");
+
+    for (int bucket = 0; bucket < STATISTICS_ACCURACY_BUCKETS && length < size; bucket++) {
+        length += snprintf(out + length, size - length, " %d-%d%%: %d%s", bucket * 10,
+                           bucket == STATISTICS_ACCURACY_BUCKETS - 1 ? 100 : bucket * 10 + 9,
+                           summary->accuracyHistogram[bucket],
+                           bucket == STATISTICS_ACCURACY_BUCKETS - 1 ? "\n" : ",");
+    }
+
+    return length;
+}
+
+// rebuild the GET_STATS snapshot (caller holds statisticsMutex)
+static void rebuildSnapshot() {
+
+    char *out = statisticsSnapshot;
+    int size = sizeof(statisticsSnapshot);
+    int length = 0;
+    int lines = 0;
+
+    length += formatSummary(out + length, size - length, "All games", &overallStatistics);
+    length += formatAccuracyDistribution(out + length, size - length, &overallStatistics);
+    lines += 2;
+
+    for (int i = 0; i < STATISTICS_SYNC_CLASSES; i++) {
+        length += formatSummary(out + length, size - length, classNames[i], &syncStatistics[i]);
+        lines++;
+    }
+
+    length += formatSummary(out + length, size - length, "Premium", &premiumStatistics[1]);
+    length += formatSummary(out + length, size - length, "Non-premium", &premiumStatistics[0]);
+    lines += 2;
+
+    // sendStatistics adds the live lines and the END line
+    statisticsSnapshotLines = lines;
+    statisticsSnapshotLength = length < size ? length : size - 1;
+}
+
+void recordGameStatistics(ServerConfig *config, Room *room, Client *client, double elapsedTime, float accuracy) {
+
+    int syncClass = room->isSinglePlayer ? 0 : room->synchronizationType + 1;
+    if (syncClass < 0 || syncClass >= STATISTICS_SYNC_CLASSES) {
+        syncClass = 0;
+    }
+
+    pthread_mutex_lock(&statisticsMutex);
+
+    addToSummary(&overallStatistics, (int)elapsedTime, accuracy);
+    addToSummary(&syncStatistics[syncClass], (int)elapsedTime, accuracy);
+    addToSummary(&premiumStatistics[client->isPremium ? 1 : 0], (int)elapsedTime, accuracy);
+
+    StatisticsSummary *gameSummary = getGameSummary(room->game->id, true);
+    if (gameSummary != NULL) {
+        addToSummary(gameSummary, (int)elapsedTime, accuracy);
+    }
+
+    statisticsDirty = true;
+    rebuildSnapshot();
+
+    pthread_mutex_unlock(&statisticsMutex);
+}
+
+void sendStatistics(ServerConfig *config, Client *client, int gameID) {
+
+    char message[STATISTICS_SNAPSHOT_SIZE + 768]; // the snapshot and the live lines
+    int length;
+
+    pthread_mutex_lock(&statisticsMutex);
+
+    if (gameID == 0) {
+        // precomputed snapshot, with the session workers', results' and WAL counters before its END line
+        memcpy(message, statisticsSnapshot, statisticsSnapshotLength);
+        length = statisticsSnapshotLength;
+
+        WorkerCounters counters;
+        getWorkerCounters(&counters);
+        length += snprintf(message + length, sizeof(message) - length,
+                           "Session workers: %d/%d busy | %d queued | %d parked | %d scheduled | %ld requests | queue delay mean %.2fms max %.2fms\n",
+                           counters.busyWorkers, counters.numWorkers, counters.queuedSessions, counters.parkedSessions, counters.scheduledSessions,
+                           counters.servedRequests, counters.meanQueueDelayMs, counters.maxQueueDelayMs);
+
+        // and the results stage's batching, write amplification and finish latency
+        ResultsCounters results;
+        getResultsCounters(&results);
+        length += snprintf(message + length, sizeof(message) - length,
+                           "Results: %ld in %ld batches (%.1f per batch) | %.0f bytes written per result | queueing mean %.1fus | durable mean %.1fms max %.1fms | %ld waited for the queue\n",
+                           results.results, results.batches, results.batches > 0 ? (double)results.results / results.batches : 0,
+                           results.results > 0 ? (double)results.bytesWritten / results.results : 0,
+                           results.meanQueueUs, results.meanDurableMs, results.maxDurableMs, results.fullQueueWaits);
+
+        // and the group commits of the games' write-ahead log
+        GameWalCounters wal;
+        getGameWalCounters(&wal);
+        if (wal.isEnabled) {
+            length += snprintf(message + length, sizeof(message) - length,
+                               "WAL: %ld records in %ld commits (%.1f per commit) | %.0f bytes per record | %ld waited for the buffer | %ld compactions | %ld write errors\n",
+                               wal.records, wal.commits, wal.commits > 0 ? (double)wal.records / wal.commits : 0,
+                               wal.records > 0 ? (double)wal.bytesWritten / wal.records : 0, wal.fullWaits, wal.compactions, wal.writeErrors);
+        } else {
+            length += snprintf(message + length, sizeof(message) - length, "WAL: off\n");
+        }
+        length += snprintf(message + length, sizeof(message) - length, "END 0 %d %d\n", statisticsSnapshotLines + 3, statisticsSnapshotLines + 3);
+    } else {
+        StatisticsSummary *summary = getGameSummary(gameID, false);
+        char label[32];
+        snprintf(label, sizeof(label), "Game %d", gameID);
+
+        if (summary == NULL) {
+            length = snprintf(message, sizeof(message), "%s: no games finished\nEND 0 1 1\n", label);
+        } else {
+            length = formatSummary(message, sizeof(message), label, summary);
+            length += formatAccuracyDistribution(message + length, sizeof(message) - length, summary);
+            length += snprintf(message + length, sizeof(message) - length, "END 0 2 2\n");
+        }
+    }
+
+    pthread_mutex_unlock(&statisticsMutex);
+
+    // Envia as estatísticas ao cliente
+    if (writen(client->socket_fd, message, length) != length) {
+        // erro ao enviar estatísticas
+        err_dump(config, 0, client->clientID, "can't send statistics to client", EVENT_MESSAGE_SERVER_NOT_SENT);
+    } else {
+        printf("Estatísticas enviadas ao cliente\n");
+        produceLog(config, "Estatísticas enviadas ao cliente", EVENT_MESSAGE_SERVER_SENT, gameID, client->clientID);
+    }
+}
+
+void saveStatistics(ServerConfig *config) {
+
+    if (config->statisticsPath[0] == '\0') {
+        return;
+    }
+
+    // copy the aggregates so the file is written without holding statisticsMutex
+    pthread_mutex_lock(&statisticsMutex);
+
+    if (!statisticsDirty) {
+        pthread_mutex_unlock(&statisticsMutex);
+        return;
+    }
+
+    StatisticsFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, STATISTICS_MAGIC, sizeof(header.magic));
+    header.version = STATISTICS_VERSION;
+    header.numGames = gameStatisticsCount;
+    header.overall = overallStatistics;
+    memcpy(header.sync, syncStatistics, sizeof(syncStatistics));
+    memcpy(header.premium, premiumStatistics, sizeof(premiumStatistics));
+
+    GameStatisticsEntry *games = (GameStatisticsEntry *)malloc(sizeof(GameStatisticsEntry) * (gameStatisticsCount > 0 ? gameStatisticsCount : 1));
+    if (games == NULL) {
+        pthread_mutex_unlock(&statisticsMutex);
+        produceLog(config, "can't allocate memory to save statistics", MEMORY_ERROR, 0, 0);
+        return;
+    }
+
+    // only the used slots are written
+    int numGames = 0;
+    for (int i = 0; i < gameStatisticsCapacity; i++) {
+        if (gameStatistics[i].gameID != 0) {
+            games[numGames++] = gameStatistics[i];
+        }
+    }
+
+    statisticsDirty = false;
+    pthread_mutex_unlock(&statisticsMutex);
+
+    // write to a temporary file and rename it, so a crash never leaves a truncated file
+    char tempPath[512];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", config->statisticsPath);
+
+    pthread_mutex_lock(&statisticsFileMutex);
+
+    FILE *file = fopen(tempPath, "wb");
+    bool written = file != NULL &&
+                   fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(games, sizeof(GameStatisticsEntry), numGames, file) == (size_t)numGames;
+
+    if (file != NULL && fclose(file) != 0) {
+        written = false;
+    }
+
+    if (written && rename(tempPath, config->statisticsPath) == 0) {
+        printf("Estatísticas guardadas em %s (%d jogos)\n", config->statisticsPath, numGames);
     } else {
-        printf("Erro ao abrir o ficheiro de estatísticas.\n");
+        produceLog(config, "can't save statistics", EVENT_GAME_NOT_LOAD, 0, 0);
+        pthread_mutex_lock(&statisticsMutex);
+        statisticsDirty = true;
+        pthread_mutex_unlock(&statisticsMutex);
+    }
+
+    pthread_mutex_unlock(&statisticsFileMutex);
+
+    free(games);
+}
+
+// load the statistics saved by a previous run
+static void loadStatistics(ServerConfig *config) {
+
+    FILE *file = fopen(config->statisticsPath, "rb");
+    if (file == NULL) {
+        return;
+    }
+
+    StatisticsFileHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, STATISTICS_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != STATISTICS_VERSION || header.numGames < 0) {
+        fprintf(stderr, "Ignoring invalid statistics file %s\n", config->statisticsPath);
+        fclose(file);
+        return;
+    }
+
+    overallStatistics = header.overall;
+    memcpy(syncStatistics, header.sync, sizeof(syncStatistics));
+    memcpy(premiumStatistics, header.premium, sizeof(premiumStatistics));
+
+    for (int i = 0; i < header.numGames; i++) {
+        GameStatisticsEntry entry;
+        if (fread(&entry, sizeof(entry), 1, file) != 1) {
+            break;
+        }
+
+        StatisticsSummary *summary = getGameSummary(entry.gameID, true);
+        if (summary != NULL) {
+            *summary = entry.summary;
+        }
+    }
+
+    fclose(file);
+
+    printf("Estatísticas carregadas de %s (%d jogos)\n", config->statisticsPath, gameStatisticsCount);
+}
+
+// periodically persist the statistics
+static void *persistStatistics(void *arg) {
+
+    ServerConfig *config = (ServerConfig *)arg;
+
+    for (;;) {
+        sleep(STATISTICS_SAVE_INTERVAL);
+        saveStatistics(config);
+    }
+
+    return NULL;
+}
+
+void initStatistics(ServerConfig *config) {
+
+    pthread_mutex_lock(&statisticsMutex);
+
+    if (config->statisticsPath[0] != '\0') {
+        loadStatistics(config);
+    }
+    rebuildSnapshot();
+
+    pthread_mutex_unlock(&statisticsMutex);
+
+    if (config->statisticsPath[0] == '\0') {
+        return;
+    }
+
+    pthread_t persistThread;
+    if (pthread_create(&persistThread, NULL, persistStatistics, (void *)config) != 0) {
+        err_dump(config, 0, 0, "can't create statistics thread", EVENT_THREAD_NOT_CREATE);
+    }
+    pthread_detach(persistThread);
+}
+
+// the coalesced result of a game in this batch, if it has one (results are sorted by game ID)
+static const GameResult *findGameResult(const GameResult *results, int numResults, int gameID) {
+
+    int low = 0;
+    int high = numResults - 1;
+
+    while (low <= high) {
+        int middle = low + (high - low) / 2;
+
+        if (results[middle].gameID == gameID) {
+            return &results[middle];
+        } else if (results[middle].gameID < gameID) {
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
     }
+
+    return NULL;
 }
 
-void updateGameStatistics(ServerConfig *config, int gameID, int elapsedTime, float accuracy) {
+// compare a result with the records of its game; returns whether any record changed
+static bool improveRecords(ServerConfig *config, const GameResult *result, int *timeRecord, float *accuracyRecord) {
+
+    bool changed = false;
+    int gameID = result->gameID;
+
+    // if elapsed time is less than the current one store it
+    if (result->elapsedTime < *timeRecord || *timeRecord == 0) {
+        char logMessage[100];
+        snprintf(logMessage, sizeof(logMessage), "Tempo recorde atualizado para %d segundos no jogo %d", result->elapsedTime, gameID);
+        produceLog(config, logMessage, EVENT_NEW_RECORD, gameID, 0);
+
+        printf("Tempo recorde atualizado de %d para %d segundos no jogo %d\n", *timeRecord, result->elapsedTime, gameID);
+
+        *timeRecord = result->elapsedTime;
+        changed = true;
+    }
+
+    // if accuracy is greater than the current one store it
+    if (result->accuracy > *accuracyRecord || *accuracyRecord == 0) {
+        char logMessage[100];
+        snprintf(logMessage, sizeof(logMessage), "Precisão recorde atualizada para %f no jogo %d", result->accuracy, gameID);
+        produceLog(config, logMessage, EVENT_NEW_RECORD, gameID, 0);
+
+        printf("Precisão recorde atualizada de %.2f para %.2f no jogo %d\n", *accuracyRecord, result->accuracy, gameID);
+
+        *accuracyRecord = result->accuracy;
+        changed = true;
+    }
+
+    return changed;
+}
+
+// update the records in the binary database, one sync for the batch (caller holds gamesFileMutex)
+static long updateGameDBRecords(ServerConfig *config, GameDB *gameDB, const GameResult *results, int numResults) {
+
+    long bytesWritten = 0;
+
+    for (int i = 0; i < numResults; i++) {
+
+        const GameDBRecord *record = findGameRecord(gameDB, results[i].gameID);
+        if (record == NULL) {
+            continue;
+        }
+
+        int timeRecord = record->timeRecord;
+        float accuracyRecord = record->accuracyRecord;
+
+        if (!improveRecords(config, &results[i], &timeRecord, &accuracyRecord)) {
+            continue;
+        }
+
+        if (updateGameRecord(gameDB, record, timeRecord, accuracyRecord) < 0) {
+            produceLog(config, "can't write updated statistics to games database", EVENT_GAME_NOT_LOAD, results[i].gameID, 0);
+        } else {
+            bytesWritten += sizeof(int32_t) + sizeof(float);
+        }
+    }
+
+    if (bytesWritten > 0 && fdatasync(gameDB->fd) < 0) {
+        produceLog(config, "can't sync games database", EVENT_GAME_NOT_LOAD, 0, 0);
+    }
+
+    return bytesWritten;
+}
+
+// update the records in games.json: one read, one rewrite and one sync for the batch (caller holds gamesFileMutex)
+static long updateGameFileRecords(ServerConfig *config, const GameResult *results, int numResults) {
 
     FILE *file = fopen(config->gamePath, "r");
+    if (file == NULL) {
+        produceLog(config, "can't open file to update statistics", EVENT_GAME_NOT_LOAD, 0, 0);
+        return 0;
+    }
 
     // Ler o ficheiro JSON
     fseek(file, 0, SEEK_END);
@@ -30,8 +550,8 @@ void updateGameStatistics(ServerConfig *config, int gameID, int elapsedTime, flo
     char *file_content = malloc(file_size + 1);
     if (file_content == NULL) {
         fclose(file);
-        err_dump(config, gameID, 0, "memory allocation failed when updating statistics", MEMORY_ERROR);
-        return;
+        produceLog(config, "memory allocation failed when updating statistics", MEMORY_ERROR, 0, 0);
+        return 0;
     }
 
     fread(file_content, 1, file_size, file);
@@ -46,96 +566,82 @@ void updateGameStatistics(ServerConfig *config, int gameID, int elapsedTime, flo
     // Get the "games" array
     JSON_Array *games_array = json_object_get_array(root_object, "games");
 
-    // iterate over the games array
+    // every game of the batch is updated in the same tree
+    bool changed = false;
     for (int i = 0; i < json_array_get_count(games_array); i++) {
 
         JSON_Object *game_object = json_array_get_object(games_array, i);
-        int currentID = (int)json_object_get_number(game_object, "id");
-
-        // if the game is found
-        if (currentID == gameID) {
-
-            int previousTimeRecord = (int)json_object_get_number(game_object, "timeRecord");
-            float previousAccuracyRecord = (float)json_object_get_number(game_object, "accuracyRecord");
-            
-            // if elapsed time is less than the current one store it
-            if (elapsedTime < previousTimeRecord || previousTimeRecord == 0) {
-                json_object_set_number(game_object, "timeRecord", elapsedTime);
-
-                // write to log
-                char logMessage[100];
-                snprintf(logMessage, sizeof(logMessage), "Tempo recorde atualizado para %d segundos no jogo %d", elapsedTime, gameID);
-                produceLog(config, logMessage, EVENT_NEW_RECORD, gameID, 0);
-
-                printf("Tempo recorde atualizado de %d para %d segundos no jogo %d\n", previousTimeRecord, elapsedTime, gameID);
-            }
-
-            // if accuracy is greater than the current one store it
-            if (accuracy > previousAccuracyRecord || previousAccuracyRecord == 0) {
-                json_object_set_number(game_object, "accuracyRecord", accuracy);
+        const GameResult *result = findGameResult(results, numResults, (int)json_object_get_number(game_object, "id"));
+        if (result == NULL) {
+            continue;
+        }
 
-                // write to log
-                char logMessage[100];
-                snprintf(logMessage, sizeof(logMessage), "Precisão recorde atualizada para %f no jogo %d", accuracy, gameID);
-                produceLog(config, logMessage, EVENT_NEW_RECORD, gameID, 0);
+        int timeRecord = (int)json_object_get_number(game_object, "timeRecord");
+        float accuracyRecord = (float)json_object_get_number(game_object, "accuracyRecord");
 
-                printf("Precisão recorde atualizada de %.2f para %.2f no jogo %d\n", previousAccuracyRecord, accuracy, gameID);
-            }
-            break;
+        if (improveRecords(config, result, &timeRecord, &accuracyRecord)) {
+            json_object_set_number(game_object, "timeRecord", timeRecord);
+            json_object_set_number(game_object, "accuracyRecord", accuracyRecord);
+            changed = true;
         }
     }
 
-    // write the updated JSON to the file
-    file = fopen(config->gamePath, "w");
-    if (file == NULL) {
-        err_dump(config, gameID, 0, "can't open file to write updated statistics", MEMORY_ERROR);
+    if (!changed) {
         json_value_free(root_value);
-        return;
+        return 0;
     }
 
-    char *serialized_string = json_serialize_to_string_pretty(root_value);
-    fwrite(serialized_string, 1, strlen(serialized_string), file);
-    fclose(file);
-    free(serialized_string);
+    // write to a temporary file and rename it: readers of games.json never see it half written
+    char tempPath[512];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", config->gamePath);
 
-    // free the JSON object
+    char *serialized_string = json_serialize_to_string_pretty(root_value);
     json_value_free(root_value);
-}
 
-void sendRoomStatistics(ServerConfig *config, Client *client) {
-    FILE *file = fopen("room_stats.log", "r");
-    if (file == NULL) {
-        const char *errorMsg = "Erro: Não foi possível abrir o ficheiro de estatísticas.\n";
-        if (send(client->socket_fd, errorMsg, strlen(errorMsg), 0) < 0) {
-            // erro ao enviar mensagem de erro
-            err_dump(config, 0, client->clientID, "can't send error message to client", EVENT_MESSAGE_SERVER_NOT_SENT);
-        } else {
-            printf("Erro: Não foi possível abrir o ficheiro de estatísticas\n");
-            produceLog(config, "Erro: Não foi possível abrir o ficheiro de estatísticas", EVENT_MESSAGE_SERVER_SENT, 0, client->clientID);
-        }
-        return;
+    if (serialized_string == NULL) {
+        produceLog(config, "memory allocation failed when updating statistics", MEMORY_ERROR, 0, 0);
+        return 0;
     }
 
-    char line[256];
-    char stats[1024] = "";  // Buffer para enviar todas as estatísticas
-    while (fgets(line, sizeof(line), file) != NULL) {
-        strncat(stats, line, sizeof(stats) - strlen(stats) - 1);  // Adiciona cada linha ao buffer
+    long length = strlen(serialized_string);
+
+    file = fopen(tempPath, "w");
+    bool written = file != NULL &&
+                   fwrite(serialized_string, 1, length, file) == (size_t)length &&
+                   fflush(file) == 0 &&
+                   fsync(fileno(file)) == 0;
+
+    if (file != NULL && fclose(file) != 0) {
+        written = false;
     }
-    fclose(file);
 
-    // if there are no statistics send "No statistics available"
-    if (strlen(stats) == 0) {
-        strcpy(stats, "No statistics available");
+    json_free_serialized_string(serialized_string);
+
+    if (!written || rename(tempPath, config->gamePath) != 0) {
+        produceLog(config, "can't write updated statistics to games file", EVENT_GAME_NOT_LOAD, 0, 0);
+        return 0;
     }
-        
 
-    // Envia as estatísticas ao cliente
-    if (send(client->socket_fd, stats, strlen(stats), 0) < 0) {
-        // erro ao enviar estatísticas
-        err_dump(config, 0, client->clientID, "can't send statistics to client", EVENT_MESSAGE_SERVER_NOT_SENT);
+    return length;
+}
+
+long updateGameStatistics(ServerConfig *config, const GameResult *results, int numResults) {
+
+    long bytesWritten;
+
+    // the whole read-modify-write of the games file is exclusive
+    pthread_mutex_lock(&config->gamesFileMutex);
+
+    // binary database: records are rewritten in place, in the file of the current catalog
+    GameCatalog *catalog = enterCatalog(config);
+    if (catalog->gameDB != NULL) {
+        bytesWritten = updateGameDBRecords(config, catalog->gameDB, results, numResults);
     } else {
-        printf("Estatísticas enviadas ao cliente\n");
-        produceLog(config, "Estatísticas enviadas ao cliente", EVENT_MESSAGE_SERVER_SENT, 0, client->clientID);
+        bytesWritten = updateGameFileRecords(config, results, numResults);
     }
-}
+    leaveCatalog();
+
+    pthread_mutex_unlock(&config->gamesFileMutex);
 
+    return bytesWritten;
+}
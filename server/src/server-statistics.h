@@ -3,13 +3,48 @@
 
 #include "../config/config.h"
 
-// Guarda as estatísticas de uma sala no ficheiro 'room_stats.log'.
-void saveRoomStatistics(int roomId, double elapsedTime);
+#define STATISTICS_MAGIC "SUDOKUST"
+#define STATISTICS_VERSION 1
+#define STATISTICS_TIME_BUCKETS 19
+#define STATISTICS_ACCURACY_BUCKETS 10
+#define STATISTICS_SYNC_CLASSES 5 // single player + one per synchronization type
+#define STATISTICS_SNAPSHOT_SIZE 2048
+#define STATISTICS_SAVE_INTERVAL 30 // seconds between saves of the statistics file
 
-// update game statistics
-void updateGameStatistics(ServerConfig *config, int roomID, int elapsedTime, float accuracy);
+// Estatísticas agregadas de um conjunto de jogos terminados.
+typedef struct {
+    int count;
+    int minTime;
+    int maxTime;
+    long long totalTime;
+    double totalAccuracy;
+    int timeHistogram[STATISTICS_TIME_BUCKETS];
+    int accuracyHistogram[STATISTICS_ACCURACY_BUCKETS];
+} StatisticsSummary;
 
-// send message with statistics to client
-void sendRoomStatistics(ServerConfig *config, Client *client);
+// Cabeçalho do ficheiro de estatísticas, seguido de um registo por jogo.
+typedef struct {
+    char magic[8];
+    int version;
+    int numGames;
+    StatisticsSummary overall;
+    StatisticsSummary sync[STATISTICS_SYNC_CLASSES];
+    StatisticsSummary premium[2];
+} StatisticsFileHeader;
 
-#endif // SERVER_STATISTICS_H
\ No newline at end of file
+// Carrega as estatísticas guardadas e inicia a thread que as persiste periodicamente.
+void initStatistics(ServerConfig *config);
+
+// Acrescenta o resultado de um jogador às estatísticas agregadas.
+void recordGameStatistics(ServerConfig *config, Room *room, Client *client, double elapsedTime, float accuracy);
+
+// Envia ao cliente as estatísticas gerais (gameID 0) ou de um jogo.
+void sendStatistics(ServerConfig *config, Client *client, int gameID);
+
+// Guarda as estatísticas no ficheiro, se tiverem mudado.
+void saveStatistics(ServerConfig *config);
+
+// Atualiza os recordes dos jogos de um lote (um resultado por jogo, ordenados por ID) com uma só escrita; devolve os bytes escritos.
+long updateGameStatistics(ServerConfig *config, const GameResult *results, int numResults);
+
+#endif // SERVER_STATISTICS_H
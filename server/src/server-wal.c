@@ -0,0 +1,520 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../../utils/logs/logs-common.h"
+#include "../logs/logs.h"
+#include "server-comms.h"
+#include "server-sessions.h"
+#include "server-wal.h"
+
+/*
+ * WAL dos jogos: cada sala a decorrer fica registada em WAL_PATH (o jogo, o tabuleiro, a solução
+ * e os jogadores quando começa, e cada linha verificada a seguir), para que um crash (um err_dump
+ * ou um kill) não perca os jogos. Quem joga só copia o registo para o buffer do WAL; uma thread
+ * escreve os registos de todas as salas com um fdatasync a cada WAL_COMMIT_INTERVAL_MS.
+ * No arranque o log é relido e as salas por acabar voltam como as do snapshot: os jogadores
+ * retomam-nas com "resume <token>". Um WAL novo começa então só com as salas restauradas, e é
+ * reescrito com as salas vivas sempre que passa de WAL_COMPACT_SIZE.
+ */
+
+// copy of a room as the log describes it, kept to rewrite the log without the finished rooms
+typedef struct WalRoom {
+    int roomID;
+    SnapshotRoomRecord record; // currentLine kept up to date, numPlayers counts players
+    long long startTime;
+    long long lastTimestamp;   // last record of the room (replay only)
+    char board[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    char solution[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    SnapshotPlayerRecord players[SNAPSHOT_MAX_PLAYERS];
+    struct WalRoom *prev;
+    struct WalRoom *next;
+} WalRoom;
+
+static Wal gameWal;
+static atomic_bool isWalOpen = false;
+
+// rooms in the log and every room->walRoom (protected by walMutex, which also keeps the
+// records of one room in order)
+static pthread_mutex_t walMutex = PTHREAD_MUTEX_INITIALIZER;
+static WalRoom *liveRooms = NULL;
+static long compactions = 0;
+
+static long long nowNs(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+static void fillHeader(WalEntryHeader *header, WalEntryType type, int roomID) {
+    memset(header, 0, sizeof(WalEntryHeader));
+    header->type = type;
+    header->roomID = roomID;
+    header->timestamp = nowNs();
+}
+
+static void linkRoom(WalRoom **list, WalRoom *walRoom) {
+    walRoom->prev = NULL;
+    walRoom->next = *list;
+    if (*list != NULL) {
+        (*list)->prev = walRoom;
+    }
+    *list = walRoom;
+}
+
+static void unlinkRoom(WalRoom **list, WalRoom *walRoom) {
+    if (walRoom->prev != NULL) {
+        walRoom->prev->next = walRoom->next;
+    } else {
+        *list = walRoom->next;
+    }
+    if (walRoom->next != NULL) {
+        walRoom->next->prev = walRoom->prev;
+    }
+}
+
+static WalRoom *findRoom(WalRoom *list, int roomID) {
+    while (list != NULL && list->roomID != roomID) {
+        list = list->next;
+    }
+    return list;
+}
+
+static void freeRooms(WalRoom *list) {
+    while (list != NULL) {
+        WalRoom *next = list->next;
+        free(list);
+        list = next;
+    }
+}
+
+static void appendRoomStart(Wal *wal, const WalRoom *walRoom) {
+
+    WalRoomStartEntry entry;
+    fillHeader(&entry.header, WAL_ROOM_START, walRoom->roomID);
+    entry.room = walRoom->record;
+    entry.room.numPlayers = 0;
+    entry.room.elapsedSeconds = 0;
+    entry.startTime = walRoom->startTime;
+
+    int numCells = walRoom->record.size * walRoom->record.size;
+    memcpy(entry.cells, walRoom->board, numCells);
+    memcpy(entry.cells + numCells, walRoom->solution, numCells);
+
+    walAppend(wal, &entry, offsetof(WalRoomStartEntry, cells) + 2 * numCells);
+}
+
+static void appendRoomPlayer(Wal *wal, const WalRoom *walRoom, const SnapshotPlayerRecord *player) {
+
+    WalRoomPlayerEntry entry;
+    fillHeader(&entry.header, WAL_ROOM_PLAYER, walRoom->roomID);
+    entry.player = *player;
+
+    walAppend(wal, &entry, sizeof(entry));
+}
+
+// the live rooms as they are now: one start with the current board and their players
+static void appendLiveRooms(Wal *wal, void *arg) {
+
+    for (WalRoom *walRoom = liveRooms; walRoom != NULL; walRoom = walRoom->next) {
+        appendRoomStart(wal, walRoom);
+        for (int i = 0; i < walRoom->record.numPlayers; i++) {
+            appendRoomPlayer(wal, walRoom, &walRoom->players[i]);
+        }
+    }
+}
+
+// copy a running room into a new WalRoom (the caller makes sure no line is merged meanwhile)
+static WalRoom *copyRoom(Room *room) {
+
+    WalRoom *walRoom = (WalRoom *)calloc(1, sizeof(WalRoom));
+    if (walRoom == NULL) {
+        return NULL;
+    }
+
+    Game *game = room->game;
+
+    walRoom->roomID = room->id;
+    walRoom->record.gameID = game->id;
+    walRoom->record.currentLine = game->currentLine;
+    walRoom->record.size = game->size;
+    walRoom->record.isSinglePlayer = room->isSinglePlayer;
+    walRoom->record.synchronizationType = room->synchronizationType;
+    walRoom->startTime = room->startTime;
+
+    for (int row = 0; row < game->size; row++) {
+        memcpy(walRoom->board + row * game->size, game->board[row], game->size);
+        memcpy(walRoom->solution + row * game->size, game->solution[row], game->size);
+    }
+
+    return walRoom;
+}
+
+static bool addPlayer(WalRoom *walRoom, const SnapshotPlayerRecord *player) {
+
+    if (walRoom->record.numPlayers == SNAPSHOT_MAX_PLAYERS) {
+        return false;
+    }
+    for (int i = 0; i < walRoom->record.numPlayers; i++) {
+        if (walRoom->players[i].clientID == player->clientID) {
+            return false;
+        }
+    }
+
+    walRoom->players[walRoom->record.numPlayers++] = *player;
+
+    return true;
+}
+
+// apply one record of the previous log to the rooms being rebuilt
+static void replayRecord(WalRoom **rooms, const char *record, uint32_t length) {
+
+    if (length < sizeof(WalEntryHeader)) {
+        return;
+    }
+
+    const WalEntryHeader *header = (const WalEntryHeader *)record;
+    WalRoom *walRoom = findRoom(*rooms, header->roomID);
+
+    if (header->type == WAL_ROOM_START) {
+
+        const WalRoomStartEntry *entry = (const WalRoomStartEntry *)record;
+        int size = length >= offsetof(WalRoomStartEntry, cells) ? entry->room.size : 0;
+        if (size == 0 || size > BOARD_MAX_SIZE || length != offsetof(WalRoomStartEntry, cells) + 2 * size * size) {
+            return;
+        }
+
+        // a rewritten log starts the room again with its current board
+        if (walRoom == NULL) {
+            walRoom = (WalRoom *)calloc(1, sizeof(WalRoom));
+            if (walRoom == NULL) {
+                return;
+            }
+            walRoom->roomID = header->roomID;
+            linkRoom(rooms, walRoom);
+        }
+
+        walRoom->record = entry->room;
+        walRoom->record.numPlayers = 0;
+        walRoom->startTime = entry->startTime;
+        memcpy(walRoom->board, entry->cells, size * size);
+        memcpy(walRoom->solution, entry->cells + size * size, size * size);
+
+    } else if (walRoom == NULL) {
+        // a room started before the log was last rewritten or checkpointed
+        return;
+
+    } else if (header->type == WAL_ROOM_PLAYER && length == sizeof(WalRoomPlayerEntry)) {
+
+        const WalRoomPlayerEntry *entry = (const WalRoomPlayerEntry *)record;
+        addPlayer(walRoom, &entry->player);
+
+    } else if (header->type == WAL_ROOM_LINE) {
+
+        const WalRoomLineEntry *entry = (const WalRoomLineEntry *)record;
+        int size = walRoom->record.size;
+        if (length != offsetof(WalRoomLineEntry, cells) + size || entry->row < 0 || entry->row >= size) {
+            return;
+        }
+
+        memcpy(walRoom->board + entry->row * size, entry->cells, size);
+        walRoom->record.currentLine = entry->currentLine;
+
+    } else if (header->type == WAL_ROOM_END) {
+
+        unlinkRoom(rooms, walRoom);
+        free(walRoom);
+        return;
+    }
+
+    walRoom->lastTimestamp = header->timestamp;
+}
+
+// rebuild the rooms the previous run didn't finish, returns how many were restored
+static int replayGameWal(ServerConfig *config) {
+
+    WalReader reader;
+    if (!openWalReader(&reader, config->walPath)) {
+        return 0;
+    }
+
+    // records are read into an aligned buffer, the entries are cast from it
+    long long buffer[WAL_MAX_RECORD / sizeof(long long)];
+    WalRoom *rooms = NULL;
+    uint32_t length;
+
+    while (nextWalRecord(&reader, buffer, sizeof(buffer), &length) == WAL_RECORD) {
+        replayRecord(&rooms, (const char *)buffer, length);
+    }
+
+    long numRecords = reader.records;
+    bool isTorn = reader.isTorn;
+    closeWalReader(&reader);
+
+    // restored players keep their IDs, new ones continue after the last one in the log
+    int lastClientID = 0;
+    for (WalRoom *walRoom = rooms; walRoom != NULL; walRoom = walRoom->next) {
+        for (int i = 0; i < walRoom->record.numPlayers; i++) {
+            if (walRoom->players[i].clientID > lastClientID) {
+                lastClientID = walRoom->players[i].clientID;
+            }
+        }
+    }
+    reserveClientIds(lastClientID);
+
+    int numRestored = 0;
+
+    for (WalRoom *walRoom = rooms; walRoom != NULL; walRoom = walRoom->next) {
+
+        // solved games only had the results left, and rooms without a session can't be resumed
+        if (walRoom->record.currentLine > walRoom->record.size || walRoom->record.numPlayers == 0) {
+            continue;
+        }
+
+        // the clock stopped with the crash: the game goes on from its last line
+        long long elapsed = walRoom->lastTimestamp / 1000000000LL - walRoom->startTime;
+        walRoom->record.elapsedSeconds = elapsed > 0 ? (int)elapsed : 0;
+
+        if (restoreSavedRoom(config, &walRoom->record, walRoom->board, walRoom->solution, walRoom->players) != NULL) {
+            numRestored++;
+        }
+    }
+
+    freeRooms(rooms);
+
+    printf("WAL dos jogos: %ld registos lidos%s, %d salas recuperadas\n", numRecords, isTorn ? " (o ultimo commit ficou incompleto)" : "", numRestored);
+
+    return numRestored;
+}
+
+// the pending records still reach the disk when an err_dump exits the process
+static void flushGameWalAtExit(void) {
+    if (atomic_load(&isWalOpen)) {
+        walFlush(&gameWal);
+    }
+}
+
+int initGameWal(ServerConfig *config) {
+
+    if (config->walPath[0] == '\0') {
+        return 0;
+    }
+
+    int numRestored = replayGameWal(config);
+
+    // the new log starts with the rooms running now (the restored ones), written aside and renamed
+    // over the old one, so a crash during the start still finds one complete log
+    char tempPath[512];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", config->walPath);
+
+    if (!openWal(&gameWal, tempPath, true)) {
+        produceLog(config, "can't open the games WAL", EVENT_ROOM_NOT_LOAD, 0, 0);
+        return numRestored;
+    }
+
+    pthread_mutex_lock(&walMutex);
+    pthread_rwlock_rdlock(&config->roomsLock);
+
+    for (int i = 0; i < config->numRooms; i++) {
+
+        Room *room = config->rooms[i];
+        if (room->game == NULL || !room->isGameRunning) {
+            continue;
+        }
+
+        WalRoom *walRoom = copyRoom(room);
+        if (walRoom == NULL) {
+            continue;
+        }
+
+        SnapshotPlayerRecord players[SNAPSHOT_MAX_PLAYERS];
+        int numPlayers = getRestoredPlayers(room, players);
+        for (int p = 0; p < numPlayers; p++) {
+            addPlayer(walRoom, &players[p]);
+        }
+
+        room->walRoom = walRoom;
+        linkRoom(&liveRooms, walRoom);
+    }
+
+    pthread_rwlock_unlock(&config->roomsLock);
+
+    appendLiveRooms(&gameWal, NULL);
+    walFlush(&gameWal);
+
+    bool isRenamed = rename(tempPath, config->walPath) == 0;
+    if (isRenamed) {
+        atomic_store(&isWalOpen, true);
+    }
+
+    pthread_mutex_unlock(&walMutex);
+
+    if (!isRenamed) {
+        closeWal(&gameWal);
+        unlink(tempPath);
+        produceLog(config, "can't open the games WAL", EVENT_ROOM_NOT_LOAD, 0, 0);
+        return numRestored;
+    }
+
+    atexit(flushGameWalAtExit);
+
+    return numRestored;
+}
+
+void walRoomStarted(ServerConfig *config, Room *room, Client *client) {
+
+    if (!atomic_load(&isWalOpen)) {
+        return;
+    }
+
+    SnapshotPlayerRecord player;
+    bool isPremium = false;
+    memset(&player, 0, sizeof(player));
+    bool hasSession = findSessionToken(client, &player.clientID, &isPremium, player.token);
+    player.isPremium = isPremium;
+
+    pthread_mutex_lock(&walMutex);
+
+    if (atomic_load(&isWalOpen)) {
+
+        // every player of the room calls this when the game starts for them, the first one logs the game
+        WalRoom *walRoom = room->walRoom;
+        if (walRoom == NULL) {
+            walRoom = copyRoom(room);
+            if (walRoom != NULL) {
+                room->walRoom = walRoom;
+                linkRoom(&liveRooms, walRoom);
+                appendRoomStart(&gameWal, walRoom);
+            }
+        }
+
+        if (walRoom != NULL && hasSession && addPlayer(walRoom, &player)) {
+            appendRoomPlayer(&gameWal, walRoom, &player);
+        }
+    }
+
+    pthread_mutex_unlock(&walMutex);
+}
+
+void walLineVerified(Room *room, int row) {
+
+    if (!atomic_load(&isWalOpen)) {
+        return;
+    }
+
+    pthread_mutex_lock(&walMutex);
+
+    WalRoom *walRoom = room->walRoom;
+
+    if (walRoom != NULL && atomic_load(&isWalOpen)) {
+
+        Game *game = room->game;
+        memcpy(walRoom->board + row * game->size, game->board[row], game->size);
+        walRoom->record.currentLine = game->currentLine;
+
+        WalRoomLineEntry entry;
+        fillHeader(&entry.header, WAL_ROOM_LINE, room->id);
+        entry.row = row;
+        entry.currentLine = game->currentLine;
+        memcpy(entry.cells, game->board[row], game->size);
+
+        // only a copy into the buffer: the commit thread writes and syncs it
+        walAppend(&gameWal, &entry, offsetof(WalRoomLineEntry, cells) + game->size);
+    }
+
+    pthread_mutex_unlock(&walMutex);
+}
+
+void walRoomFinished(ServerConfig *config, Room *room) {
+
+    pthread_mutex_lock(&walMutex);
+
+    WalRoom *walRoom = room->walRoom;
+    room->walRoom = NULL;
+
+    if (walRoom == NULL) {
+        pthread_mutex_unlock(&walMutex);
+        return;
+    }
+
+    unlinkRoom(&liveRooms, walRoom);
+    free(walRoom);
+
+    bool isCompacted = false;
+    bool isCompactFailed = false;
+
+    if (atomic_load(&isWalOpen)) {
+
+        WalEntryHeader entry;
+        fillHeader(&entry, WAL_ROOM_END, room->id);
+        walAppend(&gameWal, &entry, sizeof(entry));
+
+        pthread_mutex_lock(&gameWal.mutex);
+        off_t size = gameWal.fileSize + gameWal.used;
+        pthread_mutex_unlock(&gameWal.mutex);
+
+        // the finished rooms are dropped from the log; lines wait here for the rewrite
+        if (size > WAL_COMPACT_SIZE) {
+            isCompacted = walRewrite(&gameWal, config->walPath, appendLiveRooms, NULL);
+            isCompactFailed = !isCompacted;
+            if (isCompacted) {
+                compactions++;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&walMutex);
+
+    if (isCompacted) {
+        produceLog(config, "WAL dos jogos compactado", EVENT_ROOM_DELETE, room->id, 0);
+    } else if (isCompactFailed) {
+        produceLog(config, "can't compact the games WAL", EVENT_ROOM_NOT_DELETE, room->id, 0);
+    }
+}
+
+void closeGameWal(ServerConfig *config, bool isCheckpoint) {
+
+    pthread_mutex_lock(&walMutex);
+
+    if (!atomic_load(&isWalOpen)) {
+        pthread_mutex_unlock(&walMutex);
+        return;
+    }
+
+    // lines of the rooms still running after this are not logged any more
+    bool isEmptied = !isCheckpoint || walRewrite(&gameWal, config->walPath, NULL, NULL);
+    atomic_store(&isWalOpen, false);
+    closeWal(&gameWal);
+
+    pthread_mutex_unlock(&walMutex);
+
+    if (!isEmptied) {
+        produceLog(config, "can't checkpoint the games WAL", EVENT_ROOM_NOT_DELETE, 0, 0);
+    }
+}
+
+void getGameWalCounters(GameWalCounters *counters) {
+
+    memset(counters, 0, sizeof(GameWalCounters));
+
+    pthread_mutex_lock(&walMutex);
+
+    counters->isEnabled = atomic_load(&isWalOpen);
+    counters->compactions = compactions;
+
+    if (counters->isEnabled) {
+        pthread_mutex_lock(&gameWal.mutex);
+        counters->records = gameWal.appendedRecords;
+        counters->commits = gameWal.commits;
+        counters->bytesWritten = gameWal.bytesWritten;
+        counters->fullWaits = gameWal.fullWaits;
+        counters->writeErrors = gameWal.writeErrors;
+        pthread_mutex_unlock(&gameWal.mutex);
+    }
+
+    pthread_mutex_unlock(&walMutex);
+}
@@ -0,0 +1,78 @@
+#ifndef SERVER_WAL_H
+#define SERVER_WAL_H
+
+#include <stdbool.h>
+#include "../../utils/wal/wal.h"
+#include "../config/config.h"
+#include "server-snapshot.h"
+
+#define WAL_COMPACT_SIZE (8 * 1024 * 1024) // the log is rewritten with only the live rooms once it grows past this
+
+// Tipos dos registos do WAL dos jogos.
+typedef enum {
+    WAL_ROOM_START = 1, // a game started: the room, its board and its solution
+    WAL_ROOM_PLAYER,    // a player of the room, with the token to resume it
+    WAL_ROOM_LINE,      // a line was verified: the row as merged into the board and the new current line
+    WAL_ROOM_END        // the room was deleted
+} WalEntryType;
+
+// Início de todos os registos.
+typedef struct {
+    unsigned char type;
+    unsigned char reserved[3];
+    int roomID;
+    long long timestamp; // nanoseconds since the epoch
+} WalEntryHeader;
+
+// Um jogo que começou, seguido de size*size células do tabuleiro e size*size da solução.
+typedef struct {
+    WalEntryHeader header;
+    SnapshotRoomRecord room; // numPlayers and elapsedSeconds unused
+    long long startTime;
+    char cells[2 * BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+} WalRoomStartEntry;
+
+// Um jogador da sala.
+typedef struct {
+    WalEntryHeader header;
+    SnapshotPlayerRecord player;
+} WalRoomPlayerEntry;
+
+// Uma linha verificada, seguida das `size` células da linha.
+typedef struct {
+    WalEntryHeader header;
+    int row;
+    int currentLine;
+    char cells[BOARD_MAX_SIZE];
+} WalRoomLineEntry;
+
+// Contadores do WAL dos jogos, enviados no GET_STATS.
+typedef struct {
+    bool isEnabled;
+    long records;    // records appended since the start
+    long commits;    // writes followed by an fdatasync
+    long bytesWritten;
+    long fullWaits;  // appends that waited for room in the buffer
+    long writeErrors;
+    long compactions;
+} GameWalCounters;
+
+// Reconstrói as salas por acabar do WAL anterior, começa um WAL novo com as salas restauradas e abre-o (devolve o número de salas recuperadas).
+int initGameWal(ServerConfig *config);
+
+// Regista o início do jogo da sala (só da primeira vez) e o jogador, se tiver sessão.
+void walRoomStarted(ServerConfig *config, Room *room, Client *client);
+
+// Regista a linha `row` do tabuleiro e a linha atual depois de uma linha verificada (chamar dentro da secção de escrita).
+void walLineVerified(Room *room, int row);
+
+// Regista o fim da sala e compacta o WAL se ficou grande.
+void walRoomFinished(ServerConfig *config, Room *room);
+
+// Escreve os registos pendentes e fecha o WAL; com `isCheckpoint` esvazia-o, porque as salas já estão guardadas.
+void closeGameWal(ServerConfig *config, bool isCheckpoint);
+
+// Lê os contadores do WAL dos jogos.
+void getGameWalCounters(GameWalCounters *counters);
+
+#endif // SERVER_WAL_H
@@ -0,0 +1,390 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <sched.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include "../../utils/logs/logs-common.h"
+#include "../../utils/queues/ring.h"
+#include "../../utils/arena/arena.h"
+#include "../logs/logs.h"
+#include "server-comms.h"
+#include "server-sessions.h"
+#include "server-workers.h"
+
+/*
+ * Pool de workers das sessões: SESSION_WORKERS threads criadas no arranque tratam as mensagens dos
+ * clientes, uma de cada vez, em vez de uma thread por ligação.
+ * - As threads de accept põem cada sessão nova no epoll; quando chega a primeira mensagem, um "resume"
+ *   de uma sessão à espera é tratado logo pela thread do epoll, e as outras vão para a fila, onde um
+ *   worker recebe o estado premium e envia o ID.
+ * - Depois de cada mensagem (um pedido do menu, uma linha, a accuracy, pedidos multiplexados) a sessão
+ *   fica parada no epoll, sem ocupar um worker, e volta para a fila quando o socket tem a mensagem
+ *   seguinte (ou foi fechado). Se a mensagem seguinte já foi lida (bytes que uma ligação multiplexada
+ *   deixou em `pending`), a sessão volta logo para a fila.
+ * - As esperas que não são por uma mensagem também não ocupam um worker: a espera para entrar numa
+ *   sala e cada segundo da contagem decrescente são temporizadores da thread do epoll, os jogadores à
+ *   espera do início ou do fim da sala ficam na sala, um jogador que perdeu a ligação fica na tabela
+ *   de sessões e um espectador fica com a thread dos espectadores. Quem acaba a espera (o temporizador,
+ *   a sala, o "resume", o fim do tempo de graça ou o "stopSpectating") devolve a sessão ao pool.
+ * - Cada worker tem um arena para a memória temporária da mensagem que está a tratar (JSON, listagens),
+ *   que volta ao início quando a mensagem está tratada; uma sessão parada não guarda memória nenhuma.
+ */
+
+#define PARKED_EVENTS 64 // sessions woken per epoll_wait
+#define SWEEP_INTERVAL_MS 1000 // how often the parker looks for sessions whose grace period ran out
+
+// a session waiting for a moment rather than for its socket
+typedef struct {
+    Client *client;
+    struct timespec deadline;
+} ScheduledSession;
+
+static ServerConfig *workersConfig;
+
+// sessions with something to do, shared lock-free between the acceptors, the parker and the workers
+static RingQueue sessionQueue;
+
+// one token per queued session; idle workers sleep on it
+static sem_t queuedSemaphore;
+
+// idle sessions, watched by the parker thread, and the eventfd that wakes it for a new timer
+static int parkedFd = -1;
+static int wakeFd = -1;
+
+// timers of the parker (protected by timersMutex); a client is in at most one place, so one per client online
+static pthread_mutex_t timersMutex = PTHREAD_MUTEX_INITIALIZER;
+static ScheduledSession *timers = NULL;
+static int numTimers = 0;
+
+static int numWorkers = 0;
+static atomic_int busyWorkers = 0;
+static atomic_int parkedSessions = 0;
+
+// queueing delay (protected by countersMutex)
+static pthread_mutex_t countersMutex = PTHREAD_MUTEX_INITIALIZER;
+static long servedRequests = 0;
+static double totalQueueDelayMs = 0;
+static double maxQueueDelayMs = 0;
+
+static double msUntil(const struct timespec *deadline, const struct timespec *now) {
+    return (deadline->tv_sec - now->tv_sec) * 1e3 + (deadline->tv_nsec - now->tv_nsec) / 1e6;
+}
+
+static bool queueSession(Client *client) {
+
+    clock_gettime(CLOCK_MONOTONIC, &client->queuedAt);
+
+    if (!ringEnqueue(&sessionQueue, client)) {
+        return false;
+    }
+
+    sem_post(&queuedSemaphore);
+    return true;
+}
+
+static void recordQueueDelay(Client *client) {
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double delayMs = -msUntil(&client->queuedAt, &now);
+
+    pthread_mutex_lock(&countersMutex);
+    servedRequests++;
+    totalQueueDelayMs += delayMs;
+    if (delayMs > maxQueueDelayMs) {
+        maxQueueDelayMs = delayMs;
+    }
+    pthread_mutex_unlock(&countersMutex);
+}
+
+// there's a place for every client online, so this only fails if something leaked
+static void queueOrClose(Client *client) {
+
+    if (!queueSession(client)) {
+        produceLog(workersConfig, "session queue full", EVENT_SERVER_THREAD_ERROR, 0, client->clientID);
+        closeClientSession(workersConfig, client);
+    }
+}
+
+// hand an idle session to the parker until its socket has something to read
+static bool parkSession(Client *client) {
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | EPOLLRDHUP;
+    event.data.ptr = client;
+
+    atomic_fetch_add(&parkedSessions, 1);
+
+    if (epoll_ctl(parkedFd, EPOLL_CTL_ADD, client->socket_fd, &event) < 0) {
+        atomic_fetch_sub(&parkedSessions, 1);
+        produceLog(workersConfig, "can't park idle session", EVENT_CONNECTION_SERVER_ERROR, 0, client->clientID);
+        return false;
+    }
+
+    return true;
+}
+
+void wakeSession(Client *client) {
+    queueOrClose(client);
+}
+
+void continueSession(Client *client) {
+
+    if (client->pendingLength > 0) {
+        // the next request is already buffered, the socket may never wake the parker for it
+        queueOrClose(client);
+    } else if (!parkSession(client)) {
+        closeClientSession(workersConfig, client);
+    }
+}
+
+void scheduleSession(Client *client, int delayMs) {
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += delayMs / 1000;
+    deadline.tv_nsec += (long)(delayMs % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+
+    pthread_mutex_lock(&timersMutex);
+    bool isScheduled = numTimers < workersConfig->maxClientsOnline;
+    if (isScheduled) {
+        timers[numTimers].client = client;
+        timers[numTimers].deadline = deadline;
+        numTimers++;
+    }
+    pthread_mutex_unlock(&timersMutex);
+
+    if (!isScheduled) {
+        // only if something leaked: run the step now rather than never
+        produceLog(workersConfig, "session timers full", EVENT_SERVER_THREAD_ERROR, 0, client->clientID);
+        queueOrClose(client);
+        return;
+    }
+
+    // the parker may be sleeping past the new deadline
+    uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) < 0) {
+        produceLog(workersConfig, "can't wake the parked sessions thread", EVENT_SERVER_THREAD_ERROR, 0, client->clientID);
+    }
+}
+
+// queue the sessions whose moment came and return how long the parker may sleep
+static int fireTimers(void) {
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    int timeoutMs = SWEEP_INTERVAL_MS;
+    Client *due[PARKED_EVENTS];
+    int numDue = 0;
+
+    pthread_mutex_lock(&timersMutex);
+
+    for (int i = 0; i < numTimers; ) {
+        double ms = msUntil(&timers[i].deadline, &now);
+        if (ms <= 0 && numDue < PARKED_EVENTS) {
+            due[numDue++] = timers[i].client;
+            timers[i] = timers[--numTimers];
+        } else {
+            // one that didn't fit this time goes on the next round, right away
+            int wait = ms <= 0 ? 0 : (int)ms + 1;
+            if (wait < timeoutMs) {
+                timeoutMs = wait;
+            }
+            i++;
+        }
+    }
+
+    pthread_mutex_unlock(&timersMutex);
+
+    for (int i = 0; i < numDue; i++) {
+        queueOrClose(due[i]);
+    }
+
+    return timeoutMs;
+}
+
+static void *watchParkedSessions(void *arg) {
+
+    struct epoll_event events[PARKED_EVENTS];
+    struct timespec lastSweep;
+    clock_gettime(CLOCK_MONOTONIC, &lastSweep);
+
+    int timeoutMs = SWEEP_INTERVAL_MS;
+
+    for (;;) {
+
+        int numEvents = epoll_wait(parkedFd, events, PARKED_EVENTS, timeoutMs);
+        if (numEvents < 0) {
+            if (errno != EINTR) {
+                produceLog(workersConfig, "epoll_wait error on parked sessions", EVENT_CONNECTION_SERVER_ERROR, 0, 0);
+            }
+            numEvents = 0;
+        }
+
+        for (int i = 0; i < numEvents; i++) {
+
+            // a new timer: only the sleep is cut short
+            if (events[i].data.ptr == NULL) {
+                uint64_t count;
+                if (read(wakeFd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+                    produceLog(workersConfig, "can't read the parked sessions eventfd", EVENT_SERVER_THREAD_ERROR, 0, 0);
+                }
+                continue;
+            }
+
+            Client *client = (Client *)events[i].data.ptr;
+
+            // the worker that takes the message parks the session again afterwards
+            epoll_ctl(parkedFd, EPOLL_CTL_DEL, client->socket_fd, NULL);
+            atomic_fetch_sub(&parkedSessions, 1);
+
+            // a player coming back is answered here, whether or not any worker is free
+            if (client->step == STEP_OPEN && handOverResume(workersConfig, client)) {
+                continue;
+            }
+
+            queueOrClose(client);
+        }
+
+        timeoutMs = fireTimers();
+
+        // the players who didn't come back in time leave their games
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (-msUntil(&lastSweep, &now) >= SWEEP_INTERVAL_MS) {
+            expireDetachedSessions(workersConfig);
+            lastSweep = now;
+        }
+    }
+
+    return NULL;
+}
+
+static void *sessionWorker(void *arg) {
+
+    // the arena of the message this worker is handling, whichever session it belongs to
+    Arena arena;
+    if (!initArena(&arena)) {
+        produceLog(workersConfig, "can't allocate memory", MEMORY_ERROR, 0, 0);
+    } else {
+        setThreadArena(&arena);
+    }
+
+    for (;;) {
+
+        sem_wait(&queuedSemaphore);
+
+        // the token is posted after the enqueue, so the session is already there
+        Client *client;
+        while ((client = (Client *)ringDequeue(&sessionQueue)) == NULL) {
+            sched_yield();
+        }
+
+        recordQueueDelay(client);
+        atomic_fetch_add(&busyWorkers, 1);
+
+        SessionStatus status = serveSessionStep(workersConfig, client);
+
+        atomic_fetch_sub(&busyWorkers, 1);
+
+        // nothing allocated during the message outlives it
+        if (getThreadArena() != NULL) {
+            arenaReset(&arena);
+        }
+
+        if (status == SESSION_CONTINUE) {
+            continueSession(client);
+        } else if (status == SESSION_CLOSED) {
+            closeClientSession(workersConfig, client);
+        }
+
+        // SESSION_HELD: a timer, the room, the sessions table or the spectators thread hands it back, and it may already
+        // be running on another worker; SESSION_HANDED_OVER: the placeholder client is already gone
+    }
+
+    return NULL;
+}
+
+void initWorkers(ServerConfig *config) {
+
+    workersConfig = config;
+    numWorkers = config->sessionWorkers;
+
+    // every client online is in at most one place: running, queued, parked, scheduled or held
+    if (!initRingQueue(&sessionQueue, config->maxClientsOnline)) {
+        fprintf(stderr, "Couldn't allocate the session queue\n");
+        exit(1);
+    }
+
+    timers = (ScheduledSession *)malloc(sizeof(ScheduledSession) * config->maxClientsOnline);
+    if (timers == NULL) {
+        fprintf(stderr, "Couldn't allocate the session timers\n");
+        exit(1);
+    }
+
+    sem_init(&queuedSemaphore, 0, 0);
+
+    if ((parkedFd = epoll_create1(0)) < 0 || (wakeFd = eventfd(0, EFD_NONBLOCK)) < 0) {
+        err_dump(config, 0, 0, "can't create epoll for parked sessions", EVENT_SERVER_THREAD_ERROR);
+    }
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.ptr = NULL;
+    if (epoll_ctl(parkedFd, EPOLL_CTL_ADD, wakeFd, &event) < 0) {
+        err_dump(config, 0, 0, "can't watch the parked sessions eventfd", EVENT_SERVER_THREAD_ERROR);
+    }
+
+    pthread_t parker;
+    if (pthread_create(&parker, NULL, watchParkedSessions, NULL) != 0) {
+        err_dump(config, 0, 0, "can't create parked sessions thread", EVENT_THREAD_NOT_CREATE);
+    }
+    pthread_detach(parker);
+
+    for (int i = 0; i < numWorkers; i++) {
+        pthread_t worker;
+        if (pthread_create(&worker, NULL, sessionWorker, NULL) != 0) {
+            err_dump(config, 0, 0, "can't create session worker thread", EVENT_THREAD_NOT_CREATE);
+        }
+        pthread_detach(worker);
+    }
+}
+
+bool dispatchClient(ServerConfig *config, Client *client) {
+
+    // the first message decides who serves it: the parker for a resume, a worker for the rest
+    client->step = STEP_OPEN;
+    return parkSession(client);
+}
+
+void getWorkerCounters(WorkerCounters *counters) {
+
+    counters->numWorkers = numWorkers;
+    counters->busyWorkers = atomic_load(&busyWorkers);
+    counters->parkedSessions = atomic_load(&parkedSessions);
+    counters->queuedSessions = numWorkers > 0 ? (int)ringSize(&sessionQueue) : 0;
+
+    pthread_mutex_lock(&timersMutex);
+    counters->scheduledSessions = numTimers;
+    pthread_mutex_unlock(&timersMutex);
+
+    pthread_mutex_lock(&countersMutex);
+    counters->servedRequests = servedRequests;
+    counters->meanQueueDelayMs = servedRequests > 0 ? totalQueueDelayMs / servedRequests : 0;
+    counters->maxQueueDelayMs = maxQueueDelayMs;
+    pthread_mutex_unlock(&countersMutex);
+}
@@ -0,0 +1,37 @@
+#ifndef SERVER_WORKERS_H
+#define SERVER_WORKERS_H
+
+#include <stdbool.h>
+#include "../config/config.h"
+
+// Contadores do pool de workers das sessões, enviados no GET_STATS.
+typedef struct {
+    int numWorkers;
+    int busyWorkers;       // workers handling a message
+    int queuedSessions;    // sessions with a message waiting for a free worker
+    int parkedSessions;    // idle sessions waiting for their next message, without a worker
+    int scheduledSessions; // sessions waiting for a timer (the join delay, the countdown), without a worker
+    long servedRequests;   // messages taken from the queue since the start
+    double meanQueueDelayMs;
+    double maxQueueDelayMs;
+} WorkerCounters;
+
+// Cria os SESSION_WORKERS workers das sessões e a thread que vigia as sessões paradas.
+void initWorkers(ServerConfig *config);
+
+// Entrega a sessão de um cliente acabado de aceitar aos workers, quando chegar a primeira mensagem (false se não for possível).
+bool dispatchClient(ServerConfig *config, Client *client);
+
+// Volta a pôr na fila a sessão de um cliente retida pela sala ou pela tabela de sessões.
+void wakeSession(Client *client);
+
+// Devolve ao pool a sessão retida de um cliente, que fica parada à espera da próxima mensagem.
+void continueSession(Client *client);
+
+// Põe a sessão de um cliente na fila daqui a delayMs milissegundos, sem ocupar um worker até lá.
+void scheduleSession(Client *client, int delayMs);
+
+// Lê os contadores do pool de workers.
+void getWorkerCounters(WorkerCounters *counters);
+
+#endif // SERVER_WORKERS_H
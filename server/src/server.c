@@ -1,147 +1,282 @@
-#include <stdlib.h>
-#include <stdio.h>
-#include <string.h>
-#include <pthread.h>
-#include <signal.h>
-#include "../../utils/logs/logs-common.h"
-#include "../../utils/network/network.h"
-#include "../config/config.h"
-#include "server-comms.h"
-#include "server-game.h"
-#include "../logs/logs.h"
-
-
-/**
- * Função principal que configura e inicia o servidor, aceita conexões de clientes, 
- * e cria threads para gerir essas conexões.
- *
- * @param argc O número de argumentos passados na linha de comando.
- * @param argv Um array de strings que contém os argumentos da linha de comando. 
- * O primeiro argumento (argv[1]) deve ser o caminho para o ficheiro de configuração do servidor.
- * @return Retorna 0 se o servidor terminar normalmente ou 1 se faltar o argumento de configuração.
- *
- * @details Esta função realiza as seguintes operações:
- * - Verifica se o argumento de configuração foi fornecido. 
- * Se não for, imprime uma mensagem de erro e termina o programa.
- * - Carrega as configurações do servidor a partir do ficheiro de configuração especificado.
- * - Inicializa o socket do servidor e configura-o para aceitar conexões de clientes.
- * - Entra num loop infinito para aceitar conexões:
- *   - Aceita uma ligação do cliente e cria uma estrutura `Client` que armazena as 
- * informações necessárias para a nova conexão.
- *   - Cria uma nova thread para gerir cada cliente, usando a função `handleClient` para 
- * processar a comunicação com o cliente.
- *   - Detacha a thread para que possa ser gerida automaticamente pelo sistema operativo, 
- * sem necessidade de junção manual.
- * - Se houver um erro ao aceitar uma conexão ou criar uma thread, a função regista o erro 
- * no ficheiro de log especificado na configuração.
- *
- * @note O loop principal executa indefinidamente até que o servidor seja manualmente interrompido. 
- * O socket principal é fechado no final.
- */
-
-ServerConfig* svConfig;
-
-void handleSigInt(int sig) {
-    printf("Server shutting down...\n");
-    free(svConfig->clients);
-    free(svConfig->rooms);
-
-    // destroy semaphores
-    sem_destroy(&svConfig->mutexLogSemaphore);
-    sem_destroy(&svConfig->itemsLogSemaphore);
-    sem_destroy(&svConfig->spacesSemaphore);
-
-    // destroy mutex
-    pthread_mutex_destroy(&svConfig->mutex);
-
-    free(svConfig);
-
-    exit(0);
-}
-
-int main(int argc, char *argv[]) {
-    
-    if (argc < 2) {
-        printf("Erro: Faltam argumentos de configuracao!\n");
-        return 1;
-    }
-
-    
-    //signal(SIGINT, handleSigInt);
-
-    printf("Server starting...\n");
-
-
-    // Carrega a configuracao do servidor
-    svConfig = getServerConfig(argv[1]);
-
-    // Inicializa variáveis para socket
-    int sockfd, newSockfd;
-    struct sockaddr_in serv_addr;
-
-    // Inicializar o socket
-    initializeSocket(&serv_addr, &sockfd, svConfig);
-
-    // Aguardar por conexões indefinidamente
-    for (;;) {
-
-        // Aceitar ligação
-        if ((newSockfd = accept(sockfd, (struct sockaddr *) 0, 0)) < 0) {
-            // erro ao aceitar ligacao
-            err_dump(svConfig, 0, 0, "accept error", EVENT_CONNECTION_SERVER_ERROR);
-        } else {
-
-            // elements to pass to thread: config, playerID, newSockfd
-            Client *client = (Client *) malloc(sizeof(Client));
-            if (client == NULL) {
-                // erro ao alocar memoria
-                err_dump(svConfig, 0, 0, "can't allocate memory", MEMORY_ERROR);
-                close(newSockfd);
-                continue;
-            }
-
-            client->socket_fd = newSockfd;
-            addClient(svConfig, client);
-
-            client_data *data = (client_data *) malloc(sizeof(client_data));
-            if (data == NULL) {
-                // erro ao alocar memoria
-                err_dump(svConfig, 0, 0, "can't allocate memory", MEMORY_ERROR);
-                removeClient(svConfig, client);
-                free(client);
-                close(newSockfd);
-                continue;
-            }
-
-            data->config = svConfig;
-            data->client = client;
-
-            // create a new thread to handle the client
-            pthread_t thread;
-            if (pthread_create(&thread, NULL, handleClient, (void *)data) != 0) {
-                // erro ao criar thread
-                err_dump(svConfig, 0, 0, "can't create client thread", EVENT_SERVER_THREAD_ERROR);
-                removeClient(svConfig, client);
-                free(client);
-                free(data);
-                close(newSockfd);
-                continue;
-            }
-            
-            // detach the thread
-            pthread_detach(thread);
-        }
-
-        // Create a thread to handle consume for logs
-        pthread_t logThread;
-        if (pthread_create(&logThread, NULL, consumeLog, (void *)svConfig) != 0) {
-            // erro ao criar thread
-            err_dump(svConfig, 0, 0, "can't create log consumer thread", EVENT_THREAD_NOT_CREATE);
-            continue;
-        }
-    }
-
-    close(sockfd);
-    free(svConfig);
-    return 0;
-}
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include "../../utils/logs/logs-common.h"
+#include "../../utils/network/network.h"
+#include "../../utils/parson/parson.h"
+#include "../../utils/arena/arena.h"
+#include "../../utils/epoch/epoch.h"
+#include "../config/config.h"
+#include "server-comms.h"
+#include "server-game.h"
+#include "server-catalog.h"
+#include "server-leaderboard.h"
+#include "server-results.h"
+#include "server-generator.h"
+#include "server-spectators.h"
+#include "server-sessions.h"
+#include "server-snapshot.h"
+#include "server-wal.h"
+#include "server-admission.h"
+#include "server-acceptors.h"
+#include "server-workers.h"
+#include "../logs/logs.h"
+
+
+/**
+ * Função principal que configura e inicia o servidor, aceita conexões de clientes, 
+ * e cria threads para gerir essas conexões.
+ *
+ * @param argc O número de argumentos passados na linha de comando.
+ * @param argv Um array de strings que contém os argumentos da linha de comando. 
+ * O primeiro argumento (argv[1]) deve ser o caminho para o ficheiro de configuração do servidor.
+ * @return Retorna 0 se o servidor terminar normalmente ou 1 se faltar o argumento de configuração.
+ *
+ * @details Esta função realiza as seguintes operações:
+ * - Verifica se o argumento de configuração foi fornecido. 
+ * Se não for, imprime uma mensagem de erro e termina o programa.
+ * - Carrega as configurações do servidor a partir do ficheiro de configuração especificado.
+ * - Abre `acceptorThreads` sockets de escuta na porta do servidor (SO_REUSEPORT) e uma thread
+ * de accept por cada um (`startAcceptors`):
+ *   - Cada thread aceita ligações do seu socket e cria uma estrutura `Client` que armazena as 
+ * informações necessárias para a nova conexão.
+ *   - Põe a sessão do cliente na fila dos `sessionWorkers` workers, criados no arranque, que tratam
+ * as suas mensagens uma de cada vez; entre mensagens (e nas esperas dos jogos) a sessão não ocupa um worker.
+ * - Se houver um erro ao aceitar uma conexão ou criar uma thread, a função regista o erro 
+ * no ficheiro de log especificado na configuração.
+ *
+ * @note As threads de accept executam até o servidor receber SIGTERM ou SIGINT; nessa altura os
+ * sockets de escuta são fechados e `drainServer` desliga-o sem perder os jogos a decorrer.
+ * Um SIGHUP recarrega o catálogo de jogos sem parar o servidor (`reloadCatalog`).
+ */
+
+ServerConfig* svConfig;
+
+// SIGTERM and SIGINT are blocked in every thread and taken here, outside any signal handler
+static void *handleShutdownSignals(void *arg) {
+
+    sigset_t *signals = (sigset_t *)arg;
+    int sig;
+
+    if (sigwait(signals, &sig) == 0) {
+        printf("Sinal %d recebido: o servidor deixa de aceitar ligacoes\n", sig);
+        svConfig->isDraining = true;
+        stopAcceptors();
+    }
+
+    return NULL;
+}
+
+static double elapsedMs(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1e3 + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+/**
+ * Desliga o servidor sem que os jogadores percam os jogos a decorrer.
+ *
+ * @param config Um pointer para a estrutura `ServerConfig` com o tempo de espera e os caminhos dos ficheiros.
+ *
+ * @details Esta função é chamada quando o servidor já não aceita ligações e faz o seguinte:
+ * - Espera até `drainTimeout` segundos que as salas acabem; nenhuma sala nova é criada entretanto.
+ * - Guarda as salas que ainda estão a decorrer em `snapshotPath`, para o próximo arranque as restaurar.
+ * - Fecha o WAL dos jogos; se as salas ficaram guardadas, esvazia-o, porque o snapshot já as tem.
+ * - Escreve os resultados em fila, guarda as estatísticas, fecha o leaderboard e espera que o
+ *   buffer de logs seja escrito.
+ */
+
+static void drainServer(ServerConfig *config) {
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    int numRooms = 0;
+
+    for (int waited = 0; ; waited += 100) {
+
+        pthread_rwlock_rdlock(&config->roomsLock);
+        numRooms = config->numRooms;
+        pthread_rwlock_unlock(&config->roomsLock);
+
+        if (numRooms == 0 || waited >= config->drainTimeout * 1000) {
+            break;
+        }
+
+        usleep(100000);
+    }
+
+    // the rooms still running are saved before anything else
+    int numSaved = numRooms > 0 ? saveRoomsSnapshot(config) : 0;
+
+    // with the rooms in the snapshot the WAL would only bring them back twice; without a
+    // snapshot it keeps them for the next start
+    closeGameWal(config, numRooms == 0 || (numSaved >= 0 && config->snapshotPath[0] != '\0'));
+    if (numSaved < 0) {
+        numSaved = 0;
+    }
+
+    // the results still queued are written before the files are closed
+    flushResults();
+    saveStatistics(config);
+    closeLeaderboard();
+
+    char logMessage[128];
+    snprintf(logMessage, sizeof(logMessage), "Servidor desligado: %d salas a decorrer, %d guardadas", numRooms, numSaved);
+    produceLog(config, logMessage, EVENT_SERVER_CONNECTION_FINISH, 0, 0);
+
+    bool isFlushed = flushLogs(config, 2000);
+
+    printf("%s em %.0f ms%s\n", logMessage, elapsedMs(&start), isFlushed ? "" : " (logs por escrever)");
+}
+
+// SIGHUP rebuilds the games catalog; the old versions are freed here once no reader is left
+static void *handleReloadSignals(void *arg) {
+
+    sigset_t *signals = (sigset_t *)arg;
+    struct timespec retryDelay = { 0, 100 * 1000 * 1000 };
+    int numWaiting = 0;
+
+    for (;;) {
+
+        // while an old version waits for its readers, wake up now and then to free it
+        int sig = numWaiting > 0 ? sigtimedwait(signals, NULL, &retryDelay) : sigwaitinfo(signals, NULL);
+
+        if (sig == SIGHUP) {
+            struct timespec start;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+
+            if (reloadCatalog(svConfig)) {
+                GameCatalog *catalog = enterCatalog(svConfig);
+                printf("Catalogo de jogos recarregado em %.1f ms: versao %d, %d jogos\n", elapsedMs(&start), catalog->version, catalog->numGames);
+                leaveCatalog();
+            } else {
+                printf("Nao foi possivel recarregar o catalogo de jogos: fica a versao atual\n");
+            }
+        }
+
+        numWaiting = epochReclaim();
+    }
+
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    
+    if (argc < 2) {
+        printf("Erro: Faltam argumentos de configuracao!\n");
+        return 1;
+    }
+
+
+    // restart-to-ready time, from here until the server accepts connections
+    struct timespec startTime;
+    clock_gettime(CLOCK_MONOTONIC, &startTime);
+
+    // um cliente que desaparece não pode terminar o servidor: os erros de escrita são tratados em cada send
+    signal(SIGPIPE, SIG_IGN);
+
+    // SIGTERM e SIGINT são tratados por uma só thread; a máscara é herdada por todas as outras
+    static sigset_t shutdownSignals;
+    sigemptyset(&shutdownSignals);
+    sigaddset(&shutdownSignals, SIGTERM);
+    sigaddset(&shutdownSignals, SIGINT);
+    pthread_sigmask(SIG_BLOCK, &shutdownSignals, NULL);
+
+    // SIGHUP (recarregar o catálogo) também, por outra thread
+    static sigset_t reloadSignals;
+    sigemptyset(&reloadSignals);
+    sigaddset(&reloadSignals, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &reloadSignals, NULL);
+
+    printf("Server starting...\n");
+
+    // o parson usa o arena do worker durante um pedido, e o malloc fora dos pedidos
+    json_set_allocation_functions(arenaMalloc, arenaFree);
+
+    // Garante que os jogos aleatórios são diferentes
+    srand(time(NULL));
+
+
+    // Carrega a configuracao do servidor
+    svConfig = getServerConfig(argv[1]);
+
+    // Constrói o catálogo de jogos usado nas listagens e nos jogos aleatórios
+    GameCatalog *catalog = loadCatalog(svConfig);
+    if (catalog == NULL) {
+        fprintf(stderr, "Couldn't load the games catalog\n");
+        exit(1);
+    }
+    atomic_store(&svConfig->catalog, catalog);
+    printf("CATALOGO DE JOGOS: %d jogos (por dificuldade:", catalog->numGames);
+    for (int difficulty = 1; difficulty <= CATALOG_DIFFICULTIES; difficulty++) {
+        printf(" %d=%d", difficulty, catalog->bucketSizes[difficulty]);
+    }
+    printf(")\n");
+
+    // Carrega as estatísticas agregadas
+    initStatistics(svConfig);
+
+    // Carrega o leaderboard
+    initLeaderboard(svConfig);
+
+    // Começa a escrever os resultados dos jogos (recordes e leaderboard) em lotes
+    initResults(svConfig);
+
+    // Começa a gerar jogos para os pedidos de jogos aleatórios
+    initGenerator(svConfig);
+
+    // Começa a enviar os estados das salas aos espectadores
+    initSpectators(svConfig);
+
+    // Reserva a tabela de sessões para os jogadores retomarem jogos depois de perderem a ligação
+    initSessions(svConfig);
+
+    // Enche o token bucket das sessões novas
+    initAdmission(svConfig);
+
+    // Cria os workers que tratam os pedidos dos clientes
+    initWorkers(svConfig);
+
+    // Create a thread to handle consume for logs (before the restore, which already logs)
+    pthread_t logThread;
+    if (pthread_create(&logThread, NULL, consumeLog, (void *)svConfig) != 0) {
+        err_dump(svConfig, 0, 0, "can't create log consumer thread", EVENT_THREAD_NOT_CREATE);
+    }
+
+    // Recria as salas que estavam a decorrer quando o servidor foi desligado
+    int numRestored = restoreRoomsSnapshot(svConfig);
+
+    // e as que ficaram por acabar num crash, a partir do WAL dos jogos (que recomeça com elas)
+    numRestored += initGameWal(svConfig);
+
+    // Abre os sockets de escuta e começa a aceitar ligações, uma thread por socket
+    startAcceptors(svConfig);
+
+    pthread_t signalThread;
+    if (pthread_create(&signalThread, NULL, handleShutdownSignals, (void *)&shutdownSignals) != 0) {
+        err_dump(svConfig, 0, 0, "can't create signal thread", EVENT_THREAD_NOT_CREATE);
+    }
+    pthread_detach(signalThread);
+
+    pthread_t reloadThread;
+    if (pthread_create(&reloadThread, NULL, handleReloadSignals, (void *)&reloadSignals) != 0) {
+        err_dump(svConfig, 0, 0, "can't create signal thread", EVENT_THREAD_NOT_CREATE);
+    }
+    pthread_detach(reloadThread);
+
+    printf("Servidor pronto em %.1f ms (%d salas restauradas)\n", elapsedMs(&startTime), numRestored);
+
+    // as threads de accept acabam quando o servidor recebe SIGTERM ou SIGINT
+    joinAcceptors();
+
+    // os jogos a decorrer acabam ou ficam guardados para o próximo arranque
+    drainServer(svConfig);
+
+    // the client threads still blocked on their sockets end with the process
+    exit(0);
+}
@@ -0,0 +1,213 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../utils/parson/parson.h"
+#include "../utils/gamestream/gamestream.h"
+
+/*
+ * Compara a leitura de um ficheiro de jogos grande com o parson (árvore do ficheiro inteiro,
+ * como o servidor fazia) e com o leitor em streaming (um jogo de cada vez). Gera um ficheiro
+ * com o formato de 'games.json' (indentado, como o servidor o grava) e mede, para cada um,
+ * o tempo de leitura e o pico de memória; verifica também que ambos leem os mesmos jogos.
+ *
+ * Uso: ./catalog-bench.exe [jogos] [ficheiro]
+ */
+
+// parson's memory, counted through its allocation functions
+typedef struct {
+    size_t size;
+    size_t padding;
+} AllocationHeader;
+
+static size_t currentBytes = 0;
+static size_t peakBytes = 0;
+
+static void *countingMalloc(size_t size) {
+
+    AllocationHeader *header = (AllocationHeader *)malloc(sizeof(AllocationHeader) + size);
+    if (header == NULL) {
+        return NULL;
+    }
+
+    header->size = size;
+    currentBytes += size;
+    if (currentBytes > peakBytes) {
+        peakBytes = currentBytes;
+    }
+
+    return header + 1;
+}
+
+static void countingFree(void *ptr) {
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    AllocationHeader *header = (AllocationHeader *)ptr - 1;
+    currentBytes -= header->size;
+    free(header);
+}
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void writeMatrix(FILE *file, const char *name, const char cells[9][9], bool isLast) {
+
+    fprintf(file, "            \"%s\": [\n", name);
+    for (int i = 0; i < 9; i++) {
+        fprintf(file, "                [\n");
+        for (int j = 0; j < 9; j++) {
+            fprintf(file, "                    %d%s\n", cells[i][j], j < 8 ? "," : "");
+        }
+        fprintf(file, "                ]%s\n", i < 8 ? "," : "");
+    }
+    fprintf(file, "            ]%s\n", isLast ? "" : ",");
+}
+
+// a games file with numGames 9x9 games, laid out like json_serialize_to_file_pretty
+static bool writeGamesFile(const char *path, int numGames) {
+
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        return false;
+    }
+
+    unsigned int seed = 2024;
+    fprintf(file, "{\n    \"games\": [\n");
+
+    for (int g = 0; g < numGames; g++) {
+
+        // a valid grid, with its digits relabelled and about half of it given
+        int labels[9];
+        for (int i = 0; i < 9; i++) {
+            labels[i] = i + 1;
+        }
+        for (int i = 8; i > 0; i--) {
+            int j = rand_r(&seed) % (i + 1);
+            int temp = labels[i];
+            labels[i] = labels[j];
+            labels[j] = temp;
+        }
+
+        char solution[9][9], board[9][9];
+        for (int i = 0; i < 9; i++) {
+            for (int j = 0; j < 9; j++) {
+                solution[i][j] = (char)labels[(i * 3 + i / 3 + j) % 9];
+                board[i][j] = rand_r(&seed) % 2 ? solution[i][j] : 0;
+            }
+        }
+
+        fprintf(file, "        {\n            \"id\": %d,\n            \"difficulty\": %d,\n", g + 1, 1 + rand_r(&seed) % 5);
+        writeMatrix(file, "board", (const char (*)[9])board, false);
+        writeMatrix(file, "solution", (const char (*)[9])solution, false);
+        fprintf(file, "            \"timeRecord\": %d,\n            \"accuracyRecord\": %d\n", 60 + g % 500, g % 100);
+        fprintf(file, "        }%s\n", g < numGames - 1 ? "," : "");
+    }
+
+    fprintf(file, "    ]\n}");
+    fclose(file);
+
+    return true;
+}
+
+// what loadCatalog keeps of each game, summed up so both readers can be compared
+static unsigned long gameChecksum(int id, int difficulty, const char *cells, size_t rowStride) {
+
+    unsigned long checksum = (unsigned long)id * 31 + difficulty;
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 9; j++) {
+            checksum = checksum * 7 + cells[i * rowStride + j];
+        }
+    }
+
+    return checksum;
+}
+
+int main(int argc, char *argv[]) {
+
+    int numGames = argc > 1 ? atoi(argv[1]) : 100000;
+    const char *path = argc > 2 ? argv[2] : "catalog-bench.json";
+
+    printf("A gerar %d jogos em %s...\n", numGames, path);
+    if (!writeGamesFile(path, numGames)) {
+        fprintf(stderr, "Erro ao escrever %s\n", path);
+        return 1;
+    }
+
+    FILE *file = fopen(path, "r");
+    fseek(file, 0, SEEK_END);
+    double fileMB = ftell(file) / (1024.0 * 1024.0);
+    fclose(file);
+
+    // parson: the whole tree, then a walk over the games array
+    json_set_allocation_functions(countingMalloc, countingFree);
+
+    double start = now();
+    unsigned long parsonChecksum = 0;
+    int parsonGames = 0;
+
+    JSON_Value *root_value = json_parse_file(path);
+    JSON_Array *games_array = json_object_get_array(json_value_get_object(root_value), "games");
+
+    for (size_t i = 0; i < json_array_get_count(games_array); i++) {
+
+        JSON_Object *game_object = json_array_get_object(games_array, i);
+        JSON_Array *rows = json_object_get_array(game_object, "board");
+        char cells[9][9];
+
+        for (int r = 0; r < 9; r++) {
+            JSON_Array *row = json_array_get_array(rows, r);
+            for (int c = 0; c < 9; c++) {
+                cells[r][c] = (char)json_array_get_number(row, c);
+            }
+        }
+
+        parsonChecksum += gameChecksum((int)json_object_get_number(game_object, "id"),
+                                       (int)json_object_get_number(game_object, "difficulty"), &cells[0][0], 9);
+        parsonGames++;
+    }
+
+    json_value_free(root_value);
+    double parsonSeconds = now() - start;
+
+    // streaming: one record at a time
+    static GameStream stream;
+    static GameRecord record;
+
+    start = now();
+    unsigned long streamChecksum = 0;
+    int streamGames = 0;
+
+    if (!openGameStream(&stream, path)) {
+        fprintf(stderr, "Erro ao abrir %s\n", path);
+        return 1;
+    }
+
+    int result;
+    while ((result = nextGameRecord(&stream, &record)) == GAME_STREAM_RECORD) {
+        streamChecksum += gameChecksum(record.id, record.difficulty, &record.board[0][0], BOARD_ROW_STRIDE);
+        streamGames++;
+    }
+    closeGameStream(&stream);
+
+    double streamSeconds = now() - start;
+
+    bool same = result == GAME_STREAM_END && streamGames == parsonGames && streamChecksum == parsonChecksum;
+
+    printf("Ficheiro: %.1f MB, %d jogos\n", fileMB, numGames);
+    printf("Mesmos jogos nos dois: %s\n\n", same ? "sim" : "NAO");
+    printf("%-10s %10s %12s %12s %14s\n", "reader", "time (s)", "games/s", "MB/s", "peak memory");
+    printf("%-10s %10.3f %12.0f %12.1f %11.1f MB\n", "parson", parsonSeconds, parsonGames / parsonSeconds,
+           fileMB / parsonSeconds, peakBytes / (1024.0 * 1024.0));
+    printf("%-10s %10.3f %12.0f %12.1f %11.1f KB\n", "streaming", streamSeconds, streamGames / streamSeconds,
+           fileMB / streamSeconds, (sizeof(GameStream) + sizeof(GameRecord)) / 1024.0);
+
+    remove(path);
+
+    return same ? 0 : 1;
+}
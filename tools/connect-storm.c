@@ -0,0 +1,184 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+/*
+ * Simula o início de um torneio: muitas ligações ao servidor no mesmo instante. Cada thread liga-se,
+ * envia o estado premium ("not premium"), espera pela resposta (o ID ou "BUSY") e fecha a ligação,
+ * até fazer a sua parte das ligações. Mede quantas ligações por segundo o servidor aceita e os
+ * percentis do tempo do connect e do tempo até à resposta.
+ *
+ * Uso: ./connect-storm.exe [ip] [porta] [ligações] [threads]
+ */
+
+typedef struct {
+    struct sockaddr_in address;
+    int numConnections;
+    double *connectTimes; // ms, one per connection (-1 if it failed)
+    double *replyTimes;   // ms from the start of the connect to the reply
+    int numAdmitted;
+    int numBusy;
+    int numFailed;
+} StormThread;
+
+static pthread_barrier_t startBarrier;
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *storm(void *arg) {
+
+    StormThread *worker = (StormThread *)arg;
+    char buffer[128];
+
+    // every thread connects at the same moment
+    pthread_barrier_wait(&startBarrier);
+
+    for (int i = 0; i < worker->numConnections; i++) {
+
+        worker->connectTimes[i] = -1;
+        worker->replyTimes[i] = -1;
+
+        double start = now();
+
+        int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+        if (sockfd < 0 || connect(sockfd, (struct sockaddr *)&worker->address, sizeof(worker->address)) < 0) {
+            worker->numFailed++;
+            if (sockfd >= 0) {
+                close(sockfd);
+            }
+            continue;
+        }
+
+        worker->connectTimes[i] = (now() - start) * 1e3;
+
+        memset(buffer, 0, sizeof(buffer));
+        if (send(sockfd, "not premium", strlen("not premium"), MSG_NOSIGNAL) < 0 || recv(sockfd, buffer, sizeof(buffer) - 1, 0) <= 0) {
+            worker->numFailed++;
+        } else {
+            worker->replyTimes[i] = (now() - start) * 1e3;
+            if (strncmp(buffer, "BUSY", strlen("BUSY")) == 0) {
+                worker->numBusy++;
+            } else {
+                worker->numAdmitted++;
+            }
+        }
+
+        close(sockfd);
+    }
+
+    return NULL;
+}
+
+static int compareTimes(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// p50/p90/p99/max of the measured times, ignoring the failed connections
+static void printPercentiles(const char *name, double *times, int count) {
+
+    int measured = 0;
+    for (int i = 0; i < count; i++) {
+        if (times[i] >= 0) {
+            times[measured++] = times[i];
+        }
+    }
+
+    if (measured == 0) {
+        printf("%s: sem medidas\n", name);
+        return;
+    }
+
+    qsort(times, measured, sizeof(double), compareTimes);
+
+    printf("%s: p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms\n", name,
+           times[measured * 50 / 100], times[measured * 90 / 100], times[measured * 99 / 100], times[measured - 1]);
+}
+
+int main(int argc, char *argv[]) {
+
+    const char *ip = argc > 1 ? argv[1] : "127.0.0.1";
+    int port = argc > 2 ? atoi(argv[2]) : 8080;
+    int numConnections = argc > 3 ? atoi(argv[3]) : 2000;
+    int numThreads = argc > 4 ? atoi(argv[4]) : 64;
+
+    if (numConnections <= 0 || numThreads <= 0) {
+        fprintf(stderr, "Uso: %s [ip] [porta] [ligacoes] [threads]\n", argv[0]);
+        return 1;
+    }
+    if (numThreads > numConnections) {
+        numThreads = numConnections;
+    }
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (inet_pton(AF_INET, ip, &address.sin_addr) != 1) {
+        fprintf(stderr, "Endereco invalido: %s\n", ip);
+        return 1;
+    }
+
+    StormThread *workers = (StormThread *)calloc(numThreads, sizeof(StormThread));
+    pthread_t *threads = (pthread_t *)malloc(numThreads * sizeof(pthread_t));
+    double *connectTimes = (double *)malloc(numConnections * sizeof(double));
+    double *replyTimes = (double *)malloc(numConnections * sizeof(double));
+    if (workers == NULL || threads == NULL || connectTimes == NULL || replyTimes == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return 1;
+    }
+
+    pthread_barrier_init(&startBarrier, NULL, numThreads + 1);
+
+    // each thread writes its times into its own slice of the arrays
+    int first = 0;
+    for (int t = 0; t < numThreads; t++) {
+        workers[t].address = address;
+        workers[t].numConnections = numConnections / numThreads + (t < numConnections % numThreads);
+        workers[t].connectTimes = connectTimes + first;
+        workers[t].replyTimes = replyTimes + first;
+        first += workers[t].numConnections;
+
+        if (pthread_create(&threads[t], NULL, storm, &workers[t]) != 0) {
+            fprintf(stderr, "Nao foi possivel criar a thread %d\n", t);
+            return 1;
+        }
+    }
+
+    pthread_barrier_wait(&startBarrier);
+    double start = now();
+
+    int numAdmitted = 0, numBusy = 0, numFailed = 0;
+    for (int t = 0; t < numThreads; t++) {
+        pthread_join(threads[t], NULL);
+        numAdmitted += workers[t].numAdmitted;
+        numBusy += workers[t].numBusy;
+        numFailed += workers[t].numFailed;
+    }
+
+    double elapsed = now() - start;
+
+    printf("%d ligacoes de %d threads em %.3f s: %.0f ligacoes/s com resposta (%d com ID, %d BUSY, %d falhadas)\n",
+           numConnections, numThreads, elapsed, (numAdmitted + numBusy) / elapsed, numAdmitted, numBusy, numFailed);
+    printPercentiles("connect", connectTimes, numConnections);
+    printPercentiles("resposta", replyTimes, numConnections);
+
+    pthread_barrier_destroy(&startBarrier);
+    free(workers);
+    free(threads);
+    free(connectTimes);
+    free(replyTimes);
+
+    return 0;
+}
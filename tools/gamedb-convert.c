@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../utils/gamestream/gamestream.h"
+#include "../utils/gamedb/gamedb.h"
+#include "../utils/solver/solver.h"
+#include "../utils/solver/rating.h"
+
+/*
+ * Converte o ficheiro 'games.json' numa base de dados binária de registos fixos
+ * que o servidor pode mapear em memória (GAME_DB_PATH em server.conf).
+ * Os puzzles são validados com o solver: os que não têm solução, ou cuja solução guardada
+ * não resolve o tabuleiro, são ignorados; os que têm várias soluções geram um aviso.
+ * A dificuldade de cada registo é calculada pelo motor de classificação (1 a 5).
+ * O ficheiro é lido em streaming, um jogo de cada vez, por isso catálogos grandes não são
+ * carregados inteiros em memória (só os registos binários).
+ *
+ * Uso: ./gamedb-convert.exe server/data/games.json server/data/games.db
+ */
+
+static int compareRecords(const void *a, const void *b) {
+    const GameDBRecord *recordA = (const GameDBRecord *)a;
+    const GameDBRecord *recordB = (const GameDBRecord *)b;
+    return (recordA->id > recordB->id) - (recordA->id < recordB->id);
+}
+
+// true if the stored solution is a complete valid grid that agrees with the givens
+static int isSolutionConsistent(char board[9][9], char solution[9][9]) {
+
+    SolverState state;
+    if (!initSolverState(&state, (const char (*)[9])solution)) {
+        return 0;
+    }
+
+    for (int cell = 0; cell < 81; cell++) {
+        int given = board[cell / 9][cell % 9];
+        if (state.cells[cell] == 0 || (given != 0 && given != state.cells[cell])) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+// copy a 9x9 matrix read from the games file (returns 0 on success)
+static int readCells(int size, const char (*rows)[BOARD_ROW_STRIDE], char cells[9][9]) {
+
+    if (size != 9) {
+        return -1;
+    }
+
+    for (int row = 0; row < 9; row++) {
+        memcpy(cells[row], rows[row], 9);
+    }
+
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+
+    if (argc < 3) {
+        printf("Uso: %s <games.json> <games.db>\n", argv[0]);
+        return 1;
+    }
+
+    static GameStream stream;
+    static GameRecord game;
+
+    if (!openGameStream(&stream, argv[1])) {
+        fprintf(stderr, "Erro ao ler %s\n", argv[1]);
+        return 1;
+    }
+
+    int capacity = 1024;
+    GameDBRecord *records = (GameDBRecord *)calloc(capacity, sizeof(GameDBRecord));
+    if (records == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        closeGameStream(&stream);
+        return 1;
+    }
+
+    int numRecords = 0;
+    int result;
+
+    while ((result = nextGameRecord(&stream, &game)) == GAME_STREAM_RECORD) {
+
+        if (numRecords == capacity) {
+            GameDBRecord *grown = (GameDBRecord *)realloc(records, sizeof(GameDBRecord) * capacity * 2);
+            if (grown == NULL) {
+                fprintf(stderr, "Memory allocation failed\n");
+                closeGameStream(&stream);
+                free(records);
+                return 1;
+            }
+            memset(grown + capacity, 0, sizeof(GameDBRecord) * capacity);
+            records = grown;
+            capacity *= 2;
+        }
+
+        GameDBRecord *record = &records[numRecords];
+
+        char board[9][9];
+        char solution[9][9];
+
+        // the records hold 9x9 boards only: larger games stay in the games file
+        if (game.size != 9) {
+            fprintf(stderr, "Jogo %d ignorado: a base de dados so guarda tabuleiros 9x9\n", game.id);
+            continue;
+        }
+
+        if (readCells(game.boardSize, (const char (*)[BOARD_ROW_STRIDE])game.board, board) < 0 ||
+            readCells(game.solutionSize, (const char (*)[BOARD_ROW_STRIDE])game.solution, solution) < 0) {
+            fprintf(stderr, "Jogo %d ignorado: tabuleiro invalido\n", game.id);
+            continue;
+        }
+
+        int gameID = game.id;
+        int solutions = countSolutions((const char (*)[9])board, 2);
+
+        if (solutions == 0 || !isSolutionConsistent(board, solution)) {
+            fprintf(stderr, "Jogo %d ignorado: sem solucao ou solucao guardada invalida\n", gameID);
+            continue;
+        }
+
+        if (solutions > 1) {
+            fprintf(stderr, "Aviso: o jogo %d tem mais do que uma solucao\n", gameID);
+        }
+
+        record->id = (int32_t)gameID;
+        // the rating engine is authoritative over the difficulty in the games file
+        record->difficulty = (uint8_t)ratePuzzle((const char (*)[9])board);
+        record->timeRecord = (int32_t)game.timeRecord;
+        record->accuracyRecord = game.accuracyRecord;
+        packCells((const char (*)[9])board, record->board);
+        packCells((const char (*)[9])solution, record->solution);
+
+        numRecords++;
+    }
+
+    closeGameStream(&stream);
+
+    if (result == GAME_STREAM_ERROR) {
+        fprintf(stderr, "Erro ao ler %s: JSON mal formado\n", argv[1]);
+        free(records);
+        return 1;
+    }
+
+    // the server looks records up by ID
+    qsort(records, numRecords, sizeof(GameDBRecord), compareRecords);
+
+    GameDBHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, GAMEDB_MAGIC, sizeof(header.magic));
+    header.version = GAMEDB_VERSION;
+    header.recordSize = sizeof(GameDBRecord);
+    header.numRecords = numRecords;
+
+    FILE *file = fopen(argv[2], "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Erro ao abrir %s\n", argv[2]);
+        free(records);
+        return 1;
+    }
+
+    if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+        fwrite(records, sizeof(GameDBRecord), numRecords, file) != (size_t)numRecords) {
+        fprintf(stderr, "Erro ao escrever %s\n", argv[2]);
+        fclose(file);
+        free(records);
+        return 1;
+    }
+
+    fclose(file);
+    free(records);
+
+    printf("%d jogos convertidos para %s\n", numRecords, argv[2]);
+    return 0;
+}
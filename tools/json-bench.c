@@ -0,0 +1,254 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../utils/parson/parson.h"
+#include "../utils/board/board.h"
+#include "../utils/jsonwriter/jsonwriter.h"
+
+/*
+ * Compara o escritor de JSON em streaming com o parson: primeiro verifica que o texto é igual,
+ * byte a byte, ao de json_serialize_to_string (tabuleiros 4x4 a 25x25, strings com escapes e
+ * números especiais), e depois mede quantos tabuleiros por segundo cada um escreve, como no
+ * sendBoard (o parson constrói a árvore, serializa-a e liberta-a).
+ *
+ * Uso: ./json-bench.exe [tabuleiros]
+ */
+
+#define MESSAGE_SIZE (BOARD_MAX_SIZE * (BOARD_MAX_SIZE * 3 + 3) + 96)
+
+static volatile size_t sink; // keeps the compiler from dropping the work being timed
+
+typedef struct {
+    int id;
+    int size;
+    char board[BOARD_MAX_SIZE][BOARD_ROW_STRIDE];
+} BenchBoard;
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// a board with about half of the cells given
+static void fillBoard(BenchBoard *board, int size, unsigned int *seed) {
+
+    memset(board, 0, sizeof(BenchBoard));
+    board->id = rand_r(seed) % 2000000;
+    board->size = size;
+
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            board->board[i][j] = rand_r(seed) % 2 ? (char)(1 + rand_r(seed) % size) : 0;
+        }
+    }
+}
+
+// the same tree sendBoard used to build
+static char *parsonBoard(const BenchBoard *board) {
+
+    JSON_Value *root_value = json_value_init_object();
+    JSON_Object *root_object = json_value_get_object(root_value);
+    json_object_set_number(root_object, "id", board->id);
+    JSON_Value *board_value = json_value_init_array();
+    JSON_Array *board_array = json_value_get_array(board_value);
+
+    json_object_set_number(root_object, "size", board->size);
+
+    for (int i = 0; i < board->size; i++) {
+        JSON_Value *linha_value = json_value_init_array();
+        JSON_Array *linha_array = json_value_get_array(linha_value);
+        for (int j = 0; j < board->size; j++) {
+            json_array_append_number(linha_array, board->board[i][j]);
+        }
+        json_array_append_value(board_array, linha_value);
+    }
+
+    json_object_set_value(root_object, "board", board_value);
+    char *serialized_string = json_serialize_to_string(root_value);
+    json_value_free(root_value);
+
+    return serialized_string;
+}
+
+static size_t writerBoard(const BenchBoard *board, char *message) {
+
+    JsonWriter writer;
+    jsonWriterInit(&writer, message, MESSAGE_SIZE);
+    jsonBoard(&writer, board->id, board->size, &board->board[0][0], BOARD_ROW_STRIDE);
+
+    return jsonWriterFinish(&writer);
+}
+
+static bool sameText(const char *label, const char *expected, const char *written) {
+
+    if (expected != NULL && strcmp(expected, written) == 0) {
+        return true;
+    }
+
+    printf("DIFERENTE (%s):\n  parson: %s\n  writer: %s\n", label, expected ? expected : "(null)", written);
+    return false;
+}
+
+// every kind of value the writer knows, in nested objects and arrays
+static bool checkValues() {
+
+    static const char *strings[] = {
+        "", "plain", "quote \" and backslash \\", "slash / and </script>", "tab\tnew\nline\rform\fback\b",
+        "\x01\x02\x1f control", "utf-8: ação ñ €"
+    };
+    static const double numbers[] = {
+        0, -0.0, 1, -1, 9, 10, 99, 100, 12345, -987654321, 2147483647, -2147483648.0,
+        1e16, 99999999999999999.0, 1e17, -1e17, 1e300, 0.5, -0.25, 3.14159, 1.0 / 3, 1e-7
+    };
+
+    int numStrings = sizeof(strings) / sizeof(strings[0]);
+    int numNumbers = sizeof(numbers) / sizeof(numbers[0]);
+
+    JSON_Value *root_value = json_value_init_object();
+    JSON_Object *root_object = json_value_get_object(root_value);
+    JSON_Value *strings_value = json_value_init_array();
+    JSON_Value *numbers_value = json_value_init_array();
+    JSON_Value *nested_value = json_value_init_object();
+
+    for (int i = 0; i < numStrings; i++) {
+        json_array_append_string(json_value_get_array(strings_value), strings[i]);
+    }
+    for (int i = 0; i < numNumbers; i++) {
+        json_array_append_number(json_value_get_array(numbers_value), numbers[i]);
+    }
+    json_object_set_boolean(json_value_get_object(nested_value), "yes", 1);
+    json_object_set_boolean(json_value_get_object(nested_value), "no", 0);
+    json_object_set_null(json_value_get_object(nested_value), "nothing");
+    json_object_set_value(json_value_get_object(nested_value), "empty", json_value_init_array());
+    json_object_set_string(json_value_get_object(nested_value), "a/b \"key\"", "v");
+
+    json_object_set_value(root_object, "strings", strings_value);
+    json_object_set_value(root_object, "numbers", numbers_value);
+    json_object_set_value(root_object, "nested", nested_value);
+
+    char *expected = json_serialize_to_string(root_value);
+    json_value_free(root_value);
+
+    char written[4096];
+    JsonWriter writer;
+    jsonWriterInit(&writer, written, sizeof(written));
+    jsonBeginObject(&writer);
+    jsonKey(&writer, "strings");
+    jsonBeginArray(&writer);
+    for (int i = 0; i < numStrings; i++) {
+        jsonString(&writer, strings[i]);
+    }
+    jsonEndArray(&writer);
+    jsonKey(&writer, "numbers");
+    jsonBeginArray(&writer);
+    for (int i = 0; i < numNumbers; i++) {
+        jsonNumber(&writer, numbers[i]);
+    }
+    jsonEndArray(&writer);
+    jsonKey(&writer, "nested");
+    jsonBeginObject(&writer);
+    jsonKey(&writer, "yes");
+    jsonBool(&writer, true);
+    jsonKey(&writer, "no");
+    jsonBool(&writer, false);
+    jsonKey(&writer, "nothing");
+    jsonNull(&writer);
+    jsonKey(&writer, "empty");
+    jsonBeginArray(&writer);
+    jsonEndArray(&writer);
+    jsonKey(&writer, "a/b \"key\"");
+    jsonString(&writer, "v");
+    jsonEndObject(&writer);
+    jsonEndObject(&writer);
+    jsonWriterFinish(&writer);
+
+    bool same = sameText("valores", expected, written);
+    json_free_serialized_string(expected);
+
+    // a buffer that is too small is reported, never overrun
+    char small[16];
+    jsonWriterInit(&writer, small, sizeof(small));
+    jsonBeginArray(&writer);
+    for (int i = 0; i < numNumbers; i++) {
+        jsonNumber(&writer, numbers[i]);
+    }
+    jsonEndArray(&writer);
+    if (jsonWriterFinish(&writer) != 0) {
+        printf("DIFERENTE: buffer pequeno sem erro\n");
+        same = false;
+    }
+
+    return same;
+}
+
+int main(int argc, char *argv[]) {
+
+    long numBoards = argc > 1 ? atol(argv[1]) : 200000;
+    static const int sizes[] = {4, 9, 16, 25};
+    unsigned int seed = 12345;
+
+    // byte-identical output first: the client parses it with parson
+    bool same = checkValues();
+    char message[MESSAGE_SIZE];
+
+    for (int s = 0; s < 4; s++) {
+        for (int i = 0; i < 1000; i++) {
+            BenchBoard board;
+            fillBoard(&board, sizes[s], &seed);
+
+            char *expected = parsonBoard(&board);
+            writerBoard(&board, message);
+
+            char label[32];
+            snprintf(label, sizeof(label), "tabuleiro %dx%d", sizes[s], sizes[s]);
+            if (!sameText(label, expected, message)) {
+                same = false;
+                i = 1000;
+            }
+            json_free_serialized_string(expected);
+        }
+    }
+
+    printf("Texto igual ao do parson: %s\n\n", same ? "sim" : "NAO");
+    if (!same) {
+        return 1;
+    }
+
+    printf("%-8s %14s %14s %10s\n", "board", "parson/s", "writer/s", "speed-up");
+
+    for (int s = 0; s < 4; s++) {
+
+        BenchBoard board;
+        fillBoard(&board, sizes[s], &seed);
+
+        // the writer is too fast to time on few boards
+        long parsonBoards = numBoards / (sizes[s] * sizes[s] / 16 + 1);
+        long writerBoards = parsonBoards * 10;
+        size_t checksum = 0;
+
+        double start = now();
+        for (long i = 0; i < parsonBoards; i++) {
+            board.board[0][0] = (char)(i % sizes[s]);
+            char *text = parsonBoard(&board);
+            checksum += strlen(text);
+            json_free_serialized_string(text);
+        }
+        double parsonRate = parsonBoards / (now() - start);
+
+        start = now();
+        for (long i = 0; i < writerBoards; i++) {
+            board.board[0][0] = (char)(i % sizes[s]);
+            checksum += writerBoard(&board, message);
+        }
+        double writerRate = writerBoards / (now() - start);
+
+        char label[16];
+        snprintf(label, sizeof(label), "%dx%d", sizes[s], sizes[s]);
+        printf("%-8s %14.0f %14.0f %9.1fx\n", label, parsonRate, writerRate, writerRate / parsonRate);
+        sink = checksum;
+    }
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../utils/logs/logs-binary.h"
+#include "../utils/jsonwriter/jsonwriter.h"
+
+/*
+ * Converte o log binário do servidor (SERVER_LOG_PATH) para texto: JSON com o mesmo formato do
+ * antigo logs.json ({"logs":[{"timestamp", "gameID", "playerID", "message"}, ...]}, com o evento,
+ * o valor e o instante em ns de cada registo) ou CSV, uma linha por registo. As mensagens são
+ * formatadas aqui, a partir do código do evento e dos campos de cada registo.
+ * Um registo incompleto no fim do ficheiro (o servidor parou a meio de uma escrita) é ignorado.
+ *
+ * Uso: ./log-decode.exe <ficheiro> [json|csv]
+ */
+
+#define DECODE_MESSAGE_SIZE 512
+
+// the timestamp as the old JSON log wrote it, with the milliseconds
+static void formatTimestamp(int64_t timestamp, char *text, size_t size) {
+
+    time_t seconds = (time_t)(timestamp / 1000000000LL);
+    struct tm tm;
+    localtime_r(&seconds, &tm);
+
+    snprintf(text, size, "%02d-%02d-%04d %02d:%02d:%02d.%03d",
+             tm.tm_mday, tm.tm_mon + 1, tm.tm_year + 1900,
+             tm.tm_hour, tm.tm_min, tm.tm_sec, (int)(timestamp / 1000000 % 1000));
+}
+
+static void writeJSONRecord(const LogRecord *record, bool isFirst) {
+
+    char timestamp[64];
+    char message[DECODE_MESSAGE_SIZE];
+    formatTimestamp(record->timestamp, timestamp, sizeof(timestamp));
+    formatLogRecord(record, message, sizeof(message));
+
+    char text[DECODE_MESSAGE_SIZE * 2 + 256];
+    JsonWriter writer;
+    jsonWriterInit(&writer, text, sizeof(text));
+    jsonBeginObject(&writer);
+    jsonKey(&writer, "timestamp");
+    jsonString(&writer, timestamp);
+    jsonKey(&writer, "timestampNs");
+    jsonInt(&writer, record->timestamp);
+    jsonKey(&writer, "event");
+    jsonString(&writer, getLogEventName(record->event));
+    jsonKey(&writer, "gameID");
+    jsonInt(&writer, record->gameID);
+    jsonKey(&writer, "playerID");
+    jsonInt(&writer, record->playerID);
+    jsonKey(&writer, "value");
+    jsonInt(&writer, record->value);
+    jsonKey(&writer, "message");
+    jsonString(&writer, message);
+    jsonEndObject(&writer);
+
+    if (jsonWriterFinish(&writer) > 0) {
+        printf("%s    %s", isFirst ? "" : ",\n", text);
+    }
+}
+
+// a CSV field in quotes, with the quotes inside doubled
+static void writeCSVField(const char *field) {
+
+    putchar('"');
+    for (const char *c = field; *c != '\0'; c++) {
+        if (*c == '"') {
+            putchar('"');
+        }
+        putchar(*c == '\n' ? ' ' : *c);
+    }
+    putchar('"');
+}
+
+static void writeCSVRecord(const LogRecord *record) {
+
+    char timestamp[64];
+    char message[DECODE_MESSAGE_SIZE];
+    formatTimestamp(record->timestamp, timestamp, sizeof(timestamp));
+    formatLogRecord(record, message, sizeof(message));
+
+    printf("%lld,%s,", (long long)record->timestamp, timestamp);
+    writeCSVField(getLogEventName(record->event));
+    printf(",%d,%d,%d,", record->gameID, record->playerID, record->value);
+    writeCSVField(message);
+    putchar('\n');
+}
+
+int main(int argc, char *argv[]) {
+
+    if (argc < 2 || (argc > 2 && strcmp(argv[2], "json") != 0 && strcmp(argv[2], "csv") != 0)) {
+        fprintf(stderr, "Uso: %s <ficheiro> [json|csv]\n", argv[0]);
+        return 1;
+    }
+
+    bool isCSV = argc > 2 && strcmp(argv[2], "csv") == 0;
+
+    FILE *file = fopen(argv[1], "rb");
+    if (file == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    LogFileHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || !isLogFileHeader(&header)) {
+        fprintf(stderr, "%s nao e um log binario do servidor (versao %d)\n", argv[1], LOG_FILE_VERSION);
+        fclose(file);
+        return 1;
+    }
+
+    if (isCSV) {
+        printf("timestamp_ns,timestamp,event,gameID,playerID,value,message\n");
+    } else {
+        printf("{\n  \"logs\": [\n");
+    }
+
+    // records are read in blocks, the output goes through stdio's buffer
+    LogRecord records[256];
+    long numRecords = 0;
+    size_t numRead;
+
+    while ((numRead = fread(records, sizeof(LogRecord), 256, file)) > 0) {
+        for (size_t i = 0; i < numRead; i++) {
+            if (isCSV) {
+                writeCSVRecord(&records[i]);
+            } else {
+                writeJSONRecord(&records[i], numRecords == 0);
+            }
+            numRecords++;
+        }
+    }
+
+    if (!isCSV) {
+        printf("%s  ]\n}\n", numRecords > 0 ? "\n" : "");
+    }
+
+    fclose(file);
+
+    fprintf(stderr, "%ld registos\n", numRecords);
+
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "../utils/solver/solver.h"
+#include "../utils/solver/rating.h"
+
+/*
+ * Mede o desempenho do solver sobre um corpus de puzzles (um puzzle de 81 células por linha,
+ * '.' ou '0' para as células vazias), primeiro numa só thread e depois em todos os cores.
+ * Mostra também a distribuição das dificuldades do corpus.
+ *
+ * Uso: ./solver-bench.exe tools/data/puzzles.txt [rondas]
+ */
+
+typedef struct {
+    char board[9][9];
+} Puzzle;
+
+typedef struct {
+    const Puzzle *puzzles;
+    int numPuzzles;
+    int rounds;
+    int solved;
+} BenchWork;
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// read the corpus (returns the number of puzzles)
+static int readPuzzles(const char *path, Puzzle **puzzles) {
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    int capacity = 64, count = 0;
+    *puzzles = (Puzzle *)malloc(sizeof(Puzzle) * capacity);
+
+    char line[256];
+    while (*puzzles != NULL && fgets(line, sizeof(line), file) != NULL) {
+
+        line[strcspn(line, "\r\n")] = 0;
+        if (line[0] == '#' || strlen(line) < 81) {
+            continue;
+        }
+
+        if (count == capacity) {
+            capacity *= 2;
+            *puzzles = (Puzzle *)realloc(*puzzles, sizeof(Puzzle) * capacity);
+            if (*puzzles == NULL) {
+                break;
+            }
+        }
+
+        for (int cell = 0; cell < 81; cell++) {
+            char c = line[cell];
+            (*puzzles)[count].board[cell / 9][cell % 9] = (c >= '1' && c <= '9') ? c - '0' : 0;
+        }
+        count++;
+    }
+
+    fclose(file);
+    return *puzzles == NULL ? -1 : count;
+}
+
+static void *runBench(void *arg) {
+
+    BenchWork *work = (BenchWork *)arg;
+    char solution[9][9];
+
+    for (int round = 0; round < work->rounds; round++) {
+        for (int i = 0; i < work->numPuzzles; i++) {
+            work->solved += solveSudoku(work->puzzles[i].board, solution);
+        }
+    }
+
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+
+    if (argc < 2) {
+        printf("Uso: %s <puzzles.txt> [rondas]\n", argv[0]);
+        return 1;
+    }
+
+    int rounds = argc > 2 ? atoi(argv[2]) : 100;
+    if (rounds <= 0) {
+        rounds = 1;
+    }
+
+    Puzzle *puzzles;
+    int numPuzzles = readPuzzles(argv[1], &puzzles);
+    if (numPuzzles <= 0) {
+        fprintf(stderr, "Erro ao ler puzzles de %s\n", argv[1]);
+        return 1;
+    }
+
+    // uniqueness check of the corpus
+    int unique = 0, multiple = 0, unsolvable = 0;
+    double start = now();
+    for (int i = 0; i < numPuzzles; i++) {
+        int solutions = countSolutions(puzzles[i].board, 2);
+        if (solutions == 1) {
+            unique++;
+        } else if (solutions > 1) {
+            multiple++;
+        } else {
+            unsolvable++;
+        }
+    }
+    double elapsed = now() - start;
+
+    printf("%d puzzles: %d com solucao unica, %d com varias, %d sem solucao (verificacao: %.1f puzzles/s)\n",
+           numPuzzles, unique, multiple, unsolvable, numPuzzles / elapsed);
+
+    // difficulty ratings of the corpus
+    int ratings[RATING_LEVELS + 1] = {0};
+    start = now();
+    for (int i = 0; i < numPuzzles; i++) {
+        ratings[ratePuzzle(puzzles[i].board)]++;
+    }
+    elapsed = now() - start;
+
+    printf("dificuldades:");
+    for (int level = 1; level <= RATING_LEVELS; level++) {
+        printf(" %d=%d", level, ratings[level]);
+    }
+    printf(" (classificacao: %.1f puzzles/s)\n", numPuzzles / elapsed);
+
+    // single thread
+    BenchWork single = { puzzles, numPuzzles, rounds, 0 };
+    start = now();
+    runBench(&single);
+    elapsed = now() - start;
+
+    printf("1 thread: %d puzzles resolvidos em %.3f s (%.0f puzzles/s)\n",
+           single.solved, elapsed, single.solved / elapsed);
+
+    // all cores, each thread solves the whole corpus
+    int numThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (numThreads < 1) {
+        numThreads = 1;
+    }
+
+    pthread_t *threads = (pthread_t *)malloc(sizeof(pthread_t) * numThreads);
+    BenchWork *works = (BenchWork *)malloc(sizeof(BenchWork) * numThreads);
+    if (threads == NULL || works == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return 1;
+    }
+
+    start = now();
+    for (int i = 0; i < numThreads; i++) {
+        works[i] = single;
+        works[i].solved = 0;
+        pthread_create(&threads[i], NULL, runBench, &works[i]);
+    }
+
+    int solved = 0;
+    for (int i = 0; i < numThreads; i++) {
+        pthread_join(threads[i], NULL);
+        solved += works[i].solved;
+    }
+    elapsed = now() - start;
+
+    printf("%d threads: %d puzzles resolvidos em %.3f s (%.0f puzzles/s)\n",
+           numThreads, solved, elapsed, solved / elapsed);
+
+    free(threads);
+    free(works);
+    free(puzzles);
+    return 0;
+}
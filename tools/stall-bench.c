@@ -0,0 +1,344 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "../utils/parson/parson.h"
+#include "../utils/board/board.h"
+#include "../utils/solver/solver.h"
+
+/*
+ * Verifica que um cliente parado não bloqueia os outros (o servidor já não tem um mutex global à
+ * volta dos pedidos do menu). Um cliente joga um jogo até à última linha e para: não envia a
+ * accuracy, por isso o servidor fica à espera dele no fim do jogo, onde antes segurava o mutex
+ * global. Enquanto está parado, vários clientes ligam-se ao mesmo tempo, criam salas, jogam um jogo
+ * inteiro e recebem o tempo final. Cada resposta tem de chegar em menos de RESPONSE_TIMEOUT segundos.
+ * Por fim o cliente parado envia a accuracy e também tem de receber o tempo.
+ * As soluções vêm do ficheiro de jogos do servidor; os jogos gerados (9x9) são resolvidos aqui.
+ * Cada cliente ocupa uma sala, por isso os clientes não podem passar de MAX_ROOMS - 1.
+ *
+ * Uso: ./stall-bench.exe [ip] [porta] [jogos.json] [clientes]
+ */
+
+#define RESPONSE_TIMEOUT 5
+#define MESSAGE_SIZE 8192
+
+typedef struct {
+    int id;
+    int size;
+    char solution[BOARD_MAX_SIZE][BOARD_MAX_SIZE];
+} KnownGame;
+
+typedef struct {
+    int sockfd;
+    int gameID;
+    int size;
+    char solution[BOARD_MAX_SIZE][BOARD_MAX_SIZE];
+} Player;
+
+typedef struct {
+    double gameTime; // ms from the connect to the final time (-1 if it failed)
+    char error[128];
+} PlayerResult;
+
+static struct sockaddr_in serverAddress;
+static KnownGame *knownGames = NULL;
+static int numKnownGames = 0;
+static pthread_barrier_t startBarrier;
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static bool loadGames(const char *path) {
+
+    JSON_Value *root = json_parse_file(path);
+    JSON_Array *games = root != NULL ? json_object_get_array(json_value_get_object(root), "games") : NULL;
+    if (games == NULL) {
+        json_value_free(root);
+        return false;
+    }
+
+    numKnownGames = json_array_get_count(games);
+    knownGames = (KnownGame *)calloc(numKnownGames > 0 ? numKnownGames : 1, sizeof(KnownGame));
+    if (knownGames == NULL) {
+        json_value_free(root);
+        return false;
+    }
+
+    for (int i = 0; i < numKnownGames; i++) {
+
+        JSON_Object *game = json_array_get_object(games, i);
+        JSON_Array *rows = json_object_get_array(game, "solution");
+        KnownGame *known = &knownGames[i];
+
+        known->id = (int)json_object_get_number(game, "id");
+        known->size = json_object_has_value(game, "size") ? (int)json_object_get_number(game, "size") : 9;
+
+        for (int row = 0; row < known->size && row < BOARD_MAX_SIZE && rows != NULL; row++) {
+            JSON_Array *cells = json_array_get_array(rows, row);
+            for (int col = 0; col < known->size && col < BOARD_MAX_SIZE; col++) {
+                known->solution[row][col] = (char)json_array_get_number(cells, col);
+            }
+        }
+    }
+
+    json_value_free(root);
+    return true;
+}
+
+// read until `numLines` '\n' arrived (false on a timeout or a closed connection, with what arrived in message)
+static bool readLines(int sockfd, char *message, int numLines) {
+
+    int length = 0;
+    int found = 0;
+
+    message[0] = '\0';
+
+    while (found < numLines) {
+        if (length == MESSAGE_SIZE - 1) {
+            return false;
+        }
+        ssize_t n = recv(sockfd, message + length, MESSAGE_SIZE - 1 - length, 0);
+        if (n <= 0) {
+            message[length] = '\0';
+            return false;
+        }
+        for (ssize_t i = 0; i < n; i++) {
+            found += message[length + i] == '\n';
+        }
+        length += n;
+    }
+
+    message[length] = '\0';
+    return true;
+}
+
+// connect, take an ID and start a single player game; the solution comes from the games file or the solver
+static bool startGame(Player *player, char *error) {
+
+    char message[MESSAGE_SIZE];
+
+    player->sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    if (player->sockfd < 0 || connect(player->sockfd, (struct sockaddr *)&serverAddress, sizeof(serverAddress)) < 0) {
+        snprintf(error, 128, "connect falhou");
+        return false;
+    }
+
+    // a blocked server shows up as a timeout
+    struct timeval timeout = { RESPONSE_TIMEOUT, 0 };
+    setsockopt(player->sockfd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    memset(message, 0, sizeof(message));
+    if (send(player->sockfd, "premium", strlen("premium"), MSG_NOSIGNAL) < 0 || recv(player->sockfd, message, sizeof(message) - 1, 0) <= 0) {
+        snprintf(error, 128, "sem ID");
+        return false;
+    }
+    if (strncmp(message, "BUSY", strlen("BUSY")) == 0) {
+        snprintf(error, 128, "servidor ocupado (%s)", strtok(message, "\n"));
+        return false;
+    }
+
+    if (send(player->sockfd, "newSinglePlayerGame", strlen("newSinglePlayerGame"), MSG_NOSIGNAL) < 0 || !readLines(player->sockfd, message, 2)) {
+        snprintf(error, 128, "sem tabuleiro (%.60s)", message);
+        return false;
+    }
+
+    JSON_Value *root = json_parse_string(strtok(message, "\n"));
+    JSON_Object *board = json_value_get_object(root);
+    JSON_Array *rows = json_object_get_array(board, "board");
+    if (rows == NULL) {
+        json_value_free(root);
+        snprintf(error, 128, "tabuleiro invalido");
+        return false;
+    }
+    player->gameID = (int)json_object_get_number(board, "id");
+    player->size = (int)json_object_get_number(board, "size");
+
+    bool isSolved = false;
+    for (int i = 0; i < numKnownGames && !isSolved; i++) {
+        if (knownGames[i].id == player->gameID && knownGames[i].size == player->size) {
+            memcpy(player->solution, knownGames[i].solution, sizeof(player->solution));
+            isSolved = true;
+        }
+    }
+
+    if (!isSolved && player->size == 9) {
+        char cells[9][9];
+        char solution[9][9];
+        for (int row = 0; row < 9; row++) {
+            for (int col = 0; col < 9; col++) {
+                cells[row][col] = (char)json_array_get_number(json_array_get_array(rows, row), col);
+            }
+        }
+        isSolved = solveSudoku((const char (*)[9])cells, solution);
+        for (int row = 0; row < 9 && isSolved; row++) {
+            memcpy(player->solution[row], solution[row], 9);
+        }
+    }
+
+    json_value_free(root);
+
+    if (!isSolved) {
+        snprintf(error, 128, "sem solucao para o jogo %d (%dx%d)", player->gameID, player->size, player->size);
+        return false;
+    }
+
+    return true;
+}
+
+// send every line of the solution; the server answers each one with the board
+static bool playLines(Player *player, char *error) {
+
+    char message[MESSAGE_SIZE];
+
+    for (int row = 0; row < player->size; row++) {
+
+        char line[BOARD_LINE_MESSAGE_SIZE];
+        for (int col = 0; col < player->size; col++) {
+            line[col] = encodeCell(player->solution[row][col]);
+        }
+        line[player->size] = '\0';
+
+        if (send(player->sockfd, line, player->size + 1, MSG_NOSIGNAL) < 0 || !readLines(player->sockfd, message, 2)) {
+            snprintf(error, 128, "sem resposta a linha %d do jogo %d", row + 1, player->gameID);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// send the accuracy and wait for the final time
+static bool finishGame(Player *player, char *error) {
+
+    char message[MESSAGE_SIZE];
+
+    if (send(player->sockfd, "100", strlen("100"), MSG_NOSIGNAL) < 0 || !readLines(player->sockfd, message, 1)) {
+        snprintf(error, 128, "sem tempo final do jogo %d", player->gameID);
+        return false;
+    }
+    if (strstr(message, "terminou") == NULL) {
+        snprintf(error, 128, "resposta inesperada no fim: %.60s", message);
+        return false;
+    }
+
+    return true;
+}
+
+static void *playGame(void *arg) {
+
+    PlayerResult *result = (PlayerResult *)arg;
+    Player player;
+    memset(&player, 0, sizeof(player));
+    player.sockfd = -1;
+
+    // every client starts at the same moment, while the stalled one is waiting
+    pthread_barrier_wait(&startBarrier);
+
+    double start = now();
+    result->gameTime = -1;
+
+    if (startGame(&player, result->error) && playLines(&player, result->error) && finishGame(&player, result->error)) {
+        result->gameTime = (now() - start) * 1e3;
+    }
+
+    if (player.sockfd >= 0) {
+        close(player.sockfd);
+    }
+
+    return NULL;
+}
+
+static int compareTimes(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char *argv[]) {
+
+    const char *ip = argc > 1 ? argv[1] : "127.0.0.1";
+    int port = argc > 2 ? atoi(argv[2]) : 8080;
+    const char *gamesPath = argc > 3 ? argv[3] : "server/data/games.json";
+    int numClients = argc > 4 ? atoi(argv[4]) : 4;
+
+    if (numClients <= 0) {
+        fprintf(stderr, "Uso: %s [ip] [porta] [jogos.json] [clientes]\n", argv[0]);
+        return 1;
+    }
+
+    memset(&serverAddress, 0, sizeof(serverAddress));
+    serverAddress.sin_family = AF_INET;
+    serverAddress.sin_port = htons(port);
+    if (inet_pton(AF_INET, ip, &serverAddress.sin_addr) != 1) {
+        fprintf(stderr, "Endereco invalido: %s\n", ip);
+        return 1;
+    }
+
+    if (!loadGames(gamesPath)) {
+        fprintf(stderr, "Nao foi possivel ler %s\n", gamesPath);
+        return 1;
+    }
+
+    // the stalled client: every line sent, then silence where the server waits for the accuracy
+    Player stalled;
+    memset(&stalled, 0, sizeof(stalled));
+    char error[128];
+    if (!startGame(&stalled, error) || !playLines(&stalled, error)) {
+        fprintf(stderr, "Cliente parado: %s\n", error);
+        return 1;
+    }
+    printf("Cliente parado no fim do jogo %d, sem enviar a accuracy\n", stalled.gameID);
+
+    PlayerResult *results = (PlayerResult *)calloc(numClients, sizeof(PlayerResult));
+    pthread_t *threads = (pthread_t *)malloc(numClients * sizeof(pthread_t));
+    double *times = (double *)malloc(numClients * sizeof(double));
+    if (results == NULL || threads == NULL || times == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return 1;
+    }
+
+    pthread_barrier_init(&startBarrier, NULL, numClients);
+
+    for (int i = 0; i < numClients; i++) {
+        pthread_create(&threads[i], NULL, playGame, &results[i]);
+    }
+    for (int i = 0; i < numClients; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    int numFinished = 0;
+    for (int i = 0; i < numClients; i++) {
+        if (results[i].gameTime >= 0) {
+            times[numFinished++] = results[i].gameTime;
+        } else {
+            printf("Cliente %d: %s\n", i + 1, results[i].error);
+        }
+    }
+
+    // the stalled client wakes up and must still get its time
+    bool isStalledFinished = finishGame(&stalled, error);
+    close(stalled.sockfd);
+
+    printf("%d/%d jogos completos enquanto um cliente estava parado", numFinished, numClients);
+    if (numFinished > 0) {
+        qsort(times, numFinished, sizeof(double), compareTimes);
+        printf(" (ligacao ate ao tempo final: p50 %.1f ms, max %.1f ms)", times[numFinished / 2], times[numFinished - 1]);
+    }
+    printf("\nCliente parado: %s\n", isStalledFinished ? "recebeu o tempo final depois de continuar" : error);
+
+    free(results);
+    free(threads);
+    free(times);
+    free(knownGames);
+
+    return numFinished == numClients && isStalledFinished ? 0 : 1;
+}
@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include "../utils/board/board.h"
+
+/*
+ * Mede quantas verificações de linhas por segundo o servidor consegue fazer: a versão antiga
+ * (uma comparação e um salto por célula, nova passagem para ver se a linha está completa e duas
+ * mensagens de log formatadas) contra o kernel vetorial `mergeBoardRow`, para 9x9, 16x16 e 25x25.
+ * Antes, cada linha faz a ida e volta por um socket como no jogo: enviada como o cliente a envia
+ * (as células e o '\0') e recebida como o servidor a recebe, sem deixar bytes no socket.
+ * As linhas enviadas alternam entre certas, com células erradas, com células vazias e com ambas, e
+ * as duas versões têm de dar o mesmo resultado, a mesma máscara e o mesmo tabuleiro em cada uma.
+ *
+ * Uso: ./verify-bench.exe [verificações]
+ */
+
+#define NUM_ROWS 1024 // distinct rows per size, cycled through
+
+typedef struct {
+    char board[BOARD_ROW_STRIDE] __attribute__((aligned(32)));
+    char solution[BOARD_ROW_STRIDE] __attribute__((aligned(32)));
+    char submitted[BOARD_ROW_STRIDE] __attribute__((aligned(32)));
+    char text[BOARD_MAX_SIZE + 1];
+} BenchRow;
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// the kinds of submissions, in turn: all right, with wrong cells, with empty cells and with both
+enum { ROW_RIGHT, ROW_WRONG, ROW_PARTIAL, ROW_WRONG_PARTIAL, ROW_KINDS };
+
+static const char *rowKindNames[ROW_KINDS] = {"certas", "erradas", "incompletas", "erradas e incompletas"};
+
+// a solution row, a board row with about half of it given and a submission of the kind r % ROW_KINDS
+static void fillRows(BenchRow *rows, int size, unsigned int *seed) {
+
+    for (int r = 0; r < NUM_ROWS; r++) {
+
+        BenchRow *row = &rows[r];
+        memset(row, 0, sizeof(BenchRow));
+
+        for (int i = 0; i < size; i++) {
+            row->solution[i] = i + 1;
+        }
+        for (int i = size - 1; i > 0; i--) {
+            int j = rand_r(seed) % (i + 1);
+            char temp = row->solution[i];
+            row->solution[i] = row->solution[j];
+            row->solution[j] = temp;
+        }
+
+        for (int i = 0; i < size; i++) {
+            row->board[i] = rand_r(seed) % 2 ? row->solution[i] : 0;
+            row->submitted[i] = row->solution[i];
+        }
+
+        int kind = r % ROW_KINDS;
+
+        // one to three cells with another value
+        if (kind == ROW_WRONG || kind == ROW_WRONG_PARTIAL) {
+            for (int n = 1 + rand_r(seed) % 3; n > 0; n--) {
+                int i = rand_r(seed) % size;
+                row->submitted[i] = (row->solution[i] + rand_r(seed) % (size - 1)) % size + 1;
+            }
+        }
+
+        // up to half of the cells left empty
+        if (kind == ROW_PARTIAL || kind == ROW_WRONG_PARTIAL) {
+            for (int n = 1 + rand_r(seed) % (size / 2); n > 0; n--) {
+                row->submitted[rand_r(seed) % size] = 0;
+            }
+        }
+
+        for (int i = 0; i < size; i++) {
+            row->text[i] = encodeCell(row->submitted[i]);
+        }
+    }
+}
+
+// the mask mergeBoardRow returns, worked out one byte at a time
+static uint32_t scalarMask(const BenchRow *row) {
+
+    uint32_t mask = 0;
+    for (int j = 0; j < BOARD_ROW_STRIDE; j++) {
+        mask |= (uint32_t)(row->board[j] == row->solution[j]) << j;
+    }
+    return mask;
+}
+
+// send every row the way the client does and read it back the way receiveLine does: the whole row must
+// arrive in one read and nothing may stay in the socket, or the next read would be an empty line
+static bool roundTripRows(const BenchRow *rows, int size) {
+
+    int sockets[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+        perror("socketpair");
+        return false;
+    }
+
+    bool isOk = true;
+
+    for (int r = 0; r < NUM_ROWS && isOk; r++) {
+
+        if (send(sockets[0], rows[r].text, strlen(rows[r].text) + 1, 0) < 0) {
+            perror("send");
+            isOk = false;
+            break;
+        }
+
+        char line[BOARD_LINE_MESSAGE_SIZE];
+        memset(line, 0, sizeof(line));
+        ssize_t received = recv(sockets[1], line, sizeof(line) - 1, 0);
+
+        char extra;
+        bool hasExtra = recv(sockets[1], &extra, 1, MSG_DONTWAIT) > 0 || errno != EAGAIN;
+
+        if (received != size + 1 || strcmp(line, rows[r].text) != 0 || hasExtra) {
+            fprintf(stderr, "Linha %d (%dx%d) recebida com %zd bytes%s\n", r, size, size, received,
+                    hasExtra ? ", com bytes a mais no socket" : "");
+            isOk = false;
+        }
+    }
+
+    close(sockets[0]);
+    close(sockets[1]);
+
+    return isOk;
+}
+
+// what verifyLine used to do for each submission
+static int scalarVerify(BenchRow *row, int size) {
+
+    char logMessage[100];
+    snprintf(logMessage, sizeof(logMessage), "O jogador %d no jogo %d para a linha %d: %s", 1, 1, 1, row->text);
+
+    for (int j = 0; j < size; j++) {
+        if (row->submitted[j] == row->solution[j]) {
+            row->board[j] = row->submitted[j];
+        }
+    }
+
+    int isCorrect = 1;
+    for (int j = 0; j < size; j++) {
+        if (row->board[j] != row->solution[j]) {
+            isCorrect = 0;
+            break;
+        }
+    }
+
+    snprintf(logMessage, sizeof(logMessage), "Linha enviada (%s) validada como %s", row->text, isCorrect ? "CERTA" : "ERRADA/INCOMPLETA");
+    return isCorrect + (logMessage[0] == 0);
+}
+
+int main(int argc, char *argv[]) {
+
+    long verifications = argc > 1 ? atol(argv[1]) : 10000000;
+    if (verifications <= 0) {
+        verifications = 1;
+    }
+
+    BenchRow *rows = (BenchRow *)aligned_alloc(32, sizeof(BenchRow) * NUM_ROWS);
+    BenchRow *copies = (BenchRow *)aligned_alloc(32, sizeof(BenchRow) * NUM_ROWS);
+    if (rows == NULL || copies == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return 1;
+    }
+
+    unsigned int seed = 2024;
+    int sizes[] = {9, 16, 25};
+
+    for (int s = 0; s < 3; s++) {
+
+        int size = sizes[s];
+        fillRows(rows, size, &seed);
+
+        if (!roundTripRows(rows, size)) {
+            return 1;
+        }
+
+        // both versions must agree on every row: the result, the mask and the merged board
+        int numComplete[ROW_KINDS] = {0};
+        memcpy(copies, rows, sizeof(BenchRow) * NUM_ROWS);
+        for (int r = 0; r < NUM_ROWS; r++) {
+            int scalar = scalarVerify(&copies[r], size);
+            uint32_t mask = mergeBoardRow(rows[r].board, rows[r].solution, rows[r].submitted);
+            int vector = mask == BOARD_ROW_COMPLETE;
+            if (scalar != vector || mask != scalarMask(&copies[r]) || memcmp(copies[r].board, rows[r].board, BOARD_ROW_STRIDE) != 0) {
+                fprintf(stderr, "Resultados diferentes na linha %d (%dx%d, %s): escalar %d, vetorial %d, mascara %08x em vez de %08x\n",
+                        r, size, size, rowKindNames[r % ROW_KINDS], scalar, vector, mask, scalarMask(&copies[r]));
+                return 1;
+            }
+            numComplete[r % ROW_KINDS] += vector;
+        }
+
+        printf("%dx%d: %d linhas iguais nas duas versoes, completas:", size, size, NUM_ROWS);
+        for (int k = 0; k < ROW_KINDS; k++) {
+            printf(" %d/%d %s%s", numComplete[k], NUM_ROWS / ROW_KINDS, rowKindNames[k], k + 1 < ROW_KINDS ? "," : "\n");
+        }
+
+        fillRows(rows, size, &seed);
+        memcpy(copies, rows, sizeof(BenchRow) * NUM_ROWS);
+
+        int correct = 0;
+        double start = now();
+        for (long i = 0; i < verifications; i++) {
+            correct += scalarVerify(&copies[i % NUM_ROWS], size);
+        }
+        double scalarTime = now() - start;
+
+        int vectorCorrect = 0;
+        start = now();
+        for (long i = 0; i < verifications; i++) {
+            BenchRow *row = &rows[i % NUM_ROWS];
+            vectorCorrect += mergeBoardRow(row->board, row->solution, row->submitted) == BOARD_ROW_COMPLETE;
+        }
+        double vectorTime = now() - start;
+
+        // both ran the same submissions on the same rows, so the boards must have ended up the same
+        for (int r = 0; r < NUM_ROWS; r++) {
+            if (memcmp(copies[r].board, rows[r].board, BOARD_ROW_STRIDE) != 0) {
+                fprintf(stderr, "Tabuleiros diferentes no fim da medicao na linha %d (%dx%d)\n", r, size, size);
+                return 1;
+            }
+        }
+        if (correct != vectorCorrect) {
+            fprintf(stderr, "Numero de linhas certas diferente na medicao (%dx%d): %d e %d\n", size, size, correct, vectorCorrect);
+            return 1;
+        }
+
+        printf("%dx%d: escalar com logs %.1f M verificacoes/s, vetorial %.1f M verificacoes/s (%.1fx) [%d/%d certas]\n",
+               size, size, verifications / scalarTime / 1e6, verifications / vectorTime / 1e6,
+               scalarTime / vectorTime, correct, vectorCorrect);
+    }
+
+    free(rows);
+    free(copies);
+
+    return 0;
+}
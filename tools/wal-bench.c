@@ -0,0 +1,362 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/wait.h>
+#include "../utils/wal/wal.h"
+
+/*
+ * Mede e testa o write-ahead log dos jogos (utils/wal).
+ *
+ * bench: várias threads "verificam" linhas de 9 células, como os jogadores no servidor, sem WAL,
+ * com o WAL (cada linha só é copiada para o buffer; a thread de commit faz um fdatasync por grupo)
+ * e com um write e um fdatasync por linha, que é o que o WAL evita. Imprime linhas/s de cada um,
+ * os commits e os registos por commit.
+ *
+ * crash: em cada ronda, um processo filho escreve registos numerados no WAL e vai dizendo ao pai,
+ * por um pipe, quantos já estão no disco (depois de um walFlush). O pai mata-o com SIGKILL num
+ * instante aleatório e às vezes junta ao ficheiro um registo meio escrito, como um crash a meio de
+ * um commit. A leitura tem de devolver os registos pela ordem, intactos, pelo menos até ao último
+ * número confirmado, e parar no registo incompleto.
+ *
+ * Uso: ./wal-bench.exe bench [linhas] [threads] [ficheiro]
+ *      ./wal-bench.exe crash [rondas] [ficheiro]
+ */
+
+#define BENCH_SIZE 9
+#define CRASH_FLUSH_EVERY 64
+
+typedef enum { MODE_OFF, MODE_WAL, MODE_SYNC } BenchMode;
+
+// the line record of the server: a header, the row, the current line and the cells
+typedef struct {
+    unsigned char type;
+    unsigned char reserved[3];
+    int roomID;
+    long long timestamp;
+    int row;
+    int currentLine;
+    char cells[BENCH_SIZE];
+} BenchLine;
+
+typedef struct {
+    BenchMode mode;
+    Wal *wal;
+    int fd;
+    pthread_mutex_t *syncMutex;
+    int roomID;
+    int numLines;
+    long correct;
+} BenchWorker;
+
+static double elapsedSeconds(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void *benchLines(void *arg) {
+
+    BenchWorker *worker = (BenchWorker *)arg;
+    char solution[BENCH_SIZE][BENCH_SIZE];
+    char board[BENCH_SIZE][BENCH_SIZE];
+
+    for (int row = 0; row < BENCH_SIZE; row++) {
+        for (int col = 0; col < BENCH_SIZE; col++) {
+            solution[row][col] = (row * 3 + row / 3 + col) % BENCH_SIZE + 1;
+        }
+    }
+    memset(board, 0, sizeof(board));
+
+    for (int i = 0; i < worker->numLines; i++) {
+
+        int row = i % BENCH_SIZE;
+
+        // the verification: merge the right cells of a line with one wrong cell every other time
+        char line[BENCH_SIZE];
+        memcpy(line, solution[row], BENCH_SIZE);
+        if (i & 1) {
+            line[i % BENCH_SIZE] = 0;
+        }
+        bool isCorrect = true;
+        for (int col = 0; col < BENCH_SIZE; col++) {
+            if (line[col] == solution[row][col]) {
+                board[row][col] = line[col];
+            } else {
+                isCorrect = false;
+            }
+        }
+        worker->correct += isCorrect;
+
+        if (worker->mode == MODE_OFF) {
+            continue;
+        }
+
+        BenchLine record;
+        memset(&record, 0, sizeof(record));
+        record.type = 3;
+        record.roomID = worker->roomID;
+        record.timestamp = i;
+        record.row = row;
+        record.currentLine = row + 1 + isCorrect;
+        memcpy(record.cells, board[row], BENCH_SIZE);
+
+        if (worker->mode == MODE_WAL) {
+            walAppend(worker->wal, &record, sizeof(record));
+        } else {
+            // every line waits for its own sync
+            pthread_mutex_lock(worker->syncMutex);
+            if (write(worker->fd, &record, sizeof(record)) != sizeof(record) || fdatasync(worker->fd) != 0) {
+                perror("write");
+            }
+            pthread_mutex_unlock(worker->syncMutex);
+        }
+    }
+
+    return NULL;
+}
+
+static double runBench(BenchMode mode, int numLines, int numThreads, const char *path, Wal *wal) {
+
+    pthread_mutex_t syncMutex = PTHREAD_MUTEX_INITIALIZER;
+    int fd = -1;
+
+    if (mode == MODE_WAL && !openWal(wal, path, true)) {
+        perror(path);
+        exit(1);
+    }
+    if (mode == MODE_SYNC) {
+        fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+        if (fd < 0) {
+            perror(path);
+            exit(1);
+        }
+    }
+
+    pthread_t threads[numThreads];
+    BenchWorker workers[numThreads];
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (int t = 0; t < numThreads; t++) {
+        workers[t].mode = mode;
+        workers[t].wal = wal;
+        workers[t].fd = fd;
+        workers[t].syncMutex = &syncMutex;
+        workers[t].roomID = t + 1;
+        workers[t].numLines = numLines / numThreads;
+        workers[t].correct = 0;
+        pthread_create(&threads[t], NULL, benchLines, &workers[t]);
+    }
+    for (int t = 0; t < numThreads; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    // the lines only count once they are on disk
+    if (mode == MODE_WAL) {
+        walFlush(wal);
+    }
+
+    double seconds = elapsedSeconds(&start);
+
+    if (mode == MODE_WAL) {
+        closeWal(wal);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+
+    return (numLines / numThreads) * numThreads / seconds;
+}
+
+static int bench(int numLines, int numThreads, const char *path) {
+
+    Wal wal;
+
+    double offRate = runBench(MODE_OFF, numLines, numThreads, path, &wal);
+    double walRate = runBench(MODE_WAL, numLines, numThreads, path, &wal);
+    long records = wal.appendedRecords;
+    long commits = wal.commits;
+    long fullWaits = wal.fullWaits;
+
+    // a sync per line is slow: fewer lines are enough to measure it
+    int syncLines = numLines < 2000 ? numLines : 2000;
+    double syncRate = runBench(MODE_SYNC, syncLines, numThreads, path, &wal);
+
+    unlink(path);
+
+    printf("%d linhas, %d threads, %s\n", numLines, numThreads, path);
+    printf("sem WAL:              %12.0f linhas/s\n", offRate);
+    printf("com WAL:              %12.0f linhas/s (%ld commits, %.1f registos por commit, %ld esperas por buffer)\n",
+           walRate, commits, commits > 0 ? (double)records / commits : 0, fullWaits);
+    printf("fdatasync por linha:  %12.0f linhas/s (%d linhas)\n", syncRate, syncLines);
+
+    return 0;
+}
+
+// record number `seq`: its number, then bytes that depend on it, 16 to 215 bytes long
+static uint32_t fillCrashRecord(char *record, uint64_t seq) {
+
+    uint32_t length = 16 + seq % 200;
+
+    memset(record, 0, length);
+    memcpy(record, &seq, sizeof(seq));
+    for (uint32_t i = sizeof(seq); i < length; i++) {
+        record[i] = (char)((seq * 31 + i) & 0xff);
+    }
+
+    return length;
+}
+
+// the child: append numbered records forever, telling the parent every durable count
+static void crashWriter(const char *path, int reportFd) {
+
+    Wal wal;
+    if (!openWal(&wal, path, true)) {
+        _exit(1);
+    }
+
+    char record[256];
+
+    for (uint64_t seq = 0; ; seq++) {
+
+        walAppend(&wal, record, fillCrashRecord(record, seq));
+
+        if ((seq + 1) % CRASH_FLUSH_EVERY == 0) {
+            walFlush(&wal);
+            uint64_t durable = seq + 1;
+            if (write(reportFd, &durable, sizeof(durable)) != sizeof(durable)) {
+                _exit(1);
+            }
+        }
+    }
+}
+
+static int crash(int numRounds, const char *path) {
+
+    srand(time(NULL));
+
+    long totalRecords = 0;
+    int numTorn = 0;
+
+    for (int round = 0; round < numRounds; round++) {
+
+        int reportPipe[2];
+        if (pipe(reportPipe) != 0) {
+            perror("pipe");
+            return 1;
+        }
+
+        pid_t child = fork();
+        if (child < 0) {
+            perror("fork");
+            return 1;
+        }
+        if (child == 0) {
+            close(reportPipe[0]);
+            crashWriter(path, reportPipe[1]);
+        }
+        close(reportPipe[1]);
+
+        // the crash can come at any point of a commit
+        usleep(2000 + rand() % 40000);
+        kill(child, SIGKILL);
+        waitpid(child, NULL, 0);
+
+        uint64_t durable = 0;
+        uint64_t reported;
+        while (read(reportPipe[0], &reported, sizeof(reported)) == sizeof(reported)) {
+            durable = reported;
+        }
+        close(reportPipe[0]);
+
+        // every other round, a commit cut short: a header and part of its record
+        bool isTorn = round % 2 == 1;
+        if (isTorn) {
+            int fd = open(path, O_WRONLY | O_APPEND);
+            WalRecordHeader header = { 200, 12345 };
+            char partial[50];
+            memset(partial, 0x5a, sizeof(partial));
+            if (fd < 0 || write(fd, &header, sizeof(header)) != sizeof(header) || write(fd, partial, sizeof(partial)) != sizeof(partial)) {
+                perror(path);
+                return 1;
+            }
+            close(fd);
+        }
+
+        WalReader reader;
+        if (!openWalReader(&reader, path)) {
+            perror(path);
+            return 1;
+        }
+
+        char record[WAL_MAX_RECORD];
+        char expected[256];
+        uint32_t length;
+        uint64_t seq = 0;
+
+        while (nextWalRecord(&reader, record, sizeof(record), &length) == WAL_RECORD) {
+            uint32_t expectedLength = fillCrashRecord(expected, seq);
+            if (length != expectedLength || memcmp(record, expected, length) != 0) {
+                printf("ronda %d: registo %lu errado\n", round, (unsigned long)seq);
+                return 1;
+            }
+            seq++;
+        }
+
+        bool readTorn = reader.isTorn;
+        closeWalReader(&reader);
+
+        if (seq < durable) {
+            printf("ronda %d: so %lu registos lidos, %lu estavam no disco\n", round, (unsigned long)seq, (unsigned long)durable);
+            return 1;
+        }
+        if (isTorn && !readTorn) {
+            printf("ronda %d: o registo incompleto nao foi detetado\n", round);
+            return 1;
+        }
+
+        totalRecords += seq;
+        numTorn += readTorn;
+    }
+
+    unlink(path);
+
+    printf("%d rondas: %ld registos relidos pela ordem, nenhum confirmado perdido, %d finais incompletos ignorados\n",
+           numRounds, totalRecords, numTorn);
+
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        int numLines = argc > 2 ? atoi(argv[2]) : 1000000;
+        int numThreads = argc > 3 ? atoi(argv[3]) : 8;
+        const char *path = argc > 4 ? argv[4] : "wal-bench.wal";
+        if (numLines <= 0 || numThreads <= 0) {
+            fprintf(stderr, "Uso: %s bench [linhas] [threads] [ficheiro]\n", argv[0]);
+            return 1;
+        }
+        return bench(numLines, numThreads, path);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "crash") == 0) {
+        int numRounds = argc > 2 ? atoi(argv[2]) : 20;
+        const char *path = argc > 3 ? argv[3] : "wal-crash.wal";
+        if (numRounds <= 0) {
+            fprintf(stderr, "Uso: %s crash [rondas] [ficheiro]\n", argv[0]);
+            return 1;
+        }
+        return crash(numRounds, path);
+    }
+
+    fprintf(stderr, "Uso: %s bench [linhas] [threads] [ficheiro]\n       %s crash [rondas] [ficheiro]\n", argv[0], argv[0]);
+    return 1;
+}
@@ -0,0 +1,156 @@
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+#define ARENA_ALIGN 16
+
+// blocks handed out by arenaMalloc say where they came from, so arenaFree never frees arena memory
+#define BLOCK_FROM_MALLOC 0x6d616c6cUL
+#define BLOCK_FROM_ARENA  0x6172656eUL
+
+typedef struct {
+    _Alignas(ARENA_ALIGN) size_t owner;
+} BlockHeader;
+
+// arena of the request the thread is serving
+static __thread Arena *threadArena = NULL;
+
+static ArenaChunk *newChunk(size_t size) {
+
+    ArenaChunk *chunk = (ArenaChunk *)malloc(sizeof(ArenaChunk) + size);
+    if (chunk == NULL) {
+        return NULL;
+    }
+
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+
+    return chunk;
+}
+
+// free every chunk after `chunk`
+static void freeChunksAfter(ArenaChunk *chunk) {
+
+    ArenaChunk *next = chunk->next;
+    chunk->next = NULL;
+
+    while (next != NULL) {
+        ArenaChunk *temp = next->next;
+        free(next);
+        next = temp;
+    }
+}
+
+bool initArena(Arena *arena) {
+
+    memset(arena, 0, sizeof(Arena));
+
+    arena->first = newChunk(ARENA_CHUNK_SIZE);
+    if (arena->first == NULL) {
+        return false;
+    }
+
+    arena->current = arena->first;
+    arena->chunkAllocations = 1;
+
+    return true;
+}
+
+void *arenaAlloc(Arena *arena, size_t size) {
+
+    size = (size + ARENA_ALIGN - 1) & ~((size_t)ARENA_ALIGN - 1);
+
+    ArenaChunk *chunk = arena->current;
+
+    if (chunk->size - chunk->used < size) {
+        // a request bigger than a chunk gets a chunk of its own
+        chunk = newChunk(size > ARENA_CHUNK_SIZE ? size : ARENA_CHUNK_SIZE);
+        if (chunk == NULL) {
+            return NULL;
+        }
+        arena->current->next = chunk;
+        arena->current = chunk;
+        arena->chunkAllocations++;
+    }
+
+    void *ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    arena->allocations++;
+
+    return ptr;
+}
+
+ArenaMark arenaMark(Arena *arena) {
+
+    ArenaMark mark;
+    mark.chunk = arena->current;
+    mark.used = arena->current->used;
+
+    return mark;
+}
+
+void arenaRewind(Arena *arena, ArenaMark mark) {
+
+    freeChunksAfter(mark.chunk);
+    mark.chunk->used = mark.used;
+    arena->current = mark.chunk;
+}
+
+void arenaReset(Arena *arena) {
+
+    // a big request doesn't keep its memory after it ends
+    freeChunksAfter(arena->first);
+    arena->first->used = 0;
+    arena->current = arena->first;
+}
+
+void freeArena(Arena *arena) {
+
+    freeChunksAfter(arena->first);
+    free(arena->first);
+    arena->first = NULL;
+    arena->current = NULL;
+}
+
+void setThreadArena(Arena *arena) {
+    threadArena = arena;
+}
+
+Arena *getThreadArena(void) {
+    return threadArena;
+}
+
+void *arenaMalloc(size_t size) {
+
+    BlockHeader *header = NULL;
+
+    if (threadArena != NULL) {
+        header = (BlockHeader *)arenaAlloc(threadArena, sizeof(BlockHeader) + size);
+        if (header != NULL) {
+            header->owner = BLOCK_FROM_ARENA;
+            return header + 1;
+        }
+    }
+
+    // no arena on this thread (log writer, statistics, start-up) or no memory for a new chunk
+    header = (BlockHeader *)malloc(sizeof(BlockHeader) + size);
+    if (header == NULL) {
+        return NULL;
+    }
+    header->owner = BLOCK_FROM_MALLOC;
+
+    return header + 1;
+}
+
+void arenaFree(void *ptr) {
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    BlockHeader *header = (BlockHeader *)ptr - 1;
+    if (header->owner == BLOCK_FROM_MALLOC) {
+        free(header);
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/*
+ * Arena de blocos: as alocações avançam um ponteiro dentro de blocos grandes e nunca são
+ * libertadas uma a uma; o arena inteiro volta ao início de uma vez (arenaReset), ou até uma
+ * marca guardada antes (arenaRewind). Serve para a memória temporária de um pedido.
+ */
+
+#define ARENA_CHUNK_SIZE (64 * 1024) // first chunk, kept between resets
+
+typedef struct ArenaChunk {
+    struct ArenaChunk *next;
+    size_t size;
+    size_t used;
+    _Alignas(16) char data[];
+} ArenaChunk;
+
+typedef struct {
+    ArenaChunk *first;
+    ArenaChunk *current;
+    long allocations;      // arenaAlloc calls since the start
+    long chunkAllocations; // chunks taken from malloc since the start
+} Arena;
+
+// position of the arena, to give back everything allocated after it
+typedef struct {
+    ArenaChunk *chunk;
+    size_t used;
+} ArenaMark;
+
+// Inicia um arena com um bloco de ARENA_CHUNK_SIZE bytes (false se o malloc falhar).
+bool initArena(Arena *arena);
+
+// Reserva `size` bytes alinhados a 16 (NULL se o malloc de um bloco novo falhar).
+void *arenaAlloc(Arena *arena, size_t size);
+
+// Guarda a posição atual do arena.
+ArenaMark arenaMark(Arena *arena);
+
+// Liberta tudo o que foi reservado depois da marca.
+void arenaRewind(Arena *arena, ArenaMark mark);
+
+// Liberta tudo o que foi reservado; só o primeiro bloco fica guardado para o pedido seguinte.
+void arenaReset(Arena *arena);
+
+// Liberta os blocos do arena.
+void freeArena(Arena *arena);
+
+// Define o arena da thread atual (NULL para voltar ao malloc).
+void setThreadArena(Arena *arena);
+
+// Devolve o arena da thread atual, ou NULL.
+Arena *getThreadArena(void);
+
+// malloc para código que não recebe o arena (parson, listagens): usa o arena da thread se houver.
+void *arenaMalloc(size_t size);
+
+// free correspondente: só liberta a memória que veio do malloc; a do arena volta no reset.
+void arenaFree(void *ptr);
+
+#endif // ARENA_H
@@ -0,0 +1,145 @@
+#include "board.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+int boardBoxSize(int size) {
+
+    for (int box = 2; box * box <= BOARD_MAX_SIZE; box++) {
+        if (box * box == size) {
+            return box;
+        }
+    }
+
+    return 0;
+}
+
+char encodeCell(int value) {
+    return value < 10 ? '0' + value : 'A' + value - 10;
+}
+
+int encodeBoardCells(char *out, const char (*board)[BOARD_ROW_STRIDE], int size) {
+
+    int used = 0;
+
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            out[used++] = encodeCell(board[i][j]);
+        }
+    }
+
+    return used;
+}
+
+int decodeCell(char c) {
+
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c < 'A' + BOARD_MAX_SIZE - 9) {
+        return c - 'A' + 10;
+    }
+    if (c >= 'a' && c < 'a' + BOARD_MAX_SIZE - 9) {
+        return c - 'a' + 10;
+    }
+
+    return -1;
+}
+
+bool boardRowsEqual(const char *row, const char *other) {
+
+#if defined(__AVX2__)
+    __m256i a = _mm256_loadu_si256((const __m256i *)row);
+    __m256i b = _mm256_loadu_si256((const __m256i *)other);
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)) == -1;
+#elif defined(__SSE2__)
+    __m128i low = _mm_cmpeq_epi8(_mm_load_si128((const __m128i *)row), _mm_load_si128((const __m128i *)other));
+    __m128i high = _mm_cmpeq_epi8(_mm_load_si128((const __m128i *)(row + 16)), _mm_load_si128((const __m128i *)(other + 16)));
+    return _mm_movemask_epi8(_mm_and_si128(low, high)) == 0xFFFF;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    uint8x16_t low = vceqq_u8(vld1q_u8((const uint8_t *)row), vld1q_u8((const uint8_t *)other));
+    uint8x16_t high = vceqq_u8(vld1q_u8((const uint8_t *)row + 16), vld1q_u8((const uint8_t *)other + 16));
+    return vminvq_u8(vandq_u8(low, high)) == 0xFF;
+#else
+    for (int i = 0; i < BOARD_ROW_STRIDE; i++) {
+        if (row[i] != other[i]) {
+            return false;
+        }
+    }
+    return true;
+#endif
+}
+
+#if defined(__ARM_NEON) && defined(__aarch64__) && !defined(__SSE2__)
+// one bit per byte of a comparison result, like movemask on x86
+static uint16_t neonMask(uint8x16_t equal) {
+    static const uint8_t weights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16_t bits = vandq_u8(equal, vld1q_u8(weights));
+    bits = vpaddq_u8(bits, bits);
+    bits = vpaddq_u8(bits, bits);
+    bits = vpaddq_u8(bits, bits);
+    return vgetq_lane_u16(vreinterpretq_u16_u8(bits), 0);
+}
+#endif
+
+uint32_t mergeBoardRow(char *row, const char *solution, const char *submitted) {
+
+#if defined(__AVX2__)
+    __m256i current = _mm256_loadu_si256((const __m256i *)row);
+    __m256i expected = _mm256_loadu_si256((const __m256i *)solution);
+    __m256i sent = _mm256_loadu_si256((const __m256i *)submitted);
+
+    current = _mm256_blendv_epi8(current, sent, _mm256_cmpeq_epi8(sent, expected));
+    _mm256_storeu_si256((__m256i *)row, current);
+
+    return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(current, expected));
+#elif defined(__SSE2__)
+    uint32_t mask = 0;
+
+    for (int half = 0; half < BOARD_ROW_STRIDE; half += 16) {
+        __m128i current = _mm_load_si128((const __m128i *)(row + half));
+        __m128i expected = _mm_load_si128((const __m128i *)(solution + half));
+        __m128i sent = _mm_load_si128((const __m128i *)(submitted + half));
+
+        // take the sent byte where it matches the solution, keep the current one elsewhere
+        __m128i match = _mm_cmpeq_epi8(sent, expected);
+        current = _mm_or_si128(_mm_and_si128(match, sent), _mm_andnot_si128(match, current));
+        _mm_store_si128((__m128i *)(row + half), current);
+
+        mask |= (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(current, expected)) << half;
+    }
+
+    return mask;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    uint32_t mask = 0;
+
+    for (int half = 0; half < BOARD_ROW_STRIDE; half += 16) {
+        uint8x16_t current = vld1q_u8((const uint8_t *)row + half);
+        uint8x16_t expected = vld1q_u8((const uint8_t *)solution + half);
+        uint8x16_t sent = vld1q_u8((const uint8_t *)submitted + half);
+
+        current = vbslq_u8(vceqq_u8(sent, expected), sent, current);
+        vst1q_u8((uint8_t *)row + half, current);
+
+        mask |= (uint32_t)neonMask(vceqq_u8(current, expected)) << half;
+    }
+
+    return mask;
+#else
+    uint32_t mask = 0;
+
+    for (int i = 0; i < BOARD_ROW_STRIDE; i++) {
+        if (submitted[i] == solution[i]) {
+            row[i] = submitted[i];
+        }
+        mask |= (uint32_t)(row[i] == solution[i]) << i;
+    }
+
+    return mask;
+#endif
+}
@@ -0,0 +1,38 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Tabuleiros NxN (4x4, 9x9, 16x16 e 25x25). Cada linha ocupa BOARD_ROW_STRIDE bytes, com o
+ * espaço a seguir à última célula a zeros, para que uma linha seja comparada com um só
+ * vetor de 32 bytes (ou dois de 16). Nas mensagens, cada célula é um carácter:
+ * '0' para vazia, '1'-'9' e depois 'A'-'P' para os valores 10 a 25.
+ */
+
+#define BOARD_MAX_SIZE 25
+#define BOARD_ROW_STRIDE 32
+#define BOARD_ROW_COMPLETE 0xFFFFFFFFu // every byte of the row matches the solution
+#define BOARD_LINE_MESSAGE_SIZE (BOARD_MAX_SIZE + 2) // a row as the client sends it (cells and its '\0') and our own '\0'
+
+// side of the boxes of a board (0 if the size isn't supported)
+int boardBoxSize(int size);
+
+// cell value to message character
+char encodeCell(int value);
+
+// message character to cell value (-1 if the character isn't a cell)
+int decodeCell(char c);
+
+// write the size x size cells of a board, row after row, one character each; returns the number written
+int encodeBoardCells(char *out, const char (*board)[BOARD_ROW_STRIDE], int size);
+
+// compare two rows of BOARD_ROW_STRIDE bytes (both must be 16-byte aligned)
+bool boardRowsEqual(const char *row, const char *other);
+
+// copy the submitted cells that match the solution into row (all rows 16-byte aligned); returns the mask of the
+// cells of row that now match (BOARD_ROW_COMPLETE when the row is solved)
+uint32_t mergeBoardRow(char *row, const char *solution, const char *submitted);
+
+#endif // BOARD_H
@@ -0,0 +1,158 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "epoch.h"
+
+#define EPOCH_IDLE 0 // slot of a thread outside any read section
+
+typedef struct {
+    _Alignas(64) atomic_ulong epoch; // epoch announced on entry, EPOCH_IDLE outside
+    atomic_bool isTaken;
+} ReaderSlot;
+
+typedef struct RetiredObject {
+    void *object;
+    void (*freeObject)(void *);
+    unsigned long epoch; // readers announcing this epoch or an older one may still see it
+    struct RetiredObject *next;
+} RetiredObject;
+
+static ReaderSlot readerSlots[EPOCH_MAX_READERS];
+static atomic_ulong globalEpoch = 1;
+
+// readers without a slot: while any is inside, nothing is reclaimed
+static atomic_int sharedReaders = 0;
+
+static pthread_mutex_t retiredMutex = PTHREAD_MUTEX_INITIALIZER;
+static RetiredObject *retiredObjects = NULL;
+
+// gives the slot back when its thread exits (room threads come and go)
+static pthread_key_t slotKey;
+static pthread_once_t slotKeyOnce = PTHREAD_ONCE_INIT;
+
+static __thread int readerSlot = -1;
+static __thread int readerDepth = 0;
+static __thread bool isSharedReader = false;
+
+static void releaseSlot(void *value) {
+
+    int slot = (int)(intptr_t)value - 1;
+
+    atomic_store(&readerSlots[slot].epoch, EPOCH_IDLE);
+    atomic_store(&readerSlots[slot].isTaken, false);
+}
+
+static void createSlotKey(void) {
+    pthread_key_create(&slotKey, releaseSlot);
+}
+
+static int takeSlot(void) {
+
+    pthread_once(&slotKeyOnce, createSlotKey);
+
+    for (int slot = 0; slot < EPOCH_MAX_READERS; slot++) {
+        bool isTaken = false;
+        if (!atomic_load(&readerSlots[slot].isTaken) && atomic_compare_exchange_strong(&readerSlots[slot].isTaken, &isTaken, true)) {
+            pthread_setspecific(slotKey, (void *)(intptr_t)(slot + 1));
+            return slot;
+        }
+    }
+
+    return -1;
+}
+
+void epochEnter(void) {
+
+    if (readerDepth++ > 0) {
+        return;
+    }
+
+    if (readerSlot < 0) {
+        readerSlot = takeSlot();
+    }
+
+    if (readerSlot < 0) {
+        isSharedReader = true;
+        atomic_fetch_add(&sharedReaders, 1);
+        return;
+    }
+
+    // announced before the shared pointer is read, so a retire after this waits for us
+    atomic_store(&readerSlots[readerSlot].epoch, atomic_load(&globalEpoch));
+}
+
+void epochLeave(void) {
+
+    if (--readerDepth > 0) {
+        return;
+    }
+
+    if (isSharedReader) {
+        isSharedReader = false;
+        atomic_fetch_sub(&sharedReaders, 1);
+        return;
+    }
+
+    atomic_store(&readerSlots[readerSlot].epoch, EPOCH_IDLE);
+}
+
+bool epochRetire(void *object, void (*freeObject)(void *)) {
+
+    RetiredObject *retired = (RetiredObject *)malloc(sizeof(RetiredObject));
+    if (retired == NULL) {
+        return false;
+    }
+
+    retired->object = object;
+    retired->freeObject = freeObject;
+
+    // readers entering from now on announce a newer epoch and can only see the new object
+    retired->epoch = atomic_fetch_add(&globalEpoch, 1);
+
+    pthread_mutex_lock(&retiredMutex);
+    retired->next = retiredObjects;
+    retiredObjects = retired;
+    pthread_mutex_unlock(&retiredMutex);
+
+    return true;
+}
+
+int epochReclaim(void) {
+
+    pthread_mutex_lock(&retiredMutex);
+
+    // the oldest epoch announced by a reader still inside a section
+    unsigned long oldestEpoch = atomic_load(&globalEpoch) + 1;
+    for (int slot = 0; slot < EPOCH_MAX_READERS; slot++) {
+        unsigned long epoch = atomic_load(&readerSlots[slot].epoch);
+        if (epoch != EPOCH_IDLE && epoch < oldestEpoch) {
+            oldestEpoch = epoch;
+        }
+    }
+
+    // a reader without a slot may have entered at any epoch
+    if (atomic_load(&sharedReaders) > 0) {
+        oldestEpoch = EPOCH_IDLE;
+    }
+
+    int numWaiting = 0;
+    RetiredObject **link = &retiredObjects;
+
+    while (*link != NULL) {
+        RetiredObject *retired = *link;
+
+        if (retired->epoch < oldestEpoch) {
+            *link = retired->next;
+            retired->freeObject(retired->object);
+            free(retired);
+        } else {
+            link = &retired->next;
+            numWaiting++;
+        }
+    }
+
+    pthread_mutex_unlock(&retiredMutex);
+
+    return numWaiting;
+}
@@ -0,0 +1,27 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <stdbool.h>
+
+/*
+ * Reclamação por épocas: os leitores marcam a época em que entram numa secção de leitura,
+ * sem locks; quem substitui um objeto publicado retira o antigo, que só é libertado quando
+ * todos os leitores que o podiam ter visto saíram. Os leitores nunca esperam pelo escritor
+ * nem o escritor pelos leitores: um objeto ainda em uso fica na lista até à próxima tentativa.
+ */
+
+#define EPOCH_MAX_READERS 1024 // threads with a slot of their own; the rest share one counter
+
+// Começa uma secção de leitura (pode ser aninhada): o que for lido a partir daqui não é libertado até epochLeave.
+void epochEnter(void);
+
+// Acaba a secção de leitura começada por epochEnter.
+void epochLeave(void);
+
+// Retira um objeto que já não está publicado; é libertado com `freeObject` quando nenhum leitor o puder ver.
+bool epochRetire(void *object, void (*freeObject)(void *));
+
+// Liberta os objetos retirados que já nenhum leitor vê; devolve quantos continuam à espera.
+int epochReclaim(void);
+
+#endif // EPOCH_H
@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "gamedb.h"
+
+_Static_assert(sizeof(GameDBHeader) == 24, "unexpected GameDBHeader layout");
+_Static_assert(sizeof(GameDBRecord) == 96, "unexpected GameDBRecord layout");
+
+void packCells(const char cells[9][9], uint8_t packed[GAMEDB_PACKED_CELLS]) {
+
+    memset(packed, 0, GAMEDB_PACKED_CELLS);
+
+    for (int i = 0; i < 81; i++) {
+        uint8_t value = (uint8_t)cells[i / 9][i % 9] & 0x0F;
+
+        // even cells go to the low nibble, odd cells to the high nibble
+        packed[i / 2] |= (i % 2 == 0) ? value : (uint8_t)(value << 4);
+    }
+}
+
+void unpackCells(const uint8_t packed[GAMEDB_PACKED_CELLS], char cells[9][9]) {
+
+    for (int i = 0; i < 81; i++) {
+        uint8_t byte = packed[i / 2];
+        cells[i / 9][i % 9] = (i % 2 == 0) ? (byte & 0x0F) : (byte >> 4);
+    }
+}
+
+int openGameDB(GameDB *db, const char *path) {
+
+    memset(db, 0, sizeof(GameDB));
+
+    // open read-write so that records can be updated with pwrite; the mapping itself is read-only
+    db->fd = open(path, O_RDWR);
+    if (db->fd < 0) {
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(db->fd, &st) < 0 || st.st_size < (off_t)sizeof(GameDBHeader)) {
+        close(db->fd);
+        db->fd = -1; // a later closeGameDB must not close a descriptor reused since
+        return -1;
+    }
+
+    db->mapSize = st.st_size;
+    db->map = mmap(NULL, db->mapSize, PROT_READ, MAP_SHARED, db->fd, 0);
+    if (db->map == MAP_FAILED) {
+        close(db->fd);
+        db->fd = -1;
+        db->map = NULL;
+        return -1;
+    }
+
+    db->header = (const GameDBHeader *)db->map;
+
+    // validate the header before trusting the records
+    if (memcmp(db->header->magic, GAMEDB_MAGIC, sizeof(db->header->magic)) != 0 ||
+        db->header->version != GAMEDB_VERSION ||
+        db->header->recordSize != sizeof(GameDBRecord) ||
+        sizeof(GameDBHeader) + (size_t)db->header->numRecords * sizeof(GameDBRecord) > db->mapSize) {
+        closeGameDB(db);
+        return -1;
+    }
+
+    db->records = (const GameDBRecord *)((const char *)db->map + sizeof(GameDBHeader));
+    db->numRecords = db->header->numRecords;
+
+    return 0;
+}
+
+void closeGameDB(GameDB *db) {
+
+    if (db->map != NULL && db->map != MAP_FAILED) {
+        munmap(db->map, db->mapSize);
+    }
+
+    if (db->fd >= 0) {
+        close(db->fd);
+    }
+
+    memset(db, 0, sizeof(GameDB));
+    db->fd = -1;
+}
+
+const GameDBRecord *findGameRecord(const GameDB *db, int gameID) {
+
+    // IDs are usually 1..N, so the record is at index ID - 1
+    if (gameID >= 1 && gameID <= db->numRecords && db->records[gameID - 1].id == gameID) {
+        return &db->records[gameID - 1];
+    }
+
+    // records are sorted by ID
+    int low = 0;
+    int high = db->numRecords - 1;
+
+    while (low <= high) {
+        int middle = low + (high - low) / 2;
+        int id = db->records[middle].id;
+
+        if (id == gameID) {
+            return &db->records[middle];
+        } else if (id < gameID) {
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+
+    return NULL;
+}
+
+int updateGameRecord(GameDB *db, const GameDBRecord *record, int32_t timeRecord, float accuracyRecord) {
+
+    // timeRecord and accuracyRecord are contiguous at the end of the record
+    struct {
+        int32_t timeRecord;
+        float accuracyRecord;
+    } records = { timeRecord, accuracyRecord };
+
+    off_t offset = (const char *)&record->timeRecord - (const char *)db->map;
+
+    if (pwrite(db->fd, &records, sizeof(records), offset) != (ssize_t)sizeof(records)) {
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,62 @@
+#ifndef GAMEDB_H
+#define GAMEDB_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Base de dados binária de jogos: um cabeçalho seguido de registos de tamanho fixo,
+ * ordenados por ID. Os tabuleiros 9x9 são guardados com 4 bits por célula (41 bytes).
+ * O ficheiro é escrito por 'gamedb-convert' e mapeado em memória só de leitura pelo servidor.
+ */
+
+#define GAMEDB_MAGIC "SUDOKUDB"
+#define GAMEDB_VERSION 1
+#define GAMEDB_PACKED_CELLS 41
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t numRecords;
+    uint32_t reserved;
+} GameDBHeader;
+
+typedef struct {
+    int32_t id;
+    uint8_t difficulty;
+    uint8_t board[GAMEDB_PACKED_CELLS];
+    uint8_t solution[GAMEDB_PACKED_CELLS];
+    uint8_t reserved;
+    int32_t timeRecord;
+    float accuracyRecord;
+} GameDBRecord;
+
+typedef struct {
+    int fd;
+    void *map;
+    size_t mapSize;
+    const GameDBHeader *header;
+    const GameDBRecord *records;
+    int numRecords;
+} GameDB;
+
+// pack a 9x9 board into 41 bytes (4 bits per cell)
+void packCells(const char cells[9][9], uint8_t packed[GAMEDB_PACKED_CELLS]);
+
+// unpack 41 bytes into a 9x9 board
+void unpackCells(const uint8_t packed[GAMEDB_PACKED_CELLS], char cells[9][9]);
+
+// map a database file read-only (returns 0 on success, -1 on error)
+int openGameDB(GameDB *db, const char *path);
+
+// unmap a database file
+void closeGameDB(GameDB *db);
+
+// find the record of a game by ID (O(1) for dense IDs, binary search otherwise)
+const GameDBRecord *findGameRecord(const GameDB *db, int gameID);
+
+// write new records of a game in place (returns 0 on success, -1 on error)
+int updateGameRecord(GameDB *db, const GameDBRecord *record, int32_t timeRecord, float accuracyRecord);
+
+#endif // GAMEDB_H
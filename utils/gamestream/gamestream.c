@@ -0,0 +1,432 @@
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "gamestream.h"
+
+#define KEY_SIZE 32
+#define NUMBER_SIZE 64
+
+static bool refill(GameStream *stream) {
+
+    stream->position = 0;
+    stream->length = fread(stream->buffer, 1, sizeof(stream->buffer), stream->file);
+
+    return stream->length > 0;
+}
+
+static int peekByte(GameStream *stream) {
+
+    if (stream->position == stream->length && !refill(stream)) {
+        return EOF;
+    }
+
+    return (unsigned char)stream->buffer[stream->position];
+}
+
+// the next byte that isn't whitespace, without taking it
+static int peekToken(GameStream *stream) {
+
+    int c;
+    while ((c = peekByte(stream)) == ' ' || c == '\n' || c == '\r' || c == '\t') {
+        stream->position++;
+    }
+
+    return c;
+}
+
+static bool expect(GameStream *stream, char expected) {
+
+    if (peekToken(stream) != expected) {
+        return false;
+    }
+    stream->position++;
+
+    return true;
+}
+
+// read a string (the opening quote is next); out may be NULL to skip it, and long strings are cut
+static bool readString(GameStream *stream, char *out, size_t outSize) {
+
+    if (!expect(stream, '"')) {
+        return false;
+    }
+
+    size_t used = 0;
+
+    for (;;) {
+
+        int c = peekByte(stream);
+        if (c == EOF) {
+            return false;
+        }
+        stream->position++;
+
+        if (c == '"') {
+            break;
+        }
+
+        // keys are plain ASCII: an escape keeps the escaped byte (\uXXXX is kept as 'u' and skipped)
+        if (c == '\\') {
+            c = peekByte(stream);
+            if (c == EOF) {
+                return false;
+            }
+            stream->position++;
+        }
+
+        if (out != NULL && used + 1 < outSize) {
+            out[used++] = (char)c;
+        }
+    }
+
+    if (out != NULL && outSize > 0) {
+        out[used] = '\0';
+    }
+
+    return true;
+}
+
+static bool isNumberStart(int c) {
+    return c == '-' || (c >= '0' && c <= '9');
+}
+
+// read a number (integers without strtod)
+static bool readNumber(GameStream *stream, double *value) {
+
+    char text[NUMBER_SIZE];
+    size_t used = 0;
+    bool isInteger = true;
+    long long integer = 0;
+
+    int c;
+    while ((c = peekByte(stream)) != EOF && (isdigit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')) {
+
+        if (used + 1 == sizeof(text)) {
+            return false;
+        }
+        text[used++] = (char)c;
+        stream->position++;
+
+        if (isdigit(c)) {
+            integer = integer * 10 + (c - '0');
+        } else if (c != '-' || used > 1) {
+            isInteger = false;
+        }
+    }
+    text[used] = '\0';
+
+    if (used == 0 || (used == 1 && text[0] == '-')) {
+        return false;
+    }
+
+    if (isInteger && used < 19) {
+        *value = text[0] == '-' ? -(double)integer : (double)integer;
+    } else {
+        *value = strtod(text, NULL);
+    }
+
+    return true;
+}
+
+// skip any value (objects and arrays included) without keeping it
+static bool skipValue(GameStream *stream) {
+
+    int depth = 0;
+
+    do {
+        int c = peekToken(stream);
+
+        if (c == EOF) {
+            return false;
+        } else if (c == '"') {
+            if (!readString(stream, NULL, 0)) {
+                return false;
+            }
+        } else if (c == '{' || c == '[') {
+            stream->position++;
+            depth++;
+        } else if (c == '}' || c == ']') {
+            stream->position++;
+            if (--depth < 0) {
+                return false;
+            }
+        } else if (c == ',' || c == ':') {
+            if (depth == 0) {
+                return false;
+            }
+            stream->position++;
+        } else {
+            // number, true, false or null
+            bool isConsumed = false;
+            while ((c = peekByte(stream)) != EOF && (isalnum(c) || c == '-' || c == '+' || c == '.')) {
+                stream->position++;
+                isConsumed = true;
+            }
+            if (!isConsumed) {
+                return false;
+            }
+        }
+    } while (depth > 0);
+
+    return true;
+}
+
+// inside an object or array: 1 if another member follows (its ',' taken), 0 at the end (taken), -1 on error
+static int nextItem(GameStream *stream, bool *isFirst, char close) {
+
+    int c = peekToken(stream);
+
+    if (c == close) {
+        stream->position++;
+        return 0;
+    }
+
+    if (!*isFirst) {
+        if (c != ',') {
+            return -1;
+        }
+        stream->position++;
+    }
+    *isFirst = false;
+
+    return 1;
+}
+
+// inside an object: 1 with the next key read (and its ':'), 0 at the '}', -1 on error
+static int nextKey(GameStream *stream, bool *isFirst, char *key) {
+
+    int result = nextItem(stream, isFirst, '}');
+    if (result != 1) {
+        return result;
+    }
+
+    if (!readString(stream, key, KEY_SIZE) || !expect(stream, ':')) {
+        return -1;
+    }
+
+    return 1;
+}
+
+// a number member: a value of another type is skipped and `value` keeps its default, as in parson
+static bool readNumberMember(GameStream *stream, double *value) {
+
+    if (!isNumberStart(peekToken(stream))) {
+        return skipValue(stream);
+    }
+
+    return readNumber(stream, value);
+}
+
+// a matrix of numbers into cells; size is the number of rows if it's square, -1 if not
+static bool readMatrix(GameStream *stream, char (*cells)[BOARD_ROW_STRIDE], int *size) {
+
+    memset(cells, 0, sizeof(char) * BOARD_MAX_SIZE * BOARD_ROW_STRIDE);
+
+    if (peekToken(stream) != '[') {
+        *size = -1;
+        return skipValue(stream);
+    }
+    stream->position++;
+
+    int rows = 0;
+    int rowLength = -1;
+    bool isSquare = true;
+    bool isFirstRow = true;
+    int result;
+
+    while ((result = nextItem(stream, &isFirstRow, ']')) == 1) {
+
+        if (peekToken(stream) != '[') {
+            isSquare = false;
+            rows++;
+            if (!skipValue(stream)) {
+                return false;
+            }
+            continue;
+        }
+        stream->position++;
+
+        int cols = 0;
+        bool isFirstCol = true;
+        int colResult;
+
+        while ((colResult = nextItem(stream, &isFirstCol, ']')) == 1) {
+
+            if (!isNumberStart(peekToken(stream))) {
+                isSquare = false;
+                if (!skipValue(stream)) {
+                    return false;
+                }
+            } else {
+                double value;
+                if (!readNumber(stream, &value)) {
+                    return false;
+                }
+                if (rows < BOARD_MAX_SIZE && cols < BOARD_MAX_SIZE) {
+                    cells[rows][cols] = (char)value;
+                }
+            }
+            cols++;
+        }
+
+        if (colResult < 0) {
+            return false;
+        }
+
+        // every row as long as the first one
+        if (rowLength >= 0 && cols != rowLength) {
+            isSquare = false;
+        }
+        rowLength = cols;
+        rows++;
+    }
+
+    if (result < 0) {
+        return false;
+    }
+
+    *size = isSquare && rows <= BOARD_MAX_SIZE && (rows == 0 || rowLength == rows) ? rows : -1;
+
+    return true;
+}
+
+// the members of one game (the '{' is next)
+static bool readGame(GameStream *stream, GameRecord *record) {
+
+    record->id = 0;
+    record->size = 9;
+    record->difficulty = 0;
+    record->timeRecord = 0;
+    record->accuracyRecord = 0;
+    record->boardSize = 0;
+    record->solutionSize = 0;
+
+    if (!expect(stream, '{')) {
+        return false;
+    }
+
+    char key[KEY_SIZE];
+    bool isFirst = true;
+    int result;
+
+    while ((result = nextKey(stream, &isFirst, key)) == 1) {
+
+        double value = 0;
+        bool isRead;
+
+        if (strcmp(key, "id") == 0) {
+            isRead = readNumberMember(stream, &value);
+            record->id = (int)value;
+        } else if (strcmp(key, "size") == 0) {
+            isRead = readNumberMember(stream, &value);
+            record->size = (int)value;
+        } else if (strcmp(key, "difficulty") == 0) {
+            isRead = readNumberMember(stream, &value);
+            record->difficulty = (int)value;
+        } else if (strcmp(key, "timeRecord") == 0) {
+            isRead = readNumberMember(stream, &value);
+            record->timeRecord = (int)value;
+        } else if (strcmp(key, "accuracyRecord") == 0) {
+            isRead = readNumberMember(stream, &value);
+            record->accuracyRecord = (float)value;
+        } else if (strcmp(key, "board") == 0) {
+            isRead = readMatrix(stream, record->board, &record->boardSize);
+        } else if (strcmp(key, "solution") == 0) {
+            isRead = readMatrix(stream, record->solution, &record->solutionSize);
+        } else {
+            isRead = skipValue(stream);
+        }
+
+        if (!isRead) {
+            return false;
+        }
+    }
+
+    return result == 0;
+}
+
+bool openGameStream(GameStream *stream, const char *path) {
+
+    stream->file = fopen(path, "r");
+    if (stream->file == NULL) {
+        return false;
+    }
+
+    stream->position = 0;
+    stream->length = 0;
+    stream->isFirst = true;
+    stream->isFinished = false;
+
+    if (!expect(stream, '{')) {
+        closeGameStream(stream);
+        return false;
+    }
+
+    char key[KEY_SIZE];
+    bool isFirst = true;
+    int result;
+
+    while ((result = nextKey(stream, &isFirst, key)) == 1) {
+
+        if (strcmp(key, "games") == 0 && peekToken(stream) == '[') {
+            stream->position++;
+            return true;
+        }
+
+        if (!skipValue(stream)) {
+            closeGameStream(stream);
+            return false;
+        }
+    }
+
+    if (result < 0) {
+        closeGameStream(stream);
+        return false;
+    }
+
+    // a file without games
+    stream->isFinished = true;
+
+    return true;
+}
+
+int nextGameRecord(GameStream *stream, GameRecord *record) {
+
+    while (!stream->isFinished) {
+
+        int result = nextItem(stream, &stream->isFirst, ']');
+
+        if (result == 0) {
+            stream->isFinished = true;
+            break;
+        }
+
+        if (result < 0) {
+            return GAME_STREAM_ERROR;
+        }
+
+        // parson gives no object for other values in the array: they have no game
+        if (peekToken(stream) != '{') {
+            if (!skipValue(stream)) {
+                return GAME_STREAM_ERROR;
+            }
+            continue;
+        }
+
+        if (!readGame(stream, record)) {
+            return GAME_STREAM_ERROR;
+        }
+
+        return GAME_STREAM_RECORD;
+    }
+
+    return GAME_STREAM_END;
+}
+
+void closeGameStream(GameStream *stream) {
+
+    if (stream->file != NULL) {
+        fclose(stream->file);
+        stream->file = NULL;
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef GAMESTREAM_H
+#define GAMESTREAM_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "../board/board.h"
+
+/*
+ * Leitura em streaming do ficheiro 'games.json': em vez de construir a árvore de todos os jogos
+ * (como json_parse_file do parson), o ficheiro é lido em blocos e o array "games" é percorrido um
+ * jogo de cada vez, cada um escrito num registo compacto. A memória usada é a de um bloco e de um
+ * registo, qualquer que seja o número de jogos. As outras chaves do ficheiro e dos jogos são saltadas.
+ */
+
+#define GAME_STREAM_BUFFER_SIZE (16 * 1024)
+
+#define GAME_STREAM_RECORD 1
+#define GAME_STREAM_END 0
+#define GAME_STREAM_ERROR -1
+
+typedef struct {
+    int id;
+    int size;             // "size", 9 when missing
+    int difficulty;       // 0 when missing
+    int timeRecord;
+    float accuracyRecord;
+    int boardSize;        // rows of "board" when it is a square matrix, 0 when missing, -1 when malformed
+    int solutionSize;
+    char board[BOARD_MAX_SIZE][BOARD_ROW_STRIDE];
+    char solution[BOARD_MAX_SIZE][BOARD_ROW_STRIDE];
+} GameRecord;
+
+typedef struct {
+    FILE *file;
+    size_t position;
+    size_t length;
+    bool isFirst;    // no game read yet: the next one isn't preceded by a ','
+    bool isFinished;
+    char buffer[GAME_STREAM_BUFFER_SIZE];
+} GameStream;
+
+// Abre o ficheiro e avança até ao início do array "games" (false se o ficheiro não abre ou não é JSON válido).
+bool openGameStream(GameStream *stream, const char *path);
+
+// Lê o jogo seguinte: GAME_STREAM_RECORD, GAME_STREAM_END no fim do array ou GAME_STREAM_ERROR se o JSON estiver mal formado.
+int nextGameRecord(GameStream *stream, GameRecord *record);
+
+// Fecha o ficheiro.
+void closeGameStream(GameStream *stream);
+
+#endif // GAMESTREAM_H
@@ -0,0 +1,262 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "jsonwriter.h"
+
+// "00" to "99": two digits per division by 100
+static const char digitPairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// escape of each control character, as parson writes it (NULL: copied as it is)
+static const char *const controlEscapes[32] = {
+    "\\u0000", "\\u0001", "\\u0002", "\\u0003", "\\u0004", "\\u0005", "\\u0006", "\\u0007",
+    "\\b",     "\\t",     "\\n",     "\\u000b", "\\f",     "\\r",     "\\u000e", "\\u000f",
+    "\\u0010", "\\u0011", "\\u0012", "\\u0013", "\\u0014", "\\u0015", "\\u0016", "\\u0017",
+    "\\u0018", "\\u0019", "\\u001a", "\\u001b", "\\u001c", "\\u001d", "\\u001e", "\\u001f"
+};
+
+static void put(JsonWriter *writer, const char *text, size_t length) {
+
+    // always keep a byte for the final '\0'
+    if (writer->overflow || writer->size - writer->length <= length) {
+        writer->overflow = true;
+        return;
+    }
+
+    memcpy(writer->buf + writer->length, text, length);
+    writer->length += length;
+}
+
+static void putChar(JsonWriter *writer, char c) {
+    put(writer, &c, 1);
+}
+
+// the ',' between values of the same object or array
+static void beforeValue(JsonWriter *writer) {
+
+    if (writer->afterKey) {
+        writer->afterKey = false;
+        return;
+    }
+
+    if (writer->depth > 0) {
+        if (writer->hasItems[writer->depth - 1]) {
+            putChar(writer, ',');
+        }
+        writer->hasItems[writer->depth - 1] = true;
+    }
+}
+
+static void openContainer(JsonWriter *writer, char c) {
+
+    beforeValue(writer);
+
+    if (writer->depth == JSON_WRITER_MAX_DEPTH) {
+        writer->overflow = true;
+        return;
+    }
+
+    putChar(writer, c);
+    writer->hasItems[writer->depth++] = false;
+}
+
+static void closeContainer(JsonWriter *writer, char c) {
+
+    if (writer->depth > 0) {
+        writer->depth--;
+    }
+    putChar(writer, c);
+}
+
+static void putString(JsonWriter *writer, const char *value) {
+
+    putChar(writer, '"');
+
+    // copy runs of plain characters in one go
+    const char *run = value;
+    for (const char *c = value; *c != '\0'; c++) {
+
+        unsigned char uc = (unsigned char)*c;
+        const char *escape = NULL;
+
+        if (uc < 32) {
+            escape = controlEscapes[uc];
+        } else if (uc == '"') {
+            escape = "\\\"";
+        } else if (uc == '\\') {
+            escape = "\\\\";
+        } else if (uc == '/') {
+            escape = "\\/";
+        }
+
+        if (escape != NULL) {
+            put(writer, run, c - run);
+            put(writer, escape, strlen(escape));
+            run = c + 1;
+        }
+    }
+    put(writer, run, strlen(run));
+
+    putChar(writer, '"');
+}
+
+void jsonWriterInit(JsonWriter *writer, char *buf, size_t size) {
+
+    writer->buf = buf;
+    writer->size = size;
+    writer->length = 0;
+    writer->overflow = size == 0;
+    writer->afterKey = false;
+    writer->depth = 0;
+}
+
+void jsonBeginObject(JsonWriter *writer) {
+    openContainer(writer, '{');
+}
+
+void jsonEndObject(JsonWriter *writer) {
+    closeContainer(writer, '}');
+}
+
+void jsonBeginArray(JsonWriter *writer) {
+    openContainer(writer, '[');
+}
+
+void jsonEndArray(JsonWriter *writer) {
+    closeContainer(writer, ']');
+}
+
+void jsonKey(JsonWriter *writer, const char *key) {
+
+    beforeValue(writer);
+    putString(writer, key);
+    putChar(writer, ':');
+    writer->afterKey = true;
+}
+
+void jsonInt(JsonWriter *writer, long long value) {
+
+    beforeValue(writer);
+
+    char digits[24];
+    char *end = digits + sizeof(digits);
+    char *start = end;
+
+    unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+
+    while (magnitude >= 100) {
+        unsigned int pair = (unsigned int)(magnitude % 100) * 2;
+        magnitude /= 100;
+        start -= 2;
+        start[0] = digitPairs[pair];
+        start[1] = digitPairs[pair + 1];
+    }
+
+    if (magnitude >= 10) {
+        unsigned int pair = (unsigned int)magnitude * 2;
+        start -= 2;
+        start[0] = digitPairs[pair];
+        start[1] = digitPairs[pair + 1];
+    } else {
+        *--start = (char)('0' + magnitude);
+    }
+
+    if (value < 0) {
+        *--start = '-';
+    }
+
+    put(writer, start, end - start);
+}
+
+void jsonNumber(JsonWriter *writer, double value) {
+
+    // "%1.17g" writes every integer below 1e17 without exponent or decimals ("-0" for negative zero)
+    if (value > -1e17 && value < 1e17 && value == (double)(long long)value && !(value == 0 && signbit(value))) {
+        jsonInt(writer, (long long)value);
+        return;
+    }
+
+    beforeValue(writer);
+
+    char text[64];
+    int length = snprintf(text, sizeof(text), "%1.17g", value);
+    put(writer, text, length);
+}
+
+void jsonString(JsonWriter *writer, const char *value) {
+    beforeValue(writer);
+    putString(writer, value);
+}
+
+void jsonBool(JsonWriter *writer, bool value) {
+    beforeValue(writer);
+    put(writer, value ? "true" : "false", value ? 4 : 5);
+}
+
+void jsonNull(JsonWriter *writer) {
+    beforeValue(writer);
+    put(writer, "null", 4);
+}
+
+size_t jsonWriterFinish(JsonWriter *writer) {
+
+    if (writer->overflow) {
+        if (writer->size > 0) {
+            writer->buf[0] = '\0';
+        }
+        return 0;
+    }
+
+    writer->buf[writer->length] = '\0';
+    return writer->length;
+}
+
+void jsonBoard(JsonWriter *writer, int id, int size, const char *cells, size_t rowStride) {
+
+    jsonBeginObject(writer);
+    jsonKey(writer, "id");
+    jsonInt(writer, id);
+    jsonKey(writer, "size");
+    jsonInt(writer, size);
+    jsonKey(writer, "board");
+    jsonBeginArray(writer);
+
+    for (int i = 0; i < size; i++) {
+
+        const char *row = cells + i * rowStride;
+
+        // a row is at most "[" + 25 cells of two digits and their commas + "],": check the space once
+        if (writer->overflow || writer->size - writer->length <= (size_t)size * 3 + 3) {
+            writer->overflow = true;
+            return;
+        }
+
+        beforeValue(writer);
+        char *out = writer->buf + writer->length;
+        *out++ = '[';
+        for (int j = 0; j < size; j++) {
+            unsigned int value = (unsigned char)row[j];
+            if (j > 0) {
+                *out++ = ',';
+            }
+            if (value >= 10) {
+                *out++ = digitPairs[value * 2];
+            }
+            *out++ = digitPairs[value * 2 + 1];
+        }
+        *out++ = ']';
+        writer->length = out - writer->buf;
+    }
+
+    jsonEndArray(writer);
+    jsonEndObject(writer);
+}
@@ -0,0 +1,65 @@
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/*
+ * Escritor de JSON em streaming: escreve os valores diretamente num buffer dado por quem chama,
+ * sem construir uma árvore e sem alocar memória. O texto é igual, byte a byte, ao de
+ * json_serialize_to_string do parson (sem espaços, '/' escapado, números como "%1.17g").
+ * Se o buffer não chegar, o escritor fica em erro e jsonWriterFinish devolve 0.
+ */
+
+#define JSON_WRITER_MAX_DEPTH 16
+
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t length;
+    bool overflow;
+    bool afterKey;                              // the next value belongs to the key just written
+    bool hasItems[JSON_WRITER_MAX_DEPTH];       // the open object/array already has a value (needs a ',')
+    int depth;
+} JsonWriter;
+
+// Começa a escrever no buffer `buf` de `size` bytes.
+void jsonWriterInit(JsonWriter *writer, char *buf, size_t size);
+
+// Abre um objeto ('{').
+void jsonBeginObject(JsonWriter *writer);
+
+// Fecha o objeto aberto ('}').
+void jsonEndObject(JsonWriter *writer);
+
+// Abre um array ('[').
+void jsonBeginArray(JsonWriter *writer);
+
+// Fecha o array aberto (']').
+void jsonEndArray(JsonWriter *writer);
+
+// Escreve o nome do campo seguinte de um objeto.
+void jsonKey(JsonWriter *writer, const char *key);
+
+// Escreve um inteiro (tabela de pares de dígitos, sem printf).
+void jsonInt(JsonWriter *writer, long long value);
+
+// Escreve um número como o parson: inteiros pelo caminho rápido, os outros com "%1.17g".
+void jsonNumber(JsonWriter *writer, double value);
+
+// Escreve uma string com os escapes do parson.
+void jsonString(JsonWriter *writer, const char *value);
+
+// Escreve true ou false.
+void jsonBool(JsonWriter *writer, bool value);
+
+// Escreve null.
+void jsonNull(JsonWriter *writer);
+
+// Termina o texto com '\0'; devolve o seu tamanho (sem o '\0'), ou 0 se o buffer não chegou.
+size_t jsonWriterFinish(JsonWriter *writer);
+
+// Escreve {"id":<id>,"size":<size>,"board":[[...],...]}, o tabuleiro enviado aos clientes (células de 0 a 99).
+void jsonBoard(JsonWriter *writer, int id, int size, const char *cells, size_t rowStride);
+
+#endif // JSONWRITER_H
@@ -0,0 +1,125 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "logs-common.h"
+#include "logs-binary.h"
+
+static const char *eventNames[LOG_EVENT_COUNT] = {
+    [LOG_EVENT_TEXT] = "Mensagem",
+    [LOG_EVENT_SERVER_START] = EVENT_SERVER_START,
+    [LOG_EVENT_GAME_LOAD] = EVENT_GAME_LOAD,
+    [LOG_EVENT_GAME_NOT_LOAD] = EVENT_GAME_NOT_LOAD,
+    [LOG_EVENT_GAME_NOT_FOUND] = EVENT_GAME_NOT_FOUND,
+    [LOG_EVENT_BOARD_SHOW] = EVENT_BOARD_SHOW,
+    [LOG_EVENT_SOLUTION_SENT] = EVENT_SOLUTION_SENT,
+    [LOG_EVENT_SOLUTION_CORRECT] = EVENT_SOLUTION_CORRECT,
+    [LOG_EVENT_SOLUTION_INCORRECT] = EVENT_SOLUTION_INCORRECT,
+    [LOG_EVENT_GAME_OVER] = EVENT_GAME_OVER,
+    [LOG_EVENT_MESSAGE_SENT] = EVENT_MESSAGE_SERVER_SENT,
+    [LOG_EVENT_MESSAGE_NOT_SENT] = EVENT_MESSAGE_SERVER_NOT_SENT,
+    [LOG_EVENT_MESSAGE_RECEIVED] = EVENT_MESSAGE_SERVER_RECEIVED,
+    [LOG_EVENT_MESSAGE_NOT_RECEIVED] = EVENT_MESSAGE_SERVER_NOT_RECEIVED,
+    [LOG_EVENT_CONNECTION_ERROR] = EVENT_CONNECTION_SERVER_ERROR,
+    [LOG_EVENT_CONNECTION_ESTABLISHED] = EVENT_CONNECTION_SERVER_ESTABLISHED,
+    [LOG_EVENT_THREAD_ERROR] = EVENT_SERVER_THREAD_ERROR,
+    [LOG_EVENT_CONNECTION_FINISH] = EVENT_SERVER_CONNECTION_FINISH,
+    [LOG_EVENT_GAMES_SENT] = EVENT_SERVER_GAMES_SENT,
+    [LOG_EVENT_ROOM_NOT_CREATED] = EVENT_ROOM_NOT_CREATED,
+    [LOG_EVENT_ROOM_LOAD] = EVENT_ROOM_LOAD,
+    [LOG_EVENT_ROOM_NOT_LOAD] = EVENT_ROOM_NOT_LOAD,
+    [LOG_EVENT_ROOM_JOIN] = EVENT_ROOM_JOIN,
+    [LOG_EVENT_ROOM_NOT_JOIN] = EVENT_ROOM_NOT_JOIN,
+    [LOG_EVENT_ROOM_DELETE] = EVENT_ROOM_DELETE,
+    [LOG_EVENT_ROOM_NOT_DELETE] = EVENT_ROOM_NOT_DELETE,
+    [LOG_EVENT_NEW_RECORD] = EVENT_NEW_RECORD,
+    [LOG_EVENT_THREAD_NOT_CREATE] = EVENT_THREAD_NOT_CREATE,
+    [LOG_EVENT_BARBER_CREATED] = EVENT_BARBER_CREATED,
+    [LOG_EVENT_MEMORY_ERROR] = MEMORY_ERROR,
+    [LOG_EVENT_LINE_SENT] = "Linha enviada",
+    [LOG_EVENT_LINE_CORRECT] = "Linha certa",
+    [LOG_EVENT_LINE_INCORRECT] = "Linha errada",
+    [LOG_EVENT_BOARD_SENT] = "Tabuleiro enviado",
+    [LOG_EVENT_ACCURACY_RECEIVED] = "Accuracy recebida",
+    [LOG_EVENT_TIME_SENT] = "Tempo enviado",
+    [LOG_EVENT_ROOM_JOINED] = "Jogador juntou-se a sala",
+    [LOG_EVENT_TIMER_SENT] = "Tempo de espera enviado"
+};
+
+void fillLogRecord(LogRecord *record, LogEvent event, int gameID, int playerID, int value, const char *payload) {
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    record->timestamp = (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+    record->event = event;
+    record->gameID = gameID;
+    record->playerID = playerID;
+    record->value = value;
+
+    // the text is copied as it is, cut to the payload (no formatting)
+    size_t length = payload != NULL ? strnlen(payload, LOG_PAYLOAD_SIZE) : 0;
+    if (length > 0) {
+        memcpy(record->payload, payload, length);
+    }
+    memset(record->payload + length, 0, LOG_PAYLOAD_SIZE - length);
+    record->payloadLength = length;
+}
+
+LogEvent findLogEvent(const char *name) {
+
+    if (name == NULL) {
+        return LOG_EVENT_TEXT;
+    }
+
+    for (int event = 1; event < LOG_EVENT_COUNT; event++) {
+        if (eventNames[event] == name || strcmp(eventNames[event], name) == 0) {
+            return (LogEvent)event;
+        }
+    }
+
+    return LOG_EVENT_TEXT;
+}
+
+const char *getLogEventName(int event) {
+    return event >= 0 && event < LOG_EVENT_COUNT ? eventNames[event] : "Desconhecido";
+}
+
+void formatLogRecord(const LogRecord *record, char *message, int size) {
+
+    int length = record->payloadLength <= LOG_PAYLOAD_SIZE ? record->payloadLength : LOG_PAYLOAD_SIZE;
+
+    switch (record->event) {
+        case LOG_EVENT_LINE_SENT:
+            snprintf(message, size, "O jogador %d no jogo %d para a linha %d: %.*s", record->playerID, record->gameID, record->value, length, record->payload);
+            break;
+        case LOG_EVENT_LINE_CORRECT:
+            snprintf(message, size, "Linha enviada (%.*s) validada como CERTA", length, record->payload);
+            break;
+        case LOG_EVENT_LINE_INCORRECT:
+            snprintf(message, size, "Linha enviada (%.*s) validada como ERRADA/INCOMPLETA", length, record->payload);
+            break;
+        case LOG_EVENT_BOARD_SENT:
+            snprintf(message, size, "Tabuleiro enviado ao cliente (linha atual %d)", record->value);
+            break;
+        case LOG_EVENT_ACCURACY_RECEIVED:
+            snprintf(message, size, "A accuracy recebida foi de: %.2f %%", record->value / 100.0);
+            break;
+        case LOG_EVENT_TIME_SENT:
+            snprintf(message, size, "Time elapsed: %.2f seconds", record->value / 100.0);
+            break;
+        case LOG_EVENT_ROOM_JOINED:
+            snprintf(message, size, "Client %d joined room %d", record->playerID, record->value);
+            break;
+        case LOG_EVENT_TIMER_SENT:
+            snprintf(message, size, "Sent update to Client %d - Time left: %d seconds - Game ID: %d", record->playerID, record->value, record->gameID);
+            break;
+        default:
+            snprintf(message, size, "%.*s", length, record->payload);
+            break;
+    }
+}
+
+bool isLogFileHeader(const LogFileHeader *header) {
+    return memcmp(header->magic, LOG_FILE_MAGIC, sizeof(header->magic)) == 0 &&
+           header->version == LOG_FILE_VERSION && header->recordSize == sizeof(LogRecord);
+}
@@ -0,0 +1,94 @@
+#ifndef LOGS_BINARY_H
+#define LOGS_BINARY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Formato binário dos logs do servidor: um cabeçalho e registos de tamanho fixo, copiados tal
+ * como o produtor os preencheu (instante em ns, código do evento, jogo, jogador, um valor e um
+ * texto curto). O servidor nunca formata texto para os logs; o tools/log-decode converte o
+ * ficheiro para JSON ou CSV quando for preciso lê-lo.
+ */
+
+#define LOG_FILE_MAGIC "SUDOKLOG"
+#define LOG_FILE_VERSION 1
+#define LOG_PAYLOAD_SIZE 104 // bytes of text in a record (longer messages are cut)
+
+// Códigos dos eventos; só se acrescentam no fim, para os ficheiros antigos continuarem legíveis.
+typedef enum {
+    LOG_EVENT_TEXT = 0,             // a message without a known event
+    LOG_EVENT_SERVER_START,
+    LOG_EVENT_GAME_LOAD,
+    LOG_EVENT_GAME_NOT_LOAD,
+    LOG_EVENT_GAME_NOT_FOUND,
+    LOG_EVENT_BOARD_SHOW,
+    LOG_EVENT_SOLUTION_SENT,
+    LOG_EVENT_SOLUTION_CORRECT,
+    LOG_EVENT_SOLUTION_INCORRECT,
+    LOG_EVENT_GAME_OVER,
+    LOG_EVENT_MESSAGE_SENT,
+    LOG_EVENT_MESSAGE_NOT_SENT,
+    LOG_EVENT_MESSAGE_RECEIVED,
+    LOG_EVENT_MESSAGE_NOT_RECEIVED,
+    LOG_EVENT_CONNECTION_ERROR,
+    LOG_EVENT_CONNECTION_ESTABLISHED,
+    LOG_EVENT_THREAD_ERROR,
+    LOG_EVENT_CONNECTION_FINISH,
+    LOG_EVENT_GAMES_SENT,
+    LOG_EVENT_ROOM_NOT_CREATED,
+    LOG_EVENT_ROOM_LOAD,
+    LOG_EVENT_ROOM_NOT_LOAD,
+    LOG_EVENT_ROOM_JOIN,
+    LOG_EVENT_ROOM_NOT_JOIN,
+    LOG_EVENT_ROOM_DELETE,
+    LOG_EVENT_ROOM_NOT_DELETE,
+    LOG_EVENT_NEW_RECORD,
+    LOG_EVENT_THREAD_NOT_CREATE,
+    LOG_EVENT_BARBER_CREATED,
+    LOG_EVENT_MEMORY_ERROR,
+    LOG_EVENT_LINE_SENT,            // value: line number, payload: the line as received
+    LOG_EVENT_LINE_CORRECT,         // value: line number, payload: the line as received
+    LOG_EVENT_LINE_INCORRECT,       // value: line number, payload: the line as received
+    LOG_EVENT_BOARD_SENT,           // value: current line
+    LOG_EVENT_ACCURACY_RECEIVED,    // value: accuracy in hundredths of a percent
+    LOG_EVENT_TIME_SENT,            // value: game time in hundredths of a second
+    LOG_EVENT_ROOM_JOINED,          // value: room ID
+    LOG_EVENT_TIMER_SENT,           // value: seconds left in the waiting room
+    LOG_EVENT_COUNT
+} LogEvent;
+
+// Cabeçalho do ficheiro de logs.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize; // sizeof(LogRecord) of the writer
+} LogFileHeader;
+
+// Um registo do log (128 bytes).
+typedef struct {
+    int64_t timestamp;       // nanoseconds since the epoch
+    uint16_t event;          // LogEvent
+    uint16_t payloadLength;
+    int32_t gameID;
+    int32_t playerID;
+    int32_t value;           // meaning depends on the event
+    char payload[LOG_PAYLOAD_SIZE];
+} LogRecord;
+
+// Preenche um registo com o instante atual e, se `payload` não for NULL, o texto (cortado se for longo).
+void fillLogRecord(LogRecord *record, LogEvent event, int gameID, int playerID, int value, const char *payload);
+
+// Código do evento com este nome (um dos EVENT_* de logs-common.h), LOG_EVENT_TEXT se não existe.
+LogEvent findLogEvent(const char *name);
+
+// Nome do evento, para os descodificadores.
+const char *getLogEventName(int event);
+
+// Escreve a mensagem legível de um registo em `message` (só para descodificar, fora do servidor).
+void formatLogRecord(const LogRecord *record, char *message, int size);
+
+// Verifica o cabeçalho de um ficheiro de logs.
+bool isLogFileHeader(const LogFileHeader *header);
+
+#endif // LOGS_BINARY_H
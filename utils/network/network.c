@@ -103,3 +103,70 @@ int readline(int fd, char *ptr, int maxlen)
 	   com o \n ou \0 */
 	return (n);
 }
+
+
+/**
+ * Associa um leitor de linhas a um descritor de ficheiro, com o buffer vazio.
+ *
+ * @param reader O leitor a inicializar.
+ * @param fd O descritor de ficheiro (socket ou ficheiro) de onde serão lidas as linhas.
+ */
+
+void initLineReader(LineReader *reader, int fd)
+{
+	reader->fd = fd;
+	reader->start = 0;
+	reader->end = 0;
+}
+
+
+/**
+ * Lê uma linha de um ficheiro/socket através do buffer do leitor.
+ *
+ * @param reader O leitor, que guarda os bytes lidos a mais para as linhas seguintes.
+ * @param ptr Um pointer para o buffer onde a linha lida será armazenada.
+ * @param maxlen O número máximo de caracteres a serem lidos, incluindo o terminador '\0'.
+ * @return O mesmo que `readline`: o número de caracteres lidos, incluindo '\n', 0 no fim
+ * do ficheiro ou -1 em caso de erro.
+ *
+ * @details Ao contrário de `readline`, que faz uma leitura por carácter, cada leitura enche
+ * o buffer do leitor, pelo que várias linhas enviadas de seguida custam uma só leitura.
+ */
+
+int readBufferedLine(LineReader *reader, char *ptr, int maxlen)
+{
+	int n, rc;
+	char c;
+
+	for (n = 1; n < maxlen; n++)
+	{
+		if (reader->start == reader->end)
+		{
+			do
+			{
+				rc = read(reader->fd, reader->buffer, LINE_READER_SIZE);
+			} while (rc < 0 && errno == EINTR);
+
+			if (rc < 0)
+				return (-1);
+			if (rc == 0)
+			{
+				if (n == 1)
+					return (0);
+				else
+					break;
+			}
+
+			reader->start = 0;
+			reader->end = rc;
+		}
+
+		c = reader->buffer[reader->start++];
+		*ptr++ = c;
+		if (c == '\n')
+			break;
+	}
+
+	*ptr = 0;
+	return (n);
+}
@@ -1,3 +1,6 @@
+#ifndef NETWORK_H
+#define NETWORK_H
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <strings.h>
@@ -23,8 +26,27 @@ extern int writen(int fd, char *ptr, int nbytes);
 // Função externa para ler uma linha de um descritor de ficheiro.
 extern int readline(int fd, char *ptr, int maxlen);
 
+// Tamanho do buffer de um leitor de linhas.
+#define LINE_READER_SIZE 4096
+
+// Leitor de linhas com buffer próprio (uma leitura do socket serve várias linhas).
+typedef struct {
+	int fd;
+	int start;
+	int end;
+	char buffer[LINE_READER_SIZE];
+} LineReader;
+
+// Associa um leitor de linhas a um descritor de ficheiro.
+extern void initLineReader(LineReader *reader, int fd);
+
+// Lê uma linha através do buffer do leitor (mesmo resultado que readline).
+extern int readBufferedLine(LineReader *reader, char *ptr, int maxlen);
+
 // Função externa para gerir a comunicação cliente-servidor.
 extern void str_cli(FILE *fp, int sockfd);
 
 // Função externa para ecoar dados recebidos de um cliente.
-extern void str_echo(int sockfd);
\ No newline at end of file
+extern void str_echo(int sockfd);
+
+#endif // NETWORK_H
@@ -15,9 +15,24 @@ Node *createNode(int clientID, bool isPremium) {
     return newNode;
 }
 
+// take a node from the queue's free list, or a new one (with the queue locked)
+static Node *takeNode(PriorityQueue *queue, int clientID, bool isPremium) {
+    Node *node = queue->freeNodes;
+    if (node == NULL) {
+        return createNode(clientID, isPremium);
+    }
+    queue->freeNodes = node->next;
+    node->clientID = clientID;
+    node->isPremium = isPremium;
+    node->next = NULL;
+    node->timeInQueue = 0;
+    return node;
+}
+
 void initPriorityQueue(PriorityQueue *queue, int queueSize) {
     queue->front = NULL;
     queue->rear = NULL;
+    queue->freeNodes = NULL;
     pthread_mutex_init(&queue->mutex, NULL);
     sem_init(&queue->empty, 0, queueSize);
     sem_init(&queue->full, 0, 0);
@@ -26,15 +41,15 @@ void initPriorityQueue(PriorityQueue *queue, int queueSize) {
 void enqueueWithPriority(PriorityQueue *queue, int clientID, bool isPremium) {
     //printf("CLIENT %d WANT TO JOIN THE ROOM\n", clientID);
 
-    Node *newNode = createNode(clientID, isPremium); // create a new node
-    //printf("CREATING A NODE FOR CLIENt %d WHICH IS %s\n", clientID, isPremium ? "PREMIUM" : "NOT PREMIUM");
-
     sem_wait(&queue->empty); // wait for empty space (fica a espera que haja espaço na fila para adicionar um novo cliente)
 
     //printf("CLIENT %d JOINING THE QUEUE\n", clientID);
 
     pthread_mutex_lock(&queue->mutex); // lock the queue (garante a exclusão mútua se dois clientes tentarem aceder simultaneamente à fila)
 
+    Node *newNode = takeNode(queue, clientID, isPremium); // create a new node (or reuse a free one)
+    //printf("CREATING A NODE FOR CLIENt %d WHICH IS %s\n", clientID, isPremium ? "PREMIUM" : "NOT PREMIUM");
+
     if (queue->front == NULL) { // if the queue is empty
         //printf("QUEUE IS EMPTY: ADDING CLIENT %d TO THE FIRST NODE\n", clientID);
         queue->front = newNode;
@@ -177,12 +192,12 @@ void updateQueueWithPriority(PriorityQueue *queue, int maxWaitingTime) {
 
 void enqueueFifo(PriorityQueue *queue, int clientID) {
 
-    Node *newNode = createNode(clientID, false); // create a new node
-
     sem_wait(&queue->empty); // wait for empty space(se for >0 continua a decrementar se for =0 fica a espera que haja espaço na fila para adicionar um novo cliente)
 
     pthread_mutex_lock(&queue->mutex); // lock the queue
 
+    Node *newNode = takeNode(queue, clientID, false); // create a new node (or reuse a free one)
+
     if (queue->front == NULL) { // if the queue is empty(ao adicionar 1 cliente passa para a função de baixo porque a  fila já não está vazia)
         queue->front = newNode;
         queue->rear = newNode;
@@ -224,7 +239,9 @@ int dequeue(PriorityQueue *queue) {
 
     int clientID = temp->clientID;
 
-    free(temp);
+    // keep the node for the next enqueue (the queue never holds more than queueSize nodes)
+    temp->next = queue->freeNodes;
+    queue->freeNodes = temp;
 
     pthread_mutex_unlock(&queue->mutex);
     sem_post(&queue->empty);// incrementa o semáforo empty, indicando que há um espaço na fila para ser preenchido
@@ -240,6 +257,12 @@ void freePriorityQueue(PriorityQueue *queue) {
         free(temp);
         temp = next;
     }
+    temp = queue->freeNodes;
+    while (temp != NULL) {
+        Node *next = temp->next;
+        free(temp);
+        temp = next;
+    }
     pthread_mutex_destroy(&queue->mutex);
     sem_destroy(&queue->empty);
     sem_destroy(&queue->full);
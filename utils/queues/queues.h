@@ -16,6 +16,7 @@ typedef struct Node {
 typedef struct PriorityQueue {
     Node* front;
     Node* rear;
+    Node* freeNodes; // nodes of clients already dequeued, reused by the next enqueue
     pthread_mutex_t mutex;
     sem_t empty;
     sem_t full;
@@ -0,0 +1,99 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include "ring.h"
+
+bool initRingQueue(RingQueue *queue, size_t capacity) {
+
+    // the capacity is rounded up to a power of two so positions wrap with a mask
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    queue->cells = (RingCell *)malloc(sizeof(RingCell) * size);
+    if (queue->cells == NULL) {
+        return false;
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        atomic_init(&queue->cells[i].sequence, i);
+        queue->cells[i].value = NULL;
+    }
+
+    queue->mask = size - 1;
+    atomic_init(&queue->enqueuePos, 0);
+    atomic_init(&queue->dequeuePos, 0);
+
+    return true;
+}
+
+bool ringEnqueue(RingQueue *queue, void *value) {
+
+    RingCell *cell;
+    size_t pos = atomic_load_explicit(&queue->enqueuePos, memory_order_relaxed);
+
+    for (;;) {
+        cell = &queue->cells[pos & queue->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+
+        if (diff == 0) {
+            // the cell is free for this lap: claim the position
+            if (atomic_compare_exchange_weak_explicit(&queue->enqueuePos, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // the consumer of the previous lap hasn't freed the cell: full
+            return false;
+        } else {
+            pos = atomic_load_explicit(&queue->enqueuePos, memory_order_relaxed);
+        }
+    }
+
+    cell->value = value;
+    atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+
+    return true;
+}
+
+void *ringDequeue(RingQueue *queue) {
+
+    RingCell *cell;
+    size_t pos = atomic_load_explicit(&queue->dequeuePos, memory_order_relaxed);
+
+    for (;;) {
+        cell = &queue->cells[pos & queue->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+
+        if (diff == 0) {
+            // the cell holds a value for this lap: claim the position
+            if (atomic_compare_exchange_weak_explicit(&queue->dequeuePos, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // no producer has filled the cell yet: empty
+            return NULL;
+        } else {
+            pos = atomic_load_explicit(&queue->dequeuePos, memory_order_relaxed);
+        }
+    }
+
+    void *value = cell->value;
+    atomic_store_explicit(&cell->sequence, pos + queue->mask + 1, memory_order_release);
+
+    return value;
+}
+
+size_t ringSize(RingQueue *queue) {
+
+    size_t enqueued = atomic_load_explicit(&queue->enqueuePos, memory_order_relaxed);
+    size_t dequeued = atomic_load_explicit(&queue->dequeuePos, memory_order_relaxed);
+
+    return enqueued > dequeued ? enqueued - dequeued : 0;
+}
+
+void freeRingQueue(RingQueue *queue) {
+    free(queue->cells);
+    queue->cells = NULL;
+}
@@ -0,0 +1,41 @@
+#ifndef RING_H
+#define RING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+/*
+ * Fila circular limitada, sem locks, para vários produtores e vários consumidores
+ * (algoritmo de Dmitry Vyukov). Cada posição tem um número de sequência que diz se
+ * está livre para o produtor ou pronta para o consumidor da volta atual.
+ */
+
+typedef struct {
+    atomic_size_t sequence;
+    void *value;
+} RingCell;
+
+typedef struct {
+    RingCell *cells;
+    size_t mask;
+    _Alignas(64) atomic_size_t enqueuePos; // separate cache lines for producers and consumers
+    _Alignas(64) atomic_size_t dequeuePos;
+} RingQueue;
+
+// initialize a queue with room for at least `capacity` values (returns false on allocation failure)
+bool initRingQueue(RingQueue *queue, size_t capacity);
+
+// add a value (returns false, without blocking, if the queue is full)
+bool ringEnqueue(RingQueue *queue, void *value);
+
+// remove a value (returns NULL, without blocking, if the queue is empty)
+void *ringDequeue(RingQueue *queue);
+
+// number of values in the queue (approximate while other threads are using it)
+size_t ringSize(RingQueue *queue);
+
+// free the queue (the values are not freed)
+void freeRingQueue(RingQueue *queue);
+
+#endif // RING_H
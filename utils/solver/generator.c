@@ -0,0 +1,60 @@
+#include <stdlib.h>
+#include <string.h>
+#include "solver.h"
+#include "generator.h"
+
+static void shuffle(int *values, int count, unsigned int *seed) {
+    for (int i = count - 1; i > 0; i--) {
+        int j = rand_r(seed) % (i + 1);
+        int temp = values[i];
+        values[i] = values[j];
+        values[j] = temp;
+    }
+}
+
+int generatePuzzle(char board[9][9], char solution[9][9], int targetClues, unsigned int *seed) {
+
+    if (targetClues < GENERATOR_MIN_CLUES) {
+        targetClues = GENERATOR_MIN_CLUES;
+    }
+
+    // the diagonal boxes don't constrain each other: fill them at random and solve the rest
+    char grid[9][9];
+    memset(grid, 0, sizeof(grid));
+
+    for (int box = 0; box < 3; box++) {
+        int digits[9] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+        shuffle(digits, 9, seed);
+        for (int k = 0; k < 9; k++) {
+            grid[box * 3 + k / 3][box * 3 + k % 3] = digits[k];
+        }
+    }
+
+    solveSudoku((const char (*)[9])grid, solution);
+    memcpy(board, solution, sizeof(grid));
+
+    // remove clues in random order, keeping the solution unique
+    int order[81];
+    for (int cell = 0; cell < 81; cell++) {
+        order[cell] = cell;
+    }
+    shuffle(order, 81, seed);
+
+    int clues = 81;
+
+    for (int i = 0; i < 81 && clues > targetClues; i++) {
+
+        int row = order[i] / 9, col = order[i] % 9;
+        char digit = board[row][col];
+
+        board[row][col] = 0;
+
+        if (hasUniqueSolution((const char (*)[9])board)) {
+            clues--;
+        } else {
+            board[row][col] = digit;
+        }
+    }
+
+    return clues;
+}
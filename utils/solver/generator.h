@@ -0,0 +1,14 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+/*
+ * Gerador de puzzles com solução única: gera uma grelha completa aleatória e retira
+ * pistas por ordem aleatória enquanto o puzzle continuar a ter uma só solução.
+ */
+
+#define GENERATOR_MIN_CLUES 17 // no 9x9 puzzle with fewer clues has a unique solution
+
+// generate a puzzle with about targetClues clues (returns the number of clues left)
+int generatePuzzle(char board[9][9], char solution[9][9], int targetClues, unsigned int *seed);
+
+#endif // GENERATOR_H
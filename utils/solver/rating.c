@@ -0,0 +1,336 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "solver.h"
+#include "rating.h"
+
+#define ROW_UNIT(cell) ((cell) / 9)
+#define COL_UNIT(cell) (9 + (cell) % 9)
+#define BOX_UNIT(cell) (18 + ((cell) / 27) * 3 + ((cell) % 9) / 3)
+
+// pencil marks: unlike the solver state, candidates are also removed by eliminations
+typedef struct {
+    uint8_t cells[81];
+    uint16_t candidates[81];
+    int empty;
+} RatingGrid;
+
+static void setDigit(RatingGrid *grid, int cell, int digit) {
+
+    uint16_t bit = 1 << digit;
+    int units[3] = {ROW_UNIT(cell), COL_UNIT(cell), BOX_UNIT(cell)};
+
+    grid->cells[cell] = digit;
+    grid->candidates[cell] = 0;
+    grid->empty--;
+
+    for (int u = 0; u < 3; u++) {
+        for (int k = 0; k < 9; k++) {
+            grid->candidates[unitCell(units[u], k)] &= ~bit;
+        }
+    }
+}
+
+// remove digits from a cell, true if something changed
+static bool eliminate(RatingGrid *grid, int cell, uint16_t digits) {
+
+    if ((grid->candidates[cell] & digits) == 0) {
+        return false;
+    }
+
+    grid->candidates[cell] &= ~digits;
+    return true;
+}
+
+// positions (bit k = k-th cell of the unit) where a digit can still go
+static uint16_t digitPositions(const RatingGrid *grid, int unit, int digit) {
+
+    uint16_t positions = 0;
+
+    for (int k = 0; k < 9; k++) {
+        if (grid->candidates[unitCell(unit, k)] & (1 << digit)) {
+            positions |= 1 << k;
+        }
+    }
+
+    return positions;
+}
+
+static bool hiddenSingle(RatingGrid *grid) {
+
+    for (int unit = 0; unit < 27; unit++) {
+        for (int digit = 1; digit <= 9; digit++) {
+            uint16_t positions = digitPositions(grid, unit, digit);
+            if (__builtin_popcount(positions) == 1) {
+                setDigit(grid, unitCell(unit, __builtin_ctz(positions)), digit);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+static bool nakedSingle(RatingGrid *grid) {
+
+    for (int cell = 0; cell < 81; cell++) {
+        if (grid->cells[cell] == 0 && __builtin_popcount(grid->candidates[cell]) == 1) {
+            setDigit(grid, cell, __builtin_ctz(grid->candidates[cell]));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// pointing (box -> line) and claiming (line -> box)
+static bool lockedCandidates(RatingGrid *grid) {
+
+    for (int unit = 0; unit < 27; unit++) {
+        for (int digit = 1; digit <= 9; digit++) {
+
+            uint16_t positions = digitPositions(grid, unit, digit);
+            if (__builtin_popcount(positions) < 2) {
+                continue;
+            }
+
+            // the units every candidate cell shares with this one
+            int first = unitCell(unit, __builtin_ctz(positions));
+            int shared[2] = {-1, -1};
+
+            if (unit < 18) {
+                shared[0] = BOX_UNIT(first);
+            } else {
+                shared[0] = ROW_UNIT(first);
+                shared[1] = COL_UNIT(first);
+            }
+
+            for (int k = 0; k < 9; k++) {
+                if (positions & (1 << k)) {
+                    int cell = unitCell(unit, k);
+                    for (int s = 0; s < 2; s++) {
+                        if (shared[s] >= 0 && shared[s] != ROW_UNIT(cell) && shared[s] != COL_UNIT(cell) && shared[s] != BOX_UNIT(cell)) {
+                            shared[s] = -1;
+                        }
+                    }
+                }
+            }
+
+            bool changed = false;
+
+            for (int s = 0; s < 2; s++) {
+                if (shared[s] < 0) {
+                    continue;
+                }
+                for (int k = 0; k < 9; k++) {
+                    int cell = unitCell(shared[s], k);
+                    if (ROW_UNIT(cell) != unit && COL_UNIT(cell) != unit && BOX_UNIT(cell) != unit) {
+                        changed |= eliminate(grid, cell, 1 << digit);
+                    }
+                }
+            }
+
+            if (changed) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// size cells of a unit holding only size digits between them
+static bool nakedSubset(RatingGrid *grid, int size) {
+
+    for (int unit = 0; unit < 27; unit++) {
+
+        int cells[9], count = 0;
+
+        for (int k = 0; k < 9; k++) {
+            int cell = unitCell(unit, k);
+            int numCandidates = __builtin_popcount(grid->candidates[cell]);
+            if (grid->cells[cell] == 0 && numCandidates >= 2 && numCandidates <= size) {
+                cells[count++] = cell;
+            }
+        }
+
+        for (int a = 0; a < count; a++) {
+            for (int b = a + 1; b < count; b++) {
+                for (int c = (size == 3 ? b + 1 : count - 1); c < count; c++) {
+
+                    uint16_t digits = grid->candidates[cells[a]] | grid->candidates[cells[b]];
+                    if (size == 3) {
+                        digits |= grid->candidates[cells[c]];
+                    }
+
+                    if (__builtin_popcount(digits) != size) {
+                        continue;
+                    }
+
+                    bool changed = false;
+
+                    for (int k = 0; k < 9; k++) {
+                        int cell = unitCell(unit, k);
+                        if (cell != cells[a] && cell != cells[b] && (size == 2 || cell != cells[c])) {
+                            changed |= eliminate(grid, cell, digits);
+                        }
+                    }
+
+                    if (changed) {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+// two digits that can only go in the same two cells of a unit
+static bool hiddenPair(RatingGrid *grid) {
+
+    for (int unit = 0; unit < 27; unit++) {
+
+        uint16_t positions[10];
+        for (int digit = 1; digit <= 9; digit++) {
+            positions[digit] = digitPositions(grid, unit, digit);
+        }
+
+        for (int d1 = 1; d1 <= 9; d1++) {
+            if (__builtin_popcount(positions[d1]) != 2) {
+                continue;
+            }
+            for (int d2 = d1 + 1; d2 <= 9; d2++) {
+                if (positions[d2] != positions[d1]) {
+                    continue;
+                }
+
+                uint16_t others = SOLVER_ALL_CANDIDATES & ~((1 << d1) | (1 << d2));
+                bool changed = false;
+
+                for (int k = 0; k < 9; k++) {
+                    if (positions[d1] & (1 << k)) {
+                        changed |= eliminate(grid, unitCell(unit, k), others);
+                    }
+                }
+
+                if (changed) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+// X-wing (size 2) and swordfish (size 3), on rows and on columns
+static bool fish(RatingGrid *grid, int size) {
+
+    for (int digit = 1; digit <= 9; digit++) {
+        for (int base = 0; base <= 9; base += 9) {
+
+            // base lines are rows (0-8) or columns (9-17), cover lines are the other kind
+            int cover = 9 - base;
+            int lines[9], count = 0;
+            uint16_t positions[9];
+
+            for (int line = 0; line < 9; line++) {
+                uint16_t found = digitPositions(grid, base + line, digit);
+                int numPositions = __builtin_popcount(found);
+                if (numPositions >= 2 && numPositions <= size) {
+                    positions[count] = found;
+                    lines[count++] = line;
+                }
+            }
+
+            for (int a = 0; a < count; a++) {
+                for (int b = a + 1; b < count; b++) {
+                    for (int c = (size == 3 ? b + 1 : count - 1); c < count; c++) {
+
+                        uint16_t covered = positions[a] | positions[b];
+                        if (size == 3) {
+                            covered |= positions[c];
+                        }
+
+                        if (__builtin_popcount(covered) != size) {
+                            continue;
+                        }
+
+                        bool changed = false;
+
+                        for (int k = 0; k < 9; k++) {
+                            if (!(covered & (1 << k))) {
+                                continue;
+                            }
+                            for (int line = 0; line < 9; line++) {
+                                if (line != lines[a] && line != lines[b] && (size == 2 || line != lines[c])) {
+                                    // the cell at (base line, cover line) is the line-th cell of the cover unit
+                                    changed |= eliminate(grid, unitCell(cover + k, line), 1 << digit);
+                                }
+                            }
+                        }
+
+                        if (changed) {
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+int ratePuzzle(const char board[9][9]) {
+
+    SolverState state;
+    if (!initSolverState(&state, board)) {
+        return 0;
+    }
+
+    RatingGrid grid;
+    grid.empty = 0;
+
+    for (int cell = 0; cell < 81; cell++) {
+        grid.cells[cell] = state.cells[cell];
+        grid.candidates[cell] = state.cells[cell] == 0 ? cellCandidates(&state, cell) : 0;
+        if (state.cells[cell] == 0) {
+            grid.empty++;
+        }
+    }
+
+    int rating = RATING_HIDDEN_SINGLES;
+
+    // always go back to the simplest technique after any progress
+    while (grid.empty > 0) {
+
+        int level;
+
+        if (hiddenSingle(&grid)) {
+            level = RATING_HIDDEN_SINGLES;
+        } else if (nakedSingle(&grid)) {
+            level = RATING_NAKED_SINGLES;
+        } else if (lockedCandidates(&grid) || nakedSubset(&grid, 2) || hiddenPair(&grid)) {
+            level = RATING_PAIRS;
+        } else if (nakedSubset(&grid, 3) || fish(&grid, 2) || fish(&grid, 3)) {
+            level = RATING_FISH;
+        } else {
+            return RATING_GUESSING;
+        }
+
+        if (level > rating) {
+            rating = level;
+        }
+
+        // a cell without candidates means the puzzle has no solution: logic alone can't rate it
+        for (int cell = 0; cell < 81; cell++) {
+            if (grid.cells[cell] == 0 && grid.candidates[cell] == 0) {
+                return RATING_GUESSING;
+            }
+        }
+    }
+
+    return rating;
+}
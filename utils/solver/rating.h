@@ -0,0 +1,21 @@
+#ifndef RATING_H
+#define RATING_H
+
+/*
+ * Classificação da dificuldade de um puzzle pelas técnicas humanas necessárias para o resolver.
+ * O puzzle é resolvido só por lógica, aplicando sempre a técnica mais simples que faz progresso;
+ * a dificuldade é o nível da técnica mais difícil que foi preciso usar.
+ */
+
+#define RATING_LEVELS 5
+
+#define RATING_HIDDEN_SINGLES 1 // hidden singles only
+#define RATING_NAKED_SINGLES 2  // naked singles
+#define RATING_PAIRS 3          // locked candidates, naked and hidden pairs
+#define RATING_FISH 4           // naked triples, X-wing and swordfish
+#define RATING_GUESSING 5       // not solvable by the techniques above
+
+// rate a board from 1 to RATING_LEVELS (returns 0 if the givens conflict)
+int ratePuzzle(const char board[9][9]);
+
+#endif // RATING_H
@@ -0,0 +1,220 @@
+#include <string.h>
+#include "solver.h"
+
+#define BOX_OF(cell) (((cell) / 27) * 3 + ((cell) % 9) / 3)
+
+int unitCell(int unit, int k) {
+
+    if (unit < 9) {
+        return unit * 9 + k;
+    }
+    if (unit < 18) {
+        return k * 9 + (unit - 9);
+    }
+
+    int box = unit - 18;
+    return ((box / 3) * 3 + k / 3) * 9 + (box % 3) * 3 + k % 3;
+}
+
+uint16_t cellCandidates(const SolverState *state, int cell) {
+    int row = cell / 9, col = cell % 9;
+    return ~(state->rows[row] | state->cols[col] | state->boxes[BOX_OF(cell)]) & SOLVER_ALL_CANDIDATES;
+}
+
+void placeDigit(SolverState *state, int cell, int digit) {
+
+    uint16_t bit = 1 << digit;
+
+    state->cells[cell] = digit;
+    state->rows[cell / 9] |= bit;
+    state->cols[cell % 9] |= bit;
+    state->boxes[BOX_OF(cell)] |= bit;
+}
+
+bool initSolverState(SolverState *state, const char board[9][9]) {
+
+    memset(state, 0, sizeof(SolverState));
+
+    for (int cell = 0; cell < 81; cell++) {
+
+        int digit = board[cell / 9][cell % 9];
+
+        if (digit == 0) {
+            continue;
+        }
+
+        // a given out of range or repeated in its row, column or box
+        if (digit < 1 || digit > 9 || !(cellCandidates(state, cell) & (1 << digit))) {
+            return false;
+        }
+
+        placeDigit(state, cell, digit);
+    }
+
+    return true;
+}
+
+/**
+ * Aplica naked singles e hidden singles até não haver mais progresso.
+ *
+ * @return false se encontrar uma contradição (célula sem candidatos ou dígito sem lugar numa unidade).
+ */
+
+static bool propagate(SolverState *state) {
+
+    bool changed = true;
+
+    while (changed) {
+
+        changed = false;
+
+        // naked singles: cells with a single candidate
+        for (int cell = 0; cell < 81; cell++) {
+
+            if (state->cells[cell] != 0) {
+                continue;
+            }
+
+            uint16_t candidates = cellCandidates(state, cell);
+
+            if (candidates == 0) {
+                return false;
+            }
+
+            if ((candidates & (candidates - 1)) == 0) {
+                placeDigit(state, cell, __builtin_ctz(candidates));
+                changed = true;
+            }
+        }
+
+        // hidden singles: digits with a single place in a unit
+        for (int unit = 0; unit < 27; unit++) {
+
+            uint16_t seenOnce = 0, seenTwice = 0, placed = 0;
+            uint8_t lastCell[10];
+
+            for (int k = 0; k < 9; k++) {
+
+                int cell = unitCell(unit, k);
+
+                if (state->cells[cell] != 0) {
+                    placed |= 1 << state->cells[cell];
+                    continue;
+                }
+
+                uint16_t candidates = cellCandidates(state, cell);
+                seenTwice |= seenOnce & candidates;
+                seenOnce |= candidates;
+
+                for (uint16_t bits = candidates; bits != 0; bits &= bits - 1) {
+                    lastCell[__builtin_ctz(bits)] = cell;
+                }
+            }
+
+            // a missing digit with nowhere to go
+            if ((seenOnce | placed) != SOLVER_ALL_CANDIDATES) {
+                return false;
+            }
+
+            for (uint16_t singles = seenOnce & ~seenTwice; singles != 0; singles &= singles - 1) {
+
+                int digit = __builtin_ctz(singles);
+                int cell = lastCell[digit];
+
+                // an earlier single of this unit may have taken the digit away
+                if (state->cells[cell] != 0 || !(cellCandidates(state, cell) & (1 << digit))) {
+                    continue;
+                }
+
+                placeDigit(state, cell, digit);
+                changed = true;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Procura soluções por backtracking, escolhendo a célula com menos candidatos.
+ *
+ * @param state O estado atual (é alterado).
+ * @param count O número de soluções encontradas até agora.
+ * @param limit Para a procura quando `count` chega a este valor.
+ * @param solution Recebe a primeira solução encontrada (pode ser NULL).
+ */
+
+static void search(SolverState *state, int *count, int limit, uint8_t *solution) {
+
+    if (!propagate(state)) {
+        return;
+    }
+
+    // pick the empty cell with the fewest candidates
+    int bestCell = -1;
+    int bestCount = 10;
+
+    for (int cell = 0; cell < 81 && bestCount > 2; cell++) {
+        if (state->cells[cell] == 0) {
+            int candidates = __builtin_popcount(cellCandidates(state, cell));
+            if (candidates < bestCount) {
+                bestCount = candidates;
+                bestCell = cell;
+            }
+        }
+    }
+
+    // no empty cells left: solved
+    if (bestCell < 0) {
+        if (*count == 0 && solution != NULL) {
+            memcpy(solution, state->cells, 81);
+        }
+        (*count)++;
+        return;
+    }
+
+    for (uint16_t bits = cellCandidates(state, bestCell); bits != 0 && *count < limit; bits &= bits - 1) {
+        SolverState next = *state;
+        placeDigit(&next, bestCell, __builtin_ctz(bits));
+        search(&next, count, limit, solution);
+    }
+}
+
+bool solveSudoku(const char board[9][9], char solution[9][9]) {
+
+    SolverState state;
+    if (!initSolverState(&state, board)) {
+        return false;
+    }
+
+    uint8_t cells[81];
+    int count = 0;
+    search(&state, &count, 1, cells);
+
+    if (count == 0) {
+        return false;
+    }
+
+    for (int cell = 0; cell < 81; cell++) {
+        solution[cell / 9][cell % 9] = cells[cell];
+    }
+
+    return true;
+}
+
+int countSolutions(const char board[9][9], int limit) {
+
+    SolverState state;
+    if (!initSolverState(&state, board)) {
+        return 0;
+    }
+
+    int count = 0;
+    search(&state, &count, limit, NULL);
+
+    return count;
+}
+
+bool hasUniqueSolution(const char board[9][9]) {
+    return countSolutions(board, 2) == 1;
+}
@@ -0,0 +1,42 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Solver de Sudoku 9x9: propagação de restrições com bitmasks (naked e hidden singles)
+ * e backtracking pela célula com menos candidatos. As células vazias valem 0.
+ */
+
+#define SOLVER_ALL_CANDIDATES 0x3FE // bits 1..9
+
+typedef struct {
+    uint8_t cells[81];
+    uint16_t rows[9];   // digits used in each row
+    uint16_t cols[9];   // digits used in each column
+    uint16_t boxes[9];  // digits used in each 3x3 box
+} SolverState;
+
+// load a board into a solver state (returns false if the givens conflict)
+bool initSolverState(SolverState *state, const char board[9][9]);
+
+// place a digit in an empty cell
+void placeDigit(SolverState *state, int cell, int digit);
+
+// candidate digits of an empty cell as a bitmask
+uint16_t cellCandidates(const SolverState *state, int cell);
+
+// the cells of a unit: rows 0-8, columns 9-17, boxes 18-26
+int unitCell(int unit, int k);
+
+// solve a board (returns true and fills solution with the first solution found)
+bool solveSudoku(const char board[9][9], char solution[9][9]);
+
+// count the solutions of a board, stopping at limit (limit 2 checks uniqueness)
+int countSolutions(const char board[9][9], int limit);
+
+// true if the board has exactly one solution
+bool hasUniqueSolution(const char board[9][9]);
+
+#endif // SOLVER_H
@@ -0,0 +1,291 @@
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include "wal.h"
+
+static uint32_t checksumRecord(const void *record, uint32_t length) {
+
+    const unsigned char *bytes = (const unsigned char *)record;
+    uint32_t hash = 2166136261u;
+
+    for (uint32_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static bool writeAll(int fd, const char *buffer, size_t length) {
+
+    while (length > 0) {
+        ssize_t written = write(fd, buffer, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        buffer += written;
+        length -= written;
+    }
+
+    return true;
+}
+
+// the group commit: one write and one fdatasync for everything appended during the interval
+static void *commitRecords(void *arg) {
+
+    Wal *wal = (Wal *)arg;
+
+    pthread_mutex_lock(&wal->mutex);
+
+    for (;;) {
+
+        while (wal->used == 0 && !wal->isStopping) {
+            pthread_cond_wait(&wal->appended, &wal->mutex);
+        }
+
+        // stopping, and nothing left to write
+        if (wal->used == 0) {
+            break;
+        }
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_nsec += WAL_COMMIT_INTERVAL_MS * 1000000L;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+        deadline.tv_nsec %= 1000000000L;
+
+        // a flush or a filling buffer doesn't wait for the rest of the interval
+        while (!wal->isStopping && wal->flushWaiters == 0 && wal->used < WAL_BUFFER_SIZE / 2) {
+            if (pthread_cond_timedwait(&wal->appended, &wal->mutex, &deadline) == ETIMEDOUT) {
+                break;
+            }
+        }
+
+        char *buffer = wal->buffers[wal->active];
+        size_t length = wal->used;
+        long sequence = wal->appendedRecords;
+        int fd = wal->fd;
+
+        // new records go to the other buffer while this one is written
+        wal->active ^= 1;
+        wal->used = 0;
+        pthread_cond_broadcast(&wal->committed);
+
+        pthread_mutex_unlock(&wal->mutex);
+
+        bool isWritten = writeAll(fd, buffer, length) && fdatasync(fd) == 0;
+
+        pthread_mutex_lock(&wal->mutex);
+
+        if (!isWritten) {
+            wal->writeErrors++;
+        }
+        wal->committedRecords = sequence;
+        wal->commits++;
+        wal->bytesWritten += length;
+        wal->fileSize += length;
+        pthread_cond_broadcast(&wal->committed);
+    }
+
+    pthread_mutex_unlock(&wal->mutex);
+
+    return NULL;
+}
+
+bool openWal(Wal *wal, const char *path, bool truncate) {
+
+    memset(wal, 0, sizeof(Wal));
+
+    wal->fd = open(path, O_WRONLY | O_CREAT | O_APPEND | (truncate ? O_TRUNC : 0), 0644);
+    if (wal->fd < 0) {
+        return false;
+    }
+    wal->fileSize = lseek(wal->fd, 0, SEEK_END);
+
+    wal->buffers[0] = (char *)malloc(WAL_BUFFER_SIZE);
+    wal->buffers[1] = (char *)malloc(WAL_BUFFER_SIZE);
+    if (wal->buffers[0] == NULL || wal->buffers[1] == NULL) {
+        free(wal->buffers[0]);
+        free(wal->buffers[1]);
+        close(wal->fd);
+        return false;
+    }
+
+    pthread_mutex_init(&wal->mutex, NULL);
+    pthread_cond_init(&wal->committed, NULL);
+
+    // the commit interval is measured on the monotonic clock
+    pthread_condattr_t attributes;
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    pthread_cond_init(&wal->appended, &attributes);
+    pthread_condattr_destroy(&attributes);
+
+    if (pthread_create(&wal->writer, NULL, commitRecords, (void *)wal) != 0) {
+        free(wal->buffers[0]);
+        free(wal->buffers[1]);
+        close(wal->fd);
+        return false;
+    }
+
+    return true;
+}
+
+bool walAppend(Wal *wal, const void *record, uint32_t length) {
+
+    if (length > WAL_MAX_RECORD) {
+        return false;
+    }
+
+    WalRecordHeader header;
+    header.length = length;
+    header.checksum = checksumRecord(record, length);
+
+    size_t total = sizeof(header) + length;
+
+    pthread_mutex_lock(&wal->mutex);
+
+    // a full buffer is the only case where the caller waits for the disk
+    if (wal->used + total > WAL_BUFFER_SIZE) {
+        wal->fullWaits++;
+        while (wal->used + total > WAL_BUFFER_SIZE) {
+            pthread_cond_signal(&wal->appended);
+            pthread_cond_wait(&wal->committed, &wal->mutex);
+        }
+    }
+
+    char *buffer = wal->buffers[wal->active] + wal->used;
+    memcpy(buffer, &header, sizeof(header));
+    memcpy(buffer + sizeof(header), record, length);
+    wal->used += total;
+    wal->appendedRecords++;
+
+    // the writer only needs waking for a new group or a buffer filling up
+    if (wal->used == total || wal->used >= WAL_BUFFER_SIZE / 2) {
+        pthread_cond_signal(&wal->appended);
+    }
+
+    pthread_mutex_unlock(&wal->mutex);
+
+    return true;
+}
+
+void walFlush(Wal *wal) {
+
+    pthread_mutex_lock(&wal->mutex);
+
+    long target = wal->appendedRecords;
+
+    wal->flushWaiters++;
+    pthread_cond_signal(&wal->appended);
+
+    while (wal->committedRecords < target) {
+        pthread_cond_wait(&wal->committed, &wal->mutex);
+    }
+
+    wal->flushWaiters--;
+
+    pthread_mutex_unlock(&wal->mutex);
+}
+
+bool walRewrite(Wal *wal, const char *path, void (*writeLive)(Wal *wal, void *arg), void *arg) {
+
+    // everything before the rewrite is in the current file
+    walFlush(wal);
+
+    char tempPath[512];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+
+    int fd = open(tempPath, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    pthread_mutex_lock(&wal->mutex);
+    int previousFd = wal->fd;
+    off_t previousSize = wal->fileSize;
+    wal->fd = fd;
+    wal->fileSize = 0;
+    pthread_mutex_unlock(&wal->mutex);
+
+    if (writeLive != NULL) {
+        writeLive(wal, arg);
+    }
+    walFlush(wal);
+
+    // the new file replaces the old one at once; if it can't, the old one is still complete
+    if (rename(tempPath, path) != 0) {
+        pthread_mutex_lock(&wal->mutex);
+        wal->fd = previousFd;
+        wal->fileSize = previousSize;
+        pthread_mutex_unlock(&wal->mutex);
+
+        close(fd);
+        unlink(tempPath);
+        return false;
+    }
+
+    close(previousFd);
+
+    return true;
+}
+
+void closeWal(Wal *wal) {
+
+    pthread_mutex_lock(&wal->mutex);
+    wal->isStopping = true;
+    pthread_cond_signal(&wal->appended);
+    pthread_mutex_unlock(&wal->mutex);
+
+    pthread_join(wal->writer, NULL);
+
+    close(wal->fd);
+    free(wal->buffers[0]);
+    free(wal->buffers[1]);
+}
+
+bool openWalReader(WalReader *reader, const char *path) {
+
+    reader->file = fopen(path, "rb");
+    reader->records = 0;
+    reader->isTorn = false;
+
+    return reader->file != NULL;
+}
+
+int nextWalRecord(WalReader *reader, void *record, uint32_t size, uint32_t *length) {
+
+    WalRecordHeader header;
+
+    size_t headerBytes = fread(&header, 1, sizeof(header), reader->file);
+    if (headerBytes == 0) {
+        return WAL_END;
+    }
+
+    // a crash can leave the last commit half written: everything from there on is ignored
+    if (headerBytes < sizeof(header) || header.length > size || header.length > WAL_MAX_RECORD ||
+        fread(record, 1, header.length, reader->file) != header.length ||
+        checksumRecord(record, header.length) != header.checksum) {
+        reader->isTorn = true;
+        return WAL_END;
+    }
+
+    *length = header.length;
+    reader->records++;
+
+    return WAL_RECORD;
+}
+
+void closeWalReader(WalReader *reader) {
+
+    if (reader->file != NULL) {
+        fclose(reader->file);
+        reader->file = NULL;
+    }
+}
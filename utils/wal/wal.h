@@ -0,0 +1,80 @@
+#ifndef WAL_H
+#define WAL_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sys/types.h>
+
+/*
+ * Write-ahead log com group commit: quem regista só copia o registo para um buffer em memória;
+ * uma thread escreve tudo o que se juntou durante WAL_COMMIT_INTERVAL_MS de uma vez e faz um só
+ * fdatasync por commit. Cada registo leva o tamanho e um checksum, para que a leitura depois de
+ * um crash pare no último registo completo em vez de ler um registo meio escrito.
+ */
+
+#define WAL_BUFFER_SIZE (256 * 1024) // bytes waiting for the next commit (two buffers: one filling, one being written)
+#define WAL_COMMIT_INTERVAL_MS 5     // a commit takes everything appended this long after the first record
+#define WAL_MAX_RECORD 4096          // bytes of one record at most
+
+#define WAL_RECORD 1
+#define WAL_END 0
+
+// Cabeçalho de cada registo no ficheiro, seguido de `length` bytes.
+typedef struct {
+    uint32_t length;
+    uint32_t checksum; // FNV-1a of the record
+} WalRecordHeader;
+
+typedef struct {
+    int fd;
+    pthread_mutex_t mutex;
+    pthread_cond_t appended;  // wakes the writer
+    pthread_cond_t committed; // wakes flushes, and appenders waiting for room in the buffer
+    pthread_t writer;
+    char *buffers[2];
+    int active;               // buffer being filled
+    size_t used;
+    int flushWaiters;
+    bool isStopping;
+    long appendedRecords;     // records appended since the start
+    long committedRecords;    // of those, records already on disk
+    long commits;
+    long bytesWritten;
+    long fullWaits;           // appends that waited for room in the buffer
+    long writeErrors;
+    off_t fileSize;
+} Wal;
+
+typedef struct {
+    FILE *file;
+    long records;
+    bool isTorn; // the file ends in an incomplete or damaged record (a crash in the middle of a commit)
+} WalReader;
+
+// Abre (ou cria) o log para acrescentar registos e inicia a thread de commit (false em caso de erro).
+bool openWal(Wal *wal, const char *path, bool truncate);
+
+// Copia um registo para o próximo commit; só espera se o buffer estiver cheio (false se o registo é grande demais).
+bool walAppend(Wal *wal, const void *record, uint32_t length);
+
+// Espera que todos os registos acrescentados até agora estejam no disco.
+void walFlush(Wal *wal);
+
+// Reescreve o log num ficheiro novo com os registos de `writeLive` e troca-o pelo atual (quem chama não acrescenta outros entretanto).
+bool walRewrite(Wal *wal, const char *path, void (*writeLive)(Wal *wal, void *arg), void *arg);
+
+// Escreve os registos pendentes, termina a thread de commit e fecha o ficheiro.
+void closeWal(Wal *wal);
+
+// Abre um log para o ler do início (false se não existe).
+bool openWalReader(WalReader *reader, const char *path);
+
+// Lê o registo seguinte para `record`: WAL_RECORD, ou WAL_END no fim do ficheiro ou num registo incompleto.
+int nextWalRecord(WalReader *reader, void *record, uint32_t size, uint32_t *length);
+
+// Fecha o log lido.
+void closeWalReader(WalReader *reader);
+
+#endif // WAL_H